@@ -0,0 +1,101 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "base/vivaldi_batching_task_runner.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/trace_event/base_tracing.h"
+
+namespace vivaldi {
+
+namespace {
+
+// A USER_VISIBLE closure that waits longer than this before it runs is
+// reported as stuck behind other work on the sequence.
+constexpr base::TimeDelta kUserVisibleWaitThreshold = base::Milliseconds(50);
+
+}  // namespace
+
+BatchingTaskRunner::PendingTask::PendingTask(const base::Location& from_here,
+                                             base::OnceClosure task,
+                                             base::TaskPriority priority)
+    : from_here(from_here),
+      task(std::move(task)),
+      priority(priority),
+      posted_time(base::TimeTicks::Now()) {}
+
+BatchingTaskRunner::PendingTask::PendingTask(PendingTask&&) = default;
+
+BatchingTaskRunner::PendingTask& BatchingTaskRunner::PendingTask::operator=(
+    PendingTask&&) = default;
+
+BatchingTaskRunner::PendingTask::~PendingTask() = default;
+
+BatchingTaskRunner::BatchingTaskRunner(
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    base::TimeDelta max_delay,
+    size_t max_batch_size)
+    : task_runner_(std::move(task_runner)),
+      max_delay_(max_delay),
+      max_batch_size_(max_batch_size) {
+  DCHECK(task_runner_);
+  DCHECK_GT(max_batch_size_, 0u);
+}
+
+BatchingTaskRunner::~BatchingTaskRunner() = default;
+
+void BatchingTaskRunner::PostTask(const base::Location& from_here,
+                                  base::OnceClosure task,
+                                  base::TaskPriority priority) {
+  base::AutoLock lock(lock_);
+  pending_.emplace_back(from_here, std::move(task), priority);
+  if (priority >= base::TaskPriority::USER_VISIBLE ||
+      pending_.size() >= max_batch_size_) {
+    ScheduleFlushLocked(base::TimeDelta());
+  } else {
+    ScheduleFlushLocked(max_delay_);
+  }
+}
+
+void BatchingTaskRunner::ScheduleFlushLocked(base::TimeDelta delay) {
+  base::TimeTicks flush_time = base::TimeTicks::Now() + delay;
+  if (!flush_time_.is_null() && flush_time_ <= flush_time)
+    return;
+  flush_time_ = flush_time;
+  // A flush posted earlier with a longer delay stays posted and finds either
+  // an empty queue or a newer batch that it runs a bit early.
+  task_runner_->PostDelayedTask(
+      FROM_HERE, base::BindOnce(&BatchingTaskRunner::RunBatch, this), delay);
+}
+
+void BatchingTaskRunner::RunBatch() {
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  std::vector<PendingTask> batch;
+  {
+    base::AutoLock lock(lock_);
+    batch.swap(pending_);
+    flush_time_ = base::TimeTicks();
+  }
+  if (batch.empty())
+    return;
+
+  TRACE_EVENT1("base", "BatchingTaskRunner::RunBatch", "tasks", batch.size());
+  bool ran_best_effort = false;
+  for (PendingTask& pending : batch) {
+    if (pending.priority >= base::TaskPriority::USER_VISIBLE) {
+      base::TimeDelta wait = base::TimeTicks::Now() - pending.posted_time;
+      if (ran_best_effort || wait > kUserVisibleWaitThreshold) {
+        TRACE_EVENT_INSTANT2("base", "BatchingTaskRunner::PriorityInversion",
+                             TRACE_EVENT_SCOPE_THREAD, "wait_ms",
+                             wait.InMillisecondsF(), "posted_from",
+                             pending.from_here.ToString());
+      }
+    } else {
+      ran_best_effort = true;
+    }
+    std::move(pending.task).Run();
+  }
+}
+
+}  // namespace vivaldi
@@ -0,0 +1,86 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#ifndef BASE_VIVALDI_BATCHING_TASK_RUNNER_H_
+#define BASE_VIVALDI_BATCHING_TASK_RUNNER_H_
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/callback.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/task_traits.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+
+namespace vivaldi {
+
+// Coalesces small closures posted from any thread within a short window into
+// a single task on the wrapped sequence. This is for work items that are
+// cheap to run but numerous, like per-bookmark bookkeeping, where one worker
+// task per item costs more in scheduling than in running.
+//
+// Closures run in the order they were posted. A closure posted with
+// USER_VISIBLE or higher priority flushes the batch right away, so only
+// BEST_EFFORT closures ever wait up to |max_delay|. When a USER_VISIBLE
+// closure runs behind BEST_EFFORT closures of its batch, or waits over 50 ms
+// because the sequence is busy with other work, a
+// "BatchingTaskRunner::PriorityInversion" trace event is emitted with the
+// wait time and the posting location.
+class BASE_EXPORT BatchingTaskRunner
+    : public base::RefCountedThreadSafe<BatchingTaskRunner> {
+ public:
+  BatchingTaskRunner(scoped_refptr<base::SequencedTaskRunner> task_runner,
+                     base::TimeDelta max_delay,
+                     size_t max_batch_size);
+  BatchingTaskRunner(const BatchingTaskRunner&) = delete;
+  BatchingTaskRunner& operator=(const BatchingTaskRunner&) = delete;
+
+  void PostTask(const base::Location& from_here,
+                base::OnceClosure task,
+                base::TaskPriority priority = base::TaskPriority::BEST_EFFORT);
+
+  base::SequencedTaskRunner* task_runner() const { return task_runner_.get(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<BatchingTaskRunner>;
+
+  struct PendingTask {
+    PendingTask(const base::Location& from_here,
+                base::OnceClosure task,
+                base::TaskPriority priority);
+    PendingTask(PendingTask&&);
+    PendingTask& operator=(PendingTask&&);
+    ~PendingTask();
+
+    base::Location from_here;
+    base::OnceClosure task;
+    base::TaskPriority priority;
+    base::TimeTicks posted_time;
+  };
+
+  ~BatchingTaskRunner();
+
+  // Post RunBatch() with |delay| unless a flush that runs no later is already
+  // posted.
+  void ScheduleFlushLocked(base::TimeDelta delay)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void RunBatch();
+
+  const scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  const base::TimeDelta max_delay_;
+  const size_t max_batch_size_;
+
+  base::Lock lock_;
+  std::vector<PendingTask> pending_ GUARDED_BY(lock_);
+
+  // Time when the earliest posted RunBatch() is due, null if none is posted.
+  base::TimeTicks flush_time_ GUARDED_BY(lock_);
+};
+
+}  // namespace vivaldi
+
+#endif  // BASE_VIVALDI_BATCHING_TASK_RUNNER_H_
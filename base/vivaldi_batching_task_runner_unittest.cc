@@ -0,0 +1,87 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "base/vivaldi_batching_task_runner.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace vivaldi {
+
+namespace {
+
+constexpr base::TimeDelta kMaxDelay = base::Milliseconds(100);
+constexpr size_t kMaxBatchSize = 3;
+
+class BatchingTaskRunnerTest : public testing::Test {
+ protected:
+  BatchingTaskRunnerTest()
+      : batching_task_runner_(base::MakeRefCounted<BatchingTaskRunner>(
+            task_environment_.GetMainThreadTaskRunner(),
+            kMaxDelay,
+            kMaxBatchSize)) {}
+
+  void Post(int id,
+            base::TaskPriority priority = base::TaskPriority::BEST_EFFORT) {
+    batching_task_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(
+            [](std::vector<int>* ran, int id) { ran->push_back(id); }, &ran_,
+            id),
+        priority);
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  scoped_refptr<BatchingTaskRunner> batching_task_runner_;
+  std::vector<int> ran_;
+};
+
+}  // namespace
+
+TEST_F(BatchingTaskRunnerTest, RunsInPostingOrder) {
+  Post(1);
+  Post(2);
+  task_environment_.FastForwardBy(kMaxDelay);
+  Post(3);
+  task_environment_.FastForwardBy(kMaxDelay);
+  EXPECT_EQ(ran_, std::vector<int>({1, 2, 3}));
+}
+
+TEST_F(BatchingTaskRunnerTest, DelaysBestEffortTasks) {
+  Post(1);
+  task_environment_.FastForwardBy(kMaxDelay - base::Milliseconds(1));
+  EXPECT_TRUE(ran_.empty());
+
+  // A later task joins the batch and does not push the flush back.
+  Post(2);
+  task_environment_.FastForwardBy(base::Milliseconds(1));
+  EXPECT_EQ(ran_, std::vector<int>({1, 2}));
+}
+
+TEST_F(BatchingTaskRunnerTest, UserVisibleTaskFlushesBatch) {
+  Post(1);
+  Post(2, base::TaskPriority::USER_VISIBLE);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(ran_, std::vector<int>({1, 2}));
+
+  // The flush posted for the first task finds nothing left.
+  task_environment_.FastForwardBy(kMaxDelay);
+  EXPECT_EQ(ran_, std::vector<int>({1, 2}));
+}
+
+TEST_F(BatchingTaskRunnerTest, FullBatchFlushes) {
+  static_assert(kMaxBatchSize == 3, "the test fills a batch of 3");
+  Post(1);
+  Post(2);
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(ran_.empty());
+
+  Post(3);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(ran_, std::vector<int>({1, 2, 3}));
+}
+
+}  // namespace vivaldi
@@ -18,6 +18,18 @@ const char kRunningVivaldi[] = "running-vivaldi";
 // support more cases, but for testing the older code can be enabled.
 const char kVivaldiEnableIPCDemuxer[] = "enable-ipc-demuxer";
 
+// Sample heap allocations of the browser process and periodically write the
+// samples as pprof heap profiles to the directory given as the value. See
+// browser/vivaldi_heap_profile.h.
+const char kVivaldiHeapProfile[] = "vivaldi-heap-profile";
+
+// Minutes between the profiles written with --vivaldi-heap-profile.
+const char kVivaldiHeapProfileInterval[] = "vivaldi-heap-profile-interval";
+
+// Mean number of bytes allocated between samples for --vivaldi-heap-profile.
+const char kVivaldiHeapProfileSamplingRate[] =
+    "vivaldi-heap-profile-sampling-rate";
+
 // The installer should perform updates completely silently and should not
 // terminate running browser instances. The name is criptic as it is not
 // intended to be used by the end-user.
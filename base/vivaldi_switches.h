@@ -26,6 +26,9 @@ SWITCHES_EXPORT extern const char kDisableVivaldi[];
 SWITCHES_EXPORT extern const char kRunningVivaldi[];
 
 SWITCHES_EXPORT extern const char kVivaldiEnableIPCDemuxer[];
+SWITCHES_EXPORT extern const char kVivaldiHeapProfile[];
+SWITCHES_EXPORT extern const char kVivaldiHeapProfileInterval[];
+SWITCHES_EXPORT extern const char kVivaldiHeapProfileSamplingRate[];
 SWITCHES_EXPORT extern const char kVivaldiSilentUpdate[];
 SWITCHES_EXPORT extern const char kVivaldiUpdateURL[];
 #if defined(COMPONENT_BUILD)
@@ -32,7 +32,8 @@ void ConvertThumbnailDataOnUIThread(
   place.SetBookmarkId(bookmark_id);
   VivaldiImageStore::StoreImage(
       profile, std::move(place), VivaldiImageStore::ImageFormat::kPNG,
-      thumbnail, base::BindOnce(&OnBookmarkThumbnailStored, bookmark_id));
+      thumbnail, base::BindOnce(&OnBookmarkThumbnailStored, bookmark_id),
+      VivaldiImageStore::StoreMode::kThumbnail);
 }
 
 }  // namespace
@@ -8,6 +8,7 @@
 #include "base/logging.h"
 #include "base/no_destructor.h"
 #include "base/path_service.h"
+#include "base/rand_util.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
 #include "base/timer/timer.h"
@@ -44,6 +45,16 @@ constexpr base::TimeDelta kStandaloneCheckPeriod =
 #endif
     ;
 
+// Maximum random delay added to each periodic check so installations started
+// at the same time do not all contact the update server together.
+constexpr base::TimeDelta kStandaloneCheckJitter =
+#ifdef OFFICIAL_BUILD
+    base::Hours(2)
+#else
+    base::Minutes(5)
+#endif
+    ;
+
 void StartUpdateNotifierIfEnabled() {
   // We want to run the notifier with the current flags even if those are
   // different from the command line in the task scheduler entry. This way one
@@ -54,8 +65,8 @@ void StartUpdateNotifierIfEnabled() {
   LaunchNotifierProcess(cmdline);
 }
 
-base::RepeatingTimer& GetStandaloneAutoUpdateTimer() {
-  static base::NoDestructor<base::RepeatingTimer> instance;
+base::OneShotTimer& GetStandaloneAutoUpdateTimer() {
+  static base::NoDestructor<base::OneShotTimer> instance;
   return *instance;
 }
 
@@ -79,16 +90,28 @@ void LaunchStandaloneAutoUpdateCheck(bool first_time) {
   LaunchNotifierProcess(cmdline);
 }
 
+void ScheduleNextStandaloneAutoUpdateCheck();
+
+void RunPeriodicStandaloneAutoUpdateCheck() {
+  LaunchStandaloneAutoUpdateCheck(false);
+  ScheduleNextStandaloneAutoUpdateCheck();
+}
+
+void ScheduleNextStandaloneAutoUpdateCheck() {
+  base::TimeDelta delay =
+      kStandaloneCheckPeriod + base::RandDouble() * kStandaloneCheckJitter;
+  GetStandaloneAutoUpdateTimer().Start(
+      FROM_HERE, delay, base::BindOnce(&RunPeriodicStandaloneAutoUpdateCheck));
+}
+
 void DoStartStandaloneAutoUpdateCheck() {
-  base::RepeatingTimer& timer = GetStandaloneAutoUpdateTimer();
-  timer.Stop();
-  timer.Start(FROM_HERE, kStandaloneCheckPeriod,
-              base::BindRepeating(&LaunchStandaloneAutoUpdateCheck, false));
+  GetStandaloneAutoUpdateTimer().Stop();
+  ScheduleNextStandaloneAutoUpdateCheck();
   LaunchStandaloneAutoUpdateCheck(true);
 }
 
 void DoStopStandaloneUpdateCheck() {
-  base::RepeatingTimer& timer = GetStandaloneAutoUpdateTimer();
+  base::OneShotTimer& timer = GetStandaloneAutoUpdateTimer();
   timer.Stop();
 
   // Ask a running process if any to quit.
@@ -2,7 +2,6 @@
 
 #include "browser/menus/bookmark_sorter.h"
 
-#include "base/i18n/string_compare.h"
 #include "base/strings/utf_string_conversions.h"
 #include "components/bookmarks/browser/bookmark_model.h"
 
@@ -28,172 +27,112 @@ BookmarkSorter::BookmarkSorter(SortField sort_field,
 
 BookmarkSorter::~BookmarkSorter() {}
 
-void BookmarkSorter::sort(std::vector<bookmarks::BookmarkNode*>& vector) {
+std::string BookmarkSorter::GetCollationKey(const std::u16string& text) const {
+  if (text.empty())
+    return std::string();
+  if (!collator_) {
+    // Without the collator fall back to the code point order.
+    return base::UTF16ToUTF8(text);
+  }
+  icu::UnicodeString unicode_text(
+      false, reinterpret_cast<const UChar*>(text.data()),
+      static_cast<int32_t>(text.length()));
+  std::string key;
+  key.resize(text.length() * 4 + 16);
+  int32_t length = collator_->getSortKey(
+      unicode_text, reinterpret_cast<uint8_t*>(&key[0]),
+      static_cast<int32_t>(key.size()));
+  if (length > static_cast<int32_t>(key.size())) {
+    key.resize(length);
+    length = collator_->getSortKey(unicode_text,
+                                   reinterpret_cast<uint8_t*>(&key[0]),
+                                   static_cast<int32_t>(key.size()));
+  }
+  // The length includes the terminating zero that we do not need for the
+  // comparison.
+  key.resize(length > 0 ? length - 1 : 0);
+  return key;
+}
+
+void BookmarkSorter::InitEntryKeys(SortEntry& entry) const {
+  const bookmarks::BookmarkNode* node = entry.node;
   switch (sort_field_) {
     case FIELD_TITLE:
-      std::sort(
-          vector.begin(), vector.end(),
-          [this](bookmarks::BookmarkNode* b1, bookmarks::BookmarkNode* b2) {
-            if ((b1->type() == b2->type()) || !group_folders_) {
-              const icu::Collator* collator = collator_.get();
-
-              std::string n1 = vivaldi_bookmark_kit::GetNickname(b1);
-              std::string n2 = vivaldi_bookmark_kit::GetNickname(b2);
-              size_t l1 = n1.length();
-              size_t l2 = n2.length();
-              if (l1 == 0 || l2 == 0) {
-                return fallbackToTitleSort(collator, b1, b2, l1, l2);
-              }
-
-              if (sort_order_ == ORDER_ASCENDING) {
-                return base::i18n::CompareString16WithCollator(
-                           *collator, b1->GetTitle(), b2->GetTitle()) ==
-                       UCOL_LESS;
-              } else {
-                return base::i18n::CompareString16WithCollator(
-                           *collator, b2->GetTitle(), b1->GetTitle()) ==
-                       UCOL_LESS;
-              }
-            }
-            return b1->is_folder();
-          });
+      entry.key = GetCollationKey(node->GetTitle());
       break;
     case FIELD_URL:
-      std::sort(
-          vector.begin(), vector.end(),
-          [this](bookmarks::BookmarkNode* b1, bookmarks::BookmarkNode* b2) {
-            if ((b1->type() == b2->type()) || !group_folders_) {
-              int l1 = b1->url().spec().length();
-              int l2 = b2->url().spec().length();
-              if (l1 == 0 || l2 == 0) {
-                return fallbackToTitleSort(collator_.get(), b1, b2, l1, l2);
-              }
-
-              if (sort_order_ == ORDER_ASCENDING) {
-                return b1->url().spec() < b2->url().spec();
-              } else {
-                return b2->url().spec() < b1->url().spec();
-              }
-            }
-            return b1->is_folder();
-          });
+      entry.key = node->url().spec();
       break;
     case FIELD_NICKNAME:
-      std::sort(
-          vector.begin(), vector.end(),
-          [this](bookmarks::BookmarkNode* b1, bookmarks::BookmarkNode* b2) {
-            if ((b1->type() == b2->type()) || !group_folders_) {
-              const icu::Collator* collator = collator_.get();
-
-              std::string n1 = vivaldi_bookmark_kit::GetNickname(b1);
-              std::string n2 = vivaldi_bookmark_kit::GetNickname(b2);
-              size_t l1 = n1.length();
-              size_t l2 = n2.length();
-              if (l1 == 0 || l2 == 0) {
-                return fallbackToTitleSort(collator, b1, b2, l1, l2);
-              }
-
-              if (sort_order_ == ORDER_ASCENDING) {
-                return base::i18n::CompareString16WithCollator(
-                           *collator, base::UTF8ToUTF16(n1),
-                           base::UTF8ToUTF16(n2)) == UCOL_LESS;
-              } else {
-                return base::i18n::CompareString16WithCollator(
-                           *collator, base::UTF8ToUTF16(n2),
-                           base::UTF8ToUTF16(n1)) == UCOL_LESS;
-              }
-            }
-            return b1->is_folder();
-          });
+      entry.key = GetCollationKey(
+          base::UTF8ToUTF16(vivaldi_bookmark_kit::GetNickname(node)));
       break;
     case FIELD_DESCRIPTION:
-      std::sort(
-          vector.begin(), vector.end(),
-          [this](bookmarks::BookmarkNode* b1, bookmarks::BookmarkNode* b2) {
-            if ((b1->type() == b2->type()) || !group_folders_) {
-              const icu::Collator* collator = collator_.get();
-
-              std::string d1 = vivaldi_bookmark_kit::GetDescription(b1);
-              std::string d2 = vivaldi_bookmark_kit::GetDescription(b2);
-              size_t l1 = d1.length();
-              size_t l2 = d2.length();
-              if (l1 == 0 || l2 == 0) {
-                return fallbackToTitleSort(collator, b1, b2, l1, l2);
-              }
-
-              if (sort_order_ == ORDER_ASCENDING) {
-                return base::i18n::CompareString16WithCollator(
-                           *collator, base::UTF8ToUTF16(d1),
-                           base::UTF8ToUTF16(d2)) == UCOL_LESS;
-              } else {
-                return base::i18n::CompareString16WithCollator(
-                           *collator, base::UTF8ToUTF16(d2),
-                           base::UTF8ToUTF16(d1)) == UCOL_LESS;
-              }
-            }
-            return b1->is_folder();
-          });
+      entry.key = GetCollationKey(
+          base::UTF8ToUTF16(vivaldi_bookmark_kit::GetDescription(node)));
       break;
     case FIELD_DATEADDED:
-      std::sort(
-          vector.begin(), vector.end(),
-          [this](bookmarks::BookmarkNode* b1, bookmarks::BookmarkNode* b2) {
-            if ((b1->type() == b2->type()) || !group_folders_) {
-              if (sort_order_ == ORDER_ASCENDING) {
-                return b1->date_added() < b2->date_added();
-              } else {
-                return b2->date_added() < b1->date_added();
-              }
-            }
-            return b1->is_folder();
-          });
-      break;
-    // Keep compiler happy.
     case FIELD_NONE:
-      break;
+      return;
+  }
+  if (entry.key.empty() && sort_field_ != FIELD_TITLE) {
+    entry.title_key = GetCollationKey(node->GetTitle());
   }
 }
 
-bool BookmarkSorter::fallbackToTitleSort(const icu::Collator* collator,
-                                         bookmarks::BookmarkNode* b1,
-                                         bookmarks::BookmarkNode* b2,
-                                         size_t l1,
-                                         size_t l2) {
-  if (l1 == 0 && l2 == 0) {
-    l1 = b1->GetTitle().length();
-    l2 = b2->GetTitle().length();
-    if (l1 == 0 || l2 == 0) {
-      // Sort by date if there is missing title information
-      return fallbackToDateSort(b1, b2, l1, l2);
+bool BookmarkSorter::LessAscending(const SortEntry& e1,
+                                   const SortEntry& e2) const {
+  if (sort_field_ != FIELD_DATEADDED) {
+    // Nodes without a value for the sort field come after all other nodes and
+    // are sorted by title and then by date.
+    const std::string* k1 = &e1.key;
+    const std::string* k2 = &e2.key;
+    if (k1->empty() && k2->empty()) {
+      k1 = &e1.title_key;
+      k2 = &e2.title_key;
     }
-    if (sort_order_ == ORDER_ASCENDING) {
-      return base::i18n::CompareString16WithCollator(
-                 *collator, b1->GetTitle(), b2->GetTitle()) == UCOL_LESS;
-    } else {
-      return base::i18n::CompareString16WithCollator(
-                 *collator, b2->GetTitle(), b1->GetTitle()) == UCOL_LESS;
-    }
-  } else if (l1 == 0) {
-    return sort_order_ == ORDER_ASCENDING ? false : true;
-  } else {
-    return sort_order_ == ORDER_ASCENDING ? true : false;
+    if (!k1->empty() && !k2->empty())
+      return *k1 < *k2;
+    if (!k1->empty() || !k2->empty())
+      return k2->empty();
   }
+  return e1.node->date_added() < e2.node->date_added();
 }
 
-bool BookmarkSorter::fallbackToDateSort(bookmarks::BookmarkNode* b1,
-                                        bookmarks::BookmarkNode* b2,
-                                        size_t l1,
-                                        size_t l2) {
-  if (l1 == 0 && l2 == 0) {
-    if (sort_order_ == ORDER_ASCENDING) {
-      return b1->date_added() < b2->date_added();
-    } else {
-      return b2->date_added() < b1->date_added();
-    }
-  } else if (l1 == 0) {
-    return sort_order_ == ORDER_ASCENDING ? false : true;
-  } else {
-    return sort_order_ == ORDER_ASCENDING ? true : false;
+BookmarkSorter::SortEntry BookmarkSorter::MakeEntry(
+    bookmarks::BookmarkNode* node) const {
+  SortEntry entry;
+  entry.node = node;
+  entry.is_folder = node->is_folder();
+  entry.type = static_cast<int>(node->type());
+  InitEntryKeys(entry);
+  return entry;
+}
+
+bool BookmarkSorter::Less(const SortEntry& e1, const SortEntry& e2) const {
+  if (group_folders_ && e1.type != e2.type)
+    return e1.is_folder;
+  return sort_order_ == ORDER_ASCENDING ? LessAscending(e1, e2)
+                                        : LessAscending(e2, e1);
+}
+
+void BookmarkSorter::sort(std::vector<bookmarks::BookmarkNode*>& vector) {
+  if (sort_field_ == FIELD_NONE)
+    return;
+
+  std::vector<SortEntry> entries;
+  entries.reserve(vector.size());
+  for (bookmarks::BookmarkNode* node : vector) {
+    entries.push_back(MakeEntry(node));
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [this](const SortEntry& e1, const SortEntry& e2) {
+              return Less(e1, e2);
+            });
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    vector[i] = entries[i].node;
   }
 }
 
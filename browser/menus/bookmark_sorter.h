@@ -3,6 +3,8 @@
 #ifndef BROWSER_MENUS_BOOKMARK_SORTER_H_
 #define BROWSER_MENUS_BOOKMARK_SORTER_H_
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "third_party/icu/source/i18n/unicode/coll.h"
@@ -34,16 +36,40 @@ class BookmarkSorter {
   void setGroupFolders(bool group_folders) { group_folders_ = group_folders; }
   bool isManualOrder() const { return sort_field_ == FIELD_NONE; }
 
+  SortField sort_field() const { return sort_field_; }
+  SortOrder sort_order() const { return sort_order_; }
+  bool group_folders() const { return group_folders_; }
+
+  // Sort keys computed once per node before sorting.
+  struct SortEntry {
+    bookmarks::BookmarkNode* node;
+    bool is_folder;
+    // Type of the node as int to check for folder grouping.
+    int type;
+    // Key for the sort field. For text fields this is the collation key. It is
+    // empty when the node has no value for the field.
+    std::string key;
+    // Collation key of the title. Used only when key is empty.
+    std::string title_key;
+  };
+
+  // Compute the sort keys for the node.
+  SortEntry MakeEntry(bookmarks::BookmarkNode* node) const;
+
+  // Return true if e1 must come before e2 according to the sort field, order
+  // and folder grouping.
+  bool Less(const SortEntry& e1, const SortEntry& e2) const;
+
  private:
-  bool fallbackToTitleSort(const icu::Collator* collator,
-                           bookmarks::BookmarkNode* b1,
-                           bookmarks::BookmarkNode* b2,
-                           size_t l1,
-                           size_t l2);
-  bool fallbackToDateSort(bookmarks::BookmarkNode* b1,
-                          bookmarks::BookmarkNode* b2,
-                          size_t l1,
-                          size_t l2);
+  // Get the collation key for the text so byte-wise comparison of the keys
+  // gives the same order as the collator.
+  std::string GetCollationKey(const std::u16string& text) const;
+
+  void InitEntryKeys(SortEntry& entry) const;
+
+  // Return true if e1 must come before e2 in ascending order ignoring folder
+  // grouping.
+  bool LessAscending(const SortEntry& e1, const SortEntry& e2) const;
 
   SortField sort_field_;
   SortOrder sort_order_;
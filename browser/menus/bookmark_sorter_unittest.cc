@@ -0,0 +1,175 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "browser/menus/bookmark_sorter.h"
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "base/guid.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/timer/elapsed_timer.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+#include "components/bookmarks/vivaldi_bookmark_kit.h"
+
+namespace vivaldi {
+
+namespace {
+
+using bookmarks::BookmarkNode;
+
+constexpr char kMetricPrefix[] = "VivaldiBookmarkSorter.";
+
+// Metric names by sort field, FIELD_NONE is not timed.
+constexpr const char* kMetricSortMs[] = {
+    nullptr, "sort_by_title", "sort_by_url", "sort_by_nickname",
+    "sort_by_description", "sort_by_date_added"};
+static_assert(std::size(kMetricSortMs) == BookmarkSorter::FIELD_DATEADDED + 1,
+              "a metric name is needed for each sort field");
+
+class BookmarkSorterTest : public testing::Test {
+ protected:
+  BookmarkNode* AddUrl(const std::string& title,
+                       const std::string& url,
+                       int days_ago = 0) {
+    auto node = std::make_unique<BookmarkNode>(
+        next_id_++, base::GUID::GenerateRandomV4(), GURL(url));
+    node->SetTitle(base::UTF8ToUTF16(title));
+    node->set_date_added(base::Time::Now() - base::Days(days_ago));
+    nodes_.push_back(std::move(node));
+    return nodes_.back().get();
+  }
+
+  BookmarkNode* AddFolder(const std::string& title) {
+    auto node = std::make_unique<BookmarkNode>(
+        next_id_++, base::GUID::GenerateRandomV4(), GURL());
+    node->SetTitle(base::UTF8ToUTF16(title));
+    nodes_.push_back(std::move(node));
+    return nodes_.back().get();
+  }
+
+  std::vector<BookmarkNode*> GetNodes() {
+    std::vector<BookmarkNode*> nodes;
+    for (const auto& node : nodes_) {
+      nodes.push_back(node.get());
+    }
+    return nodes;
+  }
+
+  static std::vector<std::string> Titles(
+      const std::vector<BookmarkNode*>& nodes) {
+    std::vector<std::string> titles;
+    for (const BookmarkNode* node : nodes) {
+      titles.push_back(base::UTF16ToUTF8(node->GetTitle()));
+    }
+    return titles;
+  }
+
+ private:
+  int64_t next_id_ = 1;
+  std::vector<std::unique_ptr<BookmarkNode>> nodes_;
+};
+
+}  // namespace
+
+TEST_F(BookmarkSorterTest, TitleOrder) {
+  AddUrl("b", "http://b.com/");
+  AddUrl("", "http://empty.com/");
+  AddUrl("A", "http://a.com/");
+  AddUrl("c", "http://c.com/");
+
+  std::vector<BookmarkNode*> nodes = GetNodes();
+  BookmarkSorter(BookmarkSorter::FIELD_TITLE, BookmarkSorter::ORDER_ASCENDING,
+                 false)
+      .sort(nodes);
+  EXPECT_EQ(Titles(nodes), std::vector<std::string>({"A", "b", "c", ""}));
+
+  BookmarkSorter(BookmarkSorter::FIELD_TITLE, BookmarkSorter::ORDER_DESCENDING,
+                 false)
+      .sort(nodes);
+  EXPECT_EQ(Titles(nodes), std::vector<std::string>({"", "c", "b", "A"}));
+}
+
+TEST_F(BookmarkSorterTest, GroupFolders) {
+  AddUrl("a", "http://a.com/");
+  AddFolder("z");
+  AddUrl("b", "http://b.com/");
+  AddFolder("y");
+
+  std::vector<BookmarkNode*> nodes = GetNodes();
+  BookmarkSorter(BookmarkSorter::FIELD_TITLE, BookmarkSorter::ORDER_DESCENDING,
+                 true)
+      .sort(nodes);
+  EXPECT_EQ(Titles(nodes), std::vector<std::string>({"z", "y", "b", "a"}));
+}
+
+TEST_F(BookmarkSorterTest, UrlAndDateOrder) {
+  AddUrl("second", "http://b.com/", 1);
+  AddUrl("third", "http://c.com/", 0);
+  AddUrl("first", "http://a.com/", 2);
+
+  std::vector<BookmarkNode*> nodes = GetNodes();
+  BookmarkSorter(BookmarkSorter::FIELD_URL, BookmarkSorter::ORDER_ASCENDING,
+                 false)
+      .sort(nodes);
+  EXPECT_EQ(Titles(nodes),
+            std::vector<std::string>({"first", "second", "third"}));
+
+  BookmarkSorter(BookmarkSorter::FIELD_DATEADDED,
+                 BookmarkSorter::ORDER_DESCENDING, false)
+      .sort(nodes);
+  EXPECT_EQ(Titles(nodes),
+            std::vector<std::string>({"third", "second", "first"}));
+}
+
+TEST_F(BookmarkSorterTest, NicknameFallsBackToTitle) {
+  BookmarkNode* node = AddUrl("x", "http://x.com/");
+  node->SetMetaInfo("Nickname", "b");
+  node = AddUrl("y", "http://y.com/");
+  node->SetMetaInfo("Nickname", "a");
+  AddUrl("d", "http://d.com/");
+  AddUrl("c", "http://c.com/");
+
+  std::vector<BookmarkNode*> nodes = GetNodes();
+  BookmarkSorter(BookmarkSorter::FIELD_NICKNAME,
+                 BookmarkSorter::ORDER_ASCENDING, false)
+      .sort(nodes);
+  EXPECT_EQ(Titles(nodes), std::vector<std::string>({"y", "x", "c", "d"}));
+}
+
+// Microbenchmark for sorting of a big folder. The timings are reported in the
+// perf test result format. It is disabled to keep the unit test run fast, run
+// it with --gtest_also_run_disabled_tests
+// --gtest_filter=BookmarkSorterTest.DISABLED_LargeFolderPerf to see them.
+TEST_F(BookmarkSorterTest, DISABLED_LargeFolderPerf) {
+  constexpr int kNodeCount = 20000;
+  for (int i = 0; i < kNodeCount; ++i) {
+    // Use a scrambled order so the input is not sorted.
+    std::string n = base::NumberToString((i * 7919) % kNodeCount);
+    AddUrl("Bookmark " + n, "http://example.com/" + n, i % 365);
+  }
+
+  const BookmarkSorter::SortField kFields[] = {
+      BookmarkSorter::FIELD_TITLE, BookmarkSorter::FIELD_URL,
+      BookmarkSorter::FIELD_NICKNAME, BookmarkSorter::FIELD_DESCRIPTION,
+      BookmarkSorter::FIELD_DATEADDED};
+  perf_test::PerfResultReporter reporter(kMetricPrefix, "large_folder");
+  for (BookmarkSorter::SortField field : kFields) {
+    reporter.RegisterImportantMetric(kMetricSortMs[field], "ms");
+  }
+  for (BookmarkSorter::SortField field : kFields) {
+    std::vector<BookmarkNode*> nodes = GetNodes();
+    BookmarkSorter sorter(field, BookmarkSorter::ORDER_ASCENDING, true);
+    base::ElapsedTimer timer;
+    sorter.sort(nodes);
+    reporter.AddResult(kMetricSortMs[field], timer.Elapsed().InMillisecondsF());
+    EXPECT_EQ(nodes.size(), static_cast<size_t>(kNodeCount));
+  }
+}
+
+}  // namespace vivaldi
@@ -2,7 +2,7 @@
 
 #include "browser/menus/bookmark_support.h"
 
-#include "base/base64.h"
+#include "browser/menus/menu_icon_cache.h"
 #include "components/bookmarks/browser/bookmark_model.h"
 #include "ui/gfx/image/image.h"
 
@@ -17,12 +17,7 @@ BookmarkSupport::~BookmarkSupport() {}
 void BookmarkSupport::initIcons(const std::vector<std::string>& src_icons) {
   if (src_icons.size() == kMax) {
     for (int i = 0; i < kMax; i++) {
-      std::string png_data;
-      if (base::Base64Decode(src_icons.at(i), &png_data)) {
-        icons[i] = gfx::Image::CreateFrom1xPNGBytes(
-            reinterpret_cast<const unsigned char*>(png_data.c_str()),
-            png_data.length());
-      }
+      icons[i] = menu_icon_cache::GetIcon(src_icons.at(i));
     }
   }
 }
@@ -0,0 +1,122 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved.
+
+#include "browser/menus/menu_icon_cache.h"
+
+#include "base/base64.h"
+#include "base/bind.h"
+#include "base/containers/lru_cache.h"
+#include "base/no_destructor.h"
+#include "base/task/thread_pool.h"
+#include "content/public/browser/browser_thread.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/favicon_size.h"
+#include "ui/gfx/image/image.h"
+
+namespace vivaldi {
+namespace menu_icon_cache {
+
+namespace {
+
+// Menus use a few dozens of distinct icons. The bound only protects against
+// icons that change all the time like generated ones.
+constexpr size_t kMaxCachedIcons = 128;
+
+using IconCache = base::HashingLRUCache<std::string, gfx::Image>;
+
+IconCache& GetDecodedIcons() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  static base::NoDestructor<IconCache> cache(kMaxCachedIcons);
+  return *cache;
+}
+
+IconCache& GetFaviconSizedIcons() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  static base::NoDestructor<IconCache> cache(kMaxCachedIcons);
+  return *cache;
+}
+
+// Return an empty bitmap on errors. This is called on worker threads.
+SkBitmap DecodeIcon(const std::string& base64_png, bool favicon_sized) {
+  SkBitmap bitmap;
+  std::string png_data;
+  if (!base::Base64Decode(base64_png, &png_data))
+    return bitmap;
+  if (!gfx::PNGCodec::Decode(
+          reinterpret_cast<const unsigned char*>(png_data.data()),
+          png_data.size(), &bitmap)) {
+    return SkBitmap();
+  }
+  if (favicon_sized && (bitmap.width() > gfx::kFaviconSize ||
+                        bitmap.height() > gfx::kFaviconSize)) {
+    int width = bitmap.width();
+    int height = bitmap.height();
+    gfx::CalculateFaviconTargetSize(&width, &height);
+    bitmap = skia::ImageOperations::Resize(
+        bitmap, skia::ImageOperations::RESIZE_GOOD, width, height);
+  }
+  bitmap.setImmutable();
+  return bitmap;
+}
+
+gfx::Image ImageFromBitmap(const SkBitmap& bitmap) {
+  if (bitmap.drawsNothing())
+    return gfx::Image();
+  return gfx::Image::CreateFrom1xBitmap(bitmap);
+}
+
+void OnFaviconSizedIconDecoded(
+    std::string base64_png,
+    base::OnceCallback<void(const gfx::Image&)> callback,
+    SkBitmap bitmap) {
+  IconCache& cache = GetFaviconSizedIcons();
+  // Another menu may have loaded the same icon in the meantime.
+  auto i = cache.Get(base64_png);
+  if (i == cache.end()) {
+    i = cache.Put(std::move(base64_png), ImageFromBitmap(bitmap));
+  }
+  gfx::Image image = i->second;
+  std::move(callback).Run(image);
+}
+
+}  // namespace
+
+gfx::Image GetIcon(const std::string& base64_png) {
+  IconCache& cache = GetDecodedIcons();
+  auto i = cache.Get(base64_png);
+  if (i == cache.end()) {
+    i = cache.Put(base64_png,
+                  ImageFromBitmap(DecodeIcon(base64_png, false)));
+  }
+  return i->second;
+}
+
+bool FindFaviconSizedIcon(const std::string& base64_png, gfx::Image* image) {
+  IconCache& cache = GetFaviconSizedIcons();
+  auto i = cache.Get(base64_png);
+  if (i == cache.end())
+    return false;
+  *image = i->second;
+  return true;
+}
+
+void LoadFaviconSizedIcon(
+    const std::string& base64_png,
+    base::OnceCallback<void(const gfx::Image&)> callback) {
+  gfx::Image image;
+  if (FindFaviconSizedIcon(base64_png, &image)) {
+    std::move(callback).Run(image);
+    return;
+  }
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::TaskPriority::USER_BLOCKING,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(&DecodeIcon, base64_png, true),
+      base::BindOnce(&OnFaviconSizedIconDecoded, base64_png,
+                     std::move(callback)));
+}
+
+}  // namespace menu_icon_cache
+}  // namespace vivaldi
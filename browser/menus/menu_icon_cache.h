@@ -0,0 +1,40 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved.
+
+#ifndef BROWSER_MENUS_MENU_ICON_CACHE_H_
+#define BROWSER_MENUS_MENU_ICON_CACHE_H_
+
+#include <string>
+
+#include "base/callback.h"
+
+namespace gfx {
+class Image;
+}
+
+namespace vivaldi {
+
+// Decoded menu icons keyed by their base64 encoded PNG data. The menus get
+// their icons from JS as base64 PNG strings and the same strings come with
+// every menu that is opened, so each distinct icon is decoded only once per
+// process. All functions must be called on the UI thread.
+namespace menu_icon_cache {
+
+// Return the decoded icon or an empty image if |base64_png| is not a valid
+// PNG. Decodes on the calling thread when the icon was not decoded before.
+gfx::Image GetIcon(const std::string& base64_png);
+
+// Icons scaled down to the favicon size when they are larger.
+//
+// Find returns false if the icon has not been decoded yet. Load decodes it on
+// a worker thread and runs the callback on the UI thread with the icon or an
+// empty image on errors. When the icon is already cached the callback runs
+// synchronously.
+bool FindFaviconSizedIcon(const std::string& base64_png, gfx::Image* image);
+void LoadFaviconSizedIcon(const std::string& base64_png,
+                          base::OnceCallback<void(const gfx::Image&)> callback);
+
+}  // namespace menu_icon_cache
+
+}  // namespace vivaldi
+
+#endif  // BROWSER_MENUS_MENU_ICON_CACHE_H_
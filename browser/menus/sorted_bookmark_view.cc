@@ -0,0 +1,292 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved.
+
+#include "browser/menus/sorted_bookmark_view.h"
+
+#include "base/containers/contains.h"
+#include "base/memory/ptr_util.h"
+#include "base/no_destructor.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "content/public/browser/browser_thread.h"
+
+namespace vivaldi {
+
+namespace {
+
+// Maximum number of cached orderings. Menus and panels typically show only a
+// few folders at a time.
+constexpr size_t kMaxOrders = 32;
+
+std::map<bookmarks::BookmarkModel*, std::unique_ptr<SortedBookmarkView>>&
+GetViews() {
+  static base::NoDestructor<
+      std::map<bookmarks::BookmarkModel*, std::unique_ptr<SortedBookmarkView>>>
+      views;
+  return *views;
+}
+
+}  // namespace
+
+class SortedBookmarkView::FolderOrder {
+ public:
+  FolderOrder(const bookmarks::BookmarkNode* folder,
+              BookmarkSorter::SortField sort_field,
+              BookmarkSorter::SortOrder sort_order,
+              bool group_folders)
+      : sorter_(sort_field, sort_order, group_folders),
+        entries_(EntryLess(&sorter_)) {
+    for (const auto& child : folder->children()) {
+      Add(child.get());
+    }
+  }
+  FolderOrder(const FolderOrder&) = delete;
+  FolderOrder& operator=(const FolderOrder&) = delete;
+
+  void Add(const bookmarks::BookmarkNode* node) {
+    DCHECK(!base::Contains(positions_, node));
+    auto result = entries_.insert(
+        sorter_.MakeEntry(const_cast<bookmarks::BookmarkNode*>(node)));
+    positions_.emplace(node, result.first);
+  }
+
+  void Remove(const bookmarks::BookmarkNode* node) {
+    auto i = positions_.find(node);
+    if (i == positions_.end())
+      return;
+    entries_.erase(i->second);
+    positions_.erase(i);
+  }
+
+  std::vector<bookmarks::BookmarkNode*> GetNodes() const {
+    std::vector<bookmarks::BookmarkNode*> nodes;
+    nodes.reserve(entries_.size());
+    for (const BookmarkSorter::SortEntry& entry : entries_) {
+      nodes.push_back(entry.node);
+    }
+    return nodes;
+  }
+
+  uint64_t last_use = 0;
+
+ private:
+  // Sort order for the set. Equal entries are ordered by the node id so the
+  // set can hold them all.
+  struct EntryLess {
+    explicit EntryLess(const BookmarkSorter* sorter) : sorter(sorter) {}
+    bool operator()(const BookmarkSorter::SortEntry& e1,
+                    const BookmarkSorter::SortEntry& e2) const {
+      if (sorter->Less(e1, e2))
+        return true;
+      if (sorter->Less(e2, e1))
+        return false;
+      return e1.node->id() < e2.node->id();
+    }
+    const BookmarkSorter* sorter;
+  };
+
+  using EntrySet = std::set<BookmarkSorter::SortEntry, EntryLess>;
+
+  BookmarkSorter sorter_;
+  EntrySet entries_;
+  std::map<const bookmarks::BookmarkNode*, EntrySet::iterator> positions_;
+};
+
+// static
+SortedBookmarkView* SortedBookmarkView::GetForModel(
+    bookmarks::BookmarkModel* model) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto& views = GetViews();
+  auto i = views.find(model);
+  if (i == views.end()) {
+    i = views.emplace(model, base::WrapUnique(new SortedBookmarkView(model)))
+            .first;
+  }
+  return i->second.get();
+}
+
+SortedBookmarkView::SortedBookmarkView(bookmarks::BookmarkModel* model)
+    : model_(model) {
+  model_->AddObserver(this);
+}
+
+SortedBookmarkView::~SortedBookmarkView() {
+  if (model_) {
+    model_->RemoveObserver(this);
+  }
+}
+
+std::vector<bookmarks::BookmarkNode*> SortedBookmarkView::GetSortedChildren(
+    const bookmarks::BookmarkNode* folder,
+    BookmarkSorter::SortField sort_field,
+    BookmarkSorter::SortOrder sort_order,
+    bool group_folders) {
+  if (sort_field == BookmarkSorter::FIELD_NONE ||
+      sort_order == BookmarkSorter::ORDER_NONE || extensive_changes_) {
+    std::vector<bookmarks::BookmarkNode*> nodes;
+    nodes.reserve(folder->children().size());
+    for (const auto& child : folder->children()) {
+      nodes.push_back(const_cast<bookmarks::BookmarkNode*>(child.get()));
+    }
+    BookmarkSorter(sort_field, sort_order, group_folders).sort(nodes);
+    return nodes;
+  }
+
+  OrderKey key(folder->id(), sort_field, sort_order, group_folders);
+  auto i = orders_.find(key);
+  if (i == orders_.end()) {
+    if (orders_.size() >= kMaxOrders) {
+      auto oldest = orders_.begin();
+      for (auto j = orders_.begin(); j != orders_.end(); ++j) {
+        if (j->second->last_use < oldest->second->last_use) {
+          oldest = j;
+        }
+      }
+      orders_.erase(oldest);
+    }
+    i = orders_
+            .emplace(key, std::make_unique<FolderOrder>(
+                              folder, sort_field, sort_order, group_folders))
+            .first;
+  }
+  i->second->last_use = ++use_counter_;
+  return i->second->GetNodes();
+}
+
+std::vector<SortedBookmarkView::FolderOrder*>
+SortedBookmarkView::GetOrdersForFolder(const bookmarks::BookmarkNode* folder) {
+  std::vector<FolderOrder*> orders;
+  if (!folder)
+    return orders;
+  // All keys for the folder are adjacent in the map as the id is the first
+  // element of the key.
+  OrderKey first(folder->id(), BookmarkSorter::FIELD_NONE,
+                 BookmarkSorter::ORDER_NONE, false);
+  for (auto i = orders_.lower_bound(first);
+       i != orders_.end() && std::get<0>(i->first) == folder->id(); ++i) {
+    orders.push_back(i->second.get());
+  }
+  return orders;
+}
+
+void SortedBookmarkView::AddChild(const bookmarks::BookmarkNode* parent,
+                                  const bookmarks::BookmarkNode* node) {
+  for (FolderOrder* order : GetOrdersForFolder(parent)) {
+    order->Add(node);
+  }
+}
+
+void SortedBookmarkView::RemoveChild(const bookmarks::BookmarkNode* parent,
+                                     const bookmarks::BookmarkNode* node) {
+  for (FolderOrder* order : GetOrdersForFolder(parent)) {
+    order->Remove(node);
+  }
+}
+
+void SortedBookmarkView::RemoveOrdersForFolder(
+    const bookmarks::BookmarkNode* folder) {
+  OrderKey first(folder->id(), BookmarkSorter::FIELD_NONE,
+                 BookmarkSorter::ORDER_NONE, false);
+  auto i = orders_.lower_bound(first);
+  while (i != orders_.end() && std::get<0>(i->first) == folder->id()) {
+    i = orders_.erase(i);
+  }
+}
+
+void SortedBookmarkView::BookmarkModelChanged() {
+  // Called for changes that are not tracked individually like removal of all
+  // nodes.
+  orders_.clear();
+}
+
+void SortedBookmarkView::BookmarkModelBeingDeleted(
+    bookmarks::BookmarkModel* model) {
+  DCHECK_EQ(model, model_);
+  model_->RemoveObserver(this);
+  model_ = nullptr;
+  orders_.clear();
+
+  // This deletes this.
+  GetViews().erase(model);
+}
+
+void SortedBookmarkView::BookmarkNodeMoved(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* old_parent,
+    size_t old_index,
+    const bookmarks::BookmarkNode* new_parent,
+    size_t new_index) {
+  if (extensive_changes_ || old_parent == new_parent)
+    return;
+  const bookmarks::BookmarkNode* node = new_parent->children()[new_index].get();
+  RemoveChild(old_parent, node);
+  AddChild(new_parent, node);
+}
+
+void SortedBookmarkView::BookmarkNodeAdded(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* parent,
+    size_t index) {
+  if (extensive_changes_)
+    return;
+  AddChild(parent, parent->children()[index].get());
+}
+
+void SortedBookmarkView::BookmarkNodeRemoved(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* parent,
+    size_t old_index,
+    const bookmarks::BookmarkNode* node,
+    const std::set<GURL>& removed_urls) {
+  if (extensive_changes_)
+    return;
+  RemoveChild(parent, node);
+  if (node->is_folder()) {
+    // Drop orderings for the removed folder and its subfolders.
+    std::vector<const bookmarks::BookmarkNode*> folders = {node};
+    while (!folders.empty()) {
+      const bookmarks::BookmarkNode* folder = folders.back();
+      folders.pop_back();
+      RemoveOrdersForFolder(folder);
+      for (const auto& child : folder->children()) {
+        if (child->is_folder()) {
+          folders.push_back(child.get());
+        }
+      }
+    }
+  }
+}
+
+void SortedBookmarkView::BookmarkNodeChanged(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  if (extensive_changes_ || !node->parent())
+    return;
+  // The sort keys may have changed so re-insert the node.
+  RemoveChild(node->parent(), node);
+  AddChild(node->parent(), node);
+}
+
+void SortedBookmarkView::BookmarkMetaInfoChanged(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  // Nickname and description are stored in the meta info.
+  BookmarkNodeChanged(model, node);
+}
+
+void SortedBookmarkView::BookmarkNodeChildrenReordered(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  // The manual order is not cached so there is nothing to update.
+}
+
+void SortedBookmarkView::ExtensiveBookmarkChangesBeginning(
+    bookmarks::BookmarkModel* model) {
+  extensive_changes_ = true;
+}
+
+void SortedBookmarkView::ExtensiveBookmarkChangesEnded(
+    bookmarks::BookmarkModel* model) {
+  extensive_changes_ = false;
+  orders_.clear();
+}
+
+}  // namespace vivaldi
@@ -0,0 +1,106 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved.
+
+#ifndef BROWSER_MENUS_SORTED_BOOKMARK_VIEW_H_
+#define BROWSER_MENUS_SORTED_BOOKMARK_VIEW_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "components/bookmarks/browser/base_bookmark_model_observer.h"
+
+#include "browser/menus/bookmark_sorter.h"
+
+namespace bookmarks {
+class BookmarkModel;
+class BookmarkNode;
+}  // namespace bookmarks
+
+namespace vivaldi {
+
+// Keeps sorted orderings of bookmark folder children up to date as the model
+// changes so menus and panels do not need to sort a folder each time they are
+// shown. An ordering for a (folder, field, order, folder grouping) combination
+// is built on the first request and then updated in O(log n) per change.
+class SortedBookmarkView : public bookmarks::BaseBookmarkModelObserver {
+ public:
+  // Get the view for the model creating it on the first call. The view is
+  // deleted together with the model. This must be called on UI thread.
+  static SortedBookmarkView* GetForModel(bookmarks::BookmarkModel* model);
+
+  ~SortedBookmarkView() override;
+  SortedBookmarkView(const SortedBookmarkView&) = delete;
+  SortedBookmarkView& operator=(const SortedBookmarkView&) = delete;
+
+  // Get the sorted children of the folder. With FIELD_NONE this returns the
+  // children in the model order.
+  std::vector<bookmarks::BookmarkNode*> GetSortedChildren(
+      const bookmarks::BookmarkNode* folder,
+      BookmarkSorter::SortField sort_field,
+      BookmarkSorter::SortOrder sort_order,
+      bool group_folders);
+
+  // bookmarks::BaseBookmarkModelObserver
+  void BookmarkModelChanged() override;
+  void BookmarkModelBeingDeleted(bookmarks::BookmarkModel* model) override;
+  void BookmarkNodeMoved(bookmarks::BookmarkModel* model,
+                         const bookmarks::BookmarkNode* old_parent,
+                         size_t old_index,
+                         const bookmarks::BookmarkNode* new_parent,
+                         size_t new_index) override;
+  void BookmarkNodeAdded(bookmarks::BookmarkModel* model,
+                         const bookmarks::BookmarkNode* parent,
+                         size_t index) override;
+  void BookmarkNodeRemoved(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* parent,
+                           size_t old_index,
+                           const bookmarks::BookmarkNode* node,
+                           const std::set<GURL>& removed_urls) override;
+  void BookmarkNodeChanged(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* node) override;
+  void BookmarkMetaInfoChanged(bookmarks::BookmarkModel* model,
+                               const bookmarks::BookmarkNode* node) override;
+  void BookmarkNodeChildrenReordered(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override;
+  void ExtensiveBookmarkChangesBeginning(
+      bookmarks::BookmarkModel* model) override;
+  void ExtensiveBookmarkChangesEnded(bookmarks::BookmarkModel* model) override;
+
+ private:
+  // Ordering of children of one folder.
+  class FolderOrder;
+
+  using OrderKey = std::tuple<int64_t,
+                              BookmarkSorter::SortField,
+                              BookmarkSorter::SortOrder,
+                              bool>;
+
+  explicit SortedBookmarkView(bookmarks::BookmarkModel* model);
+
+  void AddChild(const bookmarks::BookmarkNode* parent,
+                const bookmarks::BookmarkNode* node);
+  void RemoveChild(const bookmarks::BookmarkNode* parent,
+                   const bookmarks::BookmarkNode* node);
+  void RemoveOrdersForFolder(const bookmarks::BookmarkNode* folder);
+
+  // Get orderings for the folder children.
+  std::vector<FolderOrder*> GetOrdersForFolder(
+      const bookmarks::BookmarkNode* folder);
+
+  bookmarks::BookmarkModel* model_;
+  std::map<OrderKey, std::unique_ptr<FolderOrder>> orders_;
+
+  // Counter to find the least recently used ordering.
+  uint64_t use_counter_ = 0;
+
+  // While true the orderings are not updated and are dropped at the end of
+  // the changes.
+  bool extensive_changes_ = false;
+};
+
+}  // namespace vivaldi
+
+#endif  // BROWSER_MENUS_SORTED_BOOKMARK_VIEW_H_
@@ -0,0 +1,80 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "browser/menus/sorted_bookmark_view.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/memory/raw_ptr.h"
+#include "base/strings/utf_string_conversions.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "components/bookmarks/test/test_bookmark_client.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace vivaldi {
+
+namespace {
+
+using bookmarks::BookmarkModel;
+using bookmarks::BookmarkNode;
+
+class SortedBookmarkViewTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = bookmarks::TestBookmarkClient::CreateModel();
+    folder_ = model_->AddFolder(model_->bookmark_bar_node(), 0, u"folder");
+    view_ = SortedBookmarkView::GetForModel(model_.get());
+  }
+
+  const BookmarkNode* AddUrl(const std::string& title, size_t index) {
+    return model_->AddURL(folder_, index, base::UTF8ToUTF16(title),
+                          GURL("http://" + title + ".com/"));
+  }
+
+  std::vector<std::string> SortedTitles() {
+    std::vector<std::string> titles;
+    for (const BookmarkNode* node : view_->GetSortedChildren(
+             folder_, BookmarkSorter::FIELD_TITLE,
+             BookmarkSorter::ORDER_ASCENDING, false)) {
+      titles.push_back(base::UTF16ToUTF8(node->GetTitle()));
+    }
+    return titles;
+  }
+
+  content::BrowserTaskEnvironment task_environment_;
+  std::unique_ptr<BookmarkModel> model_;
+  raw_ptr<const BookmarkNode> folder_ = nullptr;
+  raw_ptr<SortedBookmarkView> view_ = nullptr;
+};
+
+}  // namespace
+
+TEST_F(SortedBookmarkViewTest, AddToSortedFolder) {
+  AddUrl("c", 0);
+  AddUrl("a", 1);
+  EXPECT_EQ(SortedTitles(), std::vector<std::string>({"a", "c"}));
+
+  // The ordering is cached now, the added node must be inserted into it.
+  AddUrl("b", 0);
+  AddUrl("d", 1);
+  EXPECT_EQ(SortedTitles(), std::vector<std::string>({"a", "b", "c", "d"}));
+}
+
+TEST_F(SortedBookmarkViewTest, RemoveAndChangeInSortedFolder) {
+  AddUrl("c", 0);
+  const BookmarkNode* a = AddUrl("a", 1);
+  AddUrl("b", 2);
+  EXPECT_EQ(SortedTitles(), std::vector<std::string>({"a", "b", "c"}));
+
+  model_->SetTitle(a, u"d");
+  EXPECT_EQ(SortedTitles(), std::vector<std::string>({"b", "c", "d"}));
+
+  model_->Remove(folder_->children()[0].get());
+  EXPECT_EQ(SortedTitles(), std::vector<std::string>({"b", "d"}));
+}
+
+}  // namespace vivaldi
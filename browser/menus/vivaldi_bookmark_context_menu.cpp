@@ -3,6 +3,7 @@
 #include "browser/menus/vivaldi_bookmark_context_menu.h"
 
 #include "app/vivaldi_resources.h"
+#include "browser/menus/sorted_bookmark_view.h"
 #include "browser/menus/vivaldi_menu_enums.h"
 #include "chrome/app/chrome_command_ids.h"
 #include "chrome/browser/profiles/profile.h"
@@ -123,10 +124,11 @@ void ExecuteBookmarkMenuCommand(Browser* browser,
                                 int menu_id,
                                 int64_t bookmark_id,
                                 int mouse_event_flags) {
-  if (IsVivaldiMenuItem(menu_id)) {
+  auto i = MenuIdToBookmarkMap.find(menu_id);
+  if (i != MenuIdToBookmarkMap.end()) {
     // Currently, and probably forever, we only have one specific menu item so
     // no more tests.
-    Container->delegate->OnBookmarkAction(MenuIdToBookmarkMap[menu_id]->id(),
+    Container->delegate->OnBookmarkAction(i->second->id(),
                                           IDC_VIV_BOOKMARK_BAR_ADD_ACTIVE_TAB);
   } else if (bookmark_id != -1) {
     Container->delegate->OnOpenBookmark(bookmark_id, mouse_event_flags);
@@ -198,19 +200,15 @@ void SetBookmarkContainer(const BookmarkMenuContainer* container,
   MenuIdToBookmarkMap.clear();
 }
 
-void SortBookmarkNodes(const bookmarks::BookmarkNode* parent,
+void SortBookmarkNodes(bookmarks::BookmarkModel* model,
+                       const bookmarks::BookmarkNode* parent,
                        std::vector<bookmarks::BookmarkNode*>& nodes) {
-  nodes.reserve(parent->children().size());
-  for (auto& it : parent->children()) {
-    nodes.push_back(const_cast<bookmarks::BookmarkNode*>(it.get()));
-  }
   bool folder_group =
       (CurrentIndex >= 0 && CurrentIndex < Container->siblings.size())
           ? Container->siblings[CurrentIndex].folder_group
           : false;
-  BookmarkSorter sorter(Container->sort_field, Container->sort_order,
-                        folder_group);
-  sorter.sort(nodes);
+  nodes = SortedBookmarkView::GetForModel(model)->GetSortedChildren(
+      parent, Container->sort_field, Container->sort_order, folder_group);
 }
 
 void AddExtraBookmarkMenuItems(Profile* profile,
@@ -252,7 +250,9 @@ void AddExtraBookmarkMenuItems(Profile* profile,
 }
 
 bool IsVivaldiMenuItem(int id) {
-  return MenuIdToBookmarkMap[id] != nullptr;
+  // Do not use operator[] as this is called for every bookmark item and would
+  // insert an entry for each of them.
+  return MenuIdToBookmarkMap.find(id) != MenuIdToBookmarkMap.end();
 }
 
 bool AddIfSeparator(const bookmarks::BookmarkNode* node,
@@ -54,7 +54,8 @@ const bookmarks::BookmarkNode* GetNextNode(bookmarks::BookmarkModel* model,
                                            bool next,
                                            int* start_index,
                                            gfx::Rect* rect);
-void SortBookmarkNodes(const bookmarks::BookmarkNode* parent,
+void SortBookmarkNodes(bookmarks::BookmarkModel* model,
+                       const bookmarks::BookmarkNode* parent,
                        std::vector<bookmarks::BookmarkNode*>& nodes);
 void AddExtraBookmarkMenuItems(Profile* profile,
                                views::MenuItemView* menu,
@@ -2,8 +2,10 @@
 // Copyright (c) 2019 Vivaldi Technologies AS. All rights reserved.
 //
 #include "browser/menus/vivaldi_context_menu_controller.h"
-#include "base/base64.h"
+#include "base/bind.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
+#include "browser/menus/menu_icon_cache.h"
 #include "browser/menus/vivaldi_menu_enums.h"
 #include "browser/menus/vivaldi_render_view_context_menu.h"
 #include "browser/vivaldi_browser_finder.h"
@@ -16,16 +18,11 @@
 #include "content/public/browser/web_contents.h"
 #include "extensions/api/menubar_menu/menubar_menu_api.h"
 #include "extensions/tools/vivaldi_tools.h"
-#include "include/core/SkBitmap.h"
-#include "skia/ext/image_operations.h"
-#include "ui/gfx/favicon_size.h"
 #include "ui/vivaldi_context_menu.h"
 #include "vivaldi/prefs/vivaldi_gen_prefs.h"
 
 namespace vivaldi {
 
-#define ICON_SIZE 16
-
 ContextMenuController::ContextMenuController(
     content::WebContents* window_web_contents,
     VivaldiRenderViewContextMenu* rv_context_menu,
@@ -78,6 +75,7 @@ Profile* ContextMenuController::GetProfile() {
 }
 
 bool ContextMenuController::Show() {
+  TRACE_EVENT0("vivaldi", "ContextMenuController::Show");
   using Origin = extensions::vivaldi::context_menu::Origin;
 
   // Mac needs the views version for certain origins as we can not position the
@@ -116,6 +114,7 @@ bool ContextMenuController::Show() {
 }
 
 void ContextMenuController::InitModel() {
+  TRACE_EVENT0("vivaldi", "ContextMenuController::InitModel");
   namespace context_menu = extensions::vivaldi::context_menu;
 
   if (rv_context_menu_) {
@@ -340,26 +339,31 @@ void ContextMenuController::SetIcon(int command_id,
                                     const std::string& icon,
                                     ui::SimpleMenuModel* menu_model) {
   if (icon.length() > 0) {
-    std::string png_data;
-    if (base::Base64Decode(icon, &png_data)) {
-      gfx::Image img = gfx::Image::CreateFrom1xPNGBytes(
-          reinterpret_cast<const unsigned char*>(png_data.c_str()),
-          png_data.length());
-      if (img.Width() > ICON_SIZE || img.Height() > ICON_SIZE) {
-        int width = img.Width();
-        int height = img.Height();
-        gfx::CalculateFaviconTargetSize(&width, &height);
-        SkBitmap bitmap(*img.ToSkBitmap());
-        img = gfx::Image::CreateFrom1xBitmap(skia::ImageOperations::Resize(
-            bitmap, skia::ImageOperations::RESIZE_GOOD, width, height));
-      }
-
-      menu_model->SetIcon(menu_model->GetIndexOfCommandId(command_id).value(),
-                          ui::ImageModel::FromImage(img));
+    gfx::Image img;
+    if (menu_icon_cache::FindFaviconSizedIcon(icon, &img)) {
+      pending_icon_ids_.erase(command_id);
+    } else {
+      // Decode the icon on a worker thread and update the menu when it is
+      // ready. Until then use the empty icon so the menu reserves space for it.
+      pending_icon_ids_.insert(command_id);
+      menu_icon_cache::LoadFaviconSizedIcon(
+          icon, base::BindOnce(&ContextMenuController::OnIconDecoded,
+                               weak_ptr_factory_.GetWeakPtr(), command_id));
+      img = menu_icon_cache::GetIcon(GetEmptyIcon());
     }
+    menu_model->SetIcon(menu_model->GetIndexOfCommandId(command_id).value(),
+                        ui::ImageModel::FromImage(img));
   }
 }
 
+void ContextMenuController::OnIconDecoded(int command_id,
+                                          const gfx::Image& image) {
+  // Skip the icon if a favicon or another icon replaced it in the meantime.
+  if (pending_icon_ids_.erase(command_id) == 0)
+    return;
+  UpdateIcon(command_id, image);
+}
+
 void ContextMenuController::LoadFavicon(int command_id,
                                         const std::string& url,
                                         bool is_page) {
@@ -387,22 +391,30 @@ void ContextMenuController::OnFaviconDataAvailable(
     int command_id,
     const favicon_base::FaviconImageResult& image_result) {
   if (!image_result.image.IsEmpty()) {
+    pending_icon_ids_.erase(command_id);
+    UpdateIcon(command_id, image_result.image);
+  }
+}
+
+void ContextMenuController::UpdateIcon(int command_id,
+                                       const gfx::Image& image) {
+  if (!image.IsEmpty()) {
     // Update the menu directly so that a visible menu will be updated, The
     // MenuItemView class we use to paint the menu does not support dynamic
     // updates of icons through the model.
-    menu_->SetIcon(image_result.image, command_id);
+    menu_->SetIcon(image, command_id);
     // We have to update the model as well so that if a menu reloads utself
     // due to a dynamic update the model can provide the state at that point.
     auto index = root_menu_model_->GetIndexOfCommandId(command_id);
     if (index.has_value()) {
       root_menu_model_->SetIcon(index.value(),
-        ui::ImageModel::FromImage(image_result.image));
+        ui::ImageModel::FromImage(image));
     } else {
       for (unsigned i = 0; i < models_.size(); i++ ) {
         ui::SimpleMenuModel* model = models_[i].get();
         index = model->GetIndexOfCommandId(command_id);
         if (index.has_value()) {
-          model->SetIcon(index.value(), ui::ImageModel::FromImage(image_result.image));
+          model->SetIcon(index.value(), ui::ImageModel::FromImage(image));
           break;
         }
       }
@@ -463,6 +475,7 @@ void ContextMenuController::VivaldiCommandIdHighlighted(int command_id) {
 }
 
 void ContextMenuController::ExecuteCommand(int command_id, int event_flags) {
+  TRACE_EVENT0("vivaldi", "ContextMenuController::ExecuteCommand");
   if (developertools_controller_->HandleCommand(command_id)) {
   } else if (pwa_controller_ && pwa_controller_->HandleCommand(command_id)) {
   } else {
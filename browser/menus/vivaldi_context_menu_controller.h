@@ -5,8 +5,10 @@
 #define BROWSER_MENUS_CONTEXT_MENU_CONTROLLER_H_
 
 #include <map>
+#include <set>
 #include <vector>
 
+#include "base/memory/weak_ptr.h"
 #include "base/task/cancelable_task_tracker.h"
 #include "base/timer/timer.h"
 #include "browser/menus/vivaldi_developertools_menu_controller.h"
@@ -104,6 +106,8 @@ class ContextMenuController : public ui::SimpleMenuModel::Delegate,
   void OnFaviconDataAvailable(
       int command_id,
       const favicon_base::FaviconImageResult& image_result);
+  void OnIconDecoded(int command_id, const gfx::Image& image);
+  void UpdateIcon(int command_id, const gfx::Image& image);
   void Delete();
 
   typedef std::map<int, bool> IdToBoolMap;
@@ -135,6 +139,11 @@ class ContextMenuController : public ui::SimpleMenuModel::Delegate,
   std::unique_ptr<DeveloperToolsMenuController> developertools_controller_;
   std::unique_ptr<PWAMenuController> pwa_controller_;
   std::unique_ptr<base::OneShotTimer> timer_;
+
+  // Commands waiting for their icon to be decoded.
+  std::set<int> pending_icon_ids_;
+
+  base::WeakPtrFactory<ContextMenuController> weak_ptr_factory_{this};
 };
 
 }  // namespace vivaldi
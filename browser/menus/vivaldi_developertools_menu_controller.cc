@@ -6,6 +6,7 @@
 #include "app/vivaldi_resources.h"
 #include "apps/switches.h"
 #include "base/command_line.h"
+#include "base/trace_event/trace_event.h"
 #include "browser/menus/vivaldi_menu_enums.h"
 #include "browser/vivaldi_browser_finder.h"
 #include "chrome/app/chrome_command_ids.h"
@@ -49,6 +50,7 @@ bool DeveloperToolsMenuController::HasFeature() {
 
 void DeveloperToolsMenuController::PopulateModel(
     ui::SimpleMenuModel* menu_model) {
+  TRACE_EVENT0("vivaldi", "DeveloperToolsMenuController::PopulateModel");
   if (enabled_) {
     menu_model->AddSeparator(ui::NORMAL_SEPARATOR);
     // NOTE(pettern): Reload will not work with our app, disable it for now.
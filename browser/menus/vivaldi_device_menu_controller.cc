@@ -8,6 +8,7 @@
 
 #include "browser/menus/vivaldi_device_menu_controller.h"
 
+#include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
 #include "chrome/app/chrome_command_ids.h"
 #include "chrome/app/vector_icons/vector_icons.h"
@@ -30,6 +31,7 @@ void DeviceMenuController::Populate(Browser* browser,
                                     std::u16string label,
                                     ui::SimpleMenuModel* menu_model,
                                     ui::SimpleMenuModel::Delegate* delegate) {
+  TRACE_EVENT0("vivaldi", "DeviceMenuController::Populate");
   if (mode_ == kPage) {
 #if BUILDFLAG(IS_MAC)
     menu_model->AddItem(
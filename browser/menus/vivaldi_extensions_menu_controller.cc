@@ -8,6 +8,7 @@
 
 #include "browser/menus/vivaldi_extensions_menu_controller.h"
 
+#include "base/trace_event/trace_event.h"
 #include "browser/menus/vivaldi_render_view_context_menu.h"
 #include "chrome/browser/browser_process.h"
 #include "content/public/browser/render_process_host.h"
@@ -29,6 +30,7 @@ void ExtensionsMenuController::Populate(
     content::WebContents* source_web_contents,
     std::u16string printable_selection_text,
     base::RepeatingCallback<bool(const extensions::MenuItem*)> filter) {
+  TRACE_EVENT0("vivaldi", "ExtensionsMenuController::Populate");
   extension_items_.reset(new extensions::ContextMenuMatcher(
       rv_context_menu_->GetBrowserContext(), delegate, menu_model,
       std::move(filter)));
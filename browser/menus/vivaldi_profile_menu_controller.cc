@@ -9,6 +9,7 @@
 #include "browser/menus/vivaldi_profile_menu_controller.h"
 
 #include "app/vivaldi_resources.h"
+#include "base/trace_event/trace_event.h"
 #include "browser/menus/vivaldi_menu_enums.h"
 #include "browser/menus/vivaldi_render_view_context_menu.h"
 #include "chrome/app/chrome_command_ids.h"
@@ -81,6 +82,7 @@ ProfileMenuController::Ids ProfileMenuController::GetIds(bool is_image) {
 void ProfileMenuController::Populate(std::u16string label,
                                      ui::SimpleMenuModel* menu_model,
                                      ui::SimpleMenuModel::Delegate* delegate) {
+  TRACE_EVENT0("vivaldi", "ProfileMenuController::Populate");
   std::vector<ProfileAttributesEntry*> target_profiles_entries;
   CollectTargetProfiles(active_profile_, target_profiles_entries);
 
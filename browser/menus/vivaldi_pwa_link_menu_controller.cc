@@ -8,6 +8,7 @@
 #include "browser/menus/vivaldi_pwa_link_menu_controller.h"
 
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "browser/menus/vivaldi_render_view_context_menu.h"
 #include "chrome/app/chrome_command_ids.h"
 #include "chrome/browser/apps/app_service/app_service_proxy_factory.h"
@@ -33,6 +34,7 @@ PWALinkMenuController::~PWALinkMenuController() = default;
 void PWALinkMenuController::Populate(Browser* browser,
                                      std::u16string label,
                                      ui::SimpleMenuModel* menu_model) {
+  TRACE_EVENT0("vivaldi", "PWALinkMenuController::Populate");
   if (!apps::AppServiceProxyFactory::IsAppServiceAvailableForProfile(profile_))
     return;
 
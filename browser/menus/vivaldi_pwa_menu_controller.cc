@@ -4,6 +4,7 @@
 #include "browser/menus/vivaldi_pwa_menu_controller.h"
 
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "browser/vivaldi_runtime_feature.h"
 #include "chrome/app/chrome_command_ids.h"
 #include "chrome/browser/ui/browser.h"
@@ -40,6 +41,7 @@ absl::optional<std::u16string> GetInstallPWAAppMenuItemName(Browser* browser) {
 PWAMenuController::PWAMenuController(Browser* browser) : browser_(browser) {}
 
 void PWAMenuController::PopulateModel(ui::SimpleMenuModel* menu_model) {
+  TRACE_EVENT0("vivaldi", "PWAMenuController::PopulateModel");
   absl::optional<web_app::AppId> pwa = web_app::GetWebAppForActiveTab(browser_);
   if (pwa) {
     auto* provider =
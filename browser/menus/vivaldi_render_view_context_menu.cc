@@ -8,10 +8,9 @@
 
 #include "browser/menus/vivaldi_render_view_context_menu.h"
 
-#include <map>
-
 #include "app/vivaldi_constants.h"
 #include "app/vivaldi_resources.h"
+#include "base/containers/fixed_flat_map.h"
 #include "base/files/file_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "browser/menus/vivaldi_device_menu_controller.h"
@@ -1019,8 +1018,11 @@ void VivaldiRenderViewContextMenu::PopulateContainer(
   }
 }
 
-int VivaldiRenderViewContextMenu::GetStaticIdForAction(std::string command) {
-  static const std::map<std::string, int> map{
+int VivaldiRenderViewContextMenu::GetStaticIdForAction(
+    base::StringPiece command) {
+  // This is looked up for every item of every context menu, so use a table
+  // sorted at compile time.
+  static constexpr auto map = base::MakeFixedFlatMap<base::StringPiece, int>({
       {"DOCUMENT_BACK", IDC_BACK},
       {"DOCUMENT_FORWARD", IDC_FORWARD},
       {"DOCUMENT_RELOAD", IDC_RELOAD},
@@ -1059,7 +1061,6 @@ int VivaldiRenderViewContextMenu::GetStaticIdForAction(std::string command) {
       {"DOCUMENT_UNDO", IDC_CONTENT_CONTEXT_UNDO},
       {"DOCUMENT_REDO", IDC_CONTENT_CONTEXT_REDO},
       {"DOCUMENT_CUT", IDC_CONTENT_CONTEXT_CUT},
-      {"DOCUMENT_COPY", IDC_CONTENT_CONTEXT_COPY},
       {"DOCUMENT_PASTE", IDC_CONTENT_CONTEXT_PASTE},
       {"DOCUMENT_PASTE_AS_PLAIN_TEXT",
        IDC_CONTENT_CONTEXT_PASTE_AND_MATCH_STYLE},
@@ -1081,7 +1082,7 @@ int VivaldiRenderViewContextMenu::GetStaticIdForAction(std::string command) {
       {"DOCUMENT_ROTATE_COUNTERCLOCKWISE", IDC_CONTENT_CONTEXT_ROTATECCW},
       {"DOCUMENT_LOOK_UP", IDC_CONTENT_CONTEXT_LOOK_UP},
       {"DOCUMENT_SUGGEST_PASSWORD", IDC_CONTENT_CONTEXT_GENERATEPASSWORD},
-  };
+  });
 
   auto it = map.find(command);
   if (it != map.end()) {
@@ -1092,7 +1093,7 @@ int VivaldiRenderViewContextMenu::GetStaticIdForAction(std::string command) {
 }
 
 ui::ImageModel VivaldiRenderViewContextMenu::GetImageForAction(
-    std::string command) {
+    base::StringPiece command) {
 #if BUILDFLAG(IS_MAC)
   return ui::ImageModel();
 #else
@@ -7,6 +7,7 @@
 #include <map>
 #include <vector>
 
+#include "base/strings/string_piece.h"
 #include "build/build_config.h"
 #include "chrome/browser/renderer_context_menu/render_view_context_menu.h"
 #include "extensions/schema/context_menu.h"
@@ -91,8 +92,8 @@ protected:
   bool GetAcceleratorForCommandId(int command_id,
                                   ui::Accelerator* accelerator) const override;
 
-  int GetStaticIdForAction(std::string command);
-  ui::ImageModel GetImageForAction(std::string command);
+  int GetStaticIdForAction(base::StringPiece command);
+  ui::ImageModel GetImageForAction(base::StringPiece command);
 
   void ContainerWillOpen(ui::SimpleMenuModel* menu_model);
   bool HasContainerContent(const Container& container);
@@ -45,6 +45,10 @@ constexpr int kMatomoId = 13;                             // Blackhole
 constexpr int kScheduleJitter = 1;                        // minutes
 #endif
 
+// Upper bound for a single ping request so a stalled connection cannot delay
+// the following reports indefinitely.
+constexpr base::TimeDelta kRequestTimeout = base::Minutes(1);
+
 constexpr int kExtraPingCount = 2;
 constexpr int kExtraPingDelays[kExtraPingCount] = {10, 50};  // minutes
 
@@ -195,6 +199,7 @@ std::unique_ptr<network::SimpleURLLoader> CreateURLLoader(
 
   url_loader->SetRetryOptions(
       1, network::SimpleURLLoader::RETRY_ON_NETWORK_CHANGE);
+  url_loader->SetTimeoutDuration(kRequestTimeout);
 
   return url_loader;
 }
@@ -284,8 +289,54 @@ absl::optional<StatsReporterImpl::FileAndContent> LockAndReadFile(
 
   return result;
 }
+
+// Runs on a worker thread so that waiting on the reporting data file, which
+// may live on a network share, and building the request never block the UI
+// thread. Returns nullopt if another instance holds the file lock.
+absl::optional<StatsReporterImpl::PreparedPing> PreparePing(
+    base::FilePath path,
+    StatsReporterImpl::PingInputs inputs) {
+  absl::optional<StatsReporterImpl::FileAndContent> file_and_content =
+      LockAndReadFile(std::move(path));
+  if (!file_and_content)
+    return absl::nullopt;
+
+  StatsReporterImpl::PreparedPing result;
+  result.file = std::move(file_and_content->file);
+  result.local_state_reporting_data =
+      std::move(inputs.local_state_reporting_data);
+
+  if (!file_and_content->content.empty()) {
+    result.os_profile_reporting_data_json =
+        base::JSONReader::Read(file_and_content->content);
+  }
+  if (!result.os_profile_reporting_data_json ||
+      !result.os_profile_reporting_data_json->is_dict()) {
+    result.os_profile_reporting_data_json.emplace(
+        base::Value::Type::DICTIONARY);
+  }
+
+  result.should_send = StatsReporterImpl::GeneratePingRequest(
+      inputs.now, inputs.legacy_user_id, inputs.display_size,
+      inputs.architecture, VIVALDI_UA_VERSION, inputs.user_agent,
+      result.local_state_reporting_data, result.os_profile_reporting_data_json,
+      result.request_url, result.body, result.next_reporting_time_interval);
+  return result;
+}
 }  // namespace
 
+StatsReporterImpl::PingInputs::PingInputs() = default;
+StatsReporterImpl::PingInputs::PingInputs(PingInputs&&) = default;
+StatsReporterImpl::PingInputs& StatsReporterImpl::PingInputs::operator=(
+    PingInputs&&) = default;
+StatsReporterImpl::PingInputs::~PingInputs() = default;
+
+StatsReporterImpl::PreparedPing::PreparedPing() = default;
+StatsReporterImpl::PreparedPing::PreparedPing(PreparedPing&&) = default;
+StatsReporterImpl::PreparedPing& StatsReporterImpl::PreparedPing::operator=(
+    PreparedPing&&) = default;
+StatsReporterImpl::PreparedPing::~PreparedPing() = default;
+
 StatsReporterImpl::FileHolder::FileHolder(base::File file)
     : file_(std::move(file)) {}
 
@@ -328,10 +379,13 @@ void StatsReporterImpl::OnLegacyUserIdGot(const std::string& legacy_user_id) {
 
 void StatsReporterImpl::StartReporting() {
   base::ThreadPool::PostTaskAndReplyWithResult(
-      FROM_HERE, {base::MayBlock(), base::TaskPriority::LOWEST},
-      base::BindOnce(&LockAndReadFile,
-                     GetReportingDataFileDir().Append(kReportingDataFileName)),
-      base::BindOnce(&StatsReporterImpl::OnOSStatFileRead,
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::LOWEST,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(&PreparePing,
+                     GetReportingDataFileDir().Append(kReportingDataFileName),
+                     CollectPingInputs()),
+      base::BindOnce(&StatsReporterImpl::OnPingPrepared,
                      weak_factory_.GetWeakPtr()));
 }
 
@@ -687,27 +741,17 @@ bool StatsReporterImpl::GeneratePingRequest(
   return true;
 }
 
-void StatsReporterImpl::OnOSStatFileRead(
-    absl::optional<FileAndContent> file_and_content) {
-  if (!file_and_content) {
-    ScheduleNextReporting(kLockDelay, false);
-    return;
-  }
-
-  DoReporting(FileHolder(std::move(file_and_content->file)),
-              std::move(file_and_content->content));
-}
-
-void StatsReporterImpl::DoReporting(FileHolder os_profile_reporting_data_file,
-                                    std::string os_profile_reporting_data) {
+StatsReporterImpl::PingInputs StatsReporterImpl::CollectPingInputs() {
   PrefService* prefs = g_browser_process->local_state();
-  ReportingData local_state_reporting_data;
+  PingInputs inputs;
+  ReportingData& local_state_reporting_data = inputs.local_state_reporting_data;
   local_state_reporting_data.user_id =
       prefs->GetString(vivaldiprefs::kVivaldiUniqueUserId);
   if (!IsValidUserId(local_state_reporting_data.user_id))
     local_state_reporting_data.user_id.clear();
 
   base::Time now = base::Time::Now();
+  inputs.now = now;
 
   // Allow an extra day of wiggle room, to make sure we only reset for good
   // reasons.
@@ -740,35 +784,32 @@ void StatsReporterImpl::DoReporting(FileHolder os_profile_reporting_data_file,
   local_state_reporting_data.pings_since_last_month =
       prefs->GetInteger(vivaldiprefs::kVivaldiStatsPingsSinceLastMonth);
 
-  absl::optional<base::Value> os_profile_reporting_data_json;
-  if (!os_profile_reporting_data.empty()) {
-    os_profile_reporting_data_json =
-        base::JSONReader::Read(os_profile_reporting_data);
-  }
-  if (!os_profile_reporting_data_json ||
-      !os_profile_reporting_data_json->is_dict()) {
-    os_profile_reporting_data_json.emplace(base::Value::Type::DICTIONARY);
-  }
-
-  std::string request_url;
-  std::string body;
-  base::TimeDelta next_reporting_time_interval;
-
+  inputs.legacy_user_id = legacy_user_id_;
   // Screen info should only be missing if we reach this too early in the
   // startup process.
   DCHECK(display::Screen::GetScreen());
-  if (!GeneratePingRequest(
-          now, legacy_user_id_,
-          display::Screen::GetScreen()->GetPrimaryDisplay().GetSizeInPixel(),
-          base::SysInfo::OperatingSystemArchitecture(), VIVALDI_UA_VERSION,
-          embedder_support::GetUserAgent(), local_state_reporting_data,
-          os_profile_reporting_data_json, request_url, body,
-          next_reporting_time_interval)) {
-    ScheduleNextReporting(next_reporting_time_interval, true);
+  inputs.display_size =
+      display::Screen::GetScreen()->GetPrimaryDisplay().GetSizeInPixel();
+  inputs.architecture = base::SysInfo::OperatingSystemArchitecture();
+  inputs.user_agent = embedder_support::GetUserAgent();
+  return inputs;
+}
+
+void StatsReporterImpl::OnPingPrepared(
+    absl::optional<PreparedPing> prepared_ping) {
+  if (!prepared_ping) {
+    ScheduleNextReporting(kLockDelay, false);
     return;
   }
 
-  url_loader_ = CreateURLLoader(GURL(request_url), body);
+  FileHolder os_profile_reporting_data_file(std::move(prepared_ping->file));
+  if (!prepared_ping->should_send) {
+    ScheduleNextReporting(prepared_ping->next_reporting_time_interval, true);
+    return;
+  }
+
+  url_loader_ =
+      CreateURLLoader(GURL(prepared_ping->request_url), prepared_ping->body);
 
   // Unretained is safe because the callback is destroyed when the url_loader_
   // (which we own) is destroyed
@@ -777,9 +818,9 @@ void StatsReporterImpl::DoReporting(FileHolder os_profile_reporting_data_file,
       base::BindOnce(&StatsReporterImpl::OnURLLoadComplete,
                      base::Unretained(this),
                      std::move(os_profile_reporting_data_file),
-                     std::move(local_state_reporting_data),
-                     std::move(os_profile_reporting_data_json),
-                     next_reporting_time_interval),
+                     std::move(prepared_ping->local_state_reporting_data),
+                     std::move(prepared_ping->os_profile_reporting_data_json),
+                     prepared_ping->next_reporting_time_interval),
       1024);
 }
 
@@ -800,20 +841,20 @@ void StatsReporterImpl::OnURLLoadComplete(
 
   if (os_profile_reporting_data_file.IsValid() &&
       os_profile_reporting_data_json) {
-    std::string os_profile_reporting_data_file_contents;
-    base::JSONWriter::Write(*os_profile_reporting_data_json,
-                            &os_profile_reporting_data_file_contents);
-
+    // Serialize on the worker too, the file is only unlocked when it closes.
     base::ThreadPool::PostTask(
         FROM_HERE,
         {base::MayBlock(), base::TaskShutdownBehavior::BLOCK_SHUTDOWN},
         base::BindOnce(
-            [](base::File file, std::string content) {
+            [](base::File file, base::Value json) {
+              std::string content;
+              base::JSONWriter::Write(json, &content);
               file.Write(0, content.c_str(), content.length());
               file.Close();
             },
             os_profile_reporting_data_file.release(),
-            std::move(os_profile_reporting_data_file_contents)));
+            std::move(*os_profile_reporting_data_json)));
+    os_profile_reporting_data_json.reset();
   }
 
   DCHECK_GE(local_state_reporting_data.next_extra_ping, 0);
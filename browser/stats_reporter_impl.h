@@ -15,6 +15,7 @@
 #include "browser/stats_reporter.h"
 #include "net/base/backoff_entry.h"
 #include "ui/display/screen.h"
+#include "ui/gfx/geometry/size.h"
 
 namespace network {
 class SimpleURLLoader;
@@ -47,6 +48,38 @@ class StatsReporterImpl : public StatsReporter {
     std::string content;
   };
 
+  // Inputs to GeneratePingRequest() that must be collected on the UI thread.
+  struct PingInputs {
+    PingInputs();
+    PingInputs(PingInputs&&);
+    PingInputs& operator=(PingInputs&&);
+    ~PingInputs();
+
+    base::Time now;
+    std::string legacy_user_id;
+    gfx::Size display_size;
+    std::string architecture;
+    std::string user_agent;
+    ReportingData local_state_reporting_data;
+  };
+
+  // Result of reading the reporting data file and generating the ping request
+  // on a worker thread.
+  struct PreparedPing {
+    PreparedPing();
+    PreparedPing(PreparedPing&&);
+    PreparedPing& operator=(PreparedPing&&);
+    ~PreparedPing();
+
+    base::File file;
+    bool should_send = false;
+    std::string request_url;
+    std::string body;
+    base::TimeDelta next_reporting_time_interval;
+    ReportingData local_state_reporting_data;
+    absl::optional<base::Value> os_profile_reporting_data_json;
+  };
+
   StatsReporterImpl();
 
   StatsReporterImpl(const StatsReporterImpl&) = delete;
@@ -90,9 +123,8 @@ class StatsReporterImpl : public StatsReporter {
   void OnLegacyUserIdGot(const std::string& legacy_user_id);
   void StartReporting();
 
-  void OnOSStatFileRead(absl::optional<FileAndContent> file_and_content);
-  void DoReporting(FileHolder os_profile_reporting_data_file,
-                   std::string os_profile_reporting_data);
+  PingInputs CollectPingInputs();
+  void OnPingPrepared(absl::optional<PreparedPing> prepared_ping);
   void OnURLLoadComplete(
       FileHolder os_profile_reporting_data_file,
       ReportingData local_state_reporting_data,
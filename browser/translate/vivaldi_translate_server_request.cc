@@ -3,12 +3,16 @@
 #include "browser/translate/vivaldi_translate_server_request.h"
 
 #include <algorithm>
+#include <map>
 #include <string>
 #include <vector>
 
 #include "base/command_line.h"
+#include "base/containers/lru_cache.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/supports_user_data.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/vivaldi_switches.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/common/chrome_switches.h"
@@ -35,6 +39,58 @@ constexpr char kTargetLanguageKey[] = "target";
 constexpr char kStringsLanguageKey[] = "q";
 
 constexpr int kMaxTranslateResponse = 1024 * 1024;
+
+// Number of translated strings kept per profile.
+constexpr size_t kMaxCachedTranslations = 5000;
+
+const char kTranslationCacheKey[] = "vivaldi_translation_cache";
+
+// Recent translations of the profile, so translating a page again or pages
+// that share navigation and boilerplate text does not send the same strings
+// to the server.
+class TranslationCache : public base::SupportsUserData::Data {
+ public:
+  struct Entry {
+    std::string translated_text;
+    std::string detected_source_language;
+  };
+
+  TranslationCache() : cache_(kMaxCachedTranslations) {}
+  TranslationCache(const TranslationCache&) = delete;
+  TranslationCache& operator=(const TranslationCache&) = delete;
+
+  static TranslationCache* FromBrowserContext(
+      content::BrowserContext* context) {
+    auto* cache = static_cast<TranslationCache*>(
+        context->GetUserData(&kTranslationCacheKey));
+    if (!cache) {
+      auto new_cache = std::make_unique<TranslationCache>();
+      cache = new_cache.get();
+      context->SetUserData(&kTranslationCacheKey, std::move(new_cache));
+    }
+    return cache;
+  }
+
+  static std::string MakeKey(const std::string& source_language,
+                             const std::string& destination_language,
+                             const std::string& text) {
+    // Language codes never contain a newline.
+    return source_language + '\n' + destination_language + '\n' + text;
+  }
+
+  const Entry* Find(const std::string& key) {
+    auto i = cache_.Get(key);
+    return i == cache_.end() ? nullptr : &i->second;
+  }
+
+  void Put(std::string key, Entry entry) {
+    cache_.Put(std::move(key), std::move(entry));
+  }
+
+ private:
+  base::LRUCache<std::string, Entry> cache_;
+};
+
 }  // namespace
 
 VivaldiTranslateServerRequest::VivaldiTranslateServerRequest(
@@ -46,7 +102,8 @@ VivaldiTranslateServerRequest::VivaldiTranslateServerRequest() {}
 
 VivaldiTranslateServerRequest::~VivaldiTranslateServerRequest() = default;
 
-const std::string VivaldiTranslateServerRequest::GetServer() {
+// static
+std::string VivaldiTranslateServerRequest::GetServer() {
   std::string server = kTranslateLanguageServerUrl;
   const base::CommandLine& cmd_line = *base::CommandLine::ForCurrentProcess();
   if (cmd_line.HasSwitch(switches::kTranslateServerUrl)) {
@@ -81,6 +138,43 @@ void VivaldiTranslateServerRequest::StartRequest(
     const std::vector<std::string>& data,
     const std::string& source_language,
     const std::string& destination_language) {
+  source_language_ = source_language;
+  destination_language_ = destination_language;
+  source_strings_ = data;
+  translated_strings_.assign(data.size(), std::string());
+  sent_positions_.clear();
+
+  TranslationCache* cache =
+      TranslationCache::FromBrowserContext(context_.get());
+  std::string cached_source_language;
+  std::vector<std::string> strings_to_send;
+  std::map<base::StringPiece, size_t> sent_index;
+  for (size_t i = 0; i < data.size(); i++) {
+    if (const TranslationCache::Entry* entry = cache->Find(
+            TranslationCache::MakeKey(source_language, destination_language,
+                                      data[i]))) {
+      translated_strings_[i] = entry->translated_text;
+      cached_source_language = entry->detected_source_language;
+      continue;
+    }
+    auto inserted = sent_index.emplace(data[i], strings_to_send.size());
+    if (inserted.second) {
+      strings_to_send.push_back(data[i]);
+      sent_positions_.emplace_back();
+    }
+    sent_positions_[inserted.first->second].push_back(i);
+  }
+
+  if (strings_to_send.empty()) {
+    // Keep the callback asynchronous as for the server requests.
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&VivaldiTranslateServerRequest::OnAllCached,
+                       weak_factory_.GetWeakPtr(),
+                       std::move(cached_source_language)));
+    return;
+  }
+
   auto resource_request = std::make_unique<network::ResourceRequest>();
   resource_request->url = GURL(GetServer());
   resource_request->method = "POST";
@@ -115,7 +209,8 @@ void VivaldiTranslateServerRequest::StartRequest(
       2, network::SimpleURLLoader::RETRY_ON_NETWORK_CHANGE);
   url_loader_->SetAllowHttpErrorResults(true);
 
-  std::string body = GenerateJSON(data, source_language, destination_language);
+  std::string body =
+      GenerateJSON(strings_to_send, source_language, destination_language);
 
   url_loader_->AttachStringForUpload(body, "application/json");
 
@@ -126,6 +221,36 @@ void VivaldiTranslateServerRequest::StartRequest(
       kMaxTranslateResponse);
 }
 
+void VivaldiTranslateServerRequest::OnAllCached(
+    std::string detected_source_language) {
+  // `this` can be deleted after the callback call.
+  std::move(callback_).Run(TranslateError::kNoError,
+                           std::move(detected_source_language),
+                           std::move(source_strings_),
+                           std::move(translated_strings_));
+}
+
+bool VivaldiTranslateServerRequest::MergeTranslations(
+    const std::string& detected_source_language,
+    const std::vector<std::string>& translations) {
+  if (translations.size() != sent_positions_.size())
+    return false;
+  TranslationCache* cache =
+      context_ ? TranslationCache::FromBrowserContext(context_.get()) : nullptr;
+  for (size_t i = 0; i < translations.size(); i++) {
+    for (size_t position : sent_positions_[i]) {
+      translated_strings_[position] = translations[i];
+    }
+    if (cache) {
+      cache->Put(TranslationCache::MakeKey(
+                     source_language_, destination_language_,
+                     source_strings_[sent_positions_[i].front()]),
+                 {translations[i], detected_source_language});
+    }
+  }
+  return true;
+}
+
 bool VivaldiTranslateServerRequest::IsRequestInProgress() {
   return url_loader_ != nullptr;
 }
@@ -198,6 +323,19 @@ void VivaldiTranslateServerRequest::OnRequestResponse(
         }
         url_loader_.reset(nullptr);
 
+        // Combine the server result with the cached strings when only a part
+        // of the request was sent.
+        if (error == TranslateError::kNoError && !sent_positions_.empty()) {
+          if (MergeTranslations(
+                  detected_source_language ? *detected_source_language : "",
+                  translated_strings)) {
+            source_strings = std::move(source_strings_);
+            translated_strings = std::move(translated_strings_);
+          } else {
+            error = TranslateError::kTranslationError;
+          }
+        }
+
         // `this` can be deleted after the callback call.
         std::move(callback_).Run(
             error, detected_source_language ? *detected_source_language : "",
@@ -23,6 +23,7 @@ namespace vivaldi {
 
 FORWARD_DECLARE_TEST(VivaldiTranslateServerRequestTest, GenerateJSON);
 FORWARD_DECLARE_TEST(VivaldiTranslateServerRequestTest, OnRequestResponse);
+FORWARD_DECLARE_TEST(VivaldiTranslateServerRequestTest, MergeTranslations);
 
 class VivaldiTranslateServerRequestTest;
 
@@ -54,7 +55,10 @@ class VivaldiTranslateServerRequest {
       delete;
 
   // Given an array of strings and language codes, it will request
-  // a translation from the server.
+  // a translation from the server. Strings translated recently for the same
+  // languages in this profile are taken from a cache and only the rest, each
+  // distinct string once, are sent. The callback always gets all strings in
+  // the original order.
   void StartRequest(const std::vector<std::string>& data,
                     const std::string& source_language,
                     const std::string& destination_language);
@@ -67,15 +71,27 @@ class VivaldiTranslateServerRequest {
   // is ongoing.
   void AbortRequest();
 
+  // Returns the URL of the translation server.
+  static std::string GetServer();
+
  private:
   FRIEND_TEST(VivaldiTranslateServerRequestTest, GenerateJSON);
   FRIEND_TEST(VivaldiTranslateServerRequestTest, OnRequestResponse);
+  FRIEND_TEST(VivaldiTranslateServerRequestTest, MergeTranslations);
 
   std::string GenerateJSON(const std::vector<std::string>& data,
                            const std::string& source_language,
                            const std::string& destination_language);
   void OnRequestResponse(std::unique_ptr<std::string> response_body);
-  const std::string GetServer();
+
+  // Run the callback with the result for a request that was fully served from
+  // the cache.
+  void OnAllCached(std::string detected_source_language);
+
+  // Put the server translations of the sent strings into translated_strings_
+  // and the cache. Return false if they do not match the sent strings.
+  bool MergeTranslations(const std::string& detected_source_language,
+                         const std::vector<std::string>& translations);
 
   void SetCallbackForTesting(VivaldiTranslateTextCallback callback) {
     callback_ = std::move(callback);
@@ -87,6 +103,16 @@ class VivaldiTranslateServerRequest {
 
   std::unique_ptr<network::SimpleURLLoader> url_loader_;
 
+  // State of the request started with StartRequest().
+  std::string source_language_;
+  std::string destination_language_;
+  std::vector<std::string> source_strings_;
+  std::vector<std::string> translated_strings_;
+
+  // For each string sent to the server, the positions in source_strings_ where
+  // it occurs.
+  std::vector<std::vector<size_t>> sent_positions_;
+
   base::WeakPtrFactory<VivaldiTranslateServerRequest> weak_factory_{this};
 };
 
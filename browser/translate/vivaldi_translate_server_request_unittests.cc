@@ -64,4 +64,20 @@ TEST_F(VivaldiTranslateServerRequestTest, OnRequestResponse) {
   request->OnRequestResponse(std::move(response));
 }
 
+TEST_F(VivaldiTranslateServerRequestTest, MergeTranslations) {
+  std::unique_ptr<VivaldiTranslateServerRequest> request =
+      std::make_unique<VivaldiTranslateServerRequest>();
+
+  // "Hello" was found in the cache and "Menu" occurs twice but was sent once.
+  request->source_strings_ = {"Menu", "Hello", "Menu", "Close"};
+  request->translated_strings_ = {"", "Hallo", "", ""};
+  request->sent_positions_ = {{0, 2}, {3}};
+
+  EXPECT_FALSE(request->MergeTranslations("en", {"Meny"}));
+  EXPECT_TRUE(request->MergeTranslations("en", {"Meny", "Lukk"}));
+
+  std::vector<std::string> expected = {"Meny", "Hallo", "Meny", "Lukk"};
+  EXPECT_EQ(request->translated_strings_, expected);
+}
+
 }  // namespace vivaldi
\ No newline at end of file
@@ -2,11 +2,16 @@
 
 #include "browser/vivaldi_default_bookmarks.h"
 
+#include <map>
+#include <unordered_map>
+#include <utility>
+
 #include "base/bind.h"
 #include "base/containers/flat_set.h"
 #include "base/logging.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/thread_pool.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/browser_process.h"
@@ -118,6 +123,14 @@ class BookmarkUpdater {
 
   void FindExistingPartners(const BookmarkNode* top_node);
 
+  // Index nicknames of all nodes so checks for a taken nickname do not walk
+  // the whole tree for each partner.
+  void IndexNicknames();
+  bool IsNicknameTaken(const std::string& nickname,
+                       const BookmarkNode* updated_node) const;
+  void UpdateNicknameIndex(const std::string& old_nickname,
+                           const BookmarkNode* node);
+
   // Try to add the new partner at the given folder in the bookmark tree. Return
   // the added node or null if the item should be ignored because it was
   // deleted.
@@ -138,17 +151,31 @@ class BookmarkUpdater {
   const BookmarkNode* AddPartnerNode(const DefaultBookmarkItem& item,
                                      const BookmarkNode* parent_node);
 
+  // Queue the favicon for the page. The queued icons are read and stored
+  // with a single background task after the update in LoadQueuedFavicons().
   void SetFavicon(const GURL& page_url,
                   const GURL& icon_url,
                   std::string icon_path);
+  void LoadQueuedFavicons();
+
+  struct QueuedFavicon {
+    GURL page_url;
+    GURL icon_url;
+    std::string icon_path;
+  };
+
+  using GuidNodeMap =
+      std::unordered_map<base::GUID, const BookmarkNode*, base::GUIDHash>;
 
   Profile* profile_;
   const DefaultBookmarkTree* default_bookmark_tree_;
   BookmarkModel* model_;
   base::flat_set<base::GUID> deleted_partner_guids_;
 
-  std::map<base::GUID, const BookmarkNode*> guid_node_map_;
-  std::map<base::GUID, const BookmarkNode*> existing_partner_bookmarks_;
+  GuidNodeMap guid_node_map_;
+  GuidNodeMap existing_partner_bookmarks_;
+  std::unordered_multimap<std::string, const BookmarkNode*> nickname_index_;
+  std::vector<QueuedFavicon> queued_favicons_;
   Stats stats_;
 };
 
@@ -208,8 +235,8 @@ void DefaultBookmarkParser::ParseBookmarkList(
     }
     if (base::Value* children = dict.FindKey(kChildrenKey)) {
       // Folder
-      item.guid = details->guid;
-      item.title = details->title;
+      item.guid = base::GUID::ParseLowercase(details->guid);
+      item.title = std::string(details->title);
       item.speeddial = details->speeddial;
       if (!used_details.insert(details).second) {
         tree.valid = false;
@@ -263,20 +290,20 @@ void DefaultBookmarkParser::ParseBookmarkList(
           LOG(ERROR) << "bookmark is defined twice inside bookmarks folder - "
                      << item.title;
         }
-        item.guid = details->guid2;
-        item.alternative_guid = details->guid;
+        item.guid = base::GUID::ParseLowercase(details->guid2);
+        item.alternative_guid = base::GUID::ParseLowercase(details->guid);
       } else {
         if (!used_details.insert(details).second) {
           tree.valid = false;
           LOG(ERROR) << "bookmark is defined twice - " << item.title;
         }
-        item.guid = details->guid;
-        item.alternative_guid = details->guid2;
+        item.guid = base::GUID::ParseLowercase(details->guid);
+        item.alternative_guid = base::GUID::ParseLowercase(details->guid2);
       }
 
-      item.thumbnail = details->thumbnail;
+      item.thumbnail = std::string(details->thumbnail);
 
-      item.favicon = details->favicon;
+      item.favicon = std::string(details->favicon);
 
       GURL favicon_url(details->favicon_url);
       if (favicon_url.is_valid()) {
@@ -374,11 +401,16 @@ void AddBookmarkGuids(const std::vector<DefaultBookmarkItem>& default_items,
 }
 
 void BookmarkUpdater::RunCleanUpdate() {
+  TRACE_EVENT0("vivaldi", "BookmarkUpdater::RunCleanUpdate");
   DCHECK(!g_bookmark_update_actve);
   g_bookmark_update_actve = true;
 
   FindExistingPartners(model_->bookmark_bar_node());
   FindExistingPartners(model_->trash_node());
+  IndexNicknames();
+
+  // Let observers like sync and the UI process the update as one batch.
+  model_->BeginExtensiveChanges();
 
   UpdateRecursively(nullptr, default_bookmark_tree_->top_items);
   AddRecursively(default_bookmark_tree_->top_items,
@@ -407,6 +439,10 @@ void BookmarkUpdater::RunCleanUpdate() {
     }
   }
 
+  model_->EndExtensiveChanges();
+
+  LoadQueuedFavicons();
+
   DCHECK(g_bookmark_update_actve);
   g_bookmark_update_actve = false;
 }
@@ -451,6 +487,47 @@ void BookmarkUpdater::FindExistingPartners(const BookmarkNode* top_node) {
   }
 }
 
+void BookmarkUpdater::IndexNicknames() {
+  TRACE_EVENT0("vivaldi", "BookmarkUpdater::IndexNicknames");
+  ui::TreeNodeIterator<const BookmarkNode> iterator(model_->root_node());
+  while (iterator.has_next()) {
+    const BookmarkNode* node = iterator.Next();
+    const std::string& nickname = vivaldi_bookmark_kit::GetNickname(node);
+    if (!nickname.empty()) {
+      nickname_index_.emplace(nickname, node);
+    }
+  }
+}
+
+bool BookmarkUpdater::IsNicknameTaken(const std::string& nickname,
+                                      const BookmarkNode* updated_node) const {
+  auto range = nickname_index_.equal_range(nickname);
+  for (auto i = range.first; i != range.second; ++i) {
+    if (i->second != updated_node)
+      return true;
+  }
+  return false;
+}
+
+void BookmarkUpdater::UpdateNicknameIndex(const std::string& old_nickname,
+                                          const BookmarkNode* node) {
+  const std::string& nickname = vivaldi_bookmark_kit::GetNickname(node);
+  if (nickname == old_nickname)
+    return;
+  if (!old_nickname.empty()) {
+    auto range = nickname_index_.equal_range(old_nickname);
+    for (auto i = range.first; i != range.second; ++i) {
+      if (i->second == node) {
+        nickname_index_.erase(i);
+        break;
+      }
+    }
+  }
+  if (!nickname.empty()) {
+    nickname_index_.emplace(nickname, node);
+  }
+}
+
 void BookmarkUpdater::UpdateRecursively(
     const DefaultBookmarkItem* parent_item,
     const std::vector<DefaultBookmarkItem>& default_items) {
@@ -529,8 +606,7 @@ void BookmarkUpdater::UpdatePartnerNode(const DefaultBookmarkItem& item,
 
   // If nick is taken by other node do nothing. But ensure that it is cleared
   // if the nick in defaults is empty.
-  if (item.nickname.empty() ||
-      !::vivaldi_bookmark_kit::DoesNickExists(model_, item.nickname, node)) {
+  if (item.nickname.empty() || !IsNicknameTaken(item.nickname, node)) {
     custom_meta.SetNickname(item.nickname);
   }
   // We do not clear the partner status when the user selects a custom
@@ -543,7 +619,9 @@ void BookmarkUpdater::UpdatePartnerNode(const DefaultBookmarkItem& item,
   custom_meta.SetDescription(item.description);
   custom_meta.SetSpeeddial(item.speeddial);
 
+  std::string old_nickname = vivaldi_bookmark_kit::GetNickname(node);
   model_->SetNodeMetaInfoMap(node, *custom_meta.map());
+  UpdateNicknameIndex(old_nickname, node);
   if (node->is_url()) {
     stats_.updated_urls++;
   } else {
@@ -677,6 +755,7 @@ const BookmarkNode* BookmarkUpdater::AddPartnerNode(
 
     SetFavicon(item.url, item.favicon_url, item.favicon);
   }
+  UpdateNicknameIndex(std::string(), node);
   return node;
 }
 
@@ -685,24 +764,75 @@ void BookmarkUpdater::SetFavicon(const GURL& page_url,
                                  std::string icon_path) {
   if (page_url.is_empty() || icon_url.is_empty() || icon_path.empty())
     return;
+  queued_favicons_.push_back({page_url, icon_url, std::move(icon_path)});
+}
 
-  auto set_favicon_image =
-      [](base::WeakPtr<content::BrowserContext> browser_context, GURL page_url,
-         GURL icon_url, gfx::Image image) -> void {
+void BookmarkUpdater::LoadQueuedFavicons() {
+  if (queued_favicons_.empty())
+    return;
+  TRACE_EVENT1("vivaldi", "BookmarkUpdater::LoadQueuedFavicons", "count",
+               queued_favicons_.size());
+
+  // Partners often share an icon, so read each resource only once.
+  auto read_images =
+      [](std::vector<QueuedFavicon> favicons) -> std::vector<gfx::Image> {
+    TRACE_EVENT0("vivaldi", "BookmarkUpdater::ReadFaviconImages");
+    std::map<std::string, gfx::Image> image_cache;
+    std::vector<gfx::Image> images;
+    images.reserve(favicons.size());
+    for (const QueuedFavicon& favicon : favicons) {
+      auto i = image_cache.find(favicon.icon_path);
+      if (i == image_cache.end()) {
+        i = image_cache
+                .emplace(favicon.icon_path,
+                         ResourceReader::ReadPngImage(favicon.icon_path))
+                .first;
+      }
+      images.push_back(i->second);
+    }
+    return images;
+  };
+
+  auto set_favicon_images =
+      [](base::WeakPtr<content::BrowserContext> browser_context,
+         std::vector<QueuedFavicon> favicons,
+         std::vector<gfx::Image> images) -> void {
     if (!browser_context)
       return;
+    DCHECK_EQ(favicons.size(), images.size());
     Profile* profile = Profile::FromBrowserContext(browser_context.get());
     auto* favicon_service = FaviconServiceFactory::GetForProfile(
         profile, ServiceAccessType::EXPLICIT_ACCESS);
-    favicon_service->SetFavicons({page_url}, icon_url,
-                                 favicon_base::IconType::kFavicon, image);
+    // Store each icon once for all pages that use it, so the history thread
+    // gets a task per distinct icon rather than per bookmark. The database
+    // keeps one favicon per icon url, so the last image queued for a url wins
+    // as it did when each page was stored separately.
+    std::map<GURL, std::pair<base::flat_set<GURL>, gfx::Image>> icons;
+    for (size_t i = 0; i < favicons.size(); ++i) {
+      if (images[i].IsEmpty())
+        continue;
+      auto& icon = icons[favicons[i].icon_url];
+      icon.first.insert(favicons[i].page_url);
+      icon.second = images[i];
+    }
+    for (const auto& [icon_url, icon] : icons) {
+      favicon_service->SetFavicons(icon.first, icon_url,
+                                   favicon_base::IconType::kFavicon,
+                                   icon.second);
+    }
   };
+
+  // The reply needs the urls while the task needs the paths, so give each its
+  // own copy.
+  std::vector<QueuedFavicon> favicons = std::move(queued_favicons_);
+  queued_favicons_.clear();
   base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE,
-      {base::MayBlock(), base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
-      base::BindOnce(&ResourceReader::ReadPngImage, std::move(icon_path)),
-      base::BindOnce(set_favicon_image, profile_->GetWeakPtr(), page_url,
-                     icon_url));
+      {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(read_images, favicons),
+      base::BindOnce(set_favicon_images, profile_->GetWeakPtr(),
+                     std::move(favicons)));
 }
 
 void UpdatePartnersInModel(Profile* profile,
@@ -710,6 +840,7 @@ void UpdatePartnersInModel(Profile* profile,
                            absl::optional<base::Value> default_bookmarks_value,
                            UpdateCallback callback,
                            BookmarkModel* model) {
+  TRACE_EVENT0("startup", "vivaldi_default_bookmarks::UpdatePartnersInModel");
   bool ok = false;
   bool no_version = false;
   do {
@@ -722,10 +853,9 @@ void UpdatePartnersInModel(Profile* profile,
       break;
     }
 
-    // We parse default_bookmarks_value here after the bookmark model and
-    // vivaldi_partners database are loaded, not on a worker thread immediatelly
-    // after we read JSON in ReadDefaultBookmarks. The latter may run before
-    // vivaldi_partners are ready especially on Android.
+    // We parse default_bookmarks_value here after the bookmark model is
+    // loaded. The vivaldi_partners database is compiled into the binary and
+    // needs no loading.
     DefaultBookmarkTree default_tree;
     DefaultBookmarkParser bookmark_parser(default_tree);
     bookmark_parser.ParseJson(std::move(*default_bookmarks_value));
@@ -0,0 +1,277 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "browser/vivaldi_heap_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/containers/flat_map.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/format_macros.h"
+#include "base/logging.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/process/process_handle.h"
+#include "base/profiler/module_cache.h"
+#include "base/sampling_heap_profiler/sampling_heap_profiler.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+
+#include "base/vivaldi_switches.h"
+
+namespace vivaldi {
+
+namespace {
+
+constexpr base::TimeDelta kDefaultWriteInterval = base::Minutes(30);
+
+constexpr size_t kDefaultSamplingRateBytes = 1024 * 1024;
+
+// Critical memory pressure is signalled repeatedly while it lasts, one
+// profile per episode is enough.
+constexpr base::TimeDelta kMinPressureWriteInterval = base::Minutes(5);
+
+// Live samples aggregated by call stack. Stacks are inserted from the
+// outermost frame, so the common prefixes of the many stacks that start at
+// the same message loop and task runners are stored once.
+class StackTrie {
+ public:
+  StackTrie() { nodes_.emplace_back(nullptr, 0); }
+
+  // |stack| starts with the allocating frame as captured by
+  // SamplingHeapProfiler.
+  void Add(const std::vector<void*>& stack, size_t size, size_t total) {
+    uint32_t index = 0;
+    for (auto i = stack.rbegin(); i != stack.rend(); ++i) {
+      uint32_t child = static_cast<uint32_t>(nodes_.size());
+      auto inserted = nodes_[index].children.try_emplace(*i, child);
+      if (inserted.second) {
+        // This may move the nodes, so the iterator is not used after it.
+        nodes_.emplace_back(*i, index);
+      } else {
+        child = inserted.first->second;
+      }
+      index = child;
+    }
+    // |total| is the estimate of the bytes allocated at this site that the
+    // sample stands for, so scale the object count the same way.
+    size_t count = size ? std::max<size_t>(total / size, 1) : 1;
+    nodes_[index].count += count;
+    nodes_[index].bytes += total;
+    total_count_ += count;
+    total_bytes_ += total;
+  }
+
+  // Append the profile in the legacy heap_v2 text format. The values are
+  // already unsampled, so the format sampling period is 1 to tell pprof not
+  // to scale them again. Only live allocations are known, so they are also
+  // reported as the allocated totals.
+  void AppendProfile(std::string* out) const {
+    base::StringAppendF(out,
+                        "heap profile: %" PRIuS ": %" PRIuS " [%" PRIuS
+                        ": %" PRIuS "] @ heap_v2/1\n",
+                        total_count_, total_bytes_, total_count_,
+                        total_bytes_);
+    for (const Node& node : nodes_) {
+      if (!node.count)
+        continue;
+      base::StringAppendF(out,
+                          "%" PRIuS ": %" PRIuS " [%" PRIuS ": %" PRIuS "] @",
+                          node.count, node.bytes, node.count, node.bytes);
+      // Walking to the root gives the frames innermost first as pprof
+      // expects.
+      for (const Node* frame = &node; frame->frame;
+           frame = &nodes_[frame->parent]) {
+        base::StringAppendF(out, " 0x%" PRIxPTR,
+                            reinterpret_cast<uintptr_t>(frame->frame));
+      }
+      out->push_back('\n');
+    }
+  }
+
+ private:
+  struct Node {
+    Node(const void* frame, uint32_t parent) : frame(frame), parent(parent) {}
+
+    // The return address of this frame, null for the root.
+    const void* frame;
+    uint32_t parent;
+    base::flat_map<const void*, uint32_t> children;
+
+    // Totals for the samples whose stack ends at this frame.
+    size_t count = 0;
+    size_t bytes = 0;
+  };
+
+  std::vector<Node> nodes_;
+  size_t total_count_ = 0;
+  size_t total_bytes_ = 0;
+};
+
+class HeapProfileWriter {
+ public:
+  HeapProfileWriter(base::FilePath directory,
+                    base::TimeDelta interval,
+                    uint32_t profile_id)
+      : directory_(std::move(directory)),
+        interval_(interval),
+        profile_id_(profile_id),
+        task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+             base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+        memory_pressure_listener_(
+            FROM_HERE,
+            base::BindRepeating(&HeapProfileWriter::OnMemoryPressure,
+                                base::Unretained(this))) {}
+  HeapProfileWriter(const HeapProfileWriter&) = delete;
+  HeapProfileWriter& operator=(const HeapProfileWriter&) = delete;
+
+  // The writer lives until the process exits, so Unretained is safe.
+  void ScheduleWrite() {
+    task_runner_->PostDelayedTask(
+        FROM_HERE,
+        base::BindOnce(&HeapProfileWriter::WritePeriodically,
+                       base::Unretained(this)),
+        interval_);
+  }
+
+ private:
+  // Called on the sequence that created the writer.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level) {
+    if (level !=
+        base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL) {
+      return;
+    }
+    base::TimeTicks now = base::TimeTicks::Now();
+    if (!last_pressure_write_.is_null() &&
+        now - last_pressure_write_ < kMinPressureWriteInterval) {
+      return;
+    }
+    last_pressure_write_ = now;
+    task_runner_->PostTask(FROM_HERE,
+                           base::BindOnce(&HeapProfileWriter::Write,
+                                          base::Unretained(this)));
+  }
+
+  void WritePeriodically() {
+    Write();
+    ScheduleWrite();
+  }
+
+  void Write() {
+    DCHECK(task_runner_->RunsTasksInCurrentSequence());
+    StackTrie trie;
+    base::ModuleCache module_cache;
+    for (const base::SamplingHeapProfiler::Sample& sample :
+         base::SamplingHeapProfiler::Get()->GetSamples(profile_id_)) {
+      trie.Add(sample.stack, sample.size, sample.total);
+      for (const void* frame : sample.stack) {
+        module_cache.GetModuleForAddress(reinterpret_cast<uintptr_t>(frame));
+      }
+    }
+    std::string profile;
+    trie.AppendProfile(&profile);
+
+    // pprof maps the addresses to the binaries and their load addresses.
+    profile += "\nMAPPED_LIBRARIES:\n";
+    bool has_maps = false;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+    // The full map also gives the file offsets of the mappings.
+    std::string maps;
+    if (base::ReadFileToString(base::FilePath("/proc/self/maps"), &maps)) {
+      profile += maps;
+      has_maps = true;
+    }
+#endif
+    // Elsewhere, and if the map could not be read, write the modules that
+    // contain the sampled frames in the same line format.
+    if (!has_maps) {
+      for (const base::ModuleCache::Module* module :
+           module_cache.GetModules()) {
+        base::StringAppendF(&profile,
+                            "%" PRIxPTR "-%" PRIxPTR
+                            " r-xp 00000000 00:00 0 %" PRFilePath "\n",
+                            module->GetBaseAddress(),
+                            module->GetBaseAddress() + module->GetSize(),
+                            module->GetDebugBasename().value().c_str());
+      }
+    }
+
+    base::FilePath path = directory_.AppendASCII(base::StringPrintf(
+        "heap.%d.%d.heap", static_cast<int>(base::GetCurrentProcId()),
+        ++write_count_));
+    if (!base::WriteFile(path, profile)) {
+      LOG(ERROR) << "Failed to write heap profile " << path;
+    }
+  }
+
+  const base::FilePath directory_;
+  const base::TimeDelta interval_;
+  const uint32_t profile_id_;
+  const scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  base::MemoryPressureListener memory_pressure_listener_;
+  base::TimeTicks last_pressure_write_;
+  int write_count_ = 0;
+};
+
+// Set once when the profiling starts and never reset.
+std::atomic<HeapProfileWriter*> g_writer{nullptr};
+
+}  // namespace
+
+void StartHeapProfileIfEnabled() {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kVivaldiHeapProfile))
+    return;
+  base::FilePath directory =
+      command_line.GetSwitchValuePath(switches::kVivaldiHeapProfile);
+  if (directory.empty()) {
+    LOG(ERROR) << "--" << switches::kVivaldiHeapProfile
+               << " requires a directory";
+    return;
+  }
+
+  base::TimeDelta interval = kDefaultWriteInterval;
+  int minutes = 0;
+  if (base::StringToInt(command_line.GetSwitchValueASCII(
+                            switches::kVivaldiHeapProfileInterval),
+                        &minutes) &&
+      minutes > 0) {
+    interval = base::Minutes(minutes);
+  }
+  size_t sampling_rate = kDefaultSamplingRateBytes;
+  size_t rate = 0;
+  if (base::StringToSizeT(command_line.GetSwitchValueASCII(
+                              switches::kVivaldiHeapProfileSamplingRate),
+                          &rate) &&
+      rate > 0) {
+    sampling_rate = rate;
+  }
+
+  if (g_writer.load())
+    return;
+  base::SamplingHeapProfiler* profiler = base::SamplingHeapProfiler::Get();
+  base::SamplingHeapProfiler::Init();
+  profiler->SetSamplingInterval(sampling_rate);
+  uint32_t profile_id = profiler->Start();
+
+  // Leaked as the sampling runs until exit. Created here on the UI thread,
+  // which then receives the memory pressure notifications.
+  HeapProfileWriter* writer =
+      new HeapProfileWriter(std::move(directory), interval, profile_id);
+  g_writer.store(writer);
+  writer->ScheduleWrite();
+}
+
+}  // namespace vivaldi
@@ -0,0 +1,27 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#ifndef BROWSER_VIVALDI_HEAP_PROFILE_H_
+#define BROWSER_VIVALDI_HEAP_PROFILE_H_
+
+namespace vivaldi {
+
+// Start sampling heap allocations of the browser process if the
+// --vivaldi-heap-profile=<directory> switch is given. The live samples are
+// then written every --vivaldi-heap-profile-interval minutes, 30 by default,
+// to heap.<pid>.<n>.heap files in the directory. Allocations are sampled on
+// average once per --vivaldi-heap-profile-sampling-rate bytes, 1 MB by
+// default, which keeps the overhead low enough for long sessions.
+//
+// A profile is also written right away when the system reports critical
+// memory pressure, at most once every five minutes.
+//
+// The files use the legacy text heap profile format that pprof reads. They
+// contain only addresses and the load addresses of the modules, so they are
+// symbolized offline against the matching binaries, like
+//
+//   pprof -http=: vivaldi heap.1234.5.heap
+void StartHeapProfileIfEnabled();
+
+}  // namespace vivaldi
+
+#endif  // BROWSER_VIVALDI_HEAP_PROFILE_H_
@@ -0,0 +1,365 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "browser/vivaldi_host_warmup.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/adapters.h"
+#include "base/containers/contains.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/memory/weak_ptr.h"
+#include "base/scoped_observation.h"
+#include "base/supports_user_data.h"
+#include "base/task/thread_pool.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
+#include "chrome/browser/bookmarks/bookmark_model_factory.h"
+#include "chrome/browser/history/history_service_factory.h"
+#include "chrome/browser/predictors/loading_predictor.h"
+#include "chrome/browser/predictors/loading_predictor_factory.h"
+#include "chrome/browser/predictors/preconnect_manager.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/profiles/profile_observer.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_list.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/history/core/browser/history_service.h"
+#include "components/history/core/browser/history_service_observer.h"
+#include "components/keyed_service/core/service_access_type.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/web_contents.h"
+#include "net/base/network_isolation_key.h"
+#include "net/base/schemeful_site.h"
+#include "ui/base/models/tree_node_iterator.h"
+#include "url/gurl.h"
+
+#include "browser/translate/vivaldi_translate_server_request.h"
+#include "components/bookmarks/vivaldi_bookmark_kit.h"
+
+namespace vivaldi {
+
+namespace {
+
+constexpr base::FilePath::CharType kHostWarmupFileName[] =
+    FILE_PATH_LITERAL("Vivaldi Warmup Hosts");
+
+const char kHostWarmupUserDataKey[] = "vivaldi_host_warmup";
+
+// Enough for the tabs of a typical session and the Speed Dials without
+// flooding the resolver on start.
+constexpr size_t kMaxOrigins = 100;
+
+constexpr base::TimeDelta kCollectInterval = base::Minutes(10);
+
+// Socket budget for restored active tabs. Each preconnected origin gets one
+// socket, which an idle connection pool keeps for a while, so more would only
+// compete with the loads themselves.
+constexpr size_t kMaxRestorePreconnects = 6;
+
+// Number of background tab origins resolved ahead of their load.
+constexpr size_t kMaxRestorePreresolves = 16;
+
+// Services the browser talks to on its own shortly after start, like the
+// stats reporter and the update checks.
+constexpr const char* kServiceUrls[] = {
+    "https://update.vivaldi.com/",
+};
+
+std::vector<GURL> ReadOrigins(base::FilePath path) {
+  std::vector<GURL> origins;
+  std::string json;
+  if (!base::ReadFileToString(path, &json))
+    return origins;
+  absl::optional<base::Value> value = base::JSONReader::Read(json);
+  if (!value || !value->is_list())
+    return origins;
+  for (const base::Value& item : value->GetList()) {
+    if (!item.is_string())
+      continue;
+    GURL origin(item.GetString());
+    if (origin.is_valid() && origin.SchemeIsHTTPOrHTTPS())
+      origins.push_back(std::move(origin));
+    if (origins.size() == kMaxOrigins)
+      break;
+  }
+  return origins;
+}
+
+// Owned by the profile as its user data.
+class HostWarmup : public base::SupportsUserData::Data,
+                   public ProfileObserver,
+                   public history::HistoryServiceObserver,
+                   public base::ImportantFileWriter::DataSerializer {
+ public:
+  explicit HostWarmup(Profile* profile)
+      : profile_(profile),
+        task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+             base::TaskShutdownBehavior::BLOCK_SHUTDOWN})),
+        writer_(profile->GetPath().Append(kHostWarmupFileName),
+                task_runner_,
+                "VivaldiHostWarmup") {
+    profile->AddObserver(this);
+    if (history::HistoryService* history_service =
+            HistoryServiceFactory::GetForProfile(
+                profile, ServiceAccessType::EXPLICIT_ACCESS)) {
+      history_observation_.Observe(history_service);
+    }
+    task_runner_->PostTaskAndReplyWithResult(
+        FROM_HERE, base::BindOnce(&ReadOrigins, writer_.path()),
+        base::BindOnce(&HostWarmup::OnOriginsLoaded,
+                       weak_factory_.GetWeakPtr()));
+  }
+  HostWarmup(const HostWarmup&) = delete;
+  HostWarmup& operator=(const HostWarmup&) = delete;
+
+  ~HostWarmup() override {
+    // Windows are closed by now, so keep what was collected while they were
+    // open.
+    if (writer_.HasPendingWrite())
+      writer_.DoScheduledWrite();
+  }
+
+  static HostWarmup* FromProfile(Profile* profile) {
+    return static_cast<HostWarmup*>(
+        profile->GetUserData(kHostWarmupUserDataKey));
+  }
+
+  // Forget the origins and delete the file. The origins of the open tabs are
+  // collected again on the next timer run.
+  void Clear() {
+    cleared_ = true;
+    origins_.clear();
+
+    // The deletion runs on the writer's sequence after any pending write.
+    if (writer_.HasPendingWrite())
+      writer_.DoScheduledWrite();
+    task_runner_->PostTask(FROM_HERE,
+                           base::GetDeleteFileCallback(writer_.path()));
+  }
+
+ private:
+  void OnOriginsLoaded(std::vector<GURL> origins) {
+    // Origins from a file that was cleared while it was read must not be
+    // resolved.
+    if (!cleared_) {
+      origins_ = std::move(origins);
+      Preresolve();
+    }
+
+    // Unretained is safe as the timer is owned by this.
+    collect_timer_.Start(FROM_HERE, kCollectInterval,
+                         base::BindRepeating(&HostWarmup::CollectOrigins,
+                                             base::Unretained(this)));
+  }
+
+  void Preresolve() {
+    predictors::LoadingPredictor* predictor =
+        predictors::LoadingPredictorFactory::GetForProfile(profile_);
+    if (!predictor)
+      return;
+    predictors::PreconnectManager* preconnect_manager =
+        predictor->preconnect_manager();
+
+    // The preconnect manager puts each new job in front of its queue, so add
+    // the origins in reverse to resolve them in the order they were saved.
+    for (const GURL& origin : base::Reversed(origins_)) {
+      net::SchemefulSite site(origin);
+      preconnect_manager->StartPreresolveHost(
+          origin, net::NetworkIsolationKey(site, site));
+    }
+  }
+
+  void CollectOrigins() {
+    std::vector<GURL> origins;
+    auto add = [&origins](const GURL& url) {
+      if (origins.size() == kMaxOrigins || !url.SchemeIsHTTPOrHTTPS())
+        return;
+      GURL origin = url.DeprecatedGetOriginAsURL();
+      if (!base::Contains(origins, origin))
+        origins.push_back(std::move(origin));
+    };
+
+    // Session restore loads the active tab of each window first.
+    for (Browser* browser : *BrowserList::GetInstance()) {
+      if (browser->profile() != profile_ || !browser->is_type_normal())
+        continue;
+      TabStripModel* tab_strip = browser->tab_strip_model();
+      if (content::WebContents* active = tab_strip->GetActiveWebContents())
+        add(active->GetLastCommittedURL());
+      for (int i = 0; i < tab_strip->count(); ++i) {
+        add(tab_strip->GetWebContentsAt(i)->GetLastCommittedURL());
+      }
+    }
+
+    bookmarks::BookmarkModel* bookmark_model =
+        BookmarkModelFactory::GetForBrowserContext(profile_);
+    if (bookmark_model && bookmark_model->loaded()) {
+      ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(
+          bookmark_model->root_node());
+      while (iterator.has_next()) {
+        const bookmarks::BookmarkNode* node = iterator.Next();
+        if (!node->is_folder() || !vivaldi_bookmark_kit::GetSpeeddial(node))
+          continue;
+        for (const auto& child : node->children()) {
+          if (child->is_url())
+            add(child->url());
+        }
+      }
+    }
+
+    for (const char* url : kServiceUrls) {
+      add(GURL(url));
+    }
+    add(GURL(VivaldiTranslateServerRequest::GetServer()));
+
+    if (origins == origins_)
+      return;
+    origins_ = std::move(origins);
+    writer_.ScheduleWrite(this);
+  }
+
+  // ProfileObserver:
+  void OnProfileWillBeDestroyed(Profile* profile) override {
+    profile->RemoveObserver(this);
+    history_observation_.Reset();
+
+    // This deletes this.
+    profile->RemoveUserData(kHostWarmupUserDataKey);
+  }
+
+  // history::HistoryServiceObserver:
+  void OnURLsDeleted(history::HistoryService* history_service,
+                     const history::DeletionInfo& deletion_info) override {
+    // The origins are a summary of the browsing history. Any deletion may
+    // cover some of them, so drop all.
+    Clear();
+  }
+
+  void HistoryServiceBeingDeleted(
+      history::HistoryService* history_service) override {
+    history_observation_.Reset();
+  }
+
+  // base::ImportantFileWriter::DataSerializer:
+  bool SerializeData(std::string* data) override {
+    base::Value::List list;
+    for (const GURL& origin : origins_) {
+      list.Append(origin.spec());
+    }
+    return base::JSONWriter::Write(list, data);
+  }
+
+  Profile* const profile_;
+  const scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  base::ImportantFileWriter writer_;
+  base::RepeatingTimer collect_timer_;
+  base::ScopedObservation<history::HistoryService,
+                          history::HistoryServiceObserver>
+      history_observation_{this};
+
+  // Origins in the order to resolve them on the next start.
+  std::vector<GURL> origins_;
+
+  // True after Clear() was called.
+  bool cleared_ = false;
+
+  base::WeakPtrFactory<HostWarmup> weak_factory_{this};
+};
+
+GURL GetRestoredOrigin(content::WebContents* contents) {
+  content::NavigationEntry* entry =
+      contents->GetController().GetLastCommittedEntry();
+  if (!entry || !entry->GetURL().SchemeIsHTTPOrHTTPS())
+    return GURL();
+  return entry->GetURL().DeprecatedGetOriginAsURL();
+}
+
+}  // namespace
+
+void StartHostWarmup(Profile* profile) {
+  if (profile->IsOffTheRecord() || HostWarmup::FromProfile(profile))
+    return;
+  profile->SetUserData(kHostWarmupUserDataKey,
+                       std::make_unique<HostWarmup>(profile));
+}
+
+void ClearHostWarmup(Profile* profile) {
+  if (HostWarmup* host_warmup = HostWarmup::FromProfile(profile)) {
+    host_warmup->Clear();
+  } else if (!profile->IsOffTheRecord()) {
+    // Not started yet, the file may still be left from the last session.
+    base::ThreadPool::PostTask(
+        FROM_HERE,
+        {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::BLOCK_SHUTDOWN},
+        base::GetDeleteFileCallback(
+            profile->GetPath().Append(kHostWarmupFileName)));
+  }
+}
+
+void WarmUpRestoredTabs(
+    const std::vector<SessionRestoreDelegate::RestoredTab>& tabs) {
+  if (tabs.empty())
+    return;
+  Profile* profile = Profile::FromBrowserContext(
+      tabs.front().contents()->GetBrowserContext());
+  predictors::LoadingPredictor* predictor =
+      predictors::LoadingPredictorFactory::GetForProfile(profile);
+  if (!predictor)
+    return;
+
+  // TabLoader loads the active tabs first and then the rest in the order of
+  // RestoredTab::operator<.
+  std::vector<SessionRestoreDelegate::RestoredTab> ordered(tabs);
+  std::stable_sort(ordered.begin(), ordered.end());
+  std::stable_partition(
+      ordered.begin(), ordered.end(),
+      [](const SessionRestoreDelegate::RestoredTab& restored_tab) {
+        return restored_tab.is_active();
+      });
+
+  std::vector<GURL> preconnects;
+  std::vector<GURL> preresolves;
+  for (const SessionRestoreDelegate::RestoredTab& restored_tab : ordered) {
+    GURL origin = GetRestoredOrigin(restored_tab.contents());
+    if (origin.is_empty() || base::Contains(preconnects, origin) ||
+        base::Contains(preresolves, origin)) {
+      continue;
+    }
+    if (restored_tab.is_active() &&
+        preconnects.size() < kMaxRestorePreconnects) {
+      preconnects.push_back(std::move(origin));
+    } else if (preresolves.size() < kMaxRestorePreresolves) {
+      preresolves.push_back(std::move(origin));
+    } else {
+      break;
+    }
+  }
+
+  // Jobs are put in front of the preconnect manager's queue, so add them
+  // last to first. This also puts them ahead of the start-up warmup.
+  predictors::PreconnectManager* preconnect_manager =
+      predictor->preconnect_manager();
+  for (const GURL& origin : base::Reversed(preresolves)) {
+    net::SchemefulSite site(origin);
+    preconnect_manager->StartPreresolveHost(
+        origin, net::NetworkIsolationKey(site, site));
+  }
+  for (const GURL& origin : base::Reversed(preconnects)) {
+    net::SchemefulSite site(origin);
+    preconnect_manager->StartPreconnectUrl(
+        origin, /*allow_credentials=*/true,
+        net::NetworkIsolationKey(site, site));
+  }
+}
+
+}  // namespace vivaldi
@@ -0,0 +1,38 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#ifndef BROWSER_VIVALDI_HOST_WARMUP_H_
+#define BROWSER_VIVALDI_HOST_WARMUP_H_
+
+#include <vector>
+
+#include "chrome/browser/sessions/session_restore_delegate.h"
+
+class Profile;
+
+namespace vivaldi {
+
+// Remembers in the profile directory the origins the browser connects to
+// right after a start: the origins of open tabs in the order the session
+// restores them, then Speed Dial and Vivaldi service origins. On the next
+// start their hosts are resolved before the first navigation, so restored
+// tabs and the UI find the addresses in the host cache instead of all
+// waiting on DNS at once. The list is refreshed periodically in the
+// background while the profile lives and holds only what was open or in Speed
+// Dial at the last refresh.
+void StartHostWarmup(Profile* profile);
+
+// Forget the remembered origins and delete their file. This is called when
+// browsing history is deleted as the origins reveal it. Deletions through
+// HistoryService are also seen without this call.
+void ClearHostWarmup(Profile* profile);
+
+// Warm up the network for |tabs| that session restore is about to load. The
+// origins are taken in the order TabLoader loads the tabs: sockets are
+// preconnected for the active tabs, which load as soon as they are attached,
+// and the hosts of the following tabs are resolved ahead of their turn.
+void WarmUpRestoredTabs(
+    const std::vector<SessionRestoreDelegate::RestoredTab>& tabs);
+
+}  // namespace vivaldi
+
+#endif  // BROWSER_VIVALDI_HOST_WARMUP_H_
@@ -0,0 +1,148 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "browser/vivaldi_pref_shards.h"
+
+#include <iterator>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/hash/hash.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/values.h"
+#include "components/prefs/json_pref_store.h"
+#include "components/prefs/persistent_pref_store.h"
+#include "components/prefs/segregated_pref_store.h"
+
+#include "prefs/vivaldi_gen_prefs.h"
+
+namespace vivaldi {
+
+namespace {
+
+struct PrefShard {
+  const base::FilePath::CharType* file_name;
+  const char* const* pref_names;
+  size_t pref_count;
+};
+
+// Themes embed their settings and are rewritten as a whole on every edit.
+const char* const kThemePrefs[] = {
+    vivaldiprefs::kThemesPreview,
+    vivaldiprefs::kThemesSystem,
+    vivaldiprefs::kThemesUser,
+};
+
+const PrefShard kPrefShards[] = {
+    {FILE_PATH_LITERAL("Vivaldi Theme Preferences"), kThemePrefs,
+     std::size(kThemePrefs)},
+};
+
+// Dictionary in a shard file with the hash of the value of each preference in
+// the main store when it was last copied to the shard.
+const char kCopiedHashesKey[] = "vivaldi_copied_pref_hashes";
+
+std::string HashValue(const base::Value& value) {
+  std::string json;
+  base::JSONWriter::Write(value, &json);
+  return base::NumberToString(base::PersistentHash(json));
+}
+
+// Copies the values of the shard preferences from the main store before the
+// combined store reports its initialization. It observes both stores before
+// the SegregatedPrefStore does, so it runs ahead of it on the last load.
+class ShardMigrator : public PrefStore::Observer {
+ public:
+  ShardMigrator(scoped_refptr<PersistentPrefStore> main_store,
+                scoped_refptr<PersistentPrefStore> shard_store,
+                std::set<std::string> pref_names)
+      : main_store_(std::move(main_store)),
+        shard_store_(std::move(shard_store)),
+        pref_names_(std::move(pref_names)) {
+    main_store_->AddObserver(this);
+    shard_store_->AddObserver(this);
+  }
+  ShardMigrator(const ShardMigrator&) = delete;
+  ShardMigrator& operator=(const ShardMigrator&) = delete;
+
+  // PrefStore::Observer:
+  void OnPrefValueChanged(const std::string& key) override {}
+  void OnInitializationCompleted(bool succeeded) override {
+    if (!main_store_->IsInitializationComplete() ||
+        !shard_store_->IsInitializationComplete()) {
+      return;
+    }
+    main_store_->RemoveObserver(this);
+    shard_store_->RemoveObserver(this);
+    if (!main_store_->ReadOnly() && !shard_store_->ReadOnly())
+      Migrate();
+    delete this;
+  }
+
+ private:
+  ~ShardMigrator() override = default;
+
+  void Migrate() {
+    base::Value::Dict copied_hashes;
+    const base::Value* copied_hashes_value = nullptr;
+    if (shard_store_->GetValue(kCopiedHashesKey, &copied_hashes_value) &&
+        copied_hashes_value->is_dict()) {
+      copied_hashes = copied_hashes_value->GetDict().Clone();
+    }
+    bool copied = false;
+    for (const std::string& name : pref_names_) {
+      const base::Value* main_value = nullptr;
+      if (!main_store_->GetValue(name, &main_value))
+        continue;
+      // The value stays in the main store for versions that do not read the
+      // shard. If such a version changed it since it was copied, it is newer
+      // than the shard.
+      std::string hash = HashValue(*main_value);
+      const std::string* copied_hash = copied_hashes.FindString(name);
+      const base::Value* shard_value = nullptr;
+      if (shard_store_->GetValue(name, &shard_value) && copied_hash &&
+          *copied_hash == hash) {
+        continue;
+      }
+      shard_store_->SetValueSilently(
+          name, base::Value::ToUniquePtrValue(main_value->Clone()),
+          WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+      copied_hashes.Set(name, std::move(hash));
+      copied = true;
+    }
+    if (copied) {
+      shard_store_->SetValueSilently(
+          kCopiedHashesKey,
+          std::make_unique<base::Value>(std::move(copied_hashes)),
+          WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+    }
+  }
+
+  const scoped_refptr<PersistentPrefStore> main_store_;
+  const scoped_refptr<PersistentPrefStore> shard_store_;
+  const std::set<std::string> pref_names_;
+};
+
+}  // namespace
+
+PersistentPrefStore* AddVivaldiPrefShards(
+    PersistentPrefStore* store,
+    const base::FilePath& profile_path,
+    scoped_refptr<base::SequencedTaskRunner> io_task_runner) {
+  for (const PrefShard& shard : kPrefShards) {
+    std::set<std::string> pref_names(shard.pref_names,
+                                     shard.pref_names + shard.pref_count);
+    PersistentPrefStore* shard_store = new JsonPrefStore(
+        profile_path.Append(shard.file_name), nullptr, io_task_runner);
+    // Manages its own lifetime.
+    new ShardMigrator(store, shard_store, pref_names);
+    store = new SegregatedPrefStore(store, shard_store, std::move(pref_names));
+  }
+  return store;
+}
+
+}  // namespace vivaldi
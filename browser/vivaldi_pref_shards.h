@@ -0,0 +1,38 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#ifndef BROWSER_VIVALDI_PREF_SHARDS_H_
+#define BROWSER_VIVALDI_PREF_SHARDS_H_
+
+#include "base/memory/scoped_refptr.h"
+
+class PersistentPrefStore;
+
+namespace base {
+class FilePath;
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace vivaldi {
+
+// Wrap the profile |store| so the large Vivaldi preference subtrees, like the
+// user themes, are kept in their own files in |profile_path|. Each file is
+// written only when its own preferences change, so a small change elsewhere
+// does not rewrite them and a theme edit does not rewrite the Preferences
+// file.
+//
+// Values still in |store| from before the split are copied to their shard
+// when the stores load. They are kept in |store| so a downgrade to a version
+// without the shards still finds them, and when such a version changed them,
+// they are copied again on the next load.
+//
+// Like |store| and the return value of
+// ProfilePrefStoreManager::CreateProfilePrefStore(), the result is not yet
+// referenced.
+PersistentPrefStore* AddVivaldiPrefShards(
+    PersistentPrefStore* store,
+    const base::FilePath& profile_path,
+    scoped_refptr<base::SequencedTaskRunner> io_task_runner);
+
+}  // namespace vivaldi
+
+#endif  // BROWSER_VIVALDI_PREF_SHARDS_H_
@@ -194,7 +194,9 @@ EnabledSet& GetEnabledImpl(content::BrowserContext* browser_context) {
     auto holder_instance = std::make_unique<EnabledSetHolder>();
     holder_instance->enabled_set = CreateEnabledSet(profile->GetPrefs());
     holder = holder_instance.get();
-    browser_context->SetUserData(kContextKey, std::move(holder_instance));
+    // Store on the original profile as that is where the holder is looked up.
+    // Otherwise each check from an off-the-record profile would recreate it.
+    profile->SetUserData(kContextKey, std::move(holder_instance));
   }
   return holder->enabled_set;
 }
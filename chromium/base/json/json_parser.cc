@@ -210,6 +210,15 @@ void JSONParser::StringBuilder::Append(base_icu::UChar32 point) {
   }
 }
 
+void JSONParser::StringBuilder::AppendASCII(StringPiece ascii) {
+  if (!string_) {
+    DCHECK_EQ(ascii.data(), pos_ + length_);
+    length_ += ascii.length();
+  } else {
+    string_->append(ascii.data(), ascii.length());
+  }
+}
+
 void JSONParser::StringBuilder::Convert() {
   if (string_)
     return;
@@ -530,6 +539,23 @@ bool JSONParser::ConsumeStringRaw(StringBuilder* out) {
   StringBuilder string(pos());
 
   while (PeekChar()) {
+    // Vivaldi: Most string content is printable ASCII that needs no
+    // decoding, escaping or line tracking. Take such a run in one step rather
+    // than decoding it character by character below.
+    size_t run_end = index_;
+    while (run_end < input_.length()) {
+      unsigned char c = static_cast<unsigned char>(input_[run_end]);
+      if (c < 0x20 || c >= kExtendedASCIIStart || c == '"' || c == '\\')
+        break;
+      ++run_end;
+    }
+    if (run_end != index_) {
+      string.AppendASCII(
+          StringPiece(input_.data() + index_, run_end - index_));
+      index_ = run_end;
+      continue;
+    }
+
     base_icu::UChar32 next_char = 0;
     if (!ReadUnicodeCharacter(input_.data(), input_.length(), &index_,
                               &next_char) ||
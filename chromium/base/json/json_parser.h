@@ -136,6 +136,10 @@ class BASE_EXPORT JSONParser {
     // converted, or by appending the UTF8 bytes for the code point.
     void Append(base_icu::UChar32 point);
 
+    // Vivaldi: Appends |ascii|, a run of ASCII characters from the input
+    // that directly follows what was appended so far.
+    void AppendASCII(StringPiece ascii);
+
     // Converts the builder from its default StringPiece to a full std::string,
     // performing a copy. Once a builder is converted, it cannot be made a
     // StringPiece again.
@@ -64,6 +64,21 @@ TEST_F(JSONParserTest, ConsumeString) {
   EXPECT_EQ("test", value->GetString());
 }
 
+// Vivaldi: ASCII runs are taken in bulk, make sure they combine
+// correctly with escapes and multi-byte characters around them.
+TEST_F(JSONParserTest, ConsumeStringMixedRuns) {
+  std::string input("\"ab\\ncd\xC3\xA9" "ef\\u0041gh\",|");
+  std::unique_ptr<JSONParser> parser(NewTestParser(input));
+  absl::optional<Value> value(parser->ConsumeString());
+  EXPECT_EQ(',', *parser->pos());
+
+  TestLastThree(parser.get());
+
+  ASSERT_TRUE(value);
+  ASSERT_TRUE(value->is_string());
+  EXPECT_EQ("ab\ncd\xC3\xA9" "efAgh", value->GetString());
+}
+
 TEST_F(JSONParserTest, ConsumeList) {
   std::string input("[true, false],|");
   std::unique_ptr<JSONParser> parser(NewTestParser(input));
@@ -127,4 +127,56 @@ TYPED_TEST(ObserverListPerfTest, NotifyPerformance) {
   }
 }
 
+// Vivaldi: Measures notifications where an observer removes itself
+// while the list is iterated, like tab and bookmark observers do when their
+// UI goes away. The removed entry is left as a tombstone and dropped when the
+// iteration ends, so this also covers the compaction cost.
+TYPED_TEST(ObserverListPerfTest, NotifyWithRemovalPerformance) {
+  constexpr int kMaxObservers = 128;
+#if DCHECK_IS_ON()
+  constexpr int kLaps = 1000000;
+#else
+  constexpr int kLaps = 100000000;
+#endif
+  std::vector<std::unique_ptr<TypeParam>> observers;
+
+  for (int observer_count = 1; observer_count <= kMaxObservers;
+       observer_count *= 2) {
+    typename TestFixture::ObserverListType list;
+    for (int i = 0; i < observer_count; ++i)
+      observers.push_back(std::make_unique<TypeParam>());
+    for (auto& o : observers)
+      list.AddObserver(o.get());
+
+    g_observer_list_perf_test_counter = 0;
+    const int weighted_laps = kLaps / (observer_count + 1);
+    TypeParam* removed = observers.front().get();
+
+    TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < weighted_laps; ++i) {
+      for (auto& o : list) {
+        o.Observe();
+        if (&o == removed)
+          list.RemoveObserver(removed);
+      }
+      list.AddObserver(removed);
+    }
+    TimeDelta duration = TimeTicks::Now() - start;
+
+    observers.clear();
+
+    EXPECT_EQ(observer_count * weighted_laps,
+              g_observer_list_perf_test_counter);
+
+    std::string story_name = base::StringPrintf(
+        "%s_removal_%d", Pick<TypeParam>::GetName(), observer_count);
+    auto reporter = SetUpReporter(story_name);
+    reporter.AddResult(
+        kMetricNotifyTimePerObserver,
+        duration.InNanoseconds() /
+            static_cast<double>(g_observer_list_perf_test_counter +
+                                weighted_laps));
+  }
+}
+
 }  // namespace base
@@ -173,6 +173,7 @@
   X("ValueStoreFrontend::Backend")                                       \
   X("views")                                                             \
   X("views.frame")                                                       \
+  X("vivaldi")                                                           \
   X("viz")                                                               \
   X("vk")                                                                \
   X("wayland")                                                           \
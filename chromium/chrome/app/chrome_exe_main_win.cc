@@ -7,6 +7,7 @@
 #include <windows.h>
 
 #include <malloc.h>
+#include <sddl.h>
 #include <stddef.h>
 #include <tchar.h>
 
@@ -57,6 +58,8 @@
 #include "content/public/common/result_codes.h"
 #include "third_party/crashpad/crashpad/util/win/initial_client_data.h"
 
+#include "installer/util/vivaldi_static_install_helpers.h"
+
 #if defined(WIN_CONSOLE_APP)
 // Forward declaration of main.
 int main();
@@ -84,6 +87,34 @@ void SetCwdForBrowserProcess() {
           .DirName());
 }
 
+// Vivaldi: Open the browser instance mutex of this installation and keep
+// it open until the process exits so the installer can detect running
+// instances and wait for them without enumerating all processes. This is a
+// best effort, sandboxed processes may fail to open the mutex.
+void HoldVivaldiInstanceMutex() {
+  std::array<wchar_t, MAX_PATH + 1> exe_path;
+  DWORD length = ::GetModuleFileName(nullptr, &exe_path[0], exe_path.size());
+  if (!length || length >= exe_path.size())
+    return;
+  std::wstring mutex_name = vivaldi::GetBrowserInstanceMutexName(&exe_path[0]);
+  if (mutex_name.empty())
+    return;
+
+  // Let processes of other users in other sessions open the mutex for
+  // synchronization so their instances are counted as well.
+  PSECURITY_DESCRIPTOR security_descriptor = nullptr;
+  if (!::ConvertStringSecurityDescriptorToSecurityDescriptor(
+          L"D:(A;;GA;;;SY)(A;;GA;;;OW)(A;;0x100000;;;WD)", SDDL_REVISION_1,
+          &security_descriptor, nullptr)) {
+    return;
+  }
+  SECURITY_ATTRIBUTES security_attributes = {sizeof(SECURITY_ATTRIBUTES),
+                                             security_descriptor, FALSE};
+  // The handle is leaked intentionally, the system closes it on exit.
+  ::CreateMutexEx(&security_attributes, mutex_name.c_str(), 0, SYNCHRONIZE);
+  ::LocalFree(security_descriptor);
+}
+
 bool IsFastStartSwitch(const std::string& command_line_switch) {
   return command_line_switch == switches::kProfileDirectory;
 }
@@ -282,6 +313,8 @@ int main() {
 
   SetCwdForBrowserProcess();
   install_static::InitializeFromPrimaryModule();
+  // Vivaldi
+  HoldVivaldiInstanceMutex();
   SignalInitializeCrashReporting();
   if (IsBrowserProcess())
     chrome::DisableDelayLoadFailureHooksForMainExecutable();
@@ -16,6 +16,7 @@
 #include "components/bookmarks/browser/bookmark_storage.h"
 #include "components/bookmarks/managed/managed_bookmark_service.h"
 #include "components/bookmarks/managed/managed_bookmark_util.h"
+#include "components/favicon/core/favicon_service.h"
 #include "components/favicon/core/favicon_util.h"
 #include "components/favicon_base/favicon_types.h"
 #include "components/history/core/browser/history_service.h"
@@ -24,6 +25,7 @@
 #include "components/prefs/pref_service.h"
 #include "components/sync/base/pref_names.h"
 #include "components/sync_bookmarks/bookmark_sync_service.h"
+#include "ui/gfx/favicon_size.h"
 
 #if BUILDFLAG(ENABLE_OFFLINE_PAGES)
 #include "chrome/browser/offline_pages/offline_page_bookmark_observer.h"
@@ -71,6 +73,19 @@ ChromeBookmarkClient::GetFaviconImageForPageURL(
       page_url, favicon_base::IconType::kFavicon, std::move(callback), tracker);
 }
 
+void ChromeBookmarkClient::GetFaviconImagesForPageURLs(
+    const std::vector<GURL>& page_urls,
+    favicon_base::FaviconImagesCallback callback,
+    base::CancelableTaskTracker* tracker) {
+  favicon::FaviconService* favicon_service =
+      FaviconServiceFactory::GetForProfile(profile_,
+                                           ServiceAccessType::EXPLICIT_ACCESS);
+  if (!favicon_service)
+    return;
+  favicon_service->GetFaviconImagesForPageURLs(page_urls, gfx::kFaviconSize,
+                                               std::move(callback), tracker);
+}
+
 bool ChromeBookmarkClient::SupportsTypedCountForUrls() {
   return true;
 }
@@ -53,6 +53,10 @@ class ChromeBookmarkClient : public bookmarks::BookmarkClient {
       const GURL& page_url,
       favicon_base::FaviconImageCallback callback,
       base::CancelableTaskTracker* tracker) override;
+  void GetFaviconImagesForPageURLs(
+      const std::vector<GURL>& page_urls,
+      favicon_base::FaviconImagesCallback callback,
+      base::CancelableTaskTracker* tracker) override;
   bool SupportsTypedCountForUrls() override;
   void GetTypedCountForUrls(UrlTypedCountMap* url_typed_count_map) override;
   bool IsPermanentNodeVisibleWhenEmpty(
@@ -189,6 +189,10 @@
 #include "chrome/browser/media/cdm_document_service_impl.h"
 #endif  // BUILDFLAG(IS_WIN)
 
+#if !BUILDFLAG(IS_ANDROID)
+#include "browser/vivaldi_host_warmup.h"
+#endif
+
 using base::UserMetricsAction;
 using content::BrowserContext;
 using content::BrowserThread;
@@ -468,6 +472,12 @@ void ChromeBrowsingDataRemoverDelegate::RemoveEmbedderData(
         filter_builder->BuildNetworkServiceFilter(),
         CreateTaskCompletionClosureForMojo(TracingDataType::kHostCache));
 
+#if !BUILDFLAG(IS_ANDROID)
+    // Vivaldi: The hosts resolved on start are collected from the visited
+    // pages, clear them along with the host cache.
+    vivaldi::ClearHostWarmup(profile_);
+#endif
+
     // The NoStatePrefetchManager keeps history of pages scanned for prefetch,
     // so clear that. It also may have a scanned page. If so, the page could be
     // considered to have a small amount of historical information, so delete
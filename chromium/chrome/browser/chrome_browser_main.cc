@@ -341,6 +341,7 @@
 #endif  // BUILDFLAG(IS_WIN) && BUILDFLAG(USE_BROWSER_SPELLCHECKER)
 
 #include "app/vivaldi_apptools.h"
+#include "browser/vivaldi_heap_profile.h"
 
 namespace {
 
@@ -821,6 +822,9 @@ void ChromeBrowserMainParts::PostCreateMainMessageLoop() {
 
   ThreadProfiler::SetMainThreadTaskRunner(base::ThreadTaskRunnerHandle::Get());
 
+  // Vivaldi: Opt-in heap profile export for long sessions.
+  vivaldi::StartHeapProfileIfEnabled();
+
   // TODO(sebmarchand): Allow this to be created earlier if startup tracing is
   // enabled.
   trace_event_system_stats_monitor_ =
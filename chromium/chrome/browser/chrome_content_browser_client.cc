@@ -1765,6 +1765,14 @@ bool ChromeContentBrowserClient::ShouldUseProcessPerSite(
     return true;
   }
 
+  // Vivaldi: Likewise for the Vivaldi start page. It is a blank page
+  // the UI draws the Speed Dials over, so all tabs showing it can share one
+  // renderer instead of each getting its own.
+  if (site_url.SchemeIs(content::kChromeUIScheme) &&
+      site_url.host_piece() == vivaldi::kVivaldiWebUIHost) {
+    return true;
+  }
+
 #if !BUILDFLAG(IS_ANDROID)
   if (search::ShouldUseProcessPerSiteForInstantSiteURL(site_url, profile))
     return true;
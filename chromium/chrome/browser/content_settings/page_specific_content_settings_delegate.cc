@@ -128,6 +128,7 @@ void GetGuestViewDefaultContentSettingRules(
       content_settings::ContentSettingToValue(CONTENT_SETTING_BLOCK),
       std::string(), incognito));
 #if defined(VIVALDI_BUILD)
+  rules->autoplay_rules.clear();
   rules->autoplay_rules.push_back(ContentSettingPatternSource(
       ContentSettingsPattern::Wildcard(), ContentSettingsPattern::Wildcard(),
       content_settings::ContentSettingToValue(CONTENT_SETTING_ALLOW),
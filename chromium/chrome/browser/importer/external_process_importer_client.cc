@@ -165,9 +165,14 @@ void ExternalProcessImporterClient::OnHistoryImportGroup(
 
   history_rows_.insert(history_rows_.end(), history_rows_group.begin(),
                        history_rows_group.end());
-  if (history_rows_.size() >= total_history_rows_count_)
-    bridge_->SetHistoryItems(history_rows_,
+  if (history_rows_.size() >= total_history_rows_count_) {
+    // Vivaldi: The importer may send the history in several chunks, each
+    // starting with OnHistoryImportStart(), so do not keep the rows around.
+    std::vector<ImporterURLRow> history_rows;
+    history_rows.swap(history_rows_);
+    bridge_->SetHistoryItems(history_rows,
                              static_cast<importer::VisitSource>(visit_source));
+  }
 }
 
 void ExternalProcessImporterClient::OnHomePageImportReady(
@@ -6,6 +6,8 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <iterator>
 #include <map>
 #include <set>
 #include <string>
@@ -37,6 +39,7 @@
 #include "components/search_engines/template_url.h"
 #include "components/search_engines/template_url_service.h"
 
+#include "app/vivaldi_apptools.h"
 #include "components/bookmarks/vivaldi_bookmark_kit.h"
 
 using bookmarks::BookmarkModel;
@@ -77,6 +80,30 @@ void ShowBookmarkBar(Profile* profile) {
   profile->GetPrefs()->SetBoolean(bookmarks::prefs::kShowBookmarkBar, true);
 }
 
+// Vivaldi: Returns true when |node| is where |entry| would be imported to
+// apart from the folder holding the import. Its enclosing folders must end
+// with the path of the entry and agree on being a Speed Dial.
+bool VivaldiIsAtImportedPath(BookmarkModel* model,
+                             const BookmarkNode* node,
+                             const ImportedBookmarkEntry& entry) {
+  const BookmarkNode* folder = node->parent();
+  if (entry.speeddial != (vivaldi_bookmark_kit::GetSpeeddial(node) ||
+                          vivaldi_bookmark_kit::GetSpeeddial(folder))) {
+    return false;
+  }
+  for (auto name = entry.path.rbegin(); name != entry.path.rend(); ++name) {
+    // The toolbar folder is skipped when importing to the bookmark bar.
+    if (entry.in_toolbar && folder == model->bookmark_bar_node() &&
+        std::next(name) == entry.path.rend()) {
+      return true;
+    }
+    if (folder->is_permanent_node() || folder->GetTitle() != *name)
+      return false;
+    folder = folder->parent();
+  }
+  return true;
+}
+
 }  // namespace
 
 ProfileWriter::ProfileWriter(Profile* profile) : profile_(profile) {}
@@ -161,6 +188,23 @@ void ProfileWriter::AddBookmarks(
 
   model->BeginExtensiveChanges();
 
+  // Vivaldi: Skip bookmarks the user already has with the same url,
+  // title and folder path, as after importing the same source twice or from
+  // profiles that share bookmarks. Only bookmarks from before this import
+  // count so the source is imported with all of its own entries. Bookmarks in
+  // the trash do not count either.
+  std::set<const BookmarkNode*> vivaldi_added_nodes;
+  auto vivaldi_is_duplicate = [&](const ImportedBookmarkEntry& entry) {
+    std::vector<const BookmarkNode*> nodes;
+    model->GetNodesByURL(entry.url, &nodes);
+    return std::any_of(nodes.begin(), nodes.end(), [&](const auto* node) {
+      return node->GetTitle() == entry.title &&
+             !vivaldi_added_nodes.count(node) &&
+             !node->HasAncestor(model->trash_node()) &&
+             VivaldiIsAtImportedPath(model, node, entry);
+    });
+  };
+
   std::set<const BookmarkNode*> folders_added_to;
   const BookmarkNode* top_level_folder = NULL;
   for (std::vector<ImportedBookmarkEntry>::const_iterator bookmark =
@@ -170,6 +214,11 @@ void ProfileWriter::AddBookmarks(
     if (!bookmark->is_folder && !bookmark->url.is_valid())
       continue;
 
+    if (vivaldi::IsVivaldiRunning() && !bookmark->is_folder &&
+        vivaldi_is_duplicate(*bookmark)) {
+      continue;
+    }
+
     const BookmarkNode* parent = NULL;
     if (import_to_top_level && (add_all_to_top_level || bookmark->in_toolbar)) {
       // Add directly to the bookmarks bar.
@@ -223,8 +272,9 @@ void ProfileWriter::AddBookmarks(
       vivaldi_meta.SetThumbnail(bookmark->thumbnail);
       vivaldi_meta.SetSpeeddial(bookmark->speeddial);
 
-      model->AddURL(parent, parent->children().size(), bookmark->title,
-                    bookmark->url, vivaldi_meta.map(), bookmark->creation_time);
+      vivaldi_added_nodes.insert(model->AddURL(
+          parent, parent->children().size(), bookmark->title, bookmark->url,
+          vivaldi_meta.map(), bookmark->creation_time));
     }
   }
 
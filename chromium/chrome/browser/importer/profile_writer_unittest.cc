@@ -10,6 +10,7 @@
 
 #include "base/bind.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/memory/raw_ptr.h"
 #include "base/run_loop.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/test/bind.h"
@@ -35,6 +36,9 @@
 #include "content/public/test/browser_task_environment.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include "app/vivaldi_apptools.h"
+#include "components/bookmarks/vivaldi_bookmark_kit.h"
+
 namespace {
 using bookmarks::BookmarkModel;
 using bookmarks::TitledUrlMatch;
@@ -240,6 +244,98 @@ TEST_F(ProfileWriterTest, CheckBookmarksAfterWritingDataTwice) {
   VerifyBookmarksCount(bookmarks_record, bookmark_model, 2);
 }
 
+// Vivaldi: Importing skips bookmarks the user already has at the same place.
+class VivaldiProfileWriterTest : public ProfileWriterTest {
+ public:
+  void SetUp() override {
+    ProfileWriterTest::SetUp();
+    vivaldi::ForceVivaldiRunning(true);
+    bookmark_model_ = BookmarkModelFactory::GetForBrowserContext(profile());
+    bookmarks::test::WaitForBookmarkModelToLoad(bookmark_model_);
+  }
+
+  void TearDown() override {
+    vivaldi::ForceVivaldiRunning(false);
+    ProfileWriterTest::TearDown();
+  }
+
+ protected:
+  ImportedBookmarkEntry MakeEntry(std::vector<std::u16string> path,
+                                  bool speeddial) {
+    ImportedBookmarkEntry entry;
+    entry.url = GURL("http://www.google.com");
+    entry.title = u"Google";
+    entry.in_toolbar = true;
+    entry.is_folder = false;
+    entry.path = std::move(path);
+    entry.speeddial = speeddial;
+    return entry;
+  }
+
+  const bookmarks::BookmarkNode* AddFolder(const std::u16string& title,
+                                           bool speeddial) {
+    vivaldi_bookmark_kit::CustomMetaInfo meta;
+    meta.SetSpeeddial(speeddial);
+    const bookmarks::BookmarkNode* bar = bookmark_model_->bookmark_bar_node();
+    return bookmark_model_->AddFolder(bar, bar->children().size(), title,
+                                      meta.map());
+  }
+
+  void AddGoogle(const bookmarks::BookmarkNode* parent) {
+    bookmark_model_->AddURL(parent, parent->children().size(), u"Google",
+                            GURL("http://www.google.com"));
+  }
+
+  size_t GoogleCount() {
+    std::vector<const bookmarks::BookmarkNode*> nodes;
+    bookmark_model_->GetNodesByURL(GURL("http://www.google.com"), &nodes);
+    return nodes.size();
+  }
+
+  void Import(ImportedBookmarkEntry entry) {
+    scoped_refptr<TestProfileWriter> profile_writer(
+        new TestProfileWriter(profile()));
+    profile_writer->AddBookmarks({entry}, u"Imported from Firefox");
+  }
+
+  raw_ptr<BookmarkModel> bookmark_model_ = nullptr;
+};
+
+TEST_F(VivaldiProfileWriterTest, SkipsBookmarksAfterWritingDataTwice) {
+  CreateImportedBookmarksEntries();
+  scoped_refptr<TestProfileWriter> profile_writer(
+      new TestProfileWriter(profile()));
+  profile_writer->AddBookmarks(bookmarks_, u"Imported from Firefox");
+  std::vector<UrlAndTitle> bookmarks_record;
+  bookmark_model_->GetBookmarks(&bookmarks_record);
+  EXPECT_EQ(2u, bookmarks_record.size());
+
+  profile_writer->AddBookmarks(bookmarks_, u"Imported from Firefox");
+  VerifyBookmarksCount(bookmarks_record, bookmark_model_, 1);
+}
+
+TEST_F(VivaldiProfileWriterTest, SkipsBookmarkInSameFolder) {
+  AddGoogle(AddFolder(u"Work", false));
+
+  // The toolbar folder is skipped when importing to the bar.
+  Import(MakeEntry({u"Bookmarks Toolbar", u"Work"}, false));
+  EXPECT_EQ(1u, GoogleCount());
+}
+
+TEST_F(VivaldiProfileWriterTest, ImportsBookmarkInOtherFolder) {
+  AddGoogle(AddFolder(u"Play", false));
+
+  Import(MakeEntry({u"Bookmarks Toolbar", u"Work"}, false));
+  EXPECT_EQ(2u, GoogleCount());
+}
+
+TEST_F(VivaldiProfileWriterTest, ImportsSpeedDialOfBookmark) {
+  AddGoogle(AddFolder(u"Work", false));
+
+  Import(MakeEntry({u"Bookmarks Toolbar", u"Work"}, true));
+  EXPECT_EQ(2u, GoogleCount());
+}
+
 std::unique_ptr<TemplateURL> ProfileWriterTest::CreateTemplateURL(
     const std::string& keyword,
     const std::string& url,
@@ -27,6 +27,9 @@
 #include "chrome/install_static/install_util.h"
 #endif
 
+#include "app/vivaldi_apptools.h"
+#include "browser/vivaldi_pref_shards.h"
+
 namespace {
 
 #if BUILDFLAG(IS_WIN)
@@ -90,15 +93,24 @@ PersistentPrefStore* ProfilePrefStoreManager::CreateProfilePrefStore(
         reset_on_load_observer,
     mojo::PendingRemote<prefs::mojom::TrackedPreferenceValidationDelegate>
         validation_delegate) {
+  PersistentPrefStore* store;
   if (!kPlatformSupportsPreferenceTracking) {
-    return new JsonPrefStore(profile_path_.Append(chrome::kPreferencesFilename),
-                             nullptr, io_task_runner);
+    store = new JsonPrefStore(
+        profile_path_.Append(chrome::kPreferencesFilename), nullptr,
+        io_task_runner);
+  } else {
+    store = CreateTrackedPersistentPrefStore(
+        CreateTrackedPrefStoreConfiguration(
+            std::move(tracking_configuration), reporting_ids_count,
+            std::move(reset_on_load_observer), std::move(validation_delegate)),
+        io_task_runner);
+  }
+  // Vivaldi: Keep the large Vivaldi subtrees out of Preferences.
+  if (vivaldi::IsVivaldiRunning()) {
+    store = vivaldi::AddVivaldiPrefShards(store, profile_path_,
+                                          std::move(io_task_runner));
   }
-  return CreateTrackedPersistentPrefStore(
-      CreateTrackedPrefStoreConfiguration(
-          std::move(tracking_configuration), reporting_ids_count,
-          std::move(reset_on_load_observer), std::move(validation_delegate)),
-      io_task_runner);
+  return store;
 }
 
 bool ProfilePrefStoreManager::InitializePrefsFromMasterPrefs(
@@ -36,6 +36,10 @@
 #include "services/preferences/public/mojom/preferences.mojom.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include "app/vivaldi_apptools.h"
+#include "chrome/common/chrome_constants.h"
+#include "prefs/vivaldi_gen_prefs.h"
+
 namespace {
 
 using EnforcementLevel =
@@ -554,3 +558,96 @@ TEST_F(ProfilePrefStoreManagerTest, ProtectedToUnprotected) {
   ExpectStringValueEquals(kProtectedAtomic, kGoodbyeWorld);
   VerifyResetRecorded(false);
 }
+
+// Vivaldi: The themes are kept in their own file next to Preferences.
+class VivaldiProfilePrefStoreManagerTest : public ProfilePrefStoreManagerTest {
+ public:
+  void SetUp() override {
+    ProfilePrefStoreManagerTest::SetUp();
+    profile_pref_registry_->RegisterListPref(vivaldiprefs::kThemesUser);
+  }
+
+  void TearDown() override {
+    ProfilePrefStoreManagerTest::TearDown();
+    vivaldi::ForceVivaldiRunning(false);
+  }
+
+ protected:
+  // Load the stores like a version with or without the theme shard does.
+  void LoadPrefs(bool with_shards) {
+    DestroyPrefStore();
+    vivaldi::ForceVivaldiRunning(with_shards);
+    LoadExistingPrefs();
+  }
+
+  void SetThemes(const std::string& theme) {
+    base::Value::List themes;
+    themes.Append(theme);
+    pref_store_->SetValue(vivaldiprefs::kThemesUser,
+                          std::make_unique<base::Value>(std::move(themes)),
+                          WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  }
+
+  void ExpectThemes(const std::string& theme) {
+    const base::Value* value = nullptr;
+    ASSERT_TRUE(pref_store_->GetValue(vivaldiprefs::kThemesUser, &value));
+    ASSERT_TRUE(value->is_list());
+    ASSERT_EQ(1u, value->GetList().size());
+    EXPECT_EQ(theme, value->GetList()[0].GetString());
+  }
+
+  bool FileContains(const base::FilePath::CharType* file_name,
+                    const std::string& text) {
+    std::string contents;
+    return base::ReadFileToString(profile_dir_.GetPath().Append(file_name),
+                                  &contents) &&
+           contents.find(text) != std::string::npos;
+  }
+};
+
+TEST_F(VivaldiProfilePrefStoreManagerTest, CopiesThemesToShard) {
+  InitializePrefs();
+  LoadPrefs(false);
+  SetThemes("old");
+
+  LoadPrefs(true);
+  ExpectThemes("old");
+  LoadPrefs(true);
+  ExpectThemes("old");
+  DestroyPrefStore();
+
+  EXPECT_TRUE(FileContains(FILE_PATH_LITERAL("Vivaldi Theme Preferences"),
+                           "old"));
+  // Kept for versions without the shard.
+  EXPECT_TRUE(FileContains(chrome::kPreferencesFilename, "old"));
+}
+
+TEST_F(VivaldiProfilePrefStoreManagerTest, KeepsThemeEditsInShard) {
+  InitializePrefs();
+  LoadPrefs(false);
+  SetThemes("old");
+
+  LoadPrefs(true);
+  SetThemes("new");
+  LoadPrefs(true);
+  ExpectThemes("new");
+  DestroyPrefStore();
+
+  EXPECT_FALSE(FileContains(chrome::kPreferencesFilename, "new"));
+}
+
+TEST_F(VivaldiProfilePrefStoreManagerTest, KeepsThemeEditsAfterDowngrade) {
+  InitializePrefs();
+  LoadPrefs(false);
+  SetThemes("old");
+  LoadPrefs(true);
+  ExpectThemes("old");
+
+  // A version without the shard still has the themes and its edits are
+  // picked up after the next upgrade.
+  LoadPrefs(false);
+  ExpectThemes("old");
+  SetThemes("downgraded");
+  LoadPrefs(true);
+  ExpectThemes("downgraded");
+}
@@ -8,6 +8,7 @@
 
 #include "base/bind.h"
 #include "base/containers/contains.h"
+#include "base/containers/cxx20_erase.h"
 #include "base/memory/memory_pressure_monitor.h"
 #include "base/memory/raw_ptr.h"
 #include "base/no_destructor.h"
@@ -22,6 +23,9 @@
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/browser_finder.h"
 #include "chrome/browser/ui/browser_list.h"
+#include "chrome/browser/ui/tabs/tab_group.h"
+#include "chrome/browser/ui/tabs/tab_group_model.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "components/favicon/content/content_favicon_driver.h"
 #include "content/public/browser/background_tracing_manager.h"
 #include "content/public/browser/navigation_controller.h"
@@ -29,6 +33,7 @@
 #include "content/public/common/content_features.h"
 
 #include "app/vivaldi_apptools.h"
+#include "browser/vivaldi_host_warmup.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/profiles/profile_manager.h"
@@ -67,6 +72,8 @@ struct ScoredTabComparator {
 // Testing seams.
 size_t g_max_loaded_tab_count_for_testing = 0;
 base::RepeatingCallback<void(TabLoader*)>* g_construction_callback = nullptr;
+base::RepeatingCallback<bool(content::WebContents*)>*
+    g_vivaldi_tab_attached_callback = nullptr;
 
 // Determines if the given browser (can be null) is closing.
 bool IsBrowserClosing(Browser* browser) {
@@ -83,6 +90,47 @@ bool IsBrowserClosing(Browser* browser) {
   return false;
 }
 
+// Vivaldi restores every window at once without Chromium's per-window
+// visibility staggering, so on top of the policy limit cap the number of
+// parallel background loads by the cores and memory of the machine.
+size_t GetVivaldiMaxSimultaneousLoads() {
+  static const size_t max_loads = [] {
+    size_t by_cores = static_cast<size_t>(
+        std::max(1, base::SysInfo::NumberOfProcessors() / 2));
+    size_t by_memory = static_cast<size_t>(
+        std::max(1, base::SysInfo::AmountOfPhysicalMemoryMB() / 2048));
+    return std::min(by_cores, by_memory);
+  }();
+  return max_loads;
+}
+
+// Vivaldi: Whether a webview has already picked up the contents.
+bool IsVivaldiTabAttached(content::WebContents* contents) {
+  if (g_vivaldi_tab_attached_callback)
+    return g_vivaldi_tab_attached_callback->Run(contents);
+  return contents->GetOuterWebContents() != nullptr;
+}
+
+// Vivaldi: Tabs in collapsed groups are not visible, so they are left
+// unloaded until the user opens the group and focuses them.
+bool IsInCollapsedGroup(content::WebContents* contents) {
+  Browser* browser = chrome::FindBrowserWithWebContents(contents);
+  if (!browser)
+    return false;
+  TabStripModel* tab_strip = browser->tab_strip_model();
+  if (!tab_strip->SupportsTabGroups())
+    return false;
+  int index = tab_strip->GetIndexOfWebContents(contents);
+  if (index == TabStripModel::kNoTab)
+    return false;
+  absl::optional<tab_groups::TabGroupId> group =
+      tab_strip->GetTabGroupForTab(index);
+  if (!group)
+    return false;
+  const TabGroup* tab_group = tab_strip->group_model()->GetTabGroup(*group);
+  return tab_group && tab_group->visual_data()->is_collapsed();
+}
+
 }  // namespace
 
 // Used for performing lifetime management of the tab loader. Maintains entry
@@ -111,7 +159,10 @@ class TabLoader::ReentrancyHelper {
   bool ShouldDestroyTabLoader() const {
     return tab_loader_->tabs_to_load_.empty() &&
            tab_loader_->tabs_load_initiated_.empty() &&
-           tab_loader_->tabs_loading_.empty();
+           tab_loader_->tabs_loading_.empty() &&
+           tab_loader_->vivaldi_tabs_waiting_for_attach_.empty() &&
+           tab_loader_->vivaldi_attached_tabs_.empty() &&
+           !tab_loader_->vivaldi_start_loading_posted_;
   }
 
   void DestroyTabLoader() { tab_loader_->this_retainer_ = nullptr; }
@@ -135,12 +186,18 @@ void TabLoader::RestoreTabs(const std::vector<RestoredTab>& tabs,
   if (!shared_tab_loader_)
     shared_tab_loader_ = new TabLoader();
 
-  if (vivaldi::IsVivaldiRunning())
+  if (vivaldi::IsVivaldiRunning()) {
     // NOTE(andre@vivaldi.com) : Make sure we don't start loading of contents in
     // the tabstrip until the content has been moved into webview. (We had
     // issues with this in the transition to GuestViewCrossProcessFrames. See
-    // bugs VB-39149, VB-38823 et al.
+    // bugs VB-39149, VB-38823 et al. The tabs are handed to StartLoading from
+    // OnVivaldiTabAttached instead.
+    // Vivaldi: Start connecting to the restored origins while waiting
+    // for the webviews to attach.
+    vivaldi::WarmUpRestoredTabs(tabs);
+    shared_tab_loader_->AddVivaldiTabsWaitingForAttach(tabs);
     return;
+  }
 
   // TODO(chrisha): Mix overlapping session tab restore priorities. Right now
   // the lowest priority tabs from the first session restore will load before
@@ -148,6 +205,13 @@ void TabLoader::RestoreTabs(const std::vector<RestoredTab>& tabs,
   shared_tab_loader_->StartLoading(tabs);
 }
 
+// static
+void TabLoader::OnVivaldiTabAttached(content::WebContents* contents) {
+  if (!shared_tab_loader_)
+    return;
+  shared_tab_loader_->MarkVivaldiTabAsAttached(contents);
+}
+
 // static
 void TabLoader::SetMaxLoadedTabCountForTesting(size_t value) {
   g_max_loaded_tab_count_for_testing = value;
@@ -159,6 +223,12 @@ void TabLoader::SetConstructionCallbackForTesting(
   g_construction_callback = callback;
 }
 
+// static
+void TabLoader::SetVivaldiTabAttachedCallbackForTesting(
+    base::RepeatingCallback<bool(content::WebContents*)>* callback) {
+  g_vivaldi_tab_attached_callback = callback;
+}
+
 void TabLoader::SetMaxSimultaneousLoadsForTesting(size_t loading_slots) {
   DCHECK_EQ(0u, reentry_depth_);  // Should never be called reentrantly.
   max_simultaneous_loads_for_testing_ = loading_slots;
@@ -251,6 +321,8 @@ TabLoader::~TabLoader() {
   DCHECK(tabs_to_load_.empty());
   DCHECK(tabs_load_initiated_.empty());
   DCHECK(tabs_loading_.empty());
+  DCHECK(vivaldi_tabs_waiting_for_attach_.empty());
+  DCHECK(vivaldi_attached_tabs_.empty());
   DCHECK(!force_load_timer_.IsRunning());
 
   shared_tab_loader_ = nullptr;
@@ -336,6 +408,64 @@ void TabLoader::StartLoading(const std::vector<RestoredTab>& tabs) {
   SetAllTabsScored(false);
 }
 
+void TabLoader::AddVivaldiTabsWaitingForAttach(
+    const std::vector<RestoredTab>& tabs) {
+  ReentrancyHelper lifetime_helper(this);
+  for (const RestoredTab& restored_tab : tabs) {
+    vivaldi_tabs_waiting_for_attach_.push_back(restored_tab);
+    // A webview may already have picked up the contents.
+    if (IsVivaldiTabAttached(restored_tab.contents()))
+      MarkVivaldiTabAsAttached(restored_tab.contents());
+  }
+}
+
+void TabLoader::MarkVivaldiTabAsAttached(content::WebContents* contents) {
+  ReentrancyHelper lifetime_helper(this);
+  auto it = std::find_if(vivaldi_tabs_waiting_for_attach_.begin(),
+                         vivaldi_tabs_waiting_for_attach_.end(),
+                         [contents](const RestoredTab& restored_tab) {
+                           return restored_tab.contents() == contents;
+                         });
+  if (it == vivaldi_tabs_waiting_for_attach_.end())
+    return;
+  RestoredTab restored_tab = *it;
+  vivaldi_tabs_waiting_for_attach_.erase(it);
+
+  // The active tab of each window loads right away. As long as it is loading
+  // and no tab has finished, GetMaxNewTabLoads keeps the background tabs
+  // back, so it gets the network and the renderer for itself.
+  if (restored_tab.is_active())
+    contents->GetController().LoadIfNecessary();
+
+  vivaldi_attached_tabs_.push_back(restored_tab);
+  if (vivaldi_start_loading_posted_)
+    return;
+  vivaldi_start_loading_posted_ = true;
+  base::SequencedTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&TabLoader::StartLoadingAttachedVivaldiTabs,
+                     base::WrapRefCounted(this)));
+}
+
+void TabLoader::StartLoadingAttachedVivaldiTabs() {
+  ReentrancyHelper lifetime_helper(this);
+  vivaldi_start_loading_posted_ = false;
+
+  std::vector<RestoredTab> tabs;
+  tabs.swap(vivaldi_attached_tabs_);
+  base::EraseIf(tabs, [](const RestoredTab& restored_tab) {
+    return !restored_tab.is_active() &&
+           IsInCollapsedGroup(restored_tab.contents());
+  });
+  if (tabs.empty())
+    return;
+
+  // Order the batch the same way SessionRestoreDelegate does, pinned and
+  // recently used tabs first, so ties in the policy scores keep that order.
+  std::stable_sort(tabs.begin(), tabs.end());
+  StartLoading(tabs);
+}
+
 void TabLoader::OnLoadingStateChange(WebContents* contents,
                                      LoadingState old_loading_state,
                                      LoadingState new_loading_state) {
@@ -491,6 +621,12 @@ void TabLoader::RemoveTab(WebContents* contents) {
 
   tabs_load_initiated_.erase(contents);
 
+  auto is_contents = [contents](const RestoredTab& restored_tab) {
+    return restored_tab.contents() == contents;
+  };
+  base::EraseIf(vivaldi_tabs_waiting_for_attach_, is_contents);
+  base::EraseIf(vivaldi_attached_tabs_, is_contents);
+
   {
     auto it = FindTabToLoad(contents);
     if (it != tabs_to_load_.end()) {
@@ -625,16 +761,16 @@ void TabLoader::StopLoadingTabs() {
   // Stop the timer and suppress any tab loads while we clean the list.
   SetTabLoadingEnabled(false);
 
-  if (!vivaldi::IsVivaldiRunning()) {
   // Notify the stats collector of deferred tabs.
   for (auto score_content_pair : tabs_to_load_) {
     auto* contents = score_content_pair.second;
     delegate_->RemoveTabForScoring(contents);
   }
-  }
 
   // Clear out the remaining tabs to load and clean ourselves up.
   tabs_to_load_.clear();
+  vivaldi_tabs_waiting_for_attach_.clear();
+  vivaldi_attached_tabs_.clear();
 
   // Restore invariants. This will stop the timer and schedule a self-destroy.
   StartTimerIfNeeded();
@@ -807,5 +943,9 @@ void TabLoader::MoveToSortedPosition(TabVector::iterator it) {
 size_t TabLoader::MaxSimultaneousLoads() const {
   if (max_simultaneous_loads_for_testing_ != 0)
     return max_simultaneous_loads_for_testing_;
+  if (vivaldi::IsVivaldiRunning()) {
+    return std::min(delegate_->GetMaxSimultaneousTabLoads(),
+                    GetVivaldiMaxSimultaneousLoads());
+  }
   return delegate_->GetMaxSimultaneousTabLoads();
 }
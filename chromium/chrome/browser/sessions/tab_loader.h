@@ -71,6 +71,10 @@ class TabLoader : public base::RefCounted<TabLoader>,
   static void RestoreTabs(const std::vector<RestoredTab>& tabs,
                           const base::TimeTicks& restore_started);
 
+  // Vivaldi: Called when |contents| has been attached to its webview. Restored
+  // tabs are only handed to the loading machinery once this has happened.
+  static void OnVivaldiTabAttached(content::WebContents* contents);
+
  private:
   friend class base::RefCounted<TabLoader>;
   friend class ReentrancyHelper;
@@ -147,6 +151,17 @@ class TabLoader : public base::RefCounted<TabLoader>,
   // deferred load.
   void MarkTabAsDeferred(content::WebContents* contents);
 
+  // Vivaldi: Holds |tabs| until their webviews are attached.
+  void AddVivaldiTabsWaitingForAttach(const std::vector<RestoredTab>& tabs);
+
+  // Vivaldi: Moves |contents| from |vivaldi_tabs_waiting_for_attach_| to
+  // |vivaldi_attached_tabs_| and schedules StartLoadingAttachedVivaldiTabs.
+  void MarkVivaldiTabAsAttached(content::WebContents* contents);
+
+  // Vivaldi: Passes the tabs attached since the last call to StartLoading.
+  // Tabs attached within the same task are scored and sorted together.
+  void StartLoadingAttachedVivaldiTabs();
+
   // Maybes loads one of more tabs. This will cause one or more tabs (up to the
   // number of open loading slots) to load, while respecting the loading slot
   // cap.
@@ -185,6 +200,11 @@ class TabLoader : public base::RefCounted<TabLoader>,
   static void SetConstructionCallbackForTesting(
       base::RepeatingCallback<void(TabLoader*)>* callback);
 
+  // Vivaldi: Sets the check whether the webview has picked up the contents
+  // for testing.
+  static void SetVivaldiTabAttachedCallbackForTesting(
+      base::RepeatingCallback<bool(content::WebContents*)>* callback);
+
   // Sets the number of simultaneous loads for testing.
   void SetMaxSimultaneousLoadsForTesting(size_t loading_slots);
 
@@ -270,6 +290,13 @@ class TabLoader : public base::RefCounted<TabLoader>,
   // itself.
   LoadingTabSet tabs_loading_;
 
+  // Vivaldi: Restored tabs whose webviews are not attached yet, and attached
+  // tabs waiting for StartLoadingAttachedVivaldiTabs. Tabs in these are not in
+  // any of the containers above.
+  std::vector<RestoredTab> vivaldi_tabs_waiting_for_attach_;
+  std::vector<RestoredTab> vivaldi_attached_tabs_;
+  bool vivaldi_start_loading_posted_ = false;
+
   // The number of tabs that were passed into this TabLoader that have been
   // observed starting to load, or for which we explicitly initiated the load.
   // This is monotonically increasing, and can never exceed the combined number
@@ -29,6 +29,13 @@ void TabLoaderTester::SetConstructionCallbackForTesting(
   TabLoader::SetConstructionCallbackForTesting(callback);
 }
 
+// Vivaldi
+// static
+void TabLoaderTester::SetVivaldiTabAttachedCallbackForTesting(
+    base::RepeatingCallback<bool(content::WebContents*)>* callback) {
+  TabLoader::SetVivaldiTabAttachedCallbackForTesting(callback);
+}
+
 void TabLoaderTester::SetMaxSimultaneousLoadsForTesting(size_t loading_slots) {
   tab_loader_->SetMaxSimultaneousLoadsForTesting(loading_slots);
 }
@@ -82,6 +89,17 @@ size_t TabLoaderTester::scheduled_to_load_count() const {
   return tab_loader_->scheduled_to_load_count_;
 }
 
+// Vivaldi
+const std::vector<TabLoader::RestoredTab>&
+TabLoaderTester::vivaldi_tabs_waiting_for_attach() const {
+  return tab_loader_->vivaldi_tabs_waiting_for_attach_;
+}
+
+const std::vector<TabLoader::RestoredTab>&
+TabLoaderTester::vivaldi_attached_tabs() const {
+  return tab_loader_->vivaldi_attached_tabs_;
+}
+
 // static
 TabLoader* TabLoaderTester::shared_tab_loader() {
   return TabLoader::shared_tab_loader_;
@@ -32,6 +32,9 @@ class TabLoaderTester {
   static void SetMaxLoadedTabCountForTesting(size_t value);
   static void SetConstructionCallbackForTesting(
       base::RepeatingCallback<void(TabLoader*)>* callback);
+  // Vivaldi
+  static void SetVivaldiTabAttachedCallbackForTesting(
+      base::RepeatingCallback<bool(content::WebContents*)>* callback);
   void SetMaxSimultaneousLoadsForTesting(size_t loading_slots);
   void SetTickClockForTesting(base::TickClock* tick_clock);
   void MaybeLoadSomeTabsForTesting();
@@ -50,6 +53,10 @@ class TabLoaderTester {
   const TabVector& tabs_to_load() const;
   const TabSet& tabs_load_initiated() const;
   size_t scheduled_to_load_count() const;
+  // Vivaldi
+  const std::vector<TabLoader::RestoredTab>& vivaldi_tabs_waiting_for_attach()
+      const;
+  const std::vector<TabLoader::RestoredTab>& vivaldi_attached_tabs() const;
   static TabLoader* shared_tab_loader();
 
   // Returns the session restore policy engine that is currently being used.
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "base/bind.h"
+#include "base/containers/contains.h"
 #include "base/containers/flat_set.h"
 #include "base/run_loop.h"
 #include "base/test/simple_test_tick_clock.h"
@@ -25,6 +26,12 @@
 #include "content/public/test/web_contents_tester.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include "app/vivaldi_apptools.h"
+#include "chrome/browser/ui/tabs/tab_group.h"
+#include "chrome/browser/ui/tabs/tab_group_model.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "components/tab_groups/tab_group_visual_data.h"
+
 using resource_coordinator::TabLoadTracker;
 using resource_coordinator::ResourceCoordinatorTabHelper;
 using LoadingState = TabLoadTracker::LoadingState;
@@ -472,3 +479,223 @@ TEST_F(TabLoaderTest, RemoveFromTabStrip) {
   SimulateLoaded(0);
   EXPECT_TRUE(TabLoaderTester::shared_tab_loader() == nullptr);
 }
+
+// Vivaldi: Restored tabs wait for their webviews to attach before the loader
+// takes them.
+class VivaldiTabLoaderTest : public TabLoaderTest {
+ protected:
+  void SetUp() override {
+    TabLoaderTest::SetUp();
+    vivaldi::ForceVivaldiRunning(true);
+    attached_callback_ = base::BindRepeating(
+        &VivaldiTabLoaderTest::IsAttached, base::Unretained(this));
+    TabLoaderTester::SetVivaldiTabAttachedCallbackForTesting(
+        &attached_callback_);
+  }
+
+  void TearDown() override {
+    TabLoaderTester::SetVivaldiTabAttachedCallbackForTesting(nullptr);
+    vivaldi::ForceVivaldiRunning(false);
+    TabLoaderTest::TearDown();
+  }
+
+  bool IsAttached(content::WebContents* contents) {
+    return base::Contains(attached_before_restore_, contents);
+  }
+
+  // Unlike CreateRestoredWebContents() this does not start loading active
+  // tabs, that is left to the loader when the tab is attached.
+  content::WebContents* CreateVivaldiRestoredTab(bool is_active,
+                                                 bool is_pinned = false) {
+    content::WebContents* contents = CreateRestoredWebContents(false);
+    restored_tabs_.back() =
+        RestoredTab(contents, is_active, false /* is_app */, is_pinned,
+                    absl::nullopt /* group */);
+    if (is_pinned) {
+      TabStripModel* tab_strip_model = browser()->tab_strip_model();
+      tab_strip_model->SetTabPinned(
+          tab_strip_model->GetIndexOfWebContents(contents), true);
+    }
+    return contents;
+  }
+
+  void RestoreVivaldiTabs() {
+    TabLoader::RestoreTabs(restored_tabs_, clock_.NowTicks());
+    EXPECT_TRUE(tab_loader_.IsSharedTabLoader());
+  }
+
+  void AttachTab(size_t tab_index) {
+    TabLoader::OnVivaldiTabAttached(restored_tabs_[tab_index].contents());
+  }
+
+  std::vector<content::WebContents*> GetContents(
+      const std::vector<RestoredTab>& tabs) {
+    std::vector<content::WebContents*> contents;
+    for (const RestoredTab& tab : tabs)
+      contents.push_back(tab.contents());
+    return contents;
+  }
+
+  bool IsScheduledToLoad(content::WebContents* contents) {
+    for (const auto& score_and_contents : tab_loader_.tabs_to_load()) {
+      if (score_and_contents.second == contents)
+        return true;
+    }
+    return tab_loader_.tabs_load_initiated().contains(contents);
+  }
+
+  base::flat_set<content::WebContents*> attached_before_restore_;
+  base::RepeatingCallback<bool(content::WebContents*)> attached_callback_;
+};
+
+TEST_F(VivaldiTabLoaderTest, WaitsForAttach) {
+  content::WebContents* active = CreateVivaldiRestoredTab(true);
+  content::WebContents* background = CreateVivaldiRestoredTab(false);
+  content::WebContents* attached = CreateVivaldiRestoredTab(false);
+  attached_before_restore_.insert(attached);
+  max_simultaneous_loads_ = 1;
+
+  // Only the contents a webview already picked up are taken right away.
+  RestoreVivaldiTabs();
+  EXPECT_EQ(GetContents(tab_loader_.vivaldi_tabs_waiting_for_attach()),
+            (std::vector<content::WebContents*>{active, background}));
+  EXPECT_EQ(GetContents(tab_loader_.vivaldi_attached_tabs()),
+            std::vector<content::WebContents*>{attached});
+  EXPECT_TRUE(tab_loader_.tabs_to_load().empty());
+
+  AttachTab(1);
+  EXPECT_EQ(GetContents(tab_loader_.vivaldi_tabs_waiting_for_attach()),
+            std::vector<content::WebContents*>{active});
+  EXPECT_EQ(GetContents(tab_loader_.vivaldi_attached_tabs()),
+            (std::vector<content::WebContents*>{attached, background}));
+
+  // A second notification for the same contents is ignored.
+  AttachTab(1);
+  EXPECT_EQ(2u, tab_loader_.vivaldi_attached_tabs().size());
+
+  AttachTab(0);
+  SimulatePrimaryPageChanged(active);
+  tab_loader_.WaitForTabLoadingEnabled();
+  EXPECT_TRUE(tab_loader_.vivaldi_tabs_waiting_for_attach().empty());
+  EXPECT_TRUE(tab_loader_.vivaldi_attached_tabs().empty());
+  EXPECT_TRUE(IsScheduledToLoad(background));
+  EXPECT_TRUE(IsScheduledToLoad(attached));
+
+  // The loader still goes away once everything is loaded.
+  SimulateLoadedAll();
+  EXPECT_TRUE(TabLoaderTester::shared_tab_loader() == nullptr);
+}
+
+TEST_F(VivaldiTabLoaderTest, ActiveTabLoadsOnAttach) {
+  content::WebContents* active = CreateVivaldiRestoredTab(true);
+  content::WebContents* background = CreateVivaldiRestoredTab(false);
+  max_simultaneous_loads_ = 1;
+
+  RestoreVivaldiTabs();
+  EXPECT_TRUE(active->GetController().NeedsReload());
+
+  // The active tab starts loading without waiting for the batch.
+  AttachTab(0);
+  AttachTab(1);
+  EXPECT_FALSE(active->GetController().NeedsReload());
+  EXPECT_TRUE(background->GetController().NeedsReload());
+
+  SimulatePrimaryPageChanged(active);
+  tab_loader_.WaitForTabLoadingEnabled();
+  EXPECT_EQ(1u, tab_loader_.tabs_to_load().size());
+  EXPECT_EQ(1u, tab_loader_.scheduled_to_load_count());
+}
+
+TEST_F(VivaldiTabLoaderTest, AttachedTabsStartInOneOrderedBatch) {
+  content::WebContents* unpinned = CreateVivaldiRestoredTab(false);
+  content::WebContents* pinned = CreateVivaldiRestoredTab(false, true);
+  max_simultaneous_loads_ = 1;
+
+  RestoreVivaldiTabs();
+  AttachTab(0);
+  AttachTab(1);
+
+  // Tabs attached in the same task wait for one StartLoading call.
+  EXPECT_EQ(GetContents(tab_loader_.vivaldi_attached_tabs()),
+            (std::vector<content::WebContents*>{unpinned, pinned}));
+  EXPECT_TRUE(tab_loader_.tabs_to_load().empty());
+
+  // The batch is ordered like SessionRestoreDelegate orders the tabs, so the
+  // pinned tab takes the only loading slot.
+  tab_loader_.WaitForTabLoadingEnabled();
+  EXPECT_TRUE(tab_loader_.vivaldi_attached_tabs().empty());
+  EXPECT_TRUE(tab_loader_.tabs_load_initiated().contains(pinned));
+  ASSERT_EQ(1u, tab_loader_.tabs_to_load().size());
+  EXPECT_EQ(unpinned, tab_loader_.tabs_to_load()[0].second);
+}
+
+TEST_F(VivaldiTabLoaderTest, CollapsedGroupTabsAreSkipped) {
+  CreateVivaldiRestoredTab(true);
+  content::WebContents* visible = CreateVivaldiRestoredTab(false);
+  content::WebContents* collapsed = CreateVivaldiRestoredTab(false);
+  max_simultaneous_loads_ = 1;
+
+  TabStripModel* tab_strip_model = browser()->tab_strip_model();
+  tab_groups::TabGroupId group = tab_strip_model->AddToNewGroup(
+      {tab_strip_model->GetIndexOfWebContents(collapsed)});
+  tab_strip_model->group_model()->GetTabGroup(group)->SetVisualData(
+      tab_groups::TabGroupVisualData(u"group",
+                                     tab_groups::TabGroupColorId::kGrey,
+                                     true /* is_collapsed */));
+
+  RestoreVivaldiTabs();
+  AttachTab(0);
+  AttachTab(1);
+  AttachTab(2);
+  SimulatePrimaryPageChanged(restored_tabs_[0].contents());
+  tab_loader_.WaitForTabLoadingEnabled();
+  EXPECT_TRUE(IsScheduledToLoad(visible));
+  EXPECT_FALSE(IsScheduledToLoad(collapsed));
+  EXPECT_TRUE(collapsed->GetController().NeedsReload());
+}
+
+TEST_F(VivaldiTabLoaderTest, ClosedTabsAreForgotten) {
+  content::WebContents* active = CreateVivaldiRestoredTab(true);
+  content::WebContents* background = CreateVivaldiRestoredTab(false);
+  max_simultaneous_loads_ = 1;
+
+  RestoreVivaldiTabs();
+  AttachTab(1);
+  EXPECT_EQ(1u, tab_loader_.vivaldi_tabs_waiting_for_attach().size());
+  EXPECT_EQ(1u, tab_loader_.vivaldi_attached_tabs().size());
+
+  // The closed contents go away, so the test does not track them either.
+  restored_tabs_.clear();
+  TabStripModel* tab_strip_model = browser()->tab_strip_model();
+  tab_strip_model->CloseWebContentsAt(
+      tab_strip_model->GetIndexOfWebContents(background),
+      TabCloseTypes::CLOSE_NONE);
+  EXPECT_TRUE(tab_loader_.vivaldi_attached_tabs().empty());
+  tab_strip_model->CloseWebContentsAt(
+      tab_strip_model->GetIndexOfWebContents(active),
+      TabCloseTypes::CLOSE_NONE);
+  EXPECT_TRUE(tab_loader_.vivaldi_tabs_waiting_for_attach().empty());
+
+  // The loader goes away when the posted batch finds nothing to load.
+  task_environment()->RunUntilIdle();
+  EXPECT_TRUE(TabLoaderTester::shared_tab_loader() == nullptr);
+}
+
+TEST_F(VivaldiTabLoaderTest, StopLoadingTabsForgetsWaitingTabs) {
+  CreateVivaldiRestoredTab(true);
+  CreateVivaldiRestoredTab(false);
+  CreateVivaldiRestoredTab(false);
+  max_simultaneous_loads_ = 1;
+
+  RestoreVivaldiTabs();
+  AttachTab(1);
+  tab_loader_.OnMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_TRUE(tab_loader_.vivaldi_tabs_waiting_for_attach().empty());
+  EXPECT_TRUE(tab_loader_.vivaldi_attached_tabs().empty());
+
+  task_environment()->RunUntilIdle();
+  EXPECT_TRUE(TabLoaderTester::shared_tab_loader() == nullptr);
+  for (const RestoredTab& tab : restored_tabs_)
+    EXPECT_TRUE(tab.contents()->GetController().NeedsReload());
+}
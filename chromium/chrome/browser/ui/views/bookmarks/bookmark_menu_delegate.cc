@@ -51,6 +51,7 @@
 #include "browser/menus/vivaldi_bookmark_context_menu.h"
 #include "components/bookmarks/vivaldi_bookmark_kit.h"
 #include "vivaldi/prefs/vivaldi_gen_prefs.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "ui/base/dragdrop/mojom/drag_drop_types.mojom.h"
 
 using base::UserMetricsAction;
@@ -650,14 +651,29 @@ void BookmarkMenuDelegate::BuildMenu(const BookmarkNode* parent,
       chrome::BookmarkFolderIconType::kNormal, ui::kColorMenuIcon);
   unsigned int menu_index = vivaldi::IsVivaldiRunning() ?
     vivaldi::GetStartIndexForBookmarks(menu, parent->id()) : 0;
+  // Vivaldi: The icons depend on the menu colors only, so look them up
+  // once per menu rather than for each bookmarklet and speed dial folder.
+  const gfx::ImageSkia* bookmarklet_icon = nullptr;
+  absl::optional<ui::ImageModel> speeddial_icon;
 
   std::vector<bookmarks::BookmarkNode*> nodes;
   if (vivaldi::IsVivaldiRunning()) {
-    vivaldi::SortBookmarkNodes(parent, nodes);
+    vivaldi::SortBookmarkNodes(GetBookmarkModel(), parent, nodes);
     if (start_child_index == 0) {
       vivaldi::AddExtraBookmarkMenuItems(profile_, menu, &menu_index, parent,
           true);
     }
+    // Request the favicons of the whole folder at once rather than one by one
+    // through GetFavicon() below.
+    std::vector<const BookmarkNode*> favicon_nodes;
+    for (size_t k = start_child_index; k < nodes.size(); ++k) {
+      const BookmarkNode* node = nodes[k];
+      if (node->is_url() && !vivaldi_bookmark_kit::IsSeparator(node) &&
+          !node->url().SchemeIs("javascript")) {
+        favicon_nodes.push_back(node);
+      }
+    }
+    GetBookmarkModel()->LoadFavicons(favicon_nodes);
   }
 
   size_t j = start_child_index;
@@ -677,9 +693,11 @@ void BookmarkMenuDelegate::BuildMenu(const BookmarkNode* parent,
         // Ensure we do not call BookmarkModel::GetFavicon on this node as
         // the function will do an async lookup and on completion insert a
         // regular bookmark icon (since the url will not match anything).
-        const gfx::ImageSkia* icon = vivaldi::GetBookmarkletIcon(menu, parent_);
+        if (!bookmarklet_icon) {
+          bookmarklet_icon = vivaldi::GetBookmarkletIcon(menu, parent_);
+        }
         child_menu_item = vivaldi::AddMenuItem(menu, &menu_index, id,
-            MaybeEscapeLabel(node->GetTitle()), *icon,
+            MaybeEscapeLabel(node->GetTitle()), *bookmarklet_icon,
             MenuItemView::Type::kNormal);
       } else {
       const gfx::Image& image = GetBookmarkModel()->GetFavicon(node);
@@ -703,12 +721,16 @@ void BookmarkMenuDelegate::BuildMenu(const BookmarkNode* parent,
     } else {
       DCHECK(node->is_folder());
       if (vivaldi::IsVivaldiRunning()) {
+        bool is_speeddial = vivaldi_bookmark_kit::GetSpeeddial(node);
+        if (is_speeddial && !speeddial_icon) {
+          speeddial_icon = vivaldi::GetBookmarkSpeeddialIcon(
+              menu, parent_ /*ui::NativeTheme::kColorId_MenuIconColor*/);
+        }
         child_menu_item = vivaldi::AddMenuItem(
             menu, &menu_index, id, MaybeEscapeLabel(node->GetTitle()),
-            *(vivaldi_bookmark_kit::GetSpeeddial(node)
-                  ? vivaldi::GetBookmarkSpeeddialIcon(
-                        menu, parent_/*ui::NativeTheme::kColorId_MenuIconColor*/)
-                  : folder_icon).GetImage().ToImageSkia(),
+            *(is_speeddial ? *speeddial_icon : folder_icon)
+                 .GetImage()
+                 .ToImageSkia(),
             MenuItemView::Type::kSubMenu);
       } else {
       child_menu_item = menu->AppendSubMenu(
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <set>
+#include <utility>
 
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
@@ -35,6 +36,10 @@
 
 namespace {
 
+// Vivaldi: Number of history rows to read before sending them to the
+// bridge, so large profiles are not kept in memory all at once.
+constexpr size_t kVivaldiHistoryChunkSize = 5000;
+
 // Original definition is in:
 //   toolkit/components/places/nsINavBookmarksService.idl
 enum BookmarkItemType {
@@ -192,6 +197,8 @@ void FirefoxImporter::ImportHistory() {
   sql::Statement s(db.GetUniqueStatement(query));
 
   std::vector<ImporterURLRow> rows;
+  rows.reserve(kVivaldiHistoryChunkSize);
+  size_t imported = 0;
   while (s.Step() && !cancelled()) {
     GURL url(s.ColumnString(0));
 
@@ -206,7 +213,16 @@ void FirefoxImporter::ImportHistory() {
     row.typed_count = s.ColumnInt(4);
     row.last_visit = base::Time::FromTimeT(s.ColumnInt64(5)/1000000);
 
-    rows.push_back(row);
+    rows.push_back(std::move(row));
+
+    // Vivaldi: Stream the rows in chunks, the client accepts several
+    // SetHistoryItems() calls and writes each chunk on its own.
+    if (rows.size() >= kVivaldiHistoryChunkSize) {
+      bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_FIREFOX_IMPORTED);
+      imported += rows.size();
+      VLOG(1) << "Imported " << imported << " Firefox history rows so far";
+      rows.clear();
+    }
   }
 
   if (!rows.empty() && !cancelled())
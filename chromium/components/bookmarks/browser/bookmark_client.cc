@@ -4,7 +4,9 @@
 
 #include "components/bookmarks/browser/bookmark_client.h"
 
+#include "base/bind.h"
 #include "base/notreached.h"
+#include "url/gurl.h"
 
 namespace bookmarks {
 
@@ -17,6 +19,16 @@ base::CancelableTaskTracker::TaskId BookmarkClient::GetFaviconImageForPageURL(
   return base::CancelableTaskTracker::kBadTaskId;
 }
 
+void BookmarkClient::GetFaviconImagesForPageURLs(
+    const std::vector<GURL>& page_urls,
+    favicon_base::FaviconImagesCallback callback,
+    base::CancelableTaskTracker* tracker) {
+  for (size_t i = 0; i < page_urls.size(); ++i) {
+    GetFaviconImageForPageURL(page_urls[i], base::BindOnce(callback, i),
+                              tracker);
+  }
+}
+
 bool BookmarkClient::SupportsTypedCountForUrls() {
   return false;
 }
@@ -9,6 +9,7 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "base/callback_forward.h"
 #include "base/task/cancelable_task_tracker.h"
@@ -56,6 +57,15 @@ class BookmarkClient {
       favicon_base::FaviconImageCallback callback,
       base::CancelableTaskTracker* tracker);
 
+  // Vivaldi: Requests the favicons of all |page_urls| like
+  // GetFaviconImageForPageURL(). |callback| runs once for each page with its
+  // index in |page_urls|. The default implementation requests each page
+  // separately.
+  virtual void GetFaviconImagesForPageURLs(
+      const std::vector<GURL>& page_urls,
+      favicon_base::FaviconImagesCallback callback,
+      base::CancelableTaskTracker* tracker);
+
   // Returns true if the embedder supports typed count for URL.
   virtual bool SupportsTypedCountForUrls();
 
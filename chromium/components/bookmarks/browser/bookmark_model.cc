@@ -44,6 +44,8 @@
 #include "app/vivaldi_resources.h"
 #include "base/strings/utf_string_conversions.h"
 #include "components/bookmarks/vivaldi_bookmark_kit.h"
+#include "components/bookmarks/vivaldi_nickname_index.h"
+#include "components/bookmarks/vivaldi_node_id_index.h"
 
 using base::Time;
 
@@ -143,6 +145,10 @@ BookmarkModel::BookmarkModel(std::unique_ptr<BookmarkClient> client)
   // outside Chromium tree when we can guarantee that it will be called before
   // any potential model mutation calls.
   vivaldi_bookmark_kit::InitModelNonClonedKeys(this);
+  vivaldi_node_id_index_ =
+      std::make_unique<vivaldi_bookmark_kit::NodeIdIndex>(this);
+  vivaldi_nickname_index_ =
+      std::make_unique<vivaldi_bookmark_kit::NicknameIndex>(this);
 }
 
 BookmarkModel::~BookmarkModel() {
@@ -423,6 +429,34 @@ const gfx::Image& BookmarkModel::GetFavicon(const BookmarkNode* node) {
   return node->favicon();
 }
 
+void BookmarkModel::LoadFavicons(
+    const std::vector<const BookmarkNode*>& nodes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::vector<BookmarkNode*> nodes_to_load;
+  std::vector<GURL> page_urls;
+  for (const BookmarkNode* node : nodes) {
+    if (node->is_folder() || !node->url().is_valid() ||
+        node->favicon_state() != BookmarkNode::INVALID_FAVICON)
+      continue;
+    nodes_to_load.push_back(AsMutable(node));
+    page_urls.push_back(node->url());
+  }
+  if (nodes_to_load.empty())
+    return;
+
+  uint64_t batch_id = ++vivaldi_last_favicon_batch_id_;
+  for (BookmarkNode* node : nodes_to_load) {
+    node->set_favicon_state(BookmarkNode::LOADING_FAVICON);
+    vivaldi_batch_favicon_loads_[node] = batch_id;
+  }
+  client_->GetFaviconImagesForPageURLs(
+      page_urls,
+      base::BindRepeating(&BookmarkModel::OnBatchFaviconDataAvailable,
+                          base::Unretained(this), batch_id,
+                          std::move(nodes_to_load)),
+      &cancelable_task_tracker_);
+}
+
 void BookmarkModel::SetTitle(const BookmarkNode* node,
                              const std::u16string& title) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -495,7 +529,21 @@ void BookmarkModel::SetNodeMetaInfo(const BookmarkNode* node,
   for (BookmarkModelObserver& observer : observers_)
     observer.OnWillChangeBookmarkMetaInfo(this, node);
 
-  if (AsMutable(node)->SetMetaInfo(key, value) && store_.get())
+  // Vivaldi: Re-add the node so the index picks up the changed description
+  // or nickname, see SetNodeMetaInfoMap().
+  #if BUILDFLAG(IS_ANDROID) && defined(VIVALDI_BUILD)
+  if (node->is_url())
+    titled_url_index_->Remove(node);
+  #endif
+
+  bool changed = AsMutable(node)->SetMetaInfo(key, value);
+
+  #if BUILDFLAG(IS_ANDROID) && defined(VIVALDI_BUILD)
+  if (node->is_url())
+    titled_url_index_->Add(node);
+  #endif
+
+  if (changed && store_.get())
     store_->ScheduleSave();
 
   for (BookmarkModelObserver& observer : observers_)
@@ -547,7 +595,20 @@ void BookmarkModel::DeleteNodeMetaInfo(const BookmarkNode* node,
   for (BookmarkModelObserver& observer : observers_)
     observer.OnWillChangeBookmarkMetaInfo(this, node);
 
-  if (AsMutable(node)->DeleteMetaInfo(key) && store_.get())
+  // Vivaldi: See SetNodeMetaInfo().
+  #if BUILDFLAG(IS_ANDROID) && defined(VIVALDI_BUILD)
+  if (node->is_url())
+    titled_url_index_->Remove(node);
+  #endif
+
+  bool changed = AsMutable(node)->DeleteMetaInfo(key);
+
+  #if BUILDFLAG(IS_ANDROID) && defined(VIVALDI_BUILD)
+  if (node->is_url())
+    titled_url_index_->Add(node);
+  #endif
+
+  if (changed && store_.get())
     store_->ScheduleSave();
 
   for (BookmarkModelObserver& observer : observers_)
@@ -1001,6 +1062,21 @@ void BookmarkModel::LoadFavicon(BookmarkNode* node) {
     node->set_favicon_load_task_id(taskId);
 }
 
+void BookmarkModel::OnBatchFaviconDataAvailable(
+    uint64_t batch_id,
+    const std::vector<BookmarkNode*>& nodes,
+    size_t index,
+    const favicon_base::FaviconImageResult& image_result) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_LT(index, nodes.size());
+  BookmarkNode* node = nodes[index];
+  auto i = vivaldi_batch_favicon_loads_.find(node);
+  if (i == vivaldi_batch_favicon_loads_.end() || i->second != batch_id)
+    return;
+  vivaldi_batch_favicon_loads_.erase(i);
+  OnFaviconDataAvailable(node, image_result);
+}
+
 void BookmarkModel::FaviconLoaded(const BookmarkNode* node) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   for (BookmarkModelObserver& observer : observers_)
@@ -1013,6 +1089,9 @@ void BookmarkModel::CancelPendingFaviconLoadRequests(BookmarkNode* node) {
     cancelable_task_tracker_.TryCancel(node->favicon_load_task_id());
     node->set_favicon_load_task_id(base::CancelableTaskTracker::kBadTaskId);
   }
+  // Vivaldi: The batched request is shared with other nodes, so only
+  // forget about this node.
+  vivaldi_batch_favicon_loads_.erase(node);
 }
 
 int64_t BookmarkModel::generate_next_node_id() {
@@ -40,6 +40,11 @@ namespace favicon_base {
 struct FaviconImageResult;
 }
 
+namespace vivaldi_bookmark_kit {
+class NicknameIndex;
+class NodeIdIndex;
+}
+
 namespace query_parser {
 enum class MatchingAlgorithm;
 }
@@ -176,6 +181,12 @@ class BookmarkModel : public BookmarkUndoProvider,
   // LOADING_FAVICON (with the exception of folders, where the call is a no-op).
   const gfx::Image& GetFavicon(const BookmarkNode* node);
 
+  // Vivaldi: Starts loading the favicons of those |nodes| that were not
+  // loaded yet with one batched request, so building a large folder menu does
+  // not post a favicon task per node. Observers are notified as with
+  // GetFavicon(), which afterwards does not request the icons again.
+  void LoadFavicons(const std::vector<const BookmarkNode*>& nodes);
+
   // Sets the title of |node|.
   void SetTitle(const BookmarkNode* node, const std::u16string& title);
 
@@ -381,6 +392,14 @@ class BookmarkModel : public BookmarkUndoProvider,
   // favicon service.
   void LoadFavicon(BookmarkNode* node);
 
+  // Vivaldi: Result of the LoadFavicons() request |batch_id| for the
+  // node at |index| of |nodes|. Ignored if the node load was canceled since.
+  void OnBatchFaviconDataAvailable(
+      uint64_t batch_id,
+      const std::vector<BookmarkNode*>& nodes,
+      size_t index,
+      const favicon_base::FaviconImageResult& image_result);
+
   // Called to notify the observers that the favicon has been loaded.
   void FaviconLoaded(const BookmarkNode* node);
 
@@ -465,6 +484,14 @@ class BookmarkModel : public BookmarkUndoProvider,
 
   friend class VivaldiBookmarkModelFriend;
   BookmarkPermanentNode* trash_node_ = nullptr;
+  std::unique_ptr<vivaldi_bookmark_kit::NicknameIndex> vivaldi_nickname_index_;
+  std::unique_ptr<vivaldi_bookmark_kit::NodeIdIndex> vivaldi_node_id_index_;
+
+  // Nodes waiting for a LoadFavicons() result with the id of their request.
+  // The id protects against a node deleted and another allocated at the same
+  // address before the result arrives.
+  std::map<const BookmarkNode*, uint64_t> vivaldi_batch_favicon_loads_;
+  uint64_t vivaldi_last_favicon_batch_id_ = 0;
 
   SEQUENCE_CHECKER(sequence_checker_);
 
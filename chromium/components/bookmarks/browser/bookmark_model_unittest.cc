@@ -1851,4 +1851,43 @@ TEST_F(BookmarkModelFaviconTest, ShouldResetFaviconStatusAfterRestore) {
   EXPECT_FALSE(node->is_favicon_loaded());
 }
 
+// Verifies that LoadFavicons() marks the nodes as loading so GetFavicon()
+// does not request them again, and that a node removed while its batch is
+// pending does not receive a result.
+TEST(BookmarkModelLoadFaviconsTest, LoadsAndIgnoresRemovedNodes) {
+  auto owned_client = std::make_unique<TestBookmarkClient>();
+  TestBookmarkClient* client = owned_client.get();
+  std::unique_ptr<BookmarkModel> model =
+      TestBookmarkClient::CreateModelWithClient(std::move(owned_client));
+
+  const GURL kPageURL1("http://www.google.com");
+  const GURL kPageURL2("http://www.google.ca");
+  const GURL kIconURL("http://www.google.com/favicon.ico");
+  const BookmarkNode* root = model->bookmark_bar_node();
+  const BookmarkNode* folder = model->AddFolder(root, 0, u"folder");
+  const BookmarkNode* node1 = model->AddURL(root, 1, u"a", kPageURL1);
+  const BookmarkNode* node2 = model->AddURL(root, 2, u"b", kPageURL2);
+
+  model->LoadFavicons({folder, node1, node2});
+  EXPECT_TRUE(node1->is_favicon_loading());
+  EXPECT_TRUE(node2->is_favicon_loading());
+  model->GetFavicon(node1);
+
+  model->Remove(node2);
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(16, 16);
+  bitmap.eraseColor(SK_ColorBLUE);
+  gfx::Image image = gfx::Image::CreateFrom1xBitmap(bitmap);
+  EXPECT_TRUE(client->SimulateFaviconLoaded(kPageURL1, kIconURL, image));
+  EXPECT_TRUE(node1->is_favicon_loaded());
+  ASSERT_TRUE(node1->icon_url());
+  EXPECT_EQ(kIconURL, *node1->icon_url());
+  // GetFavicon() above did not start a second request.
+  EXPECT_FALSE(client->SimulateFaviconLoaded(kPageURL1, kIconURL, image));
+
+  // The result for the removed node is dropped.
+  EXPECT_TRUE(client->SimulateFaviconLoaded(kPageURL2, kIconURL, image));
+}
+
 }  // namespace bookmarks
@@ -107,12 +107,14 @@ bool BookmarkNode::SetMetaInfo(const std::string& key,
   auto it = meta_info_map_->find(key);
   if (it == meta_info_map_->end()) {
     (*meta_info_map_)[key] = value;
+    UpdateVivaldiMeta();
     return true;
   }
   // Key already in map, check if the value has changed.
   if (it->second == value)
     return false;
   it->second = value;
+  UpdateVivaldiMeta();
   return true;
 }
 
@@ -122,6 +124,8 @@ bool BookmarkNode::DeleteMetaInfo(const std::string& key) {
   bool erased = meta_info_map_->erase(key) != 0;
   if (meta_info_map_->empty())
     meta_info_map_.reset();
+  if (erased)
+    UpdateVivaldiMeta();
   return erased;
 }
 
@@ -130,6 +134,7 @@ void BookmarkNode::SetMetaInfoMap(const MetaInfoMap& meta_info_map) {
     meta_info_map_.reset();
   else
     meta_info_map_ = std::make_unique<MetaInfoMap>(meta_info_map);
+  UpdateVivaldiMeta();
 }
 
 const BookmarkNode::MetaInfoMap* BookmarkNode::GetMetaInfoMap() const {
@@ -152,6 +152,30 @@ class BookmarkNode : public ui::TreeNode<BookmarkNode>, public TitledUrlNode {
   const std::u16string GetTitledUrlNodeNickName() const override;
   const std::u16string GetTitledUrlNodeDescription() const override;
 
+  // Vivaldi: The Vivaldi properties of the meta info decoded into typed
+  // fields. This is refreshed whenever the meta info changes so readers do not
+  // search the map or parse the partner id on every access. The string
+  // pointers refer to values in the meta info map and are null when the key is
+  // absent.
+  struct VivaldiMeta {
+    VivaldiMeta();
+    ~VivaldiMeta();
+    VivaldiMeta(const VivaldiMeta&) = delete;
+    VivaldiMeta& operator=(const VivaldiMeta&) = delete;
+
+    enum Flags : uint8_t {
+      kSpeeddial = 1 << 0,
+      kBookmarkbar = 1 << 1,
+    };
+
+    uint8_t flags = 0;
+    const std::string* nickname = nullptr;
+    const std::string* description = nullptr;
+    const std::string* thumbnail = nullptr;
+    base::GUID partner;
+  };
+  const VivaldiMeta& vivaldi_meta() const { return vivaldi_meta_; }
+
   // TODO(sky): Consider adding last visit time here, it'll greatly simplify
   // HistoryContentsProvider.
 
@@ -168,6 +192,9 @@ class BookmarkNode : public ui::TreeNode<BookmarkNode>, public TitledUrlNode {
   // Called when the favicon becomes invalid.
   void InvalidateFavicon();
 
+  // Vivaldi: Decodes |meta_info_map_| into |vivaldi_meta_|.
+  void UpdateVivaldiMeta();
+
   // Sets the favicon's URL.
   void set_icon_url(const GURL& icon_url) {
     icon_url_ = std::make_unique<GURL>(icon_url);
@@ -230,6 +257,9 @@ class BookmarkNode : public ui::TreeNode<BookmarkNode>, public TitledUrlNode {
   // A map that stores arbitrary meta information about the node.
   std::unique_ptr<MetaInfoMap> meta_info_map_;
 
+  // Vivaldi: Typed view of |meta_info_map_|, see VivaldiMeta.
+  VivaldiMeta vivaldi_meta_;
+
   const bool is_permanent_node_;
 
   base::Time date_last_used_;
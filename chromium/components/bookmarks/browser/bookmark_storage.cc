@@ -24,6 +24,10 @@
 #include "components/bookmarks/browser/bookmark_node.h"
 #include "components/bookmarks/common/bookmark_metrics.h"
 
+#include "app/vivaldi_apptools.h"
+#include "base/memory/ref_counted_memory.h"
+#include "components/bookmarks/vivaldi_bookmark_snapshot.h"
+
 namespace bookmarks {
 
 namespace {
@@ -89,6 +93,35 @@ BookmarkStorage::GetSerializedDataProducerForBackgroundSequence() {
   base::Value value(
       codec.Encode(model_, model_->client()->EncodeBookmarkSyncMetadata()));
 
+  if (vivaldi::IsVivaldiRunning()) {
+    // Vivaldi: Write the binary snapshot after the JSON file so the snapshot
+    // can be tied to it. The old snapshot is removed first so it is not used
+    // with the new JSON file if the browser exits in between.
+    auto snapshot = base::MakeRefCounted<base::RefCountedString>();
+    writer_.RegisterOnNextWriteCallbacks(
+        base::BindOnce(&vivaldi_bookmark_snapshot::DeleteSnapshot,
+                       writer_.path()),
+        base::BindOnce(
+            [](const base::FilePath& path,
+               scoped_refptr<base::RefCountedString> snapshot, bool success) {
+              if (success) {
+                vivaldi_bookmark_snapshot::WriteSnapshot(path,
+                                                         snapshot->data());
+              }
+            },
+            writer_.path(), snapshot));
+    return base::BindOnce(
+        [](base::Value value, scoped_refptr<base::RefCountedString> snapshot,
+           std::string* output) {
+          // This runs on the background sequence.
+          snapshot->data() = vivaldi_bookmark_snapshot::EncodePayload(value);
+          JSONStringValueSerializer serializer(output);
+          serializer.set_pretty_print(true);
+          return serializer.Serialize(value);
+        },
+        std::move(value), std::move(snapshot));
+  }
+
   return base::BindOnce(
       [](base::Value value, std::string* output) {
         // This runs on the background sequence.
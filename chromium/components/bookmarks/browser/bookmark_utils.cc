@@ -116,18 +116,6 @@ bool HasSelectedAncestor(BookmarkModel* model,
   return HasSelectedAncestor(model, selected_nodes, node->parent());
 }
 
-const BookmarkNode* GetNodeByID(const BookmarkNode* node, int64_t id) {
-  if (node->id() == id)
-    return node;
-
-  for (const auto& child : node->children()) {
-    const BookmarkNode* result = GetNodeByID(child.get(), id);
-    if (result)
-      return result;
-  }
-  return nullptr;
-}
-
 // Attempts to shorten a URL safely (i.e., by preventing the end of the URL
 // from being in the middle of an escape sequence) to no more than
 // kCleanedUpUrlMaxLength characters, returning the result.
@@ -562,8 +550,8 @@ bool IsBookmarkedByUser(BookmarkModel* model, const GURL& url) {
 
 const BookmarkNode* GetBookmarkNodeByID(const BookmarkModel* model,
                                         int64_t id) {
-  // TODO(sky): TreeNode needs a method that visits all nodes using a predicate.
-  return GetNodeByID(model->root_node(), id);
+  // Vivaldi: Look the node up in the id index of the model.
+  return vivaldi_bookmark_kit::FindNodeByID(model, id);
 }
 
 bool IsDescendantOf(const BookmarkNode* node, const BookmarkNode* root) {
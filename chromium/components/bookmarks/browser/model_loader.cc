@@ -22,8 +22,7 @@
 #include "components/bookmarks/common/url_load_stats.h"
 
 #include "app/vivaldi_apptools.h"
-#include "base/threading/thread_task_runner_handle.h"
-#include "components/bookmarks/vivaldi_partners.h"
+#include "components/bookmarks/vivaldi_bookmark_snapshot.h"
 
 namespace bookmarks {
 
@@ -47,12 +46,22 @@ void LoadBookmarks(const base::FilePath& path,
   bool load_index = false;
   bool bookmark_file_exists = base::PathExists(path);
   if (bookmark_file_exists) {
-    // Titles may end up containing invalid utf and we shouldn't throw away
-    // all bookmarks if some titles have invalid utf.
-    JSONFileValueDeserializer deserializer(
-        path, base::JSON_REPLACE_INVALID_CHARACTERS);
-    std::unique_ptr<base::Value> root =
-        deserializer.Deserialize(nullptr, nullptr);
+    std::unique_ptr<base::Value> root;
+    if (vivaldi::IsVivaldiRunning()) {
+      // Vivaldi: Use the binary snapshot when it was written for this JSON
+      // file, it is much faster to read than the JSON text.
+      absl::optional<base::Value> snapshot =
+          vivaldi_bookmark_snapshot::LoadSnapshot(path);
+      if (snapshot)
+        root = base::Value::ToUniquePtrValue(std::move(*snapshot));
+    }
+    if (!root) {
+      // Titles may end up containing invalid utf and we shouldn't throw away
+      // all bookmarks if some titles have invalid utf.
+      JSONFileValueDeserializer deserializer(
+          path, base::JSON_REPLACE_INVALID_CHARACTERS);
+      root = deserializer.Deserialize(nullptr, nullptr);
+    }
 
     if (root) {
       // Building the index can take a while, so we do it on the background
@@ -112,12 +121,6 @@ scoped_refptr<ModelLoader> ModelLoader::Create(
           {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
            base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN});
 
-  if (vivaldi::IsVivaldiRunning()) {
-    model_loader->backend_task_runner_->PostTask(
-        FROM_HERE, base::BindOnce(&vivaldi_partners::LoadOnWorkerThread,
-                                  base::ThreadTaskRunnerHandle::Get()));
-  }
-
   model_loader->backend_task_runner_->PostTaskAndReplyWithResult(
       FROM_HERE,
       base::BindOnce(&ModelLoader::DoLoadOnBackgroundThread, model_loader,
@@ -60,6 +60,12 @@ std::u16string Normalize(const std::u16string& text) {
 
 }  // namespace
 
+TitledUrlIndex::NodeWords::NodeWords() = default;
+TitledUrlIndex::NodeWords::NodeWords(NodeWords&&) = default;
+TitledUrlIndex::NodeWords& TitledUrlIndex::NodeWords::operator=(NodeWords&&) =
+    default;
+TitledUrlIndex::NodeWords::~NodeWords() = default;
+
 TitledUrlIndex::TitledUrlIndex(std::unique_ptr<TitledUrlNodeSorter> sorter)
     : sorter_(std::move(sorter)) {
 }
@@ -75,11 +81,17 @@ void TitledUrlIndex::SetNodeSorter(
 void TitledUrlIndex::Add(const TitledUrlNode* node) {
   for (const std::u16string& term : ExtractIndexTerms(node))
     RegisterNode(term, node);
+#if defined(VIVALDI_BUILD)
+  node_words_[node] = ExtractNodeWords(node);
+#endif
 }
 
 void TitledUrlIndex::Remove(const TitledUrlNode* node) {
   for (const std::u16string& term : ExtractIndexTerms(node))
     UnregisterNode(term, node);
+#if defined(VIVALDI_BUILD)
+  node_words_.erase(node);
+#endif
 }
 
 std::vector<TitledUrlMatch> TitledUrlIndex::GetResultsMatching(
@@ -203,17 +215,18 @@ absl::optional<TitledUrlMatch> TitledUrlIndex::MatchTitledUrlNodeWithQuery(
   // of QueryParser may filter it out.  For example, the query
   // ["thi"] will match the title [Thinking], but since
   // ["thi"] is quoted we don't want to do a prefix match.
-  query_parser::QueryWordVector title_words, url_words, ancestor_words;
-#if BUILDFLAG(IS_ANDROID) && defined(VIVALDI_BUILD)
-  query_parser::QueryWordVector description_words, nickname_words;
+#if defined(VIVALDI_BUILD)
+  NodeWords extracted_words;
+  auto cached_words = node_words_.find(node);
+  if (cached_words == node_words_.end())
+    extracted_words = ExtractNodeWords(node);
+  const NodeWords& words = cached_words != node_words_.end()
+                               ? cached_words->second
+                               : extracted_words;
+#else
+  const NodeWords words = ExtractNodeWords(node);
 #endif
-  const std::u16string lower_title =
-      base::i18n::ToLower(Normalize(node->GetTitledUrlNodeTitle()));
-  query_parser::QueryParser::ExtractQueryWords(lower_title, &title_words);
-  base::OffsetAdjuster::Adjustments adjustments;
-  query_parser::QueryParser::ExtractQueryWords(
-      CleanUpUrlForMatching(node->GetTitledUrlNodeUrl(), &adjustments),
-      &url_words);
+  query_parser::QueryWordVector ancestor_words;
   if (match_ancestor_titles) {
     for (auto ancestor : node->GetTitledUrlNodeAncestorTitles()) {
       query_parser::QueryParser::ExtractQueryWords(
@@ -223,23 +236,15 @@ absl::optional<TitledUrlMatch> TitledUrlIndex::MatchTitledUrlNodeWithQuery(
   }
 
 #if BUILDFLAG(IS_ANDROID) && defined(VIVALDI_BUILD)
-  const std::u16string lower_description =
-      base::i18n::ToLower(Normalize(node->GetTitledUrlNodeDescription()));
-  query_parser::QueryParser::ExtractQueryWords(lower_description,
-                                               &description_words);
-  const std::u16string lower_nickname =
-      base::i18n::ToLower(Normalize(node->GetTitledUrlNodeNickName()));
-  query_parser::QueryParser::ExtractQueryWords(lower_nickname, &nickname_words);
-
   query_parser::Snippet::MatchPositions description_matches, nickname_matches;
 #endif
   query_parser::Snippet::MatchPositions title_matches, url_matches;
   bool query_has_ancestor_matches = false;
   for (const auto& query_node : query_nodes) {
     const bool has_title_matches =
-        query_node->HasMatchIn(title_words, &title_matches);
+        query_node->HasMatchIn(words.title_words, &title_matches);
     const bool has_url_matches =
-        query_node->HasMatchIn(url_words, &url_matches);
+        query_node->HasMatchIn(words.url_words, &url_matches);
     const bool has_ancestor_matches =
         match_ancestor_titles && query_node->HasMatchIn(ancestor_words, false);
     query_has_ancestor_matches =
@@ -249,9 +254,9 @@ absl::optional<TitledUrlMatch> TitledUrlIndex::MatchTitledUrlNodeWithQuery(
       return absl::nullopt;
 #else
     const bool has_description_matches =
-        query_node->HasMatchIn(description_words, &description_matches);
+        query_node->HasMatchIn(words.description_words, &description_matches);
     const bool has_nickname_matches =
-        query_node->HasMatchIn(nickname_words, &nickname_matches);
+        query_node->HasMatchIn(words.nickname_words, &nickname_matches);
     if (!has_title_matches && !has_url_matches && !has_ancestor_matches
         && !has_description_matches && !has_nickname_matches)
       return absl::nullopt;
@@ -266,7 +271,7 @@ absl::optional<TitledUrlMatch> TitledUrlIndex::MatchTitledUrlNodeWithQuery(
   }
 
   TitledUrlMatch match;
-  if (lower_title.length() == node->GetTitledUrlNodeTitle().length()) {
+  if (words.title_positions_valid) {
     // Only use title matches if the lowercase string is the same length
     // as the original string, otherwise the matches are meaningless.
     // TODO(mpearson): revise match positions appropriately.
@@ -277,7 +282,7 @@ absl::optional<TitledUrlMatch> TitledUrlIndex::MatchTitledUrlNodeWithQuery(
   // spec, not the cleaned-up URL string that we used for matching.
   std::vector<size_t> offsets =
       TitledUrlMatch::OffsetsFromMatchPositions(url_matches);
-  base::OffsetAdjuster::UnadjustOffsets(adjustments, &offsets);
+  base::OffsetAdjuster::UnadjustOffsets(words.url_adjustments, &offsets);
   url_matches =
       TitledUrlMatch::ReplaceOffsetsInMatchPositions(url_matches, offsets);
   match.url_match_positions.swap(url_matches);
@@ -451,6 +456,30 @@ std::vector<std::u16string> TitledUrlIndex::ExtractIndexTerms(
   return terms;
 }
 
+// static
+TitledUrlIndex::NodeWords TitledUrlIndex::ExtractNodeWords(
+    const TitledUrlNode* node) {
+  NodeWords words;
+  const std::u16string lower_title =
+      base::i18n::ToLower(Normalize(node->GetTitledUrlNodeTitle()));
+  query_parser::QueryParser::ExtractQueryWords(lower_title, &words.title_words);
+  words.title_positions_valid =
+      lower_title.length() == node->GetTitledUrlNodeTitle().length();
+  query_parser::QueryParser::ExtractQueryWords(
+      CleanUpUrlForMatching(node->GetTitledUrlNodeUrl(),
+                            &words.url_adjustments),
+      &words.url_words);
+#if BUILDFLAG(IS_ANDROID) && defined(VIVALDI_BUILD)
+  query_parser::QueryParser::ExtractQueryWords(
+      base::i18n::ToLower(Normalize(node->GetTitledUrlNodeDescription())),
+      &words.description_words);
+  query_parser::QueryParser::ExtractQueryWords(
+      base::i18n::ToLower(Normalize(node->GetTitledUrlNodeNickName())),
+      &words.nickname_words);
+#endif
+  return words;
+}
+
 void TitledUrlIndex::RegisterNode(const std::u16string& term,
                                   const TitledUrlNode* node) {
   index_[term].insert(node);
@@ -13,6 +13,8 @@
 #include <vector>
 
 #include "base/containers/flat_set.h"
+#include "base/strings/utf_offset_string_conversions.h"
+#include "build/build_config.h"
 #include "components/bookmarks/browser/titled_url_node_sorter.h"
 #include "components/query_parser/query_parser.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
@@ -80,6 +82,25 @@ class TitledUrlIndex {
   using TitledUrlNodes = std::vector<const TitledUrlNode*>;
   using Index = std::map<std::u16string, TitledUrlNodeSet>;
 
+  // The words of a node that queries are matched against.
+  struct NodeWords {
+    NodeWords();
+    NodeWords(NodeWords&&);
+    NodeWords& operator=(NodeWords&&);
+    ~NodeWords();
+
+    query_parser::QueryWordVector title_words;
+    // Title match positions are only meaningful if lowercasing the title did
+    // not change its length.
+    bool title_positions_valid = false;
+    query_parser::QueryWordVector url_words;
+    base::OffsetAdjuster::Adjustments url_adjustments;
+#if BUILDFLAG(IS_ANDROID) && defined(VIVALDI_BUILD)
+    query_parser::QueryWordVector description_words;
+    query_parser::QueryWordVector nickname_words;
+#endif
+  };
+
   // Constructs |sorted_nodes| by copying the matches in |matches| and sorting
   // them.
   void SortMatches(const TitledUrlNodeSet& matches,
@@ -130,6 +151,9 @@ class TitledUrlIndex {
   static std::vector<std::u16string> ExtractIndexTerms(
       const TitledUrlNode* node);
 
+  // Extracts the words |node| is matched with, see NodeWords.
+  static NodeWords ExtractNodeWords(const TitledUrlNode* node);
+
   // Adds |node| to |index_|.
   void RegisterNode(const std::u16string& term, const TitledUrlNode* node);
 
@@ -138,6 +162,14 @@ class TitledUrlIndex {
 
   Index index_;
 
+#if defined(VIVALDI_BUILD)
+  // Vivaldi: The words of every indexed node, extracted when the node is
+  // added. Extracting them with ICU again for each candidate on every
+  // keystroke is costly, more so on Android where matching also looks at the
+  // description and nickname.
+  std::map<const TitledUrlNode*, NodeWords> node_words_;
+#endif
+
   std::unique_ptr<TitledUrlNodeSorter> sorter_;
 };
 
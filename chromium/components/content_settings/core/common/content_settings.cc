@@ -216,6 +216,11 @@ void RendererContentSettingRules::FilterRulesByOutermostMainFrameURL(
   FilterRulesForType(popup_redirect_rules, outermost_main_frame_url);
   FilterRulesForType(mixed_content_rules, outermost_main_frame_url);
   FilterRulesForType(auto_dark_content_rules, outermost_main_frame_url);
+#if defined(VIVALDI_BUILD)
+  // Vivaldi: Send only the autoplay exceptions that apply to the page
+  // instead of the whole list with each navigation.
+  FilterRulesForType(autoplay_rules, outermost_main_frame_url);
+#endif  // VIVALDI_BUILD
 }
 
 RendererContentSettingRules::RendererContentSettingRules() = default;
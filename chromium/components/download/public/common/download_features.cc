@@ -21,14 +21,12 @@ const base::Feature kDownloadAutoResumptionNative {
 #endif
 };
 
-const base::Feature kParallelDownloading {
-  "ParallelDownloading",
-#if BUILDFLAG(IS_ANDROID)
-      base::FEATURE_ENABLED_BY_DEFAULT
-#else
-      base::FEATURE_DISABLED_BY_DEFAULT
-#endif
-};
+// Vivaldi: Enabled on all platforms. Large downloads from servers that
+// support range requests use several connections, and the slices are resumed
+// individually. It can still be turned off with enable-parallel-downloading
+// in vivaldi://flags.
+const base::Feature kParallelDownloading{"ParallelDownloading",
+                                         base::FEATURE_ENABLED_BY_DEFAULT};
 
 const base::Feature kDownloadLater{"DownloadLater",
                                    base::FEATURE_DISABLED_BY_DEFAULT};
@@ -20,6 +20,7 @@
 #include "url/origin.h"
 
 #include "base/base64.h"
+#include "base/hash/hash.h"
 #include "ui/gfx/image/image.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/image/image_skia_rep.h"
@@ -63,6 +64,23 @@ struct VivaldiPreloadedFavicon {
   base::StringPiece favicon_png_base64;
 };
 #include "components/favicon/vivaldi_preloaded_favicons.inc"
+
+// Returns a non-zero hash of kPreloadedFavicons so the database can tell
+// whether it already stores the current set.
+int64_t GetVivaldiPreloadedFaviconsHash() {
+  uint32_t hash = 0;
+  for (const VivaldiPreloadedFavicon& favicon : kPreloadedFavicons) {
+    for (base::StringPiece part : {favicon.page_url, favicon.favicon_url,
+                                   favicon.favicon_png_base64}) {
+      // Chain the hashes so the result depends on the order and the
+      // boundaries of the strings.
+      std::string data(reinterpret_cast<const char*>(&hash), sizeof(hash));
+      part.AppendToString(&data);
+      hash = base::PersistentHash(data);
+    }
+  }
+  return static_cast<int64_t>(hash) + 1;
+}
 }  // namespace
 
 // static
@@ -203,6 +221,33 @@ FaviconBackend::GetFaviconsForUrl(const GURL& page_url,
   return bitmap_results;
 }
 
+std::vector<std::vector<favicon_base::FaviconRawBitmapResult>>
+FaviconBackend::GetFaviconsForUrls(const std::vector<GURL>& page_urls,
+                                   const favicon_base::IconTypeSet& icon_types,
+                                   const std::vector<int>& desired_sizes) {
+  TRACE_EVENT0("browser", "FaviconBackend::GetFaviconsForUrls");
+  std::map<GURL, std::vector<IconMapping>> icon_mappings =
+      db_->GetIconMappingsForPageURLs(page_urls, icon_types);
+
+  std::vector<std::vector<favicon_base::FaviconRawBitmapResult>> results(
+      page_urls.size());
+  for (size_t i = 0; i < page_urls.size(); ++i) {
+    auto mappings = icon_mappings.find(page_urls[i]);
+    if (mappings == icon_mappings.end())
+      continue;
+    std::vector<favicon_base::FaviconID> favicon_ids;
+    for (const IconMapping& mapping : mappings->second)
+      favicon_ids.push_back(mapping.icon_id);
+    results[i] =
+        GetFaviconBitmapResultsForBestMatch(favicon_ids, desired_sizes);
+    if (desired_sizes.size() == 1 && !results[i].empty()) {
+      results[i].assign(1, favicon_base::ResizeFaviconBitmapResult(
+                               results[i], desired_sizes[0]));
+    }
+  }
+  return results;
+}
+
 std::vector<favicon_base::FaviconRawBitmapResult>
 FaviconBackend::GetFaviconForId(favicon_base::FaviconID favicon_id,
                                 int desired_size) {
@@ -825,6 +870,17 @@ bool FaviconBackend::ClearAllExcept(const std::vector<GURL>& kept_page_urls) {
 void FaviconBackend::SetVivaldiPreloadedFavicons() {
   if (!vivaldi::IsVivaldiRunning())
     return;
+
+  // Decoding, rescaling and re-encoding every icon on each startup is costly,
+  // so only store them again when the set changed or some of its rows were
+  // removed since, for example by clearing history.
+  const int64_t hash = GetVivaldiPreloadedFaviconsHash();
+  if (db_->GetVivaldiPreloadedFaviconsHash() == hash &&
+      db_->GetVivaldiPreloadedFaviconMappingCount() ==
+          db_->CountVivaldiPreloadedFaviconMappings()) {
+    return;
+  }
+
   db_->DeleteVivaldiPreloadedFavicons();
 
   for (size_t i = 0; i < std::size(kPreloadedFavicons); i++) {
@@ -850,5 +906,7 @@ void FaviconBackend::SetVivaldiPreloadedFavicons() {
         bitmaps,
         FaviconBitmapType::VIVALDI_PRELOADED);
   }
+  db_->SetVivaldiPreloadedFaviconsState(
+      hash, db_->CountVivaldiPreloadedFaviconMappings());
 }
 }  // namespace favicon
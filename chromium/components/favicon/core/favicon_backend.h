@@ -69,6 +69,14 @@ class FaviconBackend {
       const std::vector<int>& desired_sizes,
       bool fallback_to_host);
 
+  // Vivaldi: Same as GetFaviconsForUrl() without the host fallback for
+  // each of |page_urls|, with the icon mappings of all pages read in chunked
+  // queries. The results are in the order of |page_urls|.
+  std::vector<std::vector<favicon_base::FaviconRawBitmapResult>>
+  GetFaviconsForUrls(const std::vector<GURL>& page_urls,
+                     const favicon_base::IconTypeSet& icon_types,
+                     const std::vector<int>& desired_sizes);
+
   // See function of same name in HistoryService for details.
   std::vector<favicon_base::FaviconRawBitmapResult> GetFaviconForId(
       favicon_base::FaviconID favicon_id,
@@ -106,6 +106,11 @@ const int kCurrentVersionNumber = 8;
 const int kCompatibleVersionNumber = 8;
 const int kDeprecatedVersionNumber = 6;  // and earlier.
 
+// Meta table keys describing the stored Vivaldi preloaded favicons.
+const char kVivaldiPreloadedHashKey[] = "vivaldi_preloaded_favicons_hash";
+const char kVivaldiPreloadedMappingCountKey[] =
+    "vivaldi_preloaded_favicons_mappings";
+
 void FillIconMapping(const GURL& page_url,
                      sql::Statement& statement,
                      IconMapping* icon_mapping) {
@@ -814,6 +819,63 @@ bool FaviconDatabase::GetIconMappingsForPageURL(
   return result;
 }
 
+std::map<GURL, std::vector<IconMapping>>
+FaviconDatabase::GetIconMappingsForPageURLs(
+    const std::vector<GURL>& page_urls,
+    const favicon_base::IconTypeSet& required_icon_types) {
+  // Stay well below the SQLite limit on the number of bound parameters.
+  constexpr size_t kMaxPageURLsPerQuery = 100;
+
+  std::map<std::string, GURL> urls_by_database_url;
+  for (const GURL& page_url : page_urls) {
+    urls_by_database_url.emplace(database_utils::GurlToDatabaseUrl(page_url),
+                                 page_url);
+  }
+
+  std::map<GURL, std::vector<IconMapping>> mappings;
+  auto chunk_begin = urls_by_database_url.begin();
+  while (chunk_begin != urls_by_database_url.end()) {
+    auto chunk_end = chunk_begin;
+    size_t chunk_size = 0;
+    while (chunk_end != urls_by_database_url.end() &&
+           chunk_size < kMaxPageURLsPerQuery) {
+      ++chunk_end;
+      ++chunk_size;
+    }
+
+    std::string placeholders = "?";
+    for (size_t i = 1; i < chunk_size; ++i)
+      placeholders += ",?";
+    sql::Statement statement(db_.GetUniqueStatement(
+        base::StringPrintf("SELECT icon_mapping.id, icon_mapping.icon_id, "
+                           "favicons.icon_type, favicons.url, "
+                           "icon_mapping.page_url "
+                           "FROM icon_mapping "
+                           "INNER JOIN favicons "
+                           "ON icon_mapping.icon_id = favicons.id "
+                           "WHERE icon_mapping.page_url IN (%s) "
+                           "ORDER BY favicons.icon_type DESC",
+                           placeholders.c_str())
+            .c_str()));
+    int index = 0;
+    for (auto i = chunk_begin; i != chunk_end; ++i)
+      statement.BindString(index++, i->first);
+
+    while (statement.Step()) {
+      auto page_url = urls_by_database_url.find(statement.ColumnString(4));
+      if (page_url == urls_by_database_url.end())
+        continue;
+      IconMapping icon_mapping;
+      FillIconMapping(page_url->second, statement, &icon_mapping);
+      if (required_icon_types.count(icon_mapping.icon_type) == 0)
+        continue;
+      mappings[page_url->second].push_back(std::move(icon_mapping));
+    }
+    chunk_begin = chunk_end;
+  }
+  return mappings;
+}
+
 absl::optional<GURL> FaviconDatabase::FindFirstPageURLForHost(
     const GURL& url,
     const favicon_base::IconTypeSet& required_icon_types) {
@@ -1249,26 +1311,51 @@ bool FaviconDatabase::IsFaviconDBStructureIncorrect() {
 }
 
 void FaviconDatabase::DeleteVivaldiPreloadedFavicons() {
-  // Restrict to vivaldi preloaded bitmaps (i.e. with last_requested == -1).
-  // This is called once on starutp to cleanup preloaded favicons before
-  // setting them up anew, so not worth caching.
-  sql::Statement vivaldi_icons(db_.GetUniqueStatement(
-      "SELECT favicons.id "
-      "FROM favicons "
-      "JOIN favicon_bitmaps ON (favicon_bitmaps.icon_id = favicons.id) "
-      "WHERE (favicon_bitmaps.last_requested = ?)"));
-  vivaldi_icons.BindInt64(0, -1);
+  // Restrict to icons with vivaldi preloaded bitmaps (i.e. with
+  // last_requested == -1). The bitmaps go last as the other statements select
+  // through them. This is called rarely, so the statements are not cached.
+  static const char* const kDeleteSql[] = {
+      "DELETE FROM icon_mapping WHERE icon_id IN "
+      "(SELECT icon_id FROM favicon_bitmaps WHERE last_requested = -1)",
+      "DELETE FROM favicons WHERE id IN "
+      "(SELECT icon_id FROM favicon_bitmaps WHERE last_requested = -1)",
+      "DELETE FROM favicon_bitmaps WHERE icon_id IN "
+      "(SELECT icon_id FROM favicon_bitmaps WHERE last_requested = -1)",
+  };
+  for (const char* sql : kDeleteSql) {
+    if (!db_.Execute(sql))
+      return;
+  }
+}
+
+int64_t FaviconDatabase::CountVivaldiPreloadedFaviconMappings() {
+  sql::Statement statement(db_.GetUniqueStatement(
+      "SELECT COUNT(*) "
+      "FROM icon_mapping "
+      "JOIN favicon_bitmaps "
+      "ON (favicon_bitmaps.icon_id = icon_mapping.icon_id) "
+      "WHERE (favicon_bitmaps.last_requested = -1)"));
+  if (!statement.Step())
+    return 0;
+  return statement.ColumnInt64(0);
+}
 
-  std::set<favicon_base::FaviconID> icon_ids;
+int64_t FaviconDatabase::GetVivaldiPreloadedFaviconsHash() {
+  int64_t hash = 0;
+  meta_table_.GetValue(kVivaldiPreloadedHashKey, &hash);
+  return hash;
+}
 
-  while (vivaldi_icons.Step()) {
-    icon_ids.insert(vivaldi_icons.ColumnInt64(0));
-  }
+int64_t FaviconDatabase::GetVivaldiPreloadedFaviconMappingCount() {
+  int64_t count = 0;
+  meta_table_.GetValue(kVivaldiPreloadedMappingCountKey, &count);
+  return count;
+}
 
-  for (favicon_base::FaviconID icon_id : icon_ids) {
-    DeleteFavicon(icon_id);
-    DeleteIconMappingsForFaviconId(icon_id);
-  }
+void FaviconDatabase::SetVivaldiPreloadedFaviconsState(int64_t hash,
+                                                       int64_t mapping_count) {
+  meta_table_.SetValue(kVivaldiPreloadedHashKey, hash);
+  meta_table_.SetValue(kVivaldiPreloadedMappingCountKey, mapping_count);
 }
 
 }  // namespace favicon
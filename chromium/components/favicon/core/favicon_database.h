@@ -67,6 +67,17 @@ class FaviconDatabase {
 
   void DeleteVivaldiPreloadedFavicons();
 
+  // Returns the number of page mappings to bitmaps of the Vivaldi preloaded
+  // favicons, a cheap check that they are all still present.
+  int64_t CountVivaldiPreloadedFaviconMappings();
+
+  // The hash of the preloaded favicon table and the mapping count this
+  // database was last set up with, kept in the meta table. Both are 0 if
+  // the preloaded favicons were never stored.
+  int64_t GetVivaldiPreloadedFaviconsHash();
+  int64_t GetVivaldiPreloadedFaviconMappingCount();
+  void SetVivaldiPreloadedFaviconsState(int64_t hash, int64_t mapping_count);
+
   // Favicon Bitmaps -----------------------------------------------------------
 
   // Returns true if there are favicon bitmaps for |icon_id|. If
@@ -213,6 +224,14 @@ class FaviconDatabase {
   bool GetIconMappingsForPageURL(const GURL& page_url,
                                  std::vector<IconMapping>* mapping_data);
 
+  // Vivaldi: Returns the icon mappings with one of
+  // |required_icon_types| for each of |page_urls| that has any, in descent
+  // order of IconType. The mappings are looked up with one query per chunk of
+  // URLs rather than one query per URL.
+  std::map<GURL, std::vector<IconMapping>> GetIconMappingsForPageURLs(
+      const std::vector<GURL>& page_urls,
+      const favicon_base::IconTypeSet& required_icon_types);
+
   // Given |url|, returns the |page_url| page mapped to an icon with
   // |required_icon_types|, where |page_url| has host = url.host(). This allows
   // for icons to be retrieved when a full URL is not available. For example,
@@ -63,6 +63,17 @@ class FaviconService : public CoreFaviconService, public LargeFaviconProvider {
       favicon_base::FaviconImageCallback callback,
       base::CancelableTaskTracker* tracker) = 0;
 
+  // Vivaldi: Batched version of GetFaviconImageForPageURL() for
+  // |desired_size_in_dip| that reads the favicons of many pages with a few
+  // history tasks rather than one task per page. |callback| runs once for each
+  // entry of |page_urls| with its index as the results of each chunk of pages
+  // arrive. Pending requests are canceled through |tracker|.
+  virtual void GetFaviconImagesForPageURLs(
+      const std::vector<GURL>& page_urls,
+      int desired_size_in_dip,
+      favicon_base::FaviconImagesCallback callback,
+      base::CancelableTaskTracker* tracker) = 0;
+
   // Requests the favicon for the page at |page_url| with one of |icon_types|
   // and with |desired_size_in_pixel|. |icon_types| can be any combination of
   // IconTypes. If there is no favicon bitmap of size |desired_size_in_pixel|,
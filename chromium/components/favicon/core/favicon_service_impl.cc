@@ -9,6 +9,7 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/check_op.h"
 #include "base/hash/hash.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -96,6 +97,57 @@ FaviconServiceImpl::GetFaviconImageForPageURL(
       tracker);
 }
 
+void FaviconServiceImpl::GetFaviconImagesForPageURLs(
+    const std::vector<GURL>& page_urls,
+    int desired_size_in_dip,
+    favicon_base::FaviconImagesCallback callback,
+    base::CancelableTaskTracker* tracker) {
+  TRACE_EVENT0("browser", "FaviconServiceImpl::GetFaviconImagesForPageURLs");
+  // Pages looked up by a single history task. Chunks keep the first results
+  // arriving early and the history thread responsive for large folders.
+  constexpr size_t kPageURLsPerTask = 200;
+
+  const std::vector<int> desired_sizes_in_pixel =
+      GetPixelSizesForFaviconScales(desired_size_in_dip);
+  std::vector<GURL> chunk_urls;
+  std::vector<size_t> chunk_indices;
+  auto flush_chunk = [&]() {
+    if (chunk_urls.empty())
+      return;
+    history_service_->GetFaviconsForURLs(
+        chunk_urls, {favicon_base::IconType::kFavicon}, desired_sizes_in_pixel,
+        base::BindOnce(
+            &FaviconServiceImpl::RunFaviconImagesCallbackWithBitmapResults,
+            base::Unretained(this), callback, desired_size_in_dip,
+            std::move(chunk_indices)),
+        tracker);
+    chunk_urls.clear();
+    chunk_indices.clear();
+  };
+
+  for (size_t i = 0; i < page_urls.size(); ++i) {
+    const GURL& page_url = page_urls[i];
+    if (favicon_client_ && favicon_client_->IsNativeApplicationURL(page_url)) {
+      favicon_client_->GetFaviconForNativeApplicationURL(
+          page_url, desired_sizes_in_pixel,
+          base::BindOnce(
+              &FaviconServiceImpl::RunFaviconImageCallbackWithBitmapResults,
+              base::Unretained(this), base::BindOnce(callback, i),
+              desired_size_in_dip),
+          tracker);
+      continue;
+    }
+    chunk_urls.push_back(
+        (favicon_client_ && favicon_client_->IsReaderModeURL(page_url))
+            ? favicon_client_->GetOriginalUrlFromReaderModeUrl(page_url)
+            : page_url);
+    chunk_indices.push_back(i);
+    if (chunk_urls.size() == kPageURLsPerTask)
+      flush_chunk();
+  }
+  flush_chunk();
+}
+
 base::CancelableTaskTracker::TaskId FaviconServiceImpl::GetRawFaviconForPageURL(
     const GURL& page_url,
     const favicon_base::IconTypeSet& icon_types,
@@ -309,6 +361,20 @@ void FaviconServiceImpl::RunFaviconImageCallbackWithBitmapResults(
   std::move(callback).Run(image_result);
 }
 
+void FaviconServiceImpl::RunFaviconImagesCallbackWithBitmapResults(
+    favicon_base::FaviconImagesCallback callback,
+    int desired_size_in_dip,
+    const std::vector<size_t>& page_indices,
+    const std::vector<std::vector<favicon_base::FaviconRawBitmapResult>>&
+        favicon_bitmap_results_list) {
+  DCHECK_EQ(page_indices.size(), favicon_bitmap_results_list.size());
+  for (size_t i = 0; i < page_indices.size(); ++i) {
+    RunFaviconImageCallbackWithBitmapResults(
+        base::BindOnce(callback, page_indices[i]), desired_size_in_dip,
+        favicon_bitmap_results_list[i]);
+  }
+}
+
 void FaviconServiceImpl::RunFaviconRawBitmapCallbackWithBitmapResults(
     favicon_base::FaviconRawBitmapCallback callback,
     int desired_size_in_pixel,
@@ -66,6 +66,11 @@ class FaviconServiceImpl : public FaviconService {
       const GURL& page_url,
       favicon_base::FaviconImageCallback callback,
       base::CancelableTaskTracker* tracker) override;
+  void GetFaviconImagesForPageURLs(
+      const std::vector<GURL>& page_urls,
+      int desired_size_in_dip,
+      favicon_base::FaviconImagesCallback callback,
+      base::CancelableTaskTracker* tracker) override;
   base::CancelableTaskTracker::TaskId GetRawFaviconForPageURL(
       const GURL& page_url,
       const favicon_base::IconTypeSet& icon_types,
@@ -153,6 +158,16 @@ class FaviconServiceImpl : public FaviconService {
       const std::vector<favicon_base::FaviconRawBitmapResult>&
           favicon_bitmap_results);
 
+  // Vivaldi: Intermediate callback for GetFaviconImagesForPageURLs().
+  // Runs |callback| for each page of a chunk, |page_indices| holding the
+  // index of each page in the original request.
+  void RunFaviconImagesCallbackWithBitmapResults(
+      favicon_base::FaviconImagesCallback callback,
+      int desired_size_in_dip,
+      const std::vector<size_t>& page_indices,
+      const std::vector<std::vector<favicon_base::FaviconRawBitmapResult>>&
+          favicon_bitmap_results_list);
+
   // Intermediate callback for GetRawFavicon() and GetRawFaviconForPageURL()
   // so that history service can deal solely with FaviconResultsCallback.
   // Resizes favicon_base::FaviconRawBitmapResult if necessary and runs
@@ -47,6 +47,11 @@ class MockFaviconService : public FaviconService {
                    const GURL& page_url,
                    favicon_base::FaviconImageCallback callback,
                    base::CancelableTaskTracker* tracker));
+  MOCK_METHOD4(GetFaviconImagesForPageURLs,
+               void(const std::vector<GURL>& page_urls,
+                    int desired_size_in_dip,
+                    favicon_base::FaviconImagesCallback callback,
+                    base::CancelableTaskTracker* tracker));
   MOCK_METHOD6(GetRawFaviconForPageURL,
                base::CancelableTaskTracker::TaskId(
                    const GURL& page_url,
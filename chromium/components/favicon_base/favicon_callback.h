@@ -33,6 +33,18 @@ typedef base::OnceCallback<void(const FaviconRawBitmapResult&)>
 typedef base::OnceCallback<void(const std::vector<FaviconRawBitmapResult>&)>
     FaviconResultsCallback;
 
+// Vivaldi: Callback for functions returning raw favicon data for a list
+// of pages. The outer vector holds the results of each page in the order the
+// pages were requested.
+typedef base::OnceCallback<void(
+    const std::vector<std::vector<FaviconRawBitmapResult>>&)>
+    FaviconResultsListCallback;
+
+// Vivaldi: Callback invoked once for each page of a batched favicon
+// image request with the index of the page in the request.
+typedef base::RepeatingCallback<void(size_t, const FaviconImageResult&)>
+    FaviconImagesCallback;
+
 // Callback for functions returning data for a large icon. |LargeIconResult|
 // will contain either the raw bitmap for a large icon or the style of the
 // fallback to use if a sufficiently large icon could not be found.
@@ -120,6 +120,13 @@ const int kExpirationDelaySec = 30;
 // iteration, so we want to wait longer before checking to avoid wasting CPU.
 const int kExpirationEmptyDelayMin = 5;
 
+// Vivaldi: Lowering vivaldi.days_to_keep_visits can leave years of
+// visits to expire, which the pace above would take weeks to get through.
+// While a reader reports more to expire, expire bigger batches more often.
+// Each batch is still a separate task, so history queries run in between.
+const int kVivaldiNumExpirePerBacklogIteration = 500;
+constexpr base::TimeDelta kVivaldiBacklogExpirationDelay = base::Seconds(2);
+
 // If the expiration timer is delayed by over an hour, then assume that the
 // machine went to sleep.
 constexpr base::TimeDelta kExpirationSleepWakeupThreshold = base::Hours(1);
@@ -577,6 +584,9 @@ void ExpireHistoryBackend::ScheduleExpire() {
     // schedule next iteration after a longer delay.
     InitWorkQueue();
     delay = base::Minutes(kExpirationEmptyDelayMin);
+    vivaldi_expire_backlog_ = false;
+  } else if (vivaldi_expire_backlog_) {
+    delay = kVivaldiBacklogExpirationDelay;
   } else {
     delay = base::Seconds(kExpirationDelaySec);
   }
@@ -609,13 +619,16 @@ void ExpireHistoryBackend::DoExpireIteration() {
 
   const ExpiringVisitsReader* reader = work_queue_.front();
   bool more_to_expire = ExpireSomeOldHistory(
-      GetCurrentExpirationTime(), reader, kNumExpirePerIteration);
+      GetCurrentExpirationTime(), reader,
+      vivaldi_expire_backlog_ ? kVivaldiNumExpirePerBacklogIteration
+                              : kNumExpirePerIteration);
 
   work_queue_.pop();
   if (more_to_expire) {
     // If there are more items to expire, add the reader back to the queue, thus
     // creating a new task for future iterations.
     work_queue_.push(reader);
+    vivaldi_expire_backlog_ = true;
   } else if (internal::kClearOldOnDemandFaviconsEnabled) {
     // Otherwise do a final clean-up - remove old favicons not bound to visits.
     ClearOldOnDemandFaviconsIfPossible(
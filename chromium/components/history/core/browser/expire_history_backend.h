@@ -293,6 +293,10 @@ class ExpireHistoryBackend {
   // iterations.
   base::queue<const ExpiringVisitsReader*> work_queue_;
 
+  // Vivaldi: True from an iteration that left visits to expire until
+  // the work queue runs empty.
+  bool vivaldi_expire_backlog_ = false;
+
   // Readers for various types of visits.
   // TODO(dglazkov): If you are adding another one, please consider reorganizing
   // into a map.
@@ -72,6 +72,8 @@
 #include "base/ios/scoped_critical_action.h"
 #endif
 
+#include "app/vivaldi_apptools.h"
+
 using base::Time;
 using base::TimeTicks;
 using favicon::FaviconBitmap;
@@ -150,6 +152,13 @@ void RunUnlessCanceled(
 // How long we'll wait to do a commit, so that things are batched together.
 const int kCommitIntervalSeconds = 10;
 
+// Vivaldi: The word index for history text search is built in batches of this
+// many rows. The first batch waits until the startup is over and the batches
+// pause in between, so other history tasks are not held up.
+const size_t kURLWordsIndexBatchRows = 500;
+constexpr base::TimeDelta kURLWordsIndexStartDelay = base::Seconds(30);
+constexpr base::TimeDelta kURLWordsIndexBatchDelay = base::Milliseconds(100);
+
 // The maximum number of items we'll allow in the redirect list before
 // deleting some.
 const int kMaxRedirectCount = 32;
@@ -356,6 +365,7 @@ void HistoryBackend::Closing() {
   // Any scheduled commit will have a reference to us, we must make it
   // release that reference before we can be destroyed.
   CancelScheduledCommit();
+  url_words_index_task_.Cancel();
 }
 
 #if BUILDFLAG(IS_IOS)
@@ -1026,6 +1036,9 @@ void HistoryBackend::InitImpl(
   expirer_.StartExpiringOldStuff(base::Days(
     history_database_params.number_of_days_to_keep_visits));
 
+  // Vivaldi
+  ScheduleURLWordsIndexBatch(kURLWordsIndexStartDelay);
+
   LOCAL_HISTOGRAM_TIMES("History.InitTime", TimeTicks::Now() - beginning_time);
 }
 
@@ -2233,6 +2246,17 @@ HistoryBackend::GetFaviconsForURL(const GURL& page_url,
                                              desired_sizes, fallback_to_host);
 }
 
+std::vector<std::vector<favicon_base::FaviconRawBitmapResult>>
+HistoryBackend::GetFaviconsForURLs(const std::vector<GURL>& page_urls,
+                                   const favicon_base::IconTypeSet& icon_types,
+                                   const std::vector<int>& desired_sizes) {
+  if (!favicon_backend_)
+    return std::vector<std::vector<favicon_base::FaviconRawBitmapResult>>(
+        page_urls.size());
+  return favicon_backend_->GetFaviconsForUrls(page_urls, icon_types,
+                                              desired_sizes);
+}
+
 std::vector<favicon_base::FaviconRawBitmapResult>
 HistoryBackend::GetFaviconForID(favicon_base::FaviconID favicon_id,
                                 int desired_size) {
@@ -2499,6 +2523,26 @@ void HistoryBackend::CancelScheduledCommit() {
   scheduled_commit_.Cancel();
 }
 
+void HistoryBackend::ScheduleURLWordsIndexBatch(base::TimeDelta delay) {
+  if (!vivaldi::IsVivaldiRunning() || !url_words_index_task_.IsCancelled())
+    return;
+  url_words_index_task_.Reset(base::BindOnce(
+      &HistoryBackend::BuildURLWordsIndexBatch, base::Unretained(this)));
+  task_runner_->PostDelayedTask(FROM_HERE, url_words_index_task_.callback(),
+                                delay);
+}
+
+void HistoryBackend::BuildURLWordsIndexBatch() {
+  TRACE_EVENT0("browser", "HistoryBackend::BuildURLWordsIndexBatch");
+  url_words_index_task_.Cancel();
+  if (!db_)
+    return;
+  bool more_rows = db_->BuildURLWordsIndexBatch(kURLWordsIndexBatchRows);
+  ScheduleCommit();
+  if (more_rows)
+    ScheduleURLWordsIndexBatch(kURLWordsIndexBatchDelay);
+}
+
 void HistoryBackend::ProcessDBTaskImpl() {
   if (!db_) {
     // db went away, release all the refs.
@@ -2935,6 +2979,9 @@ bool HistoryBackend::ClearAllMainHistory(const URLRows& kept_urls) {
   db_->BeginTransaction();
   db_->GetStartDate(&first_recorded_time_);
 
+  // Vivaldi: The new urls table has no word index.
+  ScheduleURLWordsIndexBatch(kURLWordsIndexStartDelay);
+
   return true;
 }
 
@@ -383,6 +383,12 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
       const std::vector<int>& desired_sizes,
       bool fallback_to_host);
 
+  // Vivaldi
+  std::vector<std::vector<favicon_base::FaviconRawBitmapResult>>
+  GetFaviconsForURLs(const std::vector<GURL>& page_urls,
+                     const favicon_base::IconTypeSet& icon_types,
+                     const std::vector<int>& desired_sizes);
+
   std::vector<favicon_base::FaviconRawBitmapResult> GetFaviconForID(
       favicon_base::FaviconID favicon_id,
       int desired_size);
@@ -797,6 +803,12 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   // does nothing.
   void CancelScheduledCommit();
 
+  // Vivaldi: Schedules building the next batch of the word index for text
+  // search after `delay`, unless a batch is already scheduled. The searches
+  // scan the urls table until the index is complete.
+  void ScheduleURLWordsIndexBatch(base::TimeDelta delay);
+  void BuildURLWordsIndexBatch();
+
   // Segments ------------------------------------------------------------------
 
   // Walks back a segment chain to find the last visit with a non null segment
@@ -903,6 +915,9 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   // one scheduled commit at a time (see ScheduleCommit).
   base::CancelableOnceClosure scheduled_commit_;
 
+  // Vivaldi: The scheduled word index batch, see ScheduleURLWordsIndexBatch().
+  base::CancelableOnceClosure url_words_index_task_;
+
   // Maps recent redirect destination pages to the chain of redirects that
   // brought us to there. Pages that did not have redirects or were not the
   // final redirect in a chain will not be in this list, as well as pages that
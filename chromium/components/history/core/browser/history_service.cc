@@ -625,6 +625,22 @@ base::CancelableTaskTracker::TaskId HistoryService::GetFaviconsForURL(
       std::move(callback));
 }
 
+base::CancelableTaskTracker::TaskId HistoryService::GetFaviconsForURLs(
+    const std::vector<GURL>& page_urls,
+    const favicon_base::IconTypeSet& icon_types,
+    const std::vector<int>& desired_sizes,
+    favicon_base::FaviconResultsListCallback callback,
+    base::CancelableTaskTracker* tracker) {
+  TRACE_EVENT0("browser", "HistoryService::GetFaviconsForURLs");
+  DCHECK(backend_task_runner_) << "History service being called after cleanup";
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return tracker->PostTaskAndReplyWithResult(
+      backend_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&HistoryBackend::GetFaviconsForURLs, history_backend_,
+                     page_urls, icon_types, desired_sizes),
+      std::move(callback));
+}
+
 base::CancelableTaskTracker::TaskId HistoryService::GetLargestFaviconForURL(
     const GURL& page_url,
     const std::vector<favicon_base::IconTypeSet>& icon_types,
@@ -819,6 +819,16 @@ class HistoryService : public KeyedService {
       favicon_base::FaviconResultsCallback callback,
       base::CancelableTaskTracker* tracker);
 
+  // Vivaldi: Same as GetFaviconsForURL() with |fallback_to_host| false
+  // for each of |page_urls|, looked up with a single history task. |callback|
+  // receives the results in the order of |page_urls|.
+  base::CancelableTaskTracker::TaskId GetFaviconsForURLs(
+      const std::vector<GURL>& page_urls,
+      const favicon_base::IconTypeSet& icon_types,
+      const std::vector<int>& desired_sizes,
+      favicon_base::FaviconResultsListCallback callback,
+      base::CancelableTaskTracker* tracker);
+
   // Used by FaviconService to find the first favicon bitmap whose width and
   // height are greater than that of `minimum_size_in_pixels`. This searches
   // for icons by IconType. Each element of `icon_types` is a bitmask of
@@ -4,6 +4,7 @@
 
 #include "components/history/core/browser/url_database.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -17,6 +18,7 @@
 #include "components/history/core/browser/keyword_search_term.h"
 #include "components/history/core/browser/keyword_search_term_util.h"
 #include "components/url_formatter/url_formatter.h"
+#include "sql/meta_table.h"
 #include "sql/statement.h"
 #include "url/gurl.h"
 
@@ -27,6 +29,65 @@ namespace history {
 const char URLDatabase::kURLRowFields[] = HISTORY_URL_ROW_FIELDS;
 const int URLDatabase::kNumURLRowFields = 9;
 
+namespace {
+
+// Vivaldi: Version of the word index, stored in the meta table. Bump it when
+// the table or the extraction of the words changes so the index is rebuilt.
+const char kURLWordsVersionKey[] = "vivaldi_url_words_version";
+const int kURLWordsVersion = 1;
+
+// Vivaldi: Returns true when the word index was built with the current
+// version. Databases without a meta table, like the in-memory one, only have
+// an index built by this version.
+bool IsURLWordsIndexCurrent(sql::Database& db) {
+  if (!sql::MetaTable::DoesTableExist(&db))
+    return true;
+  sql::Statement statement(
+      db.GetUniqueStatement("SELECT value FROM meta WHERE key = ?"));
+  statement.BindString(0, kURLWordsVersionKey);
+  return statement.Step() && statement.ColumnInt(0) == kURLWordsVersion;
+}
+
+bool SetURLWordsIndexVersion(sql::Database& db) {
+  if (!sql::MetaTable::DoesTableExist(&db))
+    return true;
+  sql::Statement statement(db.GetUniqueStatement(
+      "INSERT OR REPLACE INTO meta (key, value) VALUES (?, ?)"));
+  statement.BindString(0, kURLWordsVersionKey);
+  statement.BindInt(1, kURLWordsVersion);
+  return statement.Run();
+}
+
+bool ClearURLWordsIndexVersion(sql::Database& db) {
+  if (!sql::MetaTable::DoesTableExist(&db))
+    return true;
+  sql::Statement statement(
+      db.GetUniqueStatement("DELETE FROM meta WHERE key = ?"));
+  statement.BindString(0, kURLWordsVersionKey);
+  return statement.Run();
+}
+
+// Vivaldi: Extracts the lowercase words of the url and title of a row, as
+// text search matches them.
+void ExtractURLRowWords(const std::u16string& url_spec,
+                        const std::u16string& title,
+                        query_parser::QueryWordVector* query_words) {
+  std::u16string url = base::i18n::ToLower(url_spec);
+  query_parser::QueryParser::ExtractQueryWords(url, query_words);
+  GURL gurl(url);
+  if (gurl.is_valid()) {
+    // Decode punycode to match IDN.
+    std::u16string ascii = base::ASCIIToUTF16(gurl.host());
+    std::u16string utf = url_formatter::IDNToUnicode(gurl.host());
+    if (ascii != utf)
+      query_parser::QueryParser::ExtractQueryWords(utf, query_words);
+  }
+  query_parser::QueryParser::ExtractQueryWords(base::i18n::ToLower(title),
+                                               query_words);
+}
+
+}  // namespace
+
 URLDatabase::URLEnumeratorBase::URLEnumeratorBase()
     : initialized_(false) {
 }
@@ -142,6 +203,16 @@ URLID URLDatabase::GetRowForURL(const GURL& url, URLRow* info) {
 }
 
 bool URLDatabase::UpdateURLRow(URLID url_id, const URLRow& info) {
+  // Vivaldi: Only the title of an existing row can change its words.
+  bool reindex = false;
+  if (ShouldIndexURLWords(url_id)) {
+    sql::Statement title_statement(GetDB().GetCachedStatement(
+        SQL_FROM_HERE, "SELECT title FROM urls WHERE id=?"));
+    title_statement.BindInt64(0, url_id);
+    reindex = title_statement.Step() &&
+              title_statement.ColumnString16(0) != info.title();
+  }
+
   sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "UPDATE urls SET title=?,visit_count=?,typed_count=?,last_visit_time=?,"
         "hidden=?"
@@ -153,7 +224,14 @@ bool URLDatabase::UpdateURLRow(URLID url_id, const URLRow& info) {
   statement.BindInt(4, info.hidden() ? 1 : 0);
   statement.BindInt64(5, url_id);
 
-  return statement.Run() && GetDB().GetLastChangeCount() > 0;
+  if (!statement.Run() || GetDB().GetLastChangeCount() == 0)
+    return false;
+  if (reindex) {
+    URLRow row;
+    if (GetURLRow(url_id, &row))
+      IndexURLWords(url_id, row);
+  }
+  return true;
 }
 
 URLID URLDatabase::AddURLInternal(const URLRow& info, bool is_temporary) {
@@ -190,7 +268,10 @@ URLID URLDatabase::AddURLInternal(const URLRow& info, bool is_temporary) {
             << " to table history.urls.";
     return 0;
   }
-  return GetDB().GetLastInsertRowId();
+  URLID url_id = GetDB().GetLastInsertRowId();
+  if (!is_temporary && ShouldIndexURLWords(url_id))
+    IndexURLWords(url_id, info);
+  return url_id;
 }
 
 bool URLDatabase::URLTableContainsAutoincrement() {
@@ -240,7 +321,11 @@ bool URLDatabase::InsertOrUpdateURLRowByID(const URLRow& info) {
   statement.BindInt64(5, info.last_visit().ToInternalValue());
   statement.BindInt(6, info.hidden() ? 1 : 0);
 
-  return statement.Run();
+  if (!statement.Run())
+    return false;
+  if (ShouldIndexURLWords(info.id()))
+    IndexURLWords(info.id(), info);
+  return true;
 }
 
 bool URLDatabase::DeleteURLRow(URLID id) {
@@ -251,6 +336,9 @@ bool URLDatabase::DeleteURLRow(URLID id) {
   if (!statement.Run())
     return false;
 
+  if (ShouldIndexURLWords(id))
+    DeleteURLWords(id);
+
   // And delete any keyword visits.
   return !has_keyword_search_terms_ || DeleteKeywordSearchTermForURL(id);
 }
@@ -264,6 +352,10 @@ bool URLDatabase::CommitTemporaryURLTable() {
   // HistoryBackend::DeleteAllHistory() for more information on how this works
   // and why it does what it does.
 
+  // Vivaldi: The ids change with the new table, so the word index must be
+  // rebuilt.
+  DropURLWordsIndex();
+
   // Swap the url table out and replace it with the temporary one.
   if (!GetDB().Execute("DROP TABLE urls")) {
     NOTREACHED() << GetDB().GetErrorMessage();
@@ -420,25 +512,49 @@ URLRows URLDatabase::GetTextMatchesWithAlgorithm(
     algorithm =query_parser::MatchingAlgorithm::ALWAYS_PREFIX_SEARCH;
   query_parser::QueryParser::ParseQueryNodes(query, algorithm, &query_nodes);
 
+  std::vector<std::u16string> words;
+  query_parser::QueryParser::ParseQueryWords(base::i18n::ToLower(query),
+                                             algorithm, &words);
+  std::set<URLID> candidates;
+  if (words.empty() || !HasURLWordsIndex() ||
+      !GetURLWordsIndexCandidates(words, &candidates)) {
+    return GetTextMatchesByScan(query_nodes);
+  }
+
+  // The index only narrows down the rows, they are matched exactly like the
+  // scan does to keep the results the same. Match on the stored columns and
+  // only fill, and so parse the URL of, the rows that match.
+  URLRows results;
+  sql::Statement statement(GetDB().GetCachedStatement(
+      SQL_FROM_HERE, "SELECT" HISTORY_URL_ROW_FIELDS "FROM urls WHERE id=?"));
+  for (URLID url_id : candidates) {
+    statement.Reset(true);
+    statement.BindInt64(0, url_id);
+    if (!statement.Step() || statement.ColumnInt(6) != 0)
+      continue;
+    query_parser::QueryWordVector query_words;
+    ExtractURLRowWords(statement.ColumnString16(1), statement.ColumnString16(2),
+                       &query_words);
+    if (!query_parser::QueryParser::DoesQueryMatch(query_words, query_nodes))
+      continue;
+    URLResult info;
+    FillURLRow(statement, &info);
+    if (info.url().is_valid())
+      results.push_back(info);
+  }
+  return results;
+}
+
+URLRows URLDatabase::GetTextMatchesByScan(
+    const query_parser::QueryNodeVector& query_nodes) {
   URLRows results;
   sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "SELECT" HISTORY_URL_ROW_FIELDS "FROM urls WHERE hidden = 0"));
 
   while (statement.Step()) {
     query_parser::QueryWordVector query_words;
-    std::u16string url = base::i18n::ToLower(statement.ColumnString16(1));
-    query_parser::QueryParser::ExtractQueryWords(url, &query_words);
-    GURL gurl(url);
-    if (gurl.is_valid()) {
-      // Decode punycode to match IDN.
-      std::u16string ascii = base::ASCIIToUTF16(gurl.host());
-      std::u16string utf = url_formatter::IDNToUnicode(gurl.host());
-      if (ascii != utf)
-        query_parser::QueryParser::ExtractQueryWords(utf, &query_words);
-    }
-    std::u16string title = base::i18n::ToLower(statement.ColumnString16(2));
-    query_parser::QueryParser::ExtractQueryWords(title, &query_words);
-
+    ExtractURLRowWords(statement.ColumnString16(1), statement.ColumnString16(2),
+                       &query_words);
     if (query_parser::QueryParser::DoesQueryMatch(query_words, query_nodes)) {
       URLResult info;
       FillURLRow(statement, &info);
@@ -449,6 +565,153 @@ URLRows URLDatabase::GetTextMatchesWithAlgorithm(
   return results;
 }
 
+bool URLDatabase::BuildURLWordsIndexBatch(size_t max_rows) {
+  if (HasURLWordsIndex())
+    return false;
+
+  if (!url_words_build_position_) {
+    // Remove what is left from an earlier build that did not finish. The
+    // indices are created up front so the rows that are already covered can
+    // be kept up to date while the rest is indexed.
+    DropURLWordsIndex();
+    if (!GetDB().Execute("CREATE TABLE vivaldi_url_words ("
+                         "word LONGVARCHAR NOT NULL,"
+                         "url_id INTEGER NOT NULL)") ||
+        !GetDB().Execute("CREATE INDEX vivaldi_url_words_word_index ON "
+                         "vivaldi_url_words (word)") ||
+        !GetDB().Execute("CREATE INDEX vivaldi_url_words_url_id_index ON "
+                         "vivaldi_url_words (url_id)")) {
+      DropURLWordsIndex();
+      return false;
+    }
+    url_words_build_position_ = 0;
+  }
+
+  // Hidden rows are indexed as well, as they can become visible later.
+  sql::Statement statement(GetDB().GetCachedStatement(
+      SQL_FROM_HERE,
+      "SELECT id, url, title FROM urls WHERE id > ? ORDER BY id LIMIT ?"));
+  statement.BindInt64(0, *url_words_build_position_);
+  statement.BindInt64(1, static_cast<int64_t>(max_rows));
+  size_t row_count = 0;
+  while (statement.Step()) {
+    URLID url_id = statement.ColumnInt64(0);
+    if (!InsertURLWords(url_id, statement.ColumnString16(1),
+                        statement.ColumnString16(2))) {
+      statement.Reset(true);
+      DropURLWordsIndex();
+      return false;
+    }
+    url_words_build_position_ = url_id;
+    ++row_count;
+  }
+  if (!statement.Succeeded()) {
+    DropURLWordsIndex();
+    return false;
+  }
+  if (row_count == max_rows)
+    return true;
+
+  if (!SetURLWordsIndexVersion(GetDB())) {
+    DropURLWordsIndex();
+    return false;
+  }
+  url_words_build_position_.reset();
+  has_url_words_index_ = true;
+  return false;
+}
+
+bool URLDatabase::HasURLWordsIndex() {
+  if (!has_url_words_index_) {
+    has_url_words_index_ =
+        GetDB().DoesTableExist("vivaldi_url_words") &&
+        GetDB().DoesIndexExist("vivaldi_url_words_word_index") &&
+        IsURLWordsIndexCurrent(GetDB());
+  }
+  return *has_url_words_index_;
+}
+
+bool URLDatabase::GetURLWordsIndexCandidates(
+    const std::vector<std::u16string>& words,
+    std::set<URLID>* candidates) {
+  bool first = true;
+  for (const std::u16string& word : words) {
+    // Like in AutocompleteForPrefix, compare 8-bit strings so sqlite does not
+    // have to convert the stored words.
+    std::string prefix = base::UTF16ToUTF8(word);
+    sql::Statement statement(GetDB().GetCachedStatement(
+        SQL_FROM_HERE,
+        "SELECT DISTINCT url_id FROM vivaldi_url_words "
+        "WHERE word >= ? AND word < ?"));
+    statement.BindString(0, prefix);
+    statement.BindString(1, database_utils::UpperBoundString(prefix));
+
+    std::set<URLID> word_ids;
+    while (statement.Step()) {
+      URLID url_id = statement.ColumnInt64(0);
+      if (first || candidates->count(url_id))
+        word_ids.insert(url_id);
+    }
+    if (!statement.Succeeded())
+      return false;
+    candidates->swap(word_ids);
+    first = false;
+    if (candidates->empty())
+      break;
+  }
+  return true;
+}
+
+bool URLDatabase::ShouldIndexURLWords(URLID url_id) {
+  if (url_words_build_position_)
+    return url_id <= *url_words_build_position_;
+  return HasURLWordsIndex();
+}
+
+bool URLDatabase::IndexURLWords(URLID url_id, const URLRow& info) {
+  return DeleteURLWords(url_id) &&
+         InsertURLWords(url_id,
+                        base::UTF8ToUTF16(info.url().possibly_invalid_spec()),
+                        info.title());
+}
+
+bool URLDatabase::InsertURLWords(URLID url_id,
+                                 const std::u16string& url_spec,
+                                 const std::u16string& title) {
+  query_parser::QueryWordVector query_words;
+  ExtractURLRowWords(url_spec, title, &query_words);
+  std::set<std::u16string> row_words;
+  for (const query_parser::QueryWord& query_word : query_words)
+    row_words.insert(query_word.word);
+
+  for (const std::u16string& word : row_words) {
+    sql::Statement statement(GetDB().GetCachedStatement(
+        SQL_FROM_HERE,
+        "INSERT INTO vivaldi_url_words (word, url_id) VALUES (?,?)"));
+    statement.BindString16(0, word);
+    statement.BindInt64(1, url_id);
+    if (!statement.Run())
+      return false;
+  }
+  return true;
+}
+
+bool URLDatabase::DeleteURLWords(URLID url_id) {
+  sql::Statement statement(GetDB().GetCachedStatement(
+      SQL_FROM_HERE, "DELETE FROM vivaldi_url_words WHERE url_id = ?"));
+  statement.BindInt64(0, url_id);
+  return statement.Run();
+}
+
+void URLDatabase::DropURLWordsIndex() {
+  if (GetDB().DoesTableExist("vivaldi_url_words"))
+    GetDB().Execute("DROP TABLE vivaldi_url_words");
+  // A partial index built later must not pass for the one built before.
+  ClearURLWordsIndexVersion(GetDB());
+  has_url_words_index_ = false;
+  url_words_build_position_.reset();
+}
+
 bool URLDatabase::InitKeywordSearchTermsTable() {
   has_keyword_search_terms_ = true;
   if (!GetDB().DoesTableExist("keyword_search_terms")) {
@@ -7,6 +7,7 @@
 
 #include <stddef.h>
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,7 @@
 #include "components/history/core/browser/url_row.h"
 #include "components/query_parser/query_parser.h"
 #include "sql/statement.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 class GURL;
 
@@ -197,6 +199,12 @@ class URLDatabase {
       const std::u16string& query,
       query_parser::MatchingAlgorithm algorithm);
 
+  // Vivaldi: Indexes the words of up to `max_rows` more rows of the urls
+  // table for the word index used by GetTextMatchesWithAlgorithm(). Starts a
+  // new index when there is no current one. Returns true while rows are left
+  // to index, false when the index is complete or could not be built.
+  bool BuildURLWordsIndexBatch(size_t max_rows);
+
   // Keyword Search Terms ------------------------------------------------------
 
   // Sets the search terms for the specified url/keyword pair.
@@ -322,6 +330,38 @@ class URLDatabase {
   // kHistoryURLRowFields.
   static void FillURLRow(sql::Statement& s, URLRow* i);
 
+  // Vivaldi: Word index over the url and title of every row, used by
+  // GetTextMatchesWithAlgorithm to find prefix matches without scanning the
+  // whole urls table. The index is built in batches by
+  // BuildURLWordsIndexBatch() and kept up to date by the functions that modify
+  // the urls table. Until it is complete, the search falls back to the full
+  // scan. An index built with another version of the schema does not count
+  // and is rebuilt.
+  bool HasURLWordsIndex();
+
+  // Scans the urls table, returning the visible rows matching `query_nodes`.
+  URLRows GetTextMatchesByScan(const query_parser::QueryNodeVector& query_nodes);
+
+  // Returns the ids of the rows having words starting with each of `words`.
+  // Returns false if the index could not be queried.
+  bool GetURLWordsIndexCandidates(const std::vector<std::u16string>& words,
+                                  std::set<URLID>* candidates);
+
+  // Returns true if changes to the row with `url_id` must update the index,
+  // which is the case for the rows a complete or partial index covers.
+  bool ShouldIndexURLWords(URLID url_id);
+
+  // Replaces the indexed words for the given row.
+  bool IndexURLWords(URLID url_id, const URLRow& info);
+  bool InsertURLWords(URLID url_id,
+                      const std::u16string& url_spec,
+                      const std::u16string& title);
+  bool DeleteURLWords(URLID url_id);
+
+  // Drops the index, complete or partial. BuildURLWordsIndexBatch() then
+  // starts over.
+  void DropURLWordsIndex();
+
   // Returns the database for the functions in this interface. The descendant of
   // this class implements these functions to return its objects.
   virtual sql::Database& GetDB() = 0;
@@ -335,6 +375,13 @@ class URLDatabase {
   // True if InitKeywordSearchTermsTable() has been invoked. Not all subclasses
   // have keyword search terms.
   bool has_keyword_search_terms_;
+
+  // Vivaldi: Whether the word index exists, unset until checked.
+  absl::optional<bool> has_url_words_index_;
+
+  // Vivaldi: While the word index is being built, the id of the last row it
+  // covers. Rows are indexed in the order of their ids.
+  absl::optional<URLID> url_words_build_position_;
 };
 
 // The fields and order expected by FillURLRow(). ID is guaranteed to be first
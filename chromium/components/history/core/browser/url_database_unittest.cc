@@ -4,12 +4,15 @@
 
 #include "components/history/core/browser/url_database.h"
 
+#include <set>
+
 #include "base/files/file_path.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/strings/utf_string_conversions.h"
 #include "components/history/core/browser/keyword_search_term.h"
 #include "components/history/core/browser/keyword_search_term_util.h"
 #include "sql/database.h"
+#include "sql/meta_table.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using base::Time;
@@ -29,6 +32,13 @@ bool IsURLRowEqual(const URLRow& a,
          a.hidden() == b.hidden();
 }
 
+std::set<URLID> GetRowIds(const URLRows& rows) {
+  std::set<URLID> ids;
+  for (const URLRow& row : rows)
+    ids.insert(row.id());
+  return ids;
+}
+
 }  // namespace
 
 class URLDatabaseTest : public testing::Test,
@@ -55,6 +65,30 @@ class URLDatabaseTest : public testing::Test,
     EXPECT_TRUE(GetDB().Execute(sql.c_str()));
   }
 
+  URLID AddTitledURL(const std::string& url,
+                     const std::u16string& title,
+                     bool hidden = false) {
+    URLRow row((GURL(url)));
+    row.set_title(title);
+    row.set_last_visit(Time::Now());
+    row.set_hidden(hidden);
+    return AddURL(row);
+  }
+
+  // Returns the rows the word index has words starting with `word` for.
+  std::set<URLID> GetIndexedRows(const std::u16string& word) {
+    std::set<URLID> ids;
+    EXPECT_TRUE(GetURLWordsIndexCandidates({word}, &ids));
+    return ids;
+  }
+
+  URLRows GetTextMatchesFromScan(const std::u16string& query) {
+    query_parser::QueryNodeVector query_nodes;
+    query_parser::QueryParser::ParseQueryNodes(
+        query, query_parser::MatchingAlgorithm::DEFAULT, &query_nodes);
+    return GetTextMatchesByScan(query_nodes);
+  }
+
  protected:
   // Provided for URL/VisitDatabase.
   sql::Database& GetDB() override { return db_; }
@@ -780,4 +814,121 @@ TEST_F(URLDatabaseTest, URLTableContainsAUTOINCREMENTTest) {
   EXPECT_TRUE(URLTableContainsAutoincrement());
 }
 
+// Vivaldi: The word index is built in batches and the search scans the table
+// until it is complete.
+TEST_F(URLDatabaseTest, URLWordsIndexBuiltInBatches) {
+  URLID id1 = AddTitledURL("http://one.example/", u"Apple pie");
+  URLID id2 = AddTitledURL("http://two.example/", u"Apple tart");
+  URLID id3 = AddTitledURL("http://three.example/", u"Apple crumble");
+
+  EXPECT_TRUE(BuildURLWordsIndexBatch(2));
+  EXPECT_FALSE(HasURLWordsIndex());
+  EXPECT_EQ(GetIndexedRows(u"apple"), std::set<URLID>({id1, id2}));
+  EXPECT_EQ(GetRowIds(GetTextMatches(u"apple")),
+            std::set<URLID>({id1, id2, id3}));
+
+  EXPECT_FALSE(BuildURLWordsIndexBatch(2));
+  EXPECT_TRUE(HasURLWordsIndex());
+  EXPECT_EQ(GetIndexedRows(u"apple"), std::set<URLID>({id1, id2, id3}));
+  EXPECT_EQ(GetRowIds(GetTextMatches(u"apple")),
+            std::set<URLID>({id1, id2, id3}));
+}
+
+// Vivaldi: Changes to the rows a partial index already covers update it, the
+// others are picked up by the later batches.
+TEST_F(URLDatabaseTest, URLWordsIndexFollowsChangesWhileBuilding) {
+  URLID id1 = AddTitledURL("http://one.example/", u"Apple pie");
+  URLID id2 = AddTitledURL("http://two.example/", u"Apple tart");
+  URLID id3 = AddTitledURL("http://three.example/", u"Apple crumble");
+  ASSERT_TRUE(BuildURLWordsIndexBatch(1));
+
+  URLRow row;
+  ASSERT_TRUE(GetURLRow(id1, &row));
+  row.set_title(u"Cherry pie");
+  ASSERT_TRUE(UpdateURLRow(id1, row));
+  ASSERT_TRUE(DeleteURLRow(id2));
+  URLID id4 = AddTitledURL("http://four.example/", u"Apple strudel");
+  EXPECT_EQ(GetIndexedRows(u"cherry"), std::set<URLID>({id1}));
+  EXPECT_TRUE(GetIndexedRows(u"apple").empty());
+
+  while (BuildURLWordsIndexBatch(1)) {
+  }
+  ASSERT_TRUE(HasURLWordsIndex());
+  EXPECT_EQ(GetIndexedRows(u"apple"), std::set<URLID>({id3, id4}));
+  EXPECT_EQ(GetIndexedRows(u"cherry"), std::set<URLID>({id1}));
+}
+
+// Vivaldi: A complete index is kept current by AddURL, UpdateURLRow and
+// DeleteURLRow.
+TEST_F(URLDatabaseTest, URLWordsIndexFollowsChanges) {
+  URLID id1 = AddTitledURL("http://one.example/", u"Apple pie");
+  ASSERT_FALSE(BuildURLWordsIndexBatch(10));
+  ASSERT_TRUE(HasURLWordsIndex());
+
+  URLID id2 = AddTitledURL("http://two.example/", u"Apple tart");
+  EXPECT_EQ(GetIndexedRows(u"apple"), std::set<URLID>({id1, id2}));
+  EXPECT_EQ(GetIndexedRows(u"two"), std::set<URLID>({id2}));
+
+  URLRow row;
+  ASSERT_TRUE(GetURLRow(id1, &row));
+  row.set_title(u"Cherry pie");
+  ASSERT_TRUE(UpdateURLRow(id1, row));
+  EXPECT_EQ(GetIndexedRows(u"apple"), std::set<URLID>({id2}));
+  EXPECT_EQ(GetIndexedRows(u"cherry"), std::set<URLID>({id1}));
+  EXPECT_EQ(GetRowIds(GetTextMatches(u"cherry")), std::set<URLID>({id1}));
+
+  ASSERT_TRUE(DeleteURLRow(id2));
+  EXPECT_TRUE(GetIndexedRows(u"apple").empty());
+  EXPECT_TRUE(GetTextMatches(u"apple").empty());
+}
+
+// Vivaldi: An index built with another version is not used and the next
+// build replaces it.
+TEST_F(URLDatabaseTest, URLWordsIndexRebuiltForOtherVersion) {
+  sql::MetaTable meta_table;
+  ASSERT_TRUE(meta_table.Init(&GetDB(), 1, 1));
+  ASSERT_TRUE(GetDB().Execute(
+      "CREATE TABLE vivaldi_url_words ("
+      "word LONGVARCHAR NOT NULL,"
+      "url_id INTEGER NOT NULL)"));
+  ASSERT_TRUE(GetDB().Execute(
+      "CREATE INDEX vivaldi_url_words_word_index ON vivaldi_url_words (word)"));
+  ASSERT_TRUE(GetDB().Execute(
+      "INSERT INTO vivaldi_url_words (word, url_id) VALUES ('stale', 1)"));
+  ASSERT_TRUE(meta_table.SetValue("vivaldi_url_words_version", 0));
+
+  URLID id = AddTitledURL("http://one.example/", u"Apple pie");
+  EXPECT_FALSE(HasURLWordsIndex());
+  EXPECT_EQ(GetRowIds(GetTextMatches(u"apple")), std::set<URLID>({id}));
+
+  EXPECT_FALSE(BuildURLWordsIndexBatch(10));
+  EXPECT_TRUE(HasURLWordsIndex());
+  EXPECT_TRUE(GetIndexedRows(u"stale").empty());
+  EXPECT_EQ(GetIndexedRows(u"apple"), std::set<URLID>({id}));
+  int version = 0;
+  EXPECT_TRUE(meta_table.GetValue("vivaldi_url_words_version", &version));
+  EXPECT_EQ(version, 1);
+}
+
+// Vivaldi: Searches through the index find the same rows as the scan.
+TEST_F(URLDatabaseTest, URLWordsIndexMatchesScan) {
+  AddTitledURL("http://www.google.com/search?q=apple", u"apple - Search");
+  AddTitledURL("http://mail.google.com/", u"Inbox");
+  AddTitledURL("http://apple.example/pie", u"Recipes");
+  AddTitledURL("http://hidden.example/apple", u"Apple", /*hidden=*/true);
+  AddTitledURL("http://xn--bcher-kva.example/", u"Books");
+  AddTitledURL("http://example.com/path/to/page", u"Some Page Title");
+
+  const std::u16string queries[] = {u"apple", u"goo",    u"google search",
+                                    u"bücher", u"page ti", u"recipes apple",
+                                    u"missing"};
+  ASSERT_FALSE(BuildURLWordsIndexBatch(100));
+  ASSERT_TRUE(HasURLWordsIndex());
+  for (const std::u16string& query : queries) {
+    SCOPED_TRACE(query);
+    EXPECT_EQ(GetRowIds(GetTextMatches(query)),
+              GetRowIds(GetTextMatchesFromScan(query)));
+  }
+}
+
 }  // namespace history
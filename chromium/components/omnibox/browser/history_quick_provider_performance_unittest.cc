@@ -2,10 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
 #include <random>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "base/check.h"
 #include "base/run_loop.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
@@ -95,6 +99,10 @@ class HQPPerfTestOnePopularURL : public testing::Test {
   void PrintMeasurements(const std::string& trace_name,
                          const std::vector<base::TimeDelta>& measurements);
 
+  // Reports the median and the 99th percentile of |measurements|.
+  void PrintPercentiles(const std::string& story_name,
+                        std::vector<base::TimeDelta> measurements);
+
   history::HistoryBackend* history_backend() {
     return client_->GetHistoryService()->history_backend_.get();
   }
@@ -183,6 +191,26 @@ void HQPPerfTestOnePopularURL::PrintMeasurements(
   reporter.AddResultList(".duration", durations);
 }
 
+void HQPPerfTestOnePopularURL::PrintPercentiles(
+    const std::string& story_name,
+    std::vector<base::TimeDelta> measurements) {
+  DCHECK(!measurements.empty());
+  std::sort(measurements.begin(), measurements.end());
+  auto percentile = [&measurements](size_t p) {
+    return static_cast<size_t>(
+        measurements[(measurements.size() - 1) * p / 100].InMicroseconds());
+  };
+
+  auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  auto metric_prefix = std::string(test_info->test_case_name()) + "_" +
+                       std::string(test_info->name());
+  perf_test::PerfResultReporter reporter(metric_prefix, story_name);
+  reporter.RegisterImportantMetric(".duration_p50", "us");
+  reporter.RegisterImportantMetric(".duration_p99", "us");
+  reporter.AddResult(".duration_p50", percentile(50));
+  reporter.AddResult(".duration_p99", percentile(99));
+}
+
 base::TimeDelta HQPPerfTestOnePopularURL::RunTest(const std::u16string& text) {
   base::RunLoop().RunUntilIdle();
   AutocompleteInput input(text, metrics::OmniboxEventProto::OTHER,
@@ -204,6 +232,7 @@ void HQPPerfTestOnePopularURL::RunAllTests(PieceIt first, PieceIt last) {
   constexpr size_t kTestGroupSize = 5;
   std::vector<base::TimeDelta> measurements;
   measurements.reserve(kTestGroupSize);
+  std::vector<base::TimeDelta> all_measurements;
 
   for (PieceIt group_start = first; group_start != last;) {
     PieceIt group_end = std::min(group_start + kTestGroupSize, last);
@@ -217,9 +246,12 @@ void HQPPerfTestOnePopularURL::RunAllTests(PieceIt first, PieceIt last) {
                           std::to_string((group_end - 1)->size()),
                       measurements);
 
+    all_measurements.insert(all_measurements.end(), measurements.begin(),
+                            measurements.end());
     measurements.clear();
     group_start = group_end;
   }
+  PrintPercentiles("all", std::move(all_measurements));
 }
 
 TEST_F(HQPPerfTestOnePopularURL, Typing) {
@@ -292,7 +292,11 @@ void InMemoryURLIndex::Shutdown() {
     return;
   private_data_tracker_.TryCancelAll();
 
-  if (!base::FeatureList::IsEnabled(
+  // Vivaldi: Only rewrite the cache when the index changed since it was
+  // restored or last saved. On large histories the file is tens of MB, and
+  // the cache restored at startup is still current if nothing was visited.
+  if (needs_to_be_cached_ &&
+      !base::FeatureList::IsEnabled(
           omnibox::kHistoryQuickProviderAblateInMemoryURLIndexCacheFile)) {
     task_runner_->PostTask(
         FROM_HERE,
@@ -383,9 +387,13 @@ void InMemoryURLIndex::PostSaveToCacheFileTask() {
     // If there is no data in our index then delete any existing cache file.
     task_runner_->PostTask(FROM_HERE, base::GetDeleteFileCallback(path));
   }
+  needs_to_be_cached_ = false;
 }
 
 void InMemoryURLIndex::OnCacheSaveDone(bool succeeded) {
+  // Try again on shutdown.
+  if (!succeeded && !shutdown_)
+    needs_to_be_cached_ = true;
   if (save_cache_observer_)
     save_cache_observer_->OnCacheSaveFinished(succeeded);
 }
@@ -12,7 +12,9 @@
 #include <numeric>
 #include <set>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "base/containers/cxx20_erase.h"
 #include "base/containers/stack.h"
@@ -564,12 +566,39 @@ bool URLIndexPrivateData::TrimHistoryIdsPool(
 
   // Trim down the set by sorting by typed-count, visit-count, and last
   // visit.
-  auto new_end = history_ids->begin() + kItemsToScoreLimit;
-  HistoryItemFactorGreater item_factor_functor(history_info_map_);
+  // Vivaldi: Short prefixes on large histories give tens of thousands
+  // of candidates. Look each one up once instead of twice per comparison.
+  struct Candidate {
+    int typed_count;
+    int visit_count;
+    base::Time last_visit;
+    HistoryID history_id;
+  };
+  std::vector<Candidate> candidates;
+  candidates.reserve(history_ids->size());
+  for (HistoryID history_id : *history_ids) {
+    auto entry = history_info_map_.find(history_id);
+    // Items missing from the map sort last.
+    if (entry == history_info_map_.end()) {
+      candidates.push_back({-1, -1, base::Time(), history_id});
+      continue;
+    }
+    const history::URLRow& row = entry->second.url_row;
+    candidates.push_back(
+        {row.typed_count(), row.visit_count(), row.last_visit(), history_id});
+  }
 
-  std::nth_element(history_ids->begin(), new_end, history_ids->end(),
-                   item_factor_functor);
-  history_ids->erase(new_end, history_ids->end());
+  auto new_end = candidates.begin() + kItemsToScoreLimit;
+  std::nth_element(candidates.begin(), new_end, candidates.end(),
+                   [](const Candidate& c1, const Candidate& c2) {
+                     return std::tie(c1.typed_count, c1.visit_count,
+                                     c1.last_visit) >
+                            std::tie(c2.typed_count, c2.visit_count,
+                                     c2.last_visit);
+                   });
+  history_ids->resize(kItemsToScoreLimit);
+  std::transform(candidates.begin(), new_end, history_ids->begin(),
+                 [](const Candidate& c) { return c.history_id; });
 
   return true;
 }
@@ -1308,35 +1337,3 @@ size_t URLIndexPrivateData::SearchTermCacheItem::EstimateMemoryUsage() const {
 
 URLIndexPrivateData::SearchTermCacheItem::~SearchTermCacheItem() {
 }
-
-// URLIndexPrivateData::HistoryItemFactorGreater -------------------------------
-
-URLIndexPrivateData::HistoryItemFactorGreater::HistoryItemFactorGreater(
-    const HistoryInfoMap& history_info_map)
-    : history_info_map_(history_info_map) {
-}
-
-URLIndexPrivateData::HistoryItemFactorGreater::~HistoryItemFactorGreater() {
-}
-
-bool URLIndexPrivateData::HistoryItemFactorGreater::operator()(
-    const HistoryID h1,
-    const HistoryID h2) {
-  auto entry1(history_info_map_.find(h1));
-  if (entry1 == history_info_map_.end())
-    return false;
-  auto entry2(history_info_map_.find(h2));
-  if (entry2 == history_info_map_.end())
-    return true;
-  const history::URLRow& r1(entry1->second.url_row);
-  const history::URLRow& r2(entry2->second.url_row);
-  // First cut: typed count, visit count, recency.
-  // TODO(mrossetti): This is too simplistic. Consider an approach which ranks
-  // recently visited (within the last 12/24 hours) as highly important. Get
-  // input from mpearson.
-  if (r1.typed_count() != r2.typed_count())
-    return (r1.typed_count() > r2.typed_count());
-  if (r1.visit_count() != r2.visit_count())
-    return (r1.visit_count() > r2.visit_count());
-  return (r1.last_visit() > r2.last_visit());
-}
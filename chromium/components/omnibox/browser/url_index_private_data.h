@@ -204,19 +204,6 @@ class URLIndexPrivateData
   };
   typedef std::map<std::u16string, SearchTermCacheItem> SearchTermCacheMap;
 
-  // A helper predicate class used to filter excess history items when the
-  // candidate results set is too large.
-  class HistoryItemFactorGreater {
-   public:
-    explicit HistoryItemFactorGreater(const HistoryInfoMap& history_info_map);
-    ~HistoryItemFactorGreater();
-
-    bool operator()(const HistoryID h1, const HistoryID h2);
-
-   private:
-    const HistoryInfoMap& history_info_map_;
-  };
-
   // URL History indexing support functions.
 
   // Composes a vector of history item IDs by intersecting the set for each word
@@ -241,31 +241,6 @@ const char* VivaldiGetDefaultProviderGuidPrefForType(
 
 }  // namespace
 
-// TemplateURLService::LessWithPrefix -----------------------------------------
-
-class TemplateURLService::LessWithPrefix {
- public:
-  // We want to find the set of keywords that begin with a prefix.  The STL
-  // algorithms will return the set of elements that are "equal to" the
-  // prefix, where "equal(x, y)" means "!(cmp(x, y) || cmp(y, x))".  When
-  // cmp() is the typical std::less<>, this results in lexicographic equality;
-  // we need to extend this to mark a prefix as "not less than" a keyword it
-  // begins, which will cause the desired elements to be considered "equal to"
-  // the prefix.  Note: this is still a strict weak ordering, as required by
-  // equal_range() (though I will not prove that here).
-  //
-  // Unfortunately the calling convention is not "prefix and element" but
-  // rather "two elements", so we pass the prefix as a fake "element" which has
-  // a NULL KeywordDataElement pointer.
-  bool operator()(
-      const KeywordToTURLAndMeaningfulLength::value_type& elem1,
-      const KeywordToTURLAndMeaningfulLength::value_type& elem2) const {
-    return (elem1.second.first == nullptr)
-               ? (elem2.first.compare(0, elem1.first.length(), elem1.first) > 0)
-               : (elem1.first < elem2.first);
-  }
-};
-
 // TemplateURLService::Scoper -------------------------------------------------
 
 class TemplateURLService::Scoper {
@@ -2597,18 +2572,15 @@ void TemplateURLService::AddMatchingKeywordsHelper(
     return;
   DCHECK(matches);
 
-  // Find matching keyword range.  Searches the element map for keywords
-  // beginning with |prefix| and stores the endpoints of the resulting set in
-  // |match_range|.
-  const auto match_range(std::equal_range(
-      keyword_to_turl_and_length.begin(), keyword_to_turl_and_length.end(),
-      typename Container::value_type(prefix,
-                                     TURLAndMeaningfulLength(nullptr, 0)),
-      LessWithPrefix()));
-
-  // Add to vector of matching keywords.
-  for (typename Container::const_iterator i(match_range.first);
-    i != match_range.second; ++i) {
+  // Vivaldi: std::equal_range() over the map iterators advances them
+  // linearly as they are not random access, which made each keystroke in the
+  // address field walk all keywords. Keywords with |prefix| are adjacent in the
+  // map, so start at the first one and stop at the first keyword without it.
+  for (typename Container::const_iterator i(
+           keyword_to_turl_and_length.lower_bound(prefix));
+       i != keyword_to_turl_and_length.end() &&
+       base::StartsWith(i->first, prefix);
+       ++i) {
     if (!supports_replacement_only ||
         i->second.first->url_ref().SupportsReplacement(search_terms_data()))
       matches->push_back(i->second);
@@ -589,10 +589,6 @@ class TemplateURLService : public WebDataServiceConsumer,
     DSP_CHANGE_MAX,
   };
 
-  // Helper functor for FindMatchingKeywords(), for finding the range of
-  // keywords which begin with a prefix.
-  class LessWithPrefix;
-
   // Used to defer notifications until the last Scoper is destroyed by leaving
   // the scope of a code block.
   class Scoper;
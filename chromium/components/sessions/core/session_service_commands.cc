@@ -917,6 +917,45 @@ std::unique_ptr<SessionCommand> CreateSessionCommandForPayload(
   return command;
 }
 
+// Vivaldi: Read the id of the tab or window an ext data command applies to.
+// Like other string commands the payload is a pickle with the id first.
+bool ReadVivExtDataCommandId(const SessionCommand& command,
+                             SessionID::id_type* id) {
+  std::unique_ptr<base::Pickle> pickle(command.PayloadAsPickle());
+  if (!pickle)
+    return false;
+  base::PickleIterator iterator(*pickle);
+  return iterator.ReadInt(id);
+}
+
+// Vivaldi: The UI rewrites the ext data of tabs and windows on many changes
+// and only the last value is used on restore. So replace a pending command for
+// the same tab or window instead of appending the full data again.
+bool ReplacePendingVivExtDataCommand(
+    CommandStorageManager* command_storage_manager,
+    std::unique_ptr<SessionCommand>* command) {
+  SessionID::id_type command_id;
+  if (!ReadVivExtDataCommandId(**command, &command_id))
+    return false;
+  for (auto i = command_storage_manager->pending_commands().rbegin();
+       i != command_storage_manager->pending_commands().rend(); ++i) {
+    SessionCommand* existing_command = i->get();
+    if (existing_command->id() != (*command)->id())
+      continue;
+    SessionID::id_type existing_id;
+    if (!ReadVivExtDataCommandId(*existing_command, &existing_id))
+      return false;
+    if (existing_id == command_id) {
+      // As with navigation updates add the new command to the end of the list
+      // in case there is a closing command after the existing one.
+      command_storage_manager->EraseCommand(existing_command);
+      command_storage_manager->AppendRebuildCommand(std::move(*command));
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 // Vivaldi functions. Has to be after CreateTabsAndWindows().
@@ -1168,6 +1207,11 @@ std::unique_ptr<SessionCommand> CreateAddWindowExtraDataCommand(
 
 bool ReplacePendingCommand(CommandStorageManager* command_storage_manager,
                            std::unique_ptr<SessionCommand>* command) {
+  if ((*command)->id() == kCommandSetExtData ||
+      (*command)->id() == kCommandSetWindowExtData) {
+    return ReplacePendingVivExtDataCommand(command_storage_manager, command);
+  }
+
   // We optimize page navigations, which can happen quite frequently and
   // is expensive. And activation is like Highlander, there can only be one!
   if ((*command)->id() != kCommandUpdateTabNavigation &&
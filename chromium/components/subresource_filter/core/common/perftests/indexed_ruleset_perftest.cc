@@ -8,21 +8,28 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/path_service.h"
 #include "base/time/time.h"
 #include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "components/subresource_filter/core/common/first_party_origin.h"
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
 #include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
 #include "components/subresource_filter/tools/filter_tool.h"
 #include "components/subresource_filter/tools/indexing_tool.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+#include "url/origin.h"
 
 namespace subresource_filter {
 
@@ -31,6 +38,32 @@ namespace {
 static constexpr char kMetricIndexAndWriteTimeUs[] = "index_and_write_time";
 static constexpr char kMetricMedianMatchTimeUs[] = "median_match_time";
 
+// A request from the requests file, parsed ahead of matching.
+struct ParsedRequest {
+  GURL url;
+  FirstPartyOrigin first_party;
+  url_pattern_index::proto::ElementType element_type;
+};
+
+url_pattern_index::proto::ElementType ParseElementType(
+    const std::string& type) {
+  if (type == "script")
+    return url_pattern_index::proto::ELEMENT_TYPE_SCRIPT;
+  if (type == "image")
+    return url_pattern_index::proto::ELEMENT_TYPE_IMAGE;
+  if (type == "stylesheet")
+    return url_pattern_index::proto::ELEMENT_TYPE_STYLESHEET;
+  if (type == "xmlhttprequest")
+    return url_pattern_index::proto::ELEMENT_TYPE_XMLHTTPREQUEST;
+  if (type == "subdocument")
+    return url_pattern_index::proto::ELEMENT_TYPE_SUBDOCUMENT;
+  if (type == "font")
+    return url_pattern_index::proto::ELEMENT_TYPE_FONT;
+  if (type == "media")
+    return url_pattern_index::proto::ELEMENT_TYPE_MEDIA;
+  return url_pattern_index::proto::ELEMENT_TYPE_OTHER;
+}
+
 }  // namespace
 
 class IndexedRulesetPerftest : public testing::Test {
@@ -66,13 +99,15 @@ class IndexedRulesetPerftest : public testing::Test {
     base::File indexed_file =
         base::File(indexed_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
     ASSERT_TRUE(indexed_file.IsValid());
-    auto ruleset = subresource_filter::MemoryMappedRuleset::CreateAndInitialize(
+    ruleset_ = subresource_filter::MemoryMappedRuleset::CreateAndInitialize(
         std::move(indexed_file));
-    filter_tool_ = std::make_unique<FilterTool>(std::move(ruleset), &output_);
+    filter_tool_ = std::make_unique<FilterTool>(ruleset_, &output_);
   }
 
   FilterTool* filter_tool() { return filter_tool_.get(); }
 
+  const MemoryMappedRuleset* ruleset() const { return ruleset_.get(); }
+
   const std::string& requests() const { return requests_; }
 
   const base::FilePath& unindexed_path() const { return unindexed_path_; }
@@ -90,6 +125,8 @@ class IndexedRulesetPerftest : public testing::Test {
 
   std::string requests_;
 
+  scoped_refptr<MemoryMappedRuleset> ruleset_;
+
   // Use an unopened output stream as a sort of null stream. All writes will
   // fail so things should be a bit faster than writing to a string.
   std::ofstream output_;
@@ -123,4 +160,44 @@ TEST_F(IndexedRulesetPerftest, MatchAll) {
   reporter.AddResult(kMetricMedianMatchTimeUs, static_cast<size_t>(results[2]));
 }
 
+// Unlike MatchAll this excludes the JSON parsing of the requests, so it only
+// measures the lookups in the index.
+TEST_F(IndexedRulesetPerftest, MatchOnly) {
+  std::vector<ParsedRequest> parsed_requests;
+  std::istringstream request_stream(requests());
+  std::string line;
+  while (std::getline(request_stream, line)) {
+    if (line.empty())
+      continue;
+    absl::optional<base::Value> request = base::JSONReader::Read(line);
+    ASSERT_TRUE(request && request->is_dict());
+    const std::string* origin = request->FindStringKey("origin");
+    const std::string* url = request->FindStringKey("request_url");
+    const std::string* type = request->FindStringKey("request_type");
+    ASSERT_TRUE(origin && url && type);
+    parsed_requests.push_back(
+        {GURL(*url), FirstPartyOrigin(url::Origin::Create(GURL(*origin))),
+         ParseElementType(*type)});
+  }
+
+  IndexedRulesetMatcher matcher(ruleset()->data(), ruleset()->length());
+  std::vector<int64_t> results;
+  size_t blocked_count = 0;
+  for (int i = 0; i < 5; ++i) {
+    base::ElapsedTimer timer;
+    for (const ParsedRequest& request : parsed_requests) {
+      if (matcher.GetLoadPolicyForResourceLoad(
+              request.url, request.first_party, request.element_type,
+              false /* disable_generic_rules */) == LoadPolicy::DISALLOW) {
+        ++blocked_count;
+      }
+    }
+    results.push_back(timer.Elapsed().InMicroseconds());
+  }
+  EXPECT_GT(blocked_count, 0u);
+  std::sort(results.begin(), results.end());
+  perf_test::PerfResultReporter reporter = SetUpReporter("MatchOnly");
+  reporter.AddResult(kMetricMedianMatchTimeUs, static_cast<size_t>(results[2]));
+}
+
 }  // namespace subresource_filter
@@ -311,6 +311,16 @@ IDNConversionResult IDNToUnicodeWithAdjustmentsImpl(
   host16.reserve(host.length());
   host16.insert(host16.end(), host.begin(), host.end());
 
+  // Vivaldi: Only labels starting with the ACE prefix are converted, so
+  // a host without one is returned as is. Panels format thousands of such
+  // URLs at a time, so this skips splitting them into labels and looking up
+  // the top level domain.
+  if (host.find("xn--") == base::StringPiece::npos) {
+    IDNConversionResult result;
+    result.result = std::move(host16);
+    return result;
+  }
+
   // Compute the top level domain to be used in spoof checks later.
   base::StringPiece top_level_domain;
   std::u16string top_level_domain_unicode;
@@ -8,9 +8,11 @@
 #include <limits>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/check_op.h"
+#include "base/containers/contains.h"
 #include "base/containers/flat_map.h"
 #include "base/no_destructor.h"
 #include "base/notreached.h"
@@ -21,6 +23,7 @@
 #include "components/url_pattern_index/ngram_extractor.h"
 #include "components/url_pattern_index/url_pattern.h"
 #include "components/url_pattern_index/url_rule_util.h"
+#include "third_party/abseil-cpp/absl/container/inlined_vector.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 #include "url/origin.h"
@@ -717,6 +720,13 @@ const flat::UrlRule* FindMatchInFlatUrlPatternIndex(
   };
   const flat::UrlRule* max_priority_rule = nullptr;
 
+  // Vivaldi: A URL often contains the same n-gram several times, in
+  // repeated path segments or query values. The rules of a bucket only need to
+  // be checked once, and checking them again for kAll would report them
+  // twice. Only a handful of buckets are hit per URL, so a linear search is
+  // enough and the list usually fits on the stack.
+  absl::InlinedVector<const flat::NGramToRules*, 16> checked_entries;
+
   for (uint64_t ngram : ngrams) {
     const uint32_t slot_index = prober.FindSlot(
         ngram, hash_table->size(),
@@ -730,6 +740,9 @@ const flat::UrlRule* FindMatchInFlatUrlPatternIndex(
     const flat::NGramToRules* entry = hash_table->Get(slot_index);
     if (entry == empty_slot)
       continue;
+    if (base::Contains(checked_entries, entry))
+      continue;
+    checked_entries.push_back(entry);
     const flat::UrlRule* rule = FindMatchAmongCandidates(
         entry->rule_list(), url, document_origin, element_type, activation_type,
         request_method, is_third_party, disable_generic_rules,
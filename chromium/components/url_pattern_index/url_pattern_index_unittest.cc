@@ -828,6 +828,18 @@ TEST_F(UrlPatternIndexTest, MultipleRuleMatches) {
   }
 }
 
+TEST_F(UrlPatternIndexTest, FindAllMatchesWithRepeatedNGram) {
+  ASSERT_TRUE(AddUrlRule(MakeUrlRule(UrlPattern("tracker", kSubstring))));
+  Finish();
+
+  // The rule's n-gram occurs twice in the URL but the rule matches once.
+  std::vector<const flat::UrlRule*> matched_rules =
+      FindAllMatches("http://tracker.com/tracker?tracker=1",
+                     "" /* document_origin_string */, testing::kOther,
+                     kNoActivation, false /* disable_generic_rules */);
+  EXPECT_EQ(1u, matched_rules.size());
+}
+
 TEST_F(UrlPatternIndexTest, MatchWithDisableGenericRules) {
   const struct {
     const char* url_pattern;
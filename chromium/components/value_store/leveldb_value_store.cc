@@ -137,6 +137,11 @@ ValueStore::WriteResult LeveldbValueStore::Set(WriteOptions options,
   if (!status.ok())
     return WriteResult(std::move(status));
 
+  // Vivaldi: Nothing to write if the value is already stored, see the
+  // dictionary version below.
+  if (!(options & NO_GENERATE_CHANGES) && changes.empty())
+    return WriteResult(std::move(changes), std::move(status));
+
   status.Merge(WriteToDb(&batch));
   return status.ok() ? WriteResult(std::move(changes), std::move(status))
                      : WriteResult(std::move(status));
@@ -158,6 +163,12 @@ ValueStore::WriteResult LeveldbValueStore::Set(
       return WriteResult(std::move(status));
   }
 
+  // Vivaldi: The UI saves its state by setting every key again, mostly
+  // with the values already stored. When changes are generated, the batch is
+  // empty exactly when there are none, so there is nothing to write.
+  if (!(options & NO_GENERATE_CHANGES) && changes.empty())
+    return WriteResult(std::move(changes), std::move(status));
+
   status.Merge(WriteToDb(&batch));
   return status.ok() ? WriteResult(std::move(changes), std::move(status))
                      : WriteResult(std::move(status));
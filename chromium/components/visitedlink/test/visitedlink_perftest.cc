@@ -33,6 +33,8 @@ static constexpr char kMetricColdLoadTimeMs[] = "cold_load_time";
 static constexpr char kMetricHotLoadTimeMs[] = "hot_load_time";
 static constexpr char kMetricAddURLTimeMs[] = "add_url_time";
 static constexpr char kMetricAddURLsTimeMs[] = "add_urls_time";
+static constexpr char kMetricGrowthTimeMs[] = "growth_time";
+static constexpr char kMetricMaxAddURLTimeMs[] = "max_add_url_time";
 
 perf_test::PerfResultReporter SetUpReporter(const std::string& metric_suffix) {
   perf_test::PerfResultReporter reporter("VisitedLink.", metric_suffix);
@@ -44,6 +46,8 @@ perf_test::PerfResultReporter SetUpReporter(const std::string& metric_suffix) {
   reporter.RegisterImportantMetric(kMetricHotLoadTimeMs, "ms");
   reporter.RegisterImportantMetric(kMetricAddURLTimeMs, "ms");
   reporter.RegisterImportantMetric(kMetricAddURLsTimeMs, "ms");
+  reporter.RegisterImportantMetric(kMetricGrowthTimeMs, "ms");
+  reporter.RegisterImportantMetric(kMetricMaxAddURLTimeMs, "ms");
   return reporter;
 }
 
@@ -85,6 +89,7 @@ void TimeLogger::Done() {
 // how we generate URLs, note that the two strings should be the same length
 const int kAddCount = 10000;
 const int kLoadTestInitialCount = 250000;
+const int kGrowthTestCount = 1000000;
 const char kAddedPrefix[] =
     "http://www.google.com/stuff/something/"
     "foo?session=85025602345625&id=1345142319023&seq=";
@@ -271,4 +276,39 @@ TEST_F(VisitedLink, MAYBE_TestBigTable) {
   add_urls_timer.Done();
 }
 
+// Tests growing an empty table to a large history one URL at a time. Each
+// resize happens on the thread that adds the URL, so besides the total time
+// this reports the slowest single AddURL(), which is the longest stall a
+// resize causes.
+// Like TestBigTable, too slow and flaky on macOS and Android
+// (crbug.com/1128183).
+#if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_ANDROID)
+#define MAYBE_TestGrowth DISABLED_TestGrowth
+#else
+#define MAYBE_TestGrowth TestGrowth
+#endif
+TEST_F(VisitedLink, MAYBE_TestGrowth) {
+  base::test::ScopedDisableRunLoopTimeout disable_run_timeout;
+  VisitedLinkWriter writer(new DummyVisitedLinkEventListener(), nullptr, true,
+                           true, db_path_, 0);
+  ASSERT_TRUE(writer.Init());
+  content::RunAllTasksUntilIdle();
+
+  TimeLogger growth_timer(kMetricGrowthTimeMs);
+  base::TimeDelta max_add_url_time;
+  for (int i = 0; i < kGrowthTestCount; i++) {
+    GURL url = TestURL(kAddedPrefix, i);
+    base::ElapsedTimer add_url_timer;
+    writer.AddURL(url);
+    max_add_url_time = std::max(max_add_url_time, add_url_timer.Elapsed());
+  }
+  content::RunAllTasksUntilIdle();
+  growth_timer.Done();
+
+  perf_test::PerfResultReporter reporter = SetUpReporter("baseline_story");
+  reporter.AddResult(kMetricMaxAddURLTimeMs,
+                     max_add_url_time.InMillisecondsF());
+  EXPECT_EQ(kGrowthTestCount, writer.GetUsedCount());
+}
+
 }  // namespace visitedlink
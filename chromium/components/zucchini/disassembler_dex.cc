@@ -8,6 +8,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <cmath>
 #include <iterator>
@@ -252,17 +253,18 @@ class InstructionParser {
   // is unknown. An internal initialize-on-first-use table is used for fast
   // lookup.
   const dex::Instruction* FindDalvikInstruction(uint8_t opcode) {
-    static bool is_init = false;
-    static const dex::Instruction* instruction_table[256];
-    if (!is_init) {
-      is_init = true;
-      std::fill(std::begin(instruction_table), std::end(instruction_table),
-                nullptr);
-      for (const dex::Instruction& instr : dex::kByteCode) {
-        std::fill(instruction_table + instr.opcode,
-                  instruction_table + instr.opcode + instr.variant, &instr);
-      }
-    }
+    // Function-local static initialization is thread-safe, which matters as
+    // elements may be disassembled concurrently.
+    static const std::array<const dex::Instruction*, 256> instruction_table =
+        [] {
+          std::array<const dex::Instruction*, 256> table;
+          table.fill(nullptr);
+          for (const dex::Instruction& instr : dex::kByteCode) {
+            std::fill(table.begin() + instr.opcode,
+                      table.begin() + instr.opcode + instr.variant, &instr);
+          }
+          return table;
+        }();
     return instruction_table[opcode];
   }
 
@@ -5,6 +5,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <initializer_list>
 #include <string>
 #include <vector>
 
@@ -12,6 +13,7 @@
 #include "base/files/memory_mapped_file.h"
 #include "base/path_service.h"
 #include "components/zucchini/buffer_view.h"
+#include "components/zucchini/parallel_utils.h"
 #include "components/zucchini/patch_reader.h"
 #include "components/zucchini/patch_writer.h"
 #include "components/zucchini/zucchini.h"
@@ -96,6 +98,51 @@ TEST(EndToEndTest, GenApplySimple) {
   TestGenApply("chrome64_1.exe", "chrome64_2.exe", false);
 }
 
+// Generates an ensemble patch for archives made of several executables with
+// one and with several worker threads, and expects identical patches.
+TEST(EndToEndTest, GenIsDeterministicAcrossThreadCounts) {
+  auto read_archive = [](std::initializer_list<const char*> filenames) {
+    std::vector<uint8_t> archive;
+    for (const char* filename : filenames) {
+      base::MemoryMappedFile file;
+      EXPECT_TRUE(file.Initialize(MakeTestPath(filename)));
+      archive.insert(archive.end(), file.data(), file.data() + file.length());
+    }
+    return archive;
+  };
+  std::vector<uint8_t> old_archive =
+      read_archive({"setup1.exe", "chrome64_1.exe"});
+  std::vector<uint8_t> new_archive =
+      read_archive({"setup2.exe", "chrome64_2.exe"});
+  ConstBufferView old_region(old_archive.data(), old_archive.size());
+  ConstBufferView new_region(new_archive.data(), new_archive.size());
+
+  auto generate = [&](size_t max_threads) {
+    SetMaxWorkerThreads(max_threads);
+    EnsemblePatchWriter patch_writer(old_region, new_region);
+    EXPECT_EQ(status::kStatusSuccess,
+              GenerateBuffer(old_region, new_region, &patch_writer));
+    std::vector<uint8_t> patch_buffer(patch_writer.SerializedSize());
+    patch_writer.SerializeInto({patch_buffer.data(), patch_buffer.size()});
+    return patch_buffer;
+  };
+  std::vector<uint8_t> sequential_patch = generate(1);
+  std::vector<uint8_t> parallel_patch = generate(4);
+  SetMaxWorkerThreads(0);
+  EXPECT_EQ(sequential_patch, parallel_patch);
+
+  absl::optional<EnsemblePatchReader> patch_reader =
+      EnsemblePatchReader::Create(
+          {parallel_patch.data(), parallel_patch.size()});
+  ASSERT_TRUE(patch_reader.has_value());
+  EXPECT_GE(patch_reader->elements().size(), 2U);
+  std::vector<uint8_t> patched_new_buffer(new_region.size());
+  ASSERT_EQ(status::kStatusSuccess, ApplyBuffer(old_region, *patch_reader,
+                                                {patched_new_buffer.data(),
+                                                 patched_new_buffer.size()}));
+  EXPECT_EQ(new_archive, patched_new_buffer);
+}
+
 TEST(EndToEndTest, GenApplyCross) {
   TestGenApply("setup1.exe", "chrome64_1.exe", false);
 }
@@ -66,9 +66,10 @@ struct Command {
 constexpr Command kCommands[] = {
     {"gen",
      "-gen <old_file> <new_file> <patch_file> [-raw] [-keep]"
-     " [-impose=#+#=#+#,#+#=#+#,...]",
+     " [-impose=#+#=#+#,#+#=#+#,...] [-threads=#]",
      3, &MainGen},
-    {"apply", "-apply <old_file> <patch_file> <new_file> [-keep]", 3,
+    {"apply",
+     "-apply <old_file> <patch_file> <new_file> [-keep] [-threads=#]", 3,
      &MainApply},
     {"verify", "-verify <patch_file>", 1, &MainVerify},
     {"read", "-read <exe> [-dump]", 1, &MainRead},
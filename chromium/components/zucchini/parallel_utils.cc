@@ -0,0 +1,77 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/zucchini/parallel_utils.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "base/check_op.h"
+#include "base/system/sys_info.h"
+#include "base/threading/simple_thread.h"
+
+namespace zucchini {
+
+namespace {
+
+// Large ensembles are dominated by a few big elements, so more threads mostly
+// add peak memory rather than speed.
+constexpr size_t kDefaultMaxWorkerThreads = 4;
+
+std::atomic<size_t> g_max_worker_threads{0};
+
+// Work item of DelegateSimpleThreadPool that is added once per index and runs
+// |task_| for the next index each time a worker picks it up.
+class IndexedTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  IndexedTask(size_t count, base::FunctionRef<void(size_t)> task)
+      : count_(count), task_(task) {}
+  IndexedTask(const IndexedTask&) = delete;
+  IndexedTask& operator=(const IndexedTask&) = delete;
+  ~IndexedTask() override = default;
+
+  // base::DelegateSimpleThread::Delegate:
+  void Run() override {
+    size_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+    DCHECK_LT(index, count_);
+    task_(index);
+  }
+
+ private:
+  const size_t count_;
+  base::FunctionRef<void(size_t)> task_;
+  std::atomic<size_t> next_index_{0};
+};
+
+}  // namespace
+
+size_t GetMaxWorkerThreads() {
+  size_t max_threads = g_max_worker_threads.load(std::memory_order_relaxed);
+  if (max_threads)
+    return max_threads;
+  return std::clamp<size_t>(base::SysInfo::NumberOfProcessors(), 1,
+                            kDefaultMaxWorkerThreads);
+}
+
+void SetMaxWorkerThreads(size_t max_threads) {
+  g_max_worker_threads.store(max_threads, std::memory_order_relaxed);
+}
+
+void ForEachIndexInParallel(size_t count,
+                            base::FunctionRef<void(size_t)> task) {
+  size_t num_threads = std::min(count, GetMaxWorkerThreads());
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < count; ++i)
+      task(i);
+    return;
+  }
+
+  IndexedTask indexed_task(count, task);
+  base::DelegateSimpleThreadPool pool("zucchini_worker", num_threads);
+  pool.AddWork(&indexed_task, count);
+  pool.Start();
+  pool.JoinAll();
+}
+
+}  // namespace zucchini
@@ -0,0 +1,31 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_ZUCCHINI_PARALLEL_UTILS_H_
+#define COMPONENTS_ZUCCHINI_PARALLEL_UTILS_H_
+
+#include <stddef.h>
+
+#include "base/functional/function_ref.h"
+
+namespace zucchini {
+
+// Returns the maximum number of threads used to process independent elements
+// of an ensemble. Each worker holds the disassembly, image index and suffix
+// arrays of its element, so this also bounds the peak memory.
+size_t GetMaxWorkerThreads();
+
+// Overrides the value returned by GetMaxWorkerThreads(). 0 restores the
+// default, which depends on the number of processors, while 1 processes all
+// elements on the calling thread.
+void SetMaxWorkerThreads(size_t max_threads);
+
+// Runs |task| for each index in [0, |count|) on up to GetMaxWorkerThreads()
+// threads and returns when all tasks are done. Tasks for different indices may
+// run concurrently, so each task must only write state owned by its index.
+void ForEachIndexInParallel(size_t count, base::FunctionRef<void(size_t)> task);
+
+}  // namespace zucchini
+
+#endif  // COMPONENTS_ZUCCHINI_PARALLEL_UTILS_H_
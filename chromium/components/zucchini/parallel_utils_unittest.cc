@@ -0,0 +1,46 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/zucchini/parallel_utils.h"
+
+#include <stddef.h>
+
+#include <atomic>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace zucchini {
+
+namespace {
+
+class ParallelUtilsTest : public testing::Test {
+ protected:
+  ~ParallelUtilsTest() override { SetMaxWorkerThreads(0); }
+};
+
+}  // namespace
+
+TEST_F(ParallelUtilsTest, MaxWorkerThreads) {
+  EXPECT_GE(GetMaxWorkerThreads(), 1U);
+  SetMaxWorkerThreads(3);
+  EXPECT_EQ(3U, GetMaxWorkerThreads());
+  SetMaxWorkerThreads(0);
+  EXPECT_GE(GetMaxWorkerThreads(), 1U);
+}
+
+TEST_F(ParallelUtilsTest, ForEachIndexInParallel) {
+  for (size_t max_threads : {1, 2, 8}) {
+    SetMaxWorkerThreads(max_threads);
+    for (size_t count : {0, 1, 2, 7, 100}) {
+      std::vector<std::atomic<int>> visits(count);
+      ForEachIndexInParallel(count, [&](size_t i) { visits[i]++; });
+      for (size_t i = 0; i < count; ++i)
+        EXPECT_EQ(1, visits[i].load())
+            << max_threads << " " << count << " " << i;
+    }
+  }
+}
+
+}  // namespace zucchini
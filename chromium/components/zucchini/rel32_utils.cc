@@ -5,6 +5,7 @@
 #include "components/zucchini/rel32_utils.h"
 
 #include <algorithm>
+#include <atomic>
 
 #include "base/check_op.h"
 #include "components/zucchini/io_utils.h"
@@ -73,12 +74,13 @@ void OutputArmCopyDispFailure(uint32_t addr_type) {
   // from mixing for these cases. TODO(huangs, etiennep): Ongoing discussion on
   // whether we should just nullify all payload disp so we won't have to deal
   // with this case, but at the cost of having Zucchini-apply do more work.
-  static int output_quota = 10;
-  if (output_quota > 0) {
+  // Atomic since elements may be patched concurrently.
+  static std::atomic<int> output_quota{10};
+  int remaining_quota = output_quota.fetch_sub(1, std::memory_order_relaxed);
+  if (remaining_quota > 0) {
     LOG(WARNING) << "Reference byte mix failed with type = " << addr_type << "."
                  << std::endl;
-    --output_quota;
-    if (!output_quota)
+    if (remaining_quota == 1)
       LOG(WARNING) << "(Additional output suppressed)";
   }
 }
@@ -4,17 +4,22 @@
 
 #include "components/zucchini/zucchini_apply.h"
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/ranges/algorithm.h"
 #include "components/zucchini/disassembler.h"
 #include "components/zucchini/element_detection.h"
 #include "components/zucchini/equivalence_map.h"
 #include "components/zucchini/image_index.h"
+#include "components/zucchini/parallel_utils.h"
 
 namespace zucchini {
 
@@ -200,12 +205,19 @@ status::Code ApplyBuffer(ConstBufferView old_image,
     return status::kStatusInvalidOldImage;
   }
 
-  for (const auto& element_patch : patch_reader.elements()) {
-    ElementMatch match = element_patch.element_match();
-    if (!ApplyElement(match.exe_type(), old_image[match.old_element.region()],
-                      element_patch, new_image[match.new_element.region()]))
-      return status::kStatusFatal;
-  }
+  // EnsemblePatchReader verified that the "new" regions of the elements are
+  // contiguous and do not overlap, so elements can be applied concurrently
+  // while the result stays the same as applying them in order.
+  const std::vector<PatchElementReader>& elements = patch_reader.elements();
+  std::vector<uint8_t> element_success(elements.size(), 0);
+  ForEachIndexInParallel(elements.size(), [&](size_t i) {
+    ElementMatch match = elements[i].element_match();
+    element_success[i] =
+        ApplyElement(match.exe_type(), old_image[match.old_element.region()],
+                     elements[i], new_image[match.new_element.region()]);
+  });
+  if (!base::ranges::all_of(element_success, [](uint8_t s) { return s; }))
+    return status::kStatusFatal;
 
   if (!patch_reader.CheckNewFile(ConstBufferView(new_image))) {
     LOG(ERROR) << "Invalid new_image.";
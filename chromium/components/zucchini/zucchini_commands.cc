@@ -16,10 +16,12 @@
 #include "base/files/file_path.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
 #include "components/zucchini/buffer_view.h"
 #include "components/zucchini/crc32.h"
 #include "components/zucchini/io_utils.h"
 #include "components/zucchini/mapped_file.h"
+#include "components/zucchini/parallel_utils.h"
 #include "components/zucchini/patch_writer.h"
 #include "components/zucchini/zucchini_integration.h"
 #include "components/zucchini/zucchini_tools.h"
@@ -32,11 +34,30 @@ constexpr char kSwitchDump[] = "dump";
 constexpr char kSwitchImpose[] = "impose";
 constexpr char kSwitchKeep[] = "keep";
 constexpr char kSwitchRaw[] = "raw";
+constexpr char kSwitchThreads[] = "threads";
+
+// Applies the worker thread limit given with -threads=#, which allows to
+// compare timings of sequential and parallel element processing.
+bool SetMaxWorkerThreadsFromCommandLine(const base::CommandLine& command_line) {
+  if (!command_line.HasSwitch(kSwitchThreads))
+    return true;
+  size_t max_threads = 0;
+  if (!base::StringToSizeT(command_line.GetSwitchValueASCII(kSwitchThreads),
+                           &max_threads) ||
+      max_threads == 0) {
+    LOG(ERROR) << "Invalid value for -" << kSwitchThreads;
+    return false;
+  }
+  zucchini::SetMaxWorkerThreads(max_threads);
+  return true;
+}
 
 }  // namespace
 
 zucchini::status::Code MainGen(MainParams params) {
   CHECK_EQ(3U, params.file_paths.size());
+  if (!SetMaxWorkerThreadsFromCommandLine(params.command_line))
+    return zucchini::status::kStatusInvalidParam;
   return zucchini::Generate(
       params.file_paths[0], params.file_paths[1], params.file_paths[2],
       params.command_line.HasSwitch(kSwitchKeep),
@@ -46,6 +67,8 @@ zucchini::status::Code MainGen(MainParams params) {
 
 zucchini::status::Code MainApply(MainParams params) {
   CHECK_EQ(3U, params.file_paths.size());
+  if (!SetMaxWorkerThreadsFromCommandLine(params.command_line))
+    return zucchini::status::kStatusInvalidParam;
   return zucchini::Apply(params.file_paths[0], params.file_paths[1],
                          params.file_paths[2],
                          params.command_line.HasSwitch(kSwitchKeep));
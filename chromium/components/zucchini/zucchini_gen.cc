@@ -12,6 +12,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
@@ -23,6 +24,7 @@
 #include "components/zucchini/heuristic_ensemble_matcher.h"
 #include "components/zucchini/image_index.h"
 #include "components/zucchini/imposed_ensemble_matcher.h"
+#include "components/zucchini/parallel_utils.h"
 #include "components/zucchini/patch_writer.h"
 #include "components/zucchini/suffix_array.h"
 #include "components/zucchini/targets_affinity.h"
@@ -360,27 +362,39 @@ status::Code GenerateBufferCommon(ConstBufferView old_image,
   size_t covered_new_bytes = 0;
 
   // Process elements first, since non-fatal failures may turn some into gaps.
-  for (const ElementMatch& match : matches) {
+  // Elements are independent, so they are generated concurrently. Each result
+  // is kept with its match and serialized by "new" offset below, so the patch
+  // does not depend on the number of threads.
+  std::vector<PatchElementWriter> element_writers;
+  element_writers.reserve(num_elements);
+  for (const ElementMatch& match : matches)
+    element_writers.emplace_back(match);
+  std::vector<uint8_t> element_success(num_elements, 0);
+  ForEachIndexInParallel(num_elements, [&](size_t i) {
+    const ElementMatch& match = matches[i];
     BufferRegion new_region = match.new_element.region();
     LOG(INFO) << "--- Match [" << new_region.lo() << "," << new_region.hi()
               << ")";
-
+    element_success[i] = GenerateExecutableElement(
+        match.exe_type(), old_image[match.old_element.region()],
+        new_image[new_region], &element_writers[i]);
+  });
+
+  for (size_t i = 0; i < num_elements; ++i) {
+    BufferRegion new_region = matches[i].new_element.region();
+    if (!element_success[i]) {
+      LOG(INFO) << "Fall back to raw patching [" << new_region.lo() << ","
+                << new_region.hi() << ")";
+      continue;
+    }
     auto it_and_success = patch_element_map.emplace(
-        base::checked_cast<offset_t>(new_region.lo()), match);
+        base::checked_cast<offset_t>(new_region.lo()),
+        std::move(element_writers[i]));
     DCHECK(it_and_success.second);
-    PatchElementWriter& patch_element = it_and_success.first->second;
-
-    ConstBufferView old_sub_image = old_image[match.old_element.region()];
-    ConstBufferView new_sub_image = new_image[new_region];
-    if (GenerateExecutableElement(match.exe_type(), old_sub_image,
-                                  new_sub_image, &patch_element)) {
-      covered_new_regions.push_back(new_region);
-      covered_new_bytes += new_region.size;
-    } else {
-      LOG(INFO) << "Fall back to raw patching.";
-      patch_element_map.erase(it_and_success.first);
-    }
+    covered_new_regions.push_back(new_region);
+    covered_new_bytes += new_region.size;
   }
+  element_writers.clear();
 
   if (covered_new_bytes < new_image.size()) {
     // Process all "gaps", which are patched against the entire "old" image. To
@@ -397,27 +411,37 @@ status::Code GenerateBufferCommon(ConstBufferView old_image,
     // Add sentinel that points to end of "new" file, to simplify gap iteration.
     covered_new_regions.emplace_back(BufferRegion{new_image.size(), 0});
 
+    std::vector<PatchElementWriter> gap_writers;
     for (const BufferRegion& covered : covered_new_regions) {
       offset_t gap_hi = base::checked_cast<offset_t>(covered.lo());
       DCHECK_GE(gap_hi, gap_lo);
       offset_t gap_size = gap_hi - gap_lo;
       if (gap_size > 0) {
         LOG(INFO) << "--- Gap   [" << gap_lo << "," << gap_hi << ")";
-
-        ElementMatch gap_match{{entire_old_element, kExeTypeNoOp},
-                               {{gap_lo, gap_size}, kExeTypeNoOp}};
-        auto it_and_success = patch_element_map.emplace(gap_lo, gap_match);
-        DCHECK(it_and_success.second);
-        PatchElementWriter& patch_element = it_and_success.first->second;
-
-        ConstBufferView new_sub_image = new_image[{gap_lo, gap_size}];
-        if (!GenerateRawElement(old_sa_raw, old_image, new_sub_image,
-                                &patch_element)) {
-          return status::kStatusFatal;
-        }
+        gap_writers.emplace_back(
+            ElementMatch{{entire_old_element, kExeTypeNoOp},
+                         {{gap_lo, gap_size}, kExeTypeNoOp}});
       }
       gap_lo = base::checked_cast<offset_t>(covered.hi());
     }
+
+    // Gaps only read the shared |old_sa_raw|, so they are generated
+    // concurrently as well.
+    std::vector<uint8_t> gap_success(gap_writers.size(), 0);
+    ForEachIndexInParallel(gap_writers.size(), [&](size_t i) {
+      ConstBufferView new_sub_image =
+          new_image[gap_writers[i].element_match().new_element.region()];
+      gap_success[i] = GenerateRawElement(old_sa_raw, old_image, new_sub_image,
+                                          &gap_writers[i]);
+    });
+    for (size_t i = 0; i < gap_writers.size(); ++i) {
+      if (!gap_success[i])
+        return status::kStatusFatal;
+      offset_t gap_offset = gap_writers[i].element_match().new_element.offset;
+      auto it_and_success =
+          patch_element_map.emplace(gap_offset, std::move(gap_writers[i]));
+      DCHECK(it_and_success.second);
+    }
   }
 
   // Write all PatchElementWriter sorted by "new" offset.
@@ -96,6 +96,11 @@ const uint32_t kMaxFilePathLength = PATH_MAX - 1;
 // should be "(9998)", so the value is 6.
 const uint32_t kMaxFileOrdinalNumberPartLength = 6;
 
+// Vivaldi: Number of sub-resources fetched at the same time when saving
+// a complete page. This matches the per-host connection limit of the network
+// stack, so a page with many images from one host uses all its connections.
+constexpr int kMaxConcurrentNetSaveItems = 6;
+
 // Strip current ordinal number, if any. Should only be used on pure
 // file names, i.e. those stripped of their extensions.
 // TODO(estade): improve this to not choke on alternate encodings.
@@ -976,7 +981,15 @@ void SavePackage::DoSavingProcess() {
     DCHECK_EQ(NET_FILES, wait_state_);
     const SaveItem* save_item = waiting_item_queue_.front().get();
     if (save_item->save_source() != SaveFileCreateInfo::SAVE_FILE_FROM_DOM) {
-      SaveNextFile(false);
+      // Vivaldi: Keep up to kMaxConcurrentNetSaveItems sub-resources in
+      // flight instead of fetching them one after another. Each item streams
+      // to its own file, so they do not depend on each other.
+      do {
+        SaveNextFile(false);
+      } while (!waiting_item_queue_.empty() &&
+               waiting_item_queue_.front()->save_source() !=
+                   SaveFileCreateInfo::SAVE_FILE_FROM_DOM &&
+               in_process_count() < kMaxConcurrentNetSaveItems);
     } else if (!in_process_count()) {
       // If there is no in-process SaveItem, it means all sub-resources
       // have been processed. Now we need to start serializing HTML DOM
@@ -2738,6 +2738,8 @@ void RenderWidgetHostViewAura::OnTextSelectionChanged(
 #if BUILDFLAG(IS_LINUX)
   if (vivaldi::IsVivaldiRunning() &&
       vivaldi::clipboard::SuppressWrite(ui::ClipboardBuffer::kSelection)) {
+    // A write scheduled for an earlier change would pick up this selection.
+    vivaldi_selection_write_timer_.Stop();
     return;
   }
 #endif  // IS_LINUX
@@ -2774,6 +2776,18 @@ void RenderWidgetHostViewAura::OnTextSelectionChanged(
       if (focused_view != updated_view) {
         return;
       }
+#if BUILDFLAG(IS_LINUX)
+      // Each write claims the selection from the display server. Dragging a
+      // selection changes it on every mouse move, so write the latest one
+      // at most once per interval.
+      vivaldi_selection_view_ = updated_view->GetWeakPtr();
+      if (!vivaldi_selection_write_timer_.IsRunning()) {
+        vivaldi_selection_write_timer_.Start(
+            FROM_HERE, base::Milliseconds(100), this,
+            &RenderWidgetHostViewAura::VivaldiWriteSelectionClipboard);
+      }
+      return;
+#endif  // IS_LINUX
     }
 
     const TextInputManager::TextSelection* selection =
@@ -2787,6 +2801,30 @@ void RenderWidgetHostViewAura::OnTextSelectionChanged(
   }
 }
 
+#if BUILDFLAG(IS_LINUX)
+void RenderWidgetHostViewAura::VivaldiWriteSelectionClipboard() {
+  // The decision to write was made when the selection changed, so
+  // SuppressWrite() is not checked again. The mouse up ending a drag would
+  // have reset it by now.
+  if (!HasFocus() || !GetTextInputManager())
+    return;
+
+  // Focus may have moved while the timer ran. Only the view that owned the
+  // selection when it changed may write it, as in OnTextSelectionChanged().
+  RenderWidgetHostViewBase* focused_view =
+      GetFocusedWidget() ? GetFocusedWidget()->GetView() : nullptr;
+  if (!focused_view || focused_view != vivaldi_selection_view_.get())
+    return;
+  const TextInputManager::TextSelection* selection =
+      GetTextInputManager()->GetTextSelection(focused_view);
+  if (selection && selection->selected_text().length()) {
+    ui::ScopedClipboardWriter clipboard_writer(
+        ui::ClipboardBuffer::kSelection);
+    clipboard_writer.WriteText(selection->selected_text());
+  }
+}
+#endif  // IS_LINUX
+
 void RenderWidgetHostViewAura::SetPopupChild(
     RenderWidgetHostViewAura* popup_child_host_view) {
   popup_child_host_view_ = popup_child_host_view;
@@ -21,6 +21,7 @@
 #include "base/memory/weak_ptr.h"
 #include "base/strings/string_piece.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
 #include "cc/layers/deadline_policy.h"
@@ -785,6 +786,19 @@ class CONTENT_EXPORT RenderWidgetHostViewAura
 
   absl::optional<display::ScopedDisplayObserver> display_observer_;
 
+#if BUILDFLAG(IS_LINUX)
+  // Vivaldi: Writes the focused text selection to the selection
+  // clipboard.
+  void VivaldiWriteSelectionClipboard();
+
+  // Throttles selection clipboard writes while a selection is dragged or
+  // extended with the keyboard.
+  base::OneShotTimer vivaldi_selection_write_timer_;
+
+  // The view whose selection change scheduled the write.
+  base::WeakPtr<RenderWidgetHostViewBase> vivaldi_selection_view_;
+#endif  // IS_LINUX
+
   base::WeakPtrFactory<RenderWidgetHostViewAura> weak_ptr_factory_{this};
 };
 
@@ -15,6 +15,7 @@
 #include "content/browser/renderer_host/render_widget_host_view_base.h"
 #include "third_party/blink/public/common/input/web_input_event.h"
 #include "ui/events/blink/blink_event_util.h"
+#include "ui/latency/latency_info.h"
 
 #include "app/vivaldi_apptools.h"
 
@@ -46,6 +47,28 @@ bool IsMouseMiddleClick(const blink::WebInputEvent& event) {
 
 constexpr const char kTracingCategory[] = "input,latency";
 
+// Vivaldi: Record how long an event took from the platform to the
+// dispatch to its target, split by the UI and the pages. This covers the
+// event hooks and the targeting queue, the stages before the ones LatencyInfo
+// already reports. The trace event joins the event's LatencyInfo flow.
+void VivaldiRecordTimeToTarget(const blink::WebInputEvent& event,
+                               const ui::LatencyInfo& latency,
+                               bool targets_ui) {
+  base::TimeDelta time_to_target = base::TimeTicks::Now() - event.TimeStamp();
+  TRACE_EVENT_WITH_FLOW2(
+      kTracingCategory, "RenderWidgetTargeter::VivaldiFoundTarget",
+      TRACE_ID_GLOBAL(latency.trace_id()),
+      TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT, "target",
+      targets_ui ? "ui" : "page", "time_to_target_us",
+      time_to_target.InMicroseconds());
+  // The macros cache the histogram per call site, so each name gets its own.
+  if (targets_ui) {
+    UMA_HISTOGRAM_TIMES("Vivaldi.Input.TimeToTarget.UI", time_to_target);
+  } else {
+    UMA_HISTOGRAM_TIMES("Vivaldi.Input.TimeToTarget.Page", time_to_target);
+  }
+}
+
 constexpr base::TimeDelta kAsyncHitTestTimeout = base::Seconds(5);
 
 }  // namespace
@@ -172,6 +195,27 @@ const ui::LatencyInfo& RenderWidgetTargeter::TargetingRequest::GetLatency()
   return latency;
 }
 
+void RenderWidgetTargeter::TargetingRequest::VivaldiStartQueueTracker() {
+  vivaldi_queue_tracker = std::make_unique<TracingUmaTracker>(
+      "Vivaldi.Input.AsyncTargeting.TimeInQueue");
+}
+
+void RenderWidgetTargeter::TargetingRequest::VivaldiStopQueueTracker() {
+  if (!vivaldi_queue_tracker)
+    return;
+  vivaldi_queue_tracker->StopAndRecord();
+  vivaldi_queue_tracker.reset();
+}
+
+bool RenderWidgetTargeter::TargetingRequest::VivaldiMayTargetRoot() const {
+  return vivaldi_may_target_root;
+}
+
+void RenderWidgetTargeter::TargetingRequest::SetVivaldiMayTargetRoot(
+    bool may_target_root) {
+  vivaldi_may_target_root = may_target_root;
+}
+
 RenderWidgetTargeter::RenderWidgetTargeter(Delegate* delegate)
     : async_hit_test_timeout_delay_(kAsyncHitTestTimeout),
       trace_id_(base::RandUint64()),
@@ -214,24 +258,8 @@ void RenderWidgetTargeter::FindTargetAndCallback(
   ResolveTargetingRequest(std::move(request));
 }
 
-void RenderWidgetTargeter::ResolveTargetingRequest(TargetingRequest request) {
-  bool vivaldi_optimizaton = false;
-  if (request_in_flight_) {
-    if (vivaldi::IsVivaldiRunning()) {
-      // VB-47391: avoid blocking Vivaldi UI when the page is loading slowly.
-      // UI does not depend on page's state and it is OK to send events to it
-      // even the page does not yet reported the geometry of its iframes if
-      // any.
-      vivaldi_optimizaton = true;
-    } else {
-    vivaldi_delay_request:
-      // clang-format off
-    requests_.push(std::move(request));
-    return;
-      // clang-format on
-    }
-  }
-
+RenderWidgetTargetResult RenderWidgetTargeter::FindTargetSynchronously(
+    TargetingRequest& request) {
   RenderWidgetTargetResult result;
   auto* request_target = request.GetRootView();
   auto request_target_location = request.GetLocation();
@@ -257,13 +285,51 @@ void RenderWidgetTargeter::ResolveTargetingRequest(TargetingRequest request) {
     result = delegate_->FindTargetSynchronouslyAtPoint(request_target,
                                                        request_target_location);
   }
-  if (vivaldi_optimizaton) {
-    if (result.view != request.GetRootView())
-      goto vivaldi_delay_request;
-    if (result.should_query_view)
-      goto vivaldi_delay_request;
+  return result;
+}
+
+void RenderWidgetTargeter::QueueRequest(TargetingRequest request,
+                                        bool vivaldi_may_target_root) {
+  // Vivaldi
+  if (vivaldi::IsVivaldiRunning())
+    request.VivaldiStartQueueTracker();
+  request.SetVivaldiMayTargetRoot(vivaldi_may_target_root);
+  if (vivaldi_may_target_root)
+    vivaldi_queued_root_requests_++;
+  requests_.push(std::move(request));
+}
+
+void RenderWidgetTargeter::ResolveTargetingRequest(TargetingRequest request) {
+  if (request_in_flight_) {
+    if (!vivaldi::IsVivaldiRunning()) {
+      QueueRequest(std::move(request), false);
+      return;
+    }
+    // VB-47391: avoid blocking Vivaldi UI when the page is loading slowly.
+    // UI does not depend on page's state and it is OK to send events to it
+    // even the page does not yet reported the geometry of its iframes if
+    // any. All webviews share this targeter with the UI, so only events that
+    // resolve synchronously to the UI root skip the queue. To keep the order
+    // of the events the UI receives, they do not skip ahead of queued events
+    // that may also end up at the root.
+    RenderWidgetTargetResult result = FindTargetSynchronously(request);
+    bool targets_root = result.view == request.GetRootView();
+    if (!targets_root || result.should_query_view ||
+        vivaldi_queued_root_requests_ > 0) {
+      QueueRequest(std::move(request), targets_root);
+      return;
+    }
+    TRACE_EVENT_INSTANT0(kTracingCategory,
+                         "RenderWidgetTargeter::VivaldiSkipQueue",
+                         TRACE_EVENT_SCOPE_THREAD);
+    FoundTarget(result.view, result.target_location, &request);
+    return;
   }
 
+  RenderWidgetTargetResult result = FindTargetSynchronously(request);
+  auto* request_target = request.GetRootView();
+  auto request_target_location = request.GetLocation();
+
   RenderWidgetHostViewBase* target = result.view;
   if (!is_autoscroll_in_progress_ && result.should_query_view) {
     TRACE_EVENT_WITH_FLOW2(
@@ -360,6 +426,13 @@ void RenderWidgetTargeter::FlushEventQueue() {
   while (!request_in_flight_ && !requests_.empty()) {
     auto request = std::move(requests_.front());
     requests_.pop();
+    // Vivaldi
+    request.VivaldiStopQueueTracker();
+    if (request.VivaldiMayTargetRoot()) {
+      DCHECK_GT(vivaldi_queued_root_requests_, 0u);
+      vivaldi_queued_root_requests_--;
+      request.SetVivaldiMayTargetRoot(false);
+    }
     // The root-view has gone away. Ignore this event, and try to process the
     // next event.
     if (!request.GetRootView())
@@ -444,6 +517,13 @@ void RenderWidgetTargeter::FoundTarget(
   if (!request->GetRootView() || !request->GetRootView()->GetRenderWidgetHost())
     return;
 
+  // Vivaldi: Input latency, see VivaldiRecordTimeToTarget().
+  if (vivaldi::IsVivaldiRunning() && request->IsWebInputEventRequest() &&
+      target) {
+    VivaldiRecordTimeToTarget(*request->GetEvent(), request->GetLatency(),
+                              target == request->GetRootView());
+  }
+
   if (request->IsWebInputEventRequest()) {
     delegate_->DispatchEventToTarget(request->GetRootView(), target,
                                      request->GetEvent(), request->GetLatency(),
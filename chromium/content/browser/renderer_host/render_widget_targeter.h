@@ -5,6 +5,7 @@
 #ifndef CONTENT_BROWSER_RENDERER_HOST_RENDER_WIDGET_TARGETER_H_
 #define CONTENT_BROWSER_RENDERER_HOST_RENDER_WIDGET_TARGETER_H_
 
+#include <memory>
 #include <queue>
 
 #include "base/memory/raw_ptr.h"
@@ -163,6 +164,15 @@ class RenderWidgetTargeter {
     gfx::PointF GetLocation() const;
     const ui::LatencyInfo& GetLatency() const;
 
+    // Vivaldi: Measures the time the request spends in |requests_|.
+    void VivaldiStartQueueTracker();
+    void VivaldiStopQueueTracker();
+
+    // Vivaldi: The request was queued while its synchronous target was the
+    // root view. Counted in |vivaldi_queued_root_requests_|.
+    bool VivaldiMayTargetRoot() const;
+    void SetVivaldiMayTargetRoot(bool may_target_root);
+
    private:
     base::WeakPtr<RenderWidgetHostViewBase> root_view;
 
@@ -174,10 +184,21 @@ class RenderWidgetTargeter {
     // |event| if set is in the coordinate space of |root_view|.
     ui::WebScopedInputEvent event;
     ui::LatencyInfo latency;
+
+    // Vivaldi
+    std::unique_ptr<TracingUmaTracker> vivaldi_queue_tracker;
+    bool vivaldi_may_target_root = false;
   };
 
   void ResolveTargetingRequest(TargetingRequest);
 
+  // Runs the synchronous hit test for |request|.
+  RenderWidgetTargetResult FindTargetSynchronously(TargetingRequest& request);
+
+  // Adds |request| to |requests_| to be resolved once the request in flight
+  // is done.
+  void QueueRequest(TargetingRequest request, bool vivaldi_may_target_root);
+
   // Attempts to target and dispatch all events in the queue. It stops if it has
   // to query a client, or if the queue becomes empty.
   void FlushEventQueue();
@@ -254,6 +275,9 @@ class RenderWidgetTargeter {
 
   RenderWidgetHostViewBase* vivaldi_active_down_target_ = nullptr;
 
+  // Number of requests in |requests_| with |vivaldi_may_target_root| set.
+  size_t vivaldi_queued_root_requests_ = 0;
+
   const raw_ptr<Delegate> delegate_;
   base::WeakPtrFactory<RenderWidgetTargeter> weak_ptr_factory_{this};
 };
@@ -208,8 +208,13 @@ scoped_refptr<net::HttpResponseHeaders> URLDataManagerBackend::GetHeaders(
                        kChromeURLContentSecurityPolicyReportOnlyHeaderValue);
   }
 
-  if (!source->AllowCaching(url))
-    headers->SetHeader("Cache-Control", "no-cache");
+  std::string cache_control = source->GetCacheControl(url);
+  if (!cache_control.empty())
+    headers->SetHeader("Cache-Control", cache_control);
+
+  std::string etag = source->GetETag(url);
+  if (!etag.empty())
+    headers->SetHeader("ETag", etag);
 
   std::string mime_type = source->GetMimeType(url);
   if (source->ShouldServeMimeTypeAsContentTypeHeader() && !mime_type.empty())
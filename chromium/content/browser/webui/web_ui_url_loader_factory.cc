@@ -9,11 +9,14 @@
 
 #include "base/bind.h"
 #include "base/debug/crash_logging.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/task/thread_pool.h"
 #include "base/timer/elapsed_timer.h"
@@ -35,6 +38,9 @@
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/receiver_set.h"
 #include "mojo/public/cpp/bindings/remote.h"
+#include "mojo/public/cpp/system/data_pipe_producer.h"
+#include "mojo/public/cpp/system/file_data_source.h"
+#include "net/base/net_errors.h"
 #include "net/http/http_byte_range.h"
 #include "net/http/http_util.h"
 #include "services/network/public/cpp/parsed_headers.h"
@@ -60,6 +66,46 @@ void CallOnError(
   client->OnComplete(status);
 }
 
+// Vivaldi: checks the If-None-Match header, a list of entity tags or "*",
+// against the ETag of the source. The comparison is weak as the header
+// requires.
+bool MatchesIfNoneMatch(const std::string& if_none_match,
+                        base::StringPiece etag) {
+  auto strip_weak = [](base::StringPiece tag) {
+    return base::StartsWith(tag, "W/") ? tag.substr(2) : tag;
+  };
+  etag = strip_weak(etag);
+  net::HttpUtil::ValuesIterator it(if_none_match.begin(), if_none_match.end(),
+                                   ',');
+  while (it.GetNext()) {
+    base::StringPiece tag = it.value_piece();
+    if (tag == "*" || strip_weak(tag) == etag)
+      return true;
+  }
+  return false;
+}
+
+// Vivaldi: answers a revalidation whose If-None-Match matches the ETag of the
+// source without asking the source for the data.
+void CallOnNotModified(
+    network::mojom::URLResponseHeadPtr headers,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client_remote) {
+  headers->headers->ReplaceStatusLine("HTTP/1.1 304 Not Modified");
+  headers->content_length = 0;
+
+  mojo::ScopedDataPipeProducerHandle pipe_producer_handle;
+  mojo::ScopedDataPipeConsumerHandle pipe_consumer_handle;
+  MojoResult create_result =
+      mojo::CreateDataPipe(nullptr, pipe_producer_handle, pipe_consumer_handle);
+  CHECK_EQ(create_result, MOJO_RESULT_OK);
+
+  mojo::Remote<network::mojom::URLLoaderClient> client(
+      std::move(client_remote));
+  client->OnReceiveResponse(std::move(headers),
+                            std::move(pipe_consumer_handle));
+  client->OnComplete(network::URLLoaderCompletionStatus(net::OK));
+}
+
 void ReadData(
     network::mojom::URLResponseHeadPtr headers,
     const ui::TemplateReplacements* replacements,
@@ -181,6 +227,124 @@ void DataAvailable(
                                 std::move(url_request_elapsed_timer), bytes));
 }
 
+// Vivaldi: size of the pipe used to stream files so big files never need a
+// buffer of their full size.
+constexpr uint32_t kFileStreamPipeCapacity = 512 * 1024;
+
+void OnFileStreamed(std::unique_ptr<mojo::DataPipeProducer> producer,
+                    mojo::Remote<network::mojom::URLLoaderClient> client,
+                    uint64_t output_size,
+                    base::ElapsedTimer url_request_elapsed_timer,
+                    MojoResult result) {
+  network::URLLoaderCompletionStatus status(
+      result == MOJO_RESULT_OK ? net::OK : net::ERR_FAILED);
+  status.encoded_data_length = output_size;
+  status.encoded_body_length = output_size;
+  status.decoded_body_length = output_size;
+  client->OnComplete(status);
+
+  UMA_HISTOGRAM_TIMES("WebUI.WebUIURLLoaderFactory.URLRequestLoadTime",
+                      url_request_elapsed_timer.Elapsed());
+}
+
+void StreamFile(
+    network::mojom::URLResponseHeadPtr headers,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client_remote,
+    absl::optional<net::HttpByteRange> requested_range,
+    base::ElapsedTimer url_request_elapsed_timer,
+    base::FilePath file_path) {
+  TRACE_EVENT0("ui", "WebUIURLLoader::StreamFile");
+  base::File file(file_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid()) {
+    CallOnError(std::move(client_remote),
+                net::FileErrorToNetError(file.error_details()));
+    return;
+  }
+  int64_t length = file.GetLength();
+  if (length < 0) {
+    CallOnError(std::move(client_remote), net::ERR_FAILED);
+    return;
+  }
+
+  uint64_t output_offset = 0;
+  uint64_t output_size = static_cast<uint64_t>(length);
+  if (requested_range) {
+    if (!requested_range->ComputeBounds(length)) {
+      CallOnError(std::move(client_remote),
+                  net::ERR_REQUEST_RANGE_NOT_SATISFIABLE);
+      return;
+    }
+    output_offset = requested_range->first_byte_position();
+    output_size = requested_range->last_byte_position() -
+                  requested_range->first_byte_position() + 1;
+  }
+
+  MojoCreateDataPipeOptions options;
+  options.struct_size = sizeof(MojoCreateDataPipeOptions);
+  options.flags = MOJO_CREATE_DATA_PIPE_FLAG_NONE;
+  options.element_num_bytes = 1;
+  options.capacity_num_bytes = kFileStreamPipeCapacity;
+  mojo::ScopedDataPipeProducerHandle pipe_producer_handle;
+  mojo::ScopedDataPipeConsumerHandle pipe_consumer_handle;
+  MojoResult create_result = mojo::CreateDataPipe(
+      &options, pipe_producer_handle, pipe_consumer_handle);
+  CHECK_EQ(create_result, MOJO_RESULT_OK);
+
+  // See ReadData() for why the length must be known upfront.
+  headers->content_length = static_cast<int64_t>(output_size);
+
+  mojo::Remote<network::mojom::URLLoaderClient> client(
+      std::move(client_remote));
+  client->OnReceiveResponse(std::move(headers),
+                            std::move(pipe_consumer_handle));
+
+  auto file_source = std::make_unique<mojo::FileDataSource>(std::move(file));
+  file_source->SetRange(output_offset, output_offset + output_size);
+
+  // The producer reads the file in chunks as the consumer drains the pipe. It
+  // is owned by its completion callback.
+  auto producer =
+      std::make_unique<mojo::DataPipeProducer>(std::move(pipe_producer_handle));
+  mojo::DataPipeProducer* raw_producer = producer.get();
+  raw_producer->Write(
+      std::move(file_source),
+      base::BindOnce(OnFileStreamed, std::move(producer), std::move(client),
+                     output_size, std::move(url_request_elapsed_timer)));
+}
+
+void FilePathAvailable(
+    const GURL& url,
+    const WebContents::Getter& wc_getter,
+    network::mojom::URLResponseHeadPtr headers,
+    scoped_refptr<URLDataSourceImpl> source,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client_remote,
+    absl::optional<net::HttpByteRange> requested_range,
+    base::ElapsedTimer url_request_elapsed_timer,
+    base::FilePath file_path) {
+  if (file_path.empty()) {
+    source->source()->StartDataRequest(
+        url, wc_getter,
+        base::BindOnce(DataAvailable, std::move(headers),
+                       static_cast<const ui::TemplateReplacements*>(nullptr),
+                       /*replace_in_js=*/false, source,
+                       std::move(client_remote), std::move(requested_range),
+                       std::move(url_request_elapsed_timer)));
+    return;
+  }
+
+  // Files are opened and read with blocking calls. Mojo requires a
+  // SequencedTaskRunnerHandle in scope for the producer.
+  base::ThreadPool::CreateSequencedTaskRunner(
+      {base::TaskPriority::USER_BLOCKING, base::MayBlock(),
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})
+      ->PostTask(FROM_HERE,
+                 base::BindOnce(StreamFile, std::move(headers),
+                                std::move(client_remote),
+                                std::move(requested_range),
+                                std::move(url_request_elapsed_timer),
+                                std::move(file_path)));
+}
+
 void StartURLLoader(
     const network::ResourceRequest& request,
     int frame_tree_node_id,
@@ -239,10 +403,22 @@ void StartURLLoader(
   // process.
   resource_response->parsed_headers = network::PopulateParsedHeaders(
       resource_response->headers.get(), request.url);
-  resource_response->mime_type = source->source()->GetMimeType(request.url);
+  // Vivaldi: sources may parse the url to find the mime type, so ask once.
+  const std::string mime_type = source->source()->GetMimeType(request.url);
+  resource_response->mime_type = mime_type;
   // TODO: fill all the time related field i.e. request_time response_time
   // request_start response_start
 
+  std::string etag;
+  std::string if_none_match;
+  if (headers->GetNormalizedHeader("ETag", &etag) &&
+      request.headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch,
+                                &if_none_match) &&
+      MatchesIfNoneMatch(if_none_match, etag)) {
+    CallOnNotModified(std::move(resource_response), std::move(client_remote));
+    return;
+  }
+
   WebContents::Getter wc_getter;
 
   // Service Workers factories have no associated frame.
@@ -253,15 +429,25 @@ void StartURLLoader(
                                     frame_tree_node_id);
   }
 
-  bool replace_in_js =
-      source->source()->ShouldReplaceI18nInJS() &&
-      source->source()->GetMimeType(request.url) == "application/javascript";
+  bool replace_in_js = source->source()->ShouldReplaceI18nInJS() &&
+                       mime_type == "application/javascript";
 
   const ui::TemplateReplacements* replacements = nullptr;
-  const std::string mime_type = source->source()->GetMimeType(request.url);
   if (mime_type == "text/html" || mime_type == "text/css" || replace_in_js)
     replacements = source->source()->GetReplacements();
 
+  // Vivaldi: let sources that opt in stream big files. They run the callback
+  // with an empty path for urls they do not stream and get StartDataRequest().
+  if (!replacements && source->source()->ShouldStreamFiles()) {
+    source->source()->StartFilePathRequest(
+        request.url, wc_getter,
+        base::BindOnce(FilePathAvailable, request.url, wc_getter,
+                       std::move(resource_response),
+                       base::WrapRefCounted(source), std::move(client_remote),
+                       std::move(range), std::move(url_request_elapsed_timer)));
+    return;
+  }
+
   // To keep the same behavior as the old WebUI code, we call the source to get
   // the value for |replacements| on the IO thread. Since |replacements| is
   // owned by |source| keep a reference to it in the callback.
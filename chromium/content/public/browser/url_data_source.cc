@@ -54,6 +54,16 @@ std::string URLDataSource::URLToRequestPath(const GURL& url) {
   return std::string();
 }
 
+bool URLDataSource::ShouldStreamFiles() {
+  return false;
+}
+
+void URLDataSource::StartFilePathRequest(const GURL& url,
+                                         const WebContents::Getter& wc_getter,
+                                         GotFilePathCallback callback) {
+  std::move(callback).Run(base::FilePath());
+}
+
 bool URLDataSource::ShouldReplaceExistingSource() {
   return true;
 }
@@ -66,6 +76,14 @@ bool URLDataSource::AllowCaching() {
   return true;
 }
 
+std::string URLDataSource::GetCacheControl(const GURL& url) {
+  return AllowCaching(url) ? std::string() : "no-cache";
+}
+
+std::string URLDataSource::GetETag(const GURL& url) {
+  return std::string();
+}
+
 bool URLDataSource::ShouldAddContentSecurityPolicy() {
   return true;
 }
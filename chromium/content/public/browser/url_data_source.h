@@ -9,6 +9,7 @@
 #include <string>
 
 #include "base/callback.h"
+#include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "content/common/content_export.h"
 #include "content/public/browser/web_contents.h"
@@ -67,6 +68,23 @@ class CONTENT_EXPORT URLDataSource {
                                 const WebContents::Getter& wc_getter,
                                 GotDataCallback callback) = 0;
 
+  // Vivaldi: Returns true if the source serves big files and wants
+  // StartFilePathRequest() to be called before StartDataRequest(). The
+  // default is false, so other sources are always loaded with
+  // StartDataRequest().
+  virtual bool ShouldStreamFiles();
+
+  // Vivaldi: Variant of StartDataRequest() for sources that return true from
+  // ShouldStreamFiles(). Run |callback| with the path of the file for |url| to
+  // have the response streamed from the file in chunks, honoring any Range
+  // header, instead of being read into one buffer. An empty path makes the
+  // request use StartDataRequest(). Template replacements are never applied
+  // to the streamed files. The default runs |callback| with an empty path.
+  using GotFilePathCallback = base::OnceCallback<void(base::FilePath)>;
+  virtual void StartFilePathRequest(const GURL& url,
+                                    const WebContents::Getter& wc_getter,
+                                    GotFilePathCallback callback);
+
   // Return the mimetype that should be sent with this response, or empty
   // string to specify no mime type.
   virtual std::string GetMimeType(const GURL& url) = 0;
@@ -86,6 +104,16 @@ class CONTENT_EXPORT URLDataSource {
   virtual bool AllowCaching();
  public:
 
+  // Vivaldi: Returns the Cache-Control header value for |url| or an
+  // empty string to send none. The default sends no-cache when
+  // AllowCaching(url) is false.
+  virtual std::string GetCacheControl(const GURL& url);
+
+  // Vivaldi: Returns the quoted ETag of the response for |url| or an
+  // empty string when the source cannot name the content without loading it.
+  // A request whose If-None-Match matches it is answered with 304.
+  virtual std::string GetETag(const GURL& url);
+
   // If you are overriding the following two methods, then you have a bug.
   // It is not acceptable to disable content-security-policy on chrome:// pages
   // to permit functionality excluded by CSP, such as inline script.
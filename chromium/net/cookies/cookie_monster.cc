@@ -642,9 +642,12 @@ void CookieMonster::GetCookieListWithOptions(
   CookieAccessResultList included_cookies;
   CookieAccessResultList excluded_cookies;
   if (HasCookieableScheme(url)) {
+    // Vivaldi: The registry lookup in GetKey() is the costly part of
+    // finding the cookies, do it once for all partitions.
+    const std::string key(GetKey(url.host_piece()));
     std::vector<CanonicalCookie*> cookie_ptrs;
     if (IncludeUnpartitionedCookies(cookie_partition_key_collection)) {
-      cookie_ptrs = FindCookiesForRegistryControlledHost(url);
+      cookie_ptrs = FindCookiesForKey(key);
     } else {
       DCHECK(!cookie_partition_key_collection.IsEmpty());
     }
@@ -653,15 +656,15 @@ void CookieMonster::GetCookieListWithOptions(
       if (cookie_partition_key_collection.ContainsAllKeys()) {
         for (const auto& it : partitioned_cookies_) {
           std::vector<CanonicalCookie*> partitioned_cookie_ptrs =
-              FindPartitionedCookiesForRegistryControlledHost(it.first, url);
+              FindPartitionedCookiesForKey(it.first, key);
           cookie_ptrs.insert(cookie_ptrs.end(), partitioned_cookie_ptrs.begin(),
                              partitioned_cookie_ptrs.end());
         }
       } else {
-        for (const CookiePartitionKey& key :
+        for (const CookiePartitionKey& partition_key :
              cookie_partition_key_collection.PartitionKeys()) {
           std::vector<CanonicalCookie*> partitioned_cookie_ptrs =
-              FindPartitionedCookiesForRegistryControlledHost(key, url);
+              FindPartitionedCookiesForKey(partition_key, key);
           cookie_ptrs.insert(cookie_ptrs.end(), partitioned_cookie_ptrs.begin(),
                              partitioned_cookie_ptrs.end());
         }
@@ -1124,9 +1127,8 @@ void CookieMonster::TrimDuplicateCookiesForKey(
   DCHECK_EQ(num_duplicates, num_duplicates_found);
 }
 
-std::vector<CanonicalCookie*>
-CookieMonster::FindCookiesForRegistryControlledHost(
-    const GURL& url,
+std::vector<CanonicalCookie*> CookieMonster::FindCookiesForKey(
+    const std::string& key,
     CookieMap* cookie_map,
     CookieMonster::PartitionedCookieMap::iterator* partition_it) {
   DCHECK(thread_checker_.CalledOnValidThread());
@@ -1137,8 +1139,6 @@ CookieMonster::FindCookiesForRegistryControlledHost(
   Time current_time = Time::Now();
 
   // Retrieve all cookies for a given key
-  const std::string key(GetKey(url.host_piece()));
-
   std::vector<CanonicalCookie*> cookies;
   for (CookieMapItPair its = cookie_map->equal_range(key);
        its.first != its.second;) {
@@ -1163,10 +1163,9 @@ CookieMonster::FindCookiesForRegistryControlledHost(
   return cookies;
 }
 
-std::vector<CanonicalCookie*>
-CookieMonster::FindPartitionedCookiesForRegistryControlledHost(
+std::vector<CanonicalCookie*> CookieMonster::FindPartitionedCookiesForKey(
     const CookiePartitionKey& cookie_partition_key,
-    const GURL& url) {
+    const std::string& key) {
   DCHECK(thread_checker_.CalledOnValidThread());
 
   PartitionedCookieMap::iterator it =
@@ -1174,7 +1173,7 @@ CookieMonster::FindPartitionedCookiesForRegistryControlledHost(
   if (it == partitioned_cookies_.end())
     return std::vector<CanonicalCookie*>();
 
-  return FindCookiesForRegistryControlledHost(url, it->second.get(), &it);
+  return FindCookiesForKey(key, it->second.get(), &it);
 }
 
 void CookieMonster::FilterCookiesWithOptions(
@@ -1268,6 +1267,7 @@ void CookieMonster::MaybeDeleteEquivalentCookieAndUpdateStatus(
     bool skip_httponly,
     bool already_expired,
     base::Time* creation_date_to_inherit,
+    bool* skip_store_write,
     CookieInclusionStatus* status,
     absl::optional<PartitionedCookieMap::iterator> cookie_partition_it) {
   DCHECK(thread_checker_.CalledOnValidThread());
@@ -1347,14 +1347,34 @@ void CookieMonster::MaybeDeleteEquivalentCookieAndUpdateStatus(
     if (deletion_candidate->Value() == cookie_being_set.Value())
       *creation_date_to_inherit = deletion_candidate->CreationDate();
     if (status->IsInclude()) {
+      // Vivaldi: Pages often set the same cookie again on every
+      // request. When the new cookie inherits the creation date and matches
+      // all other stored fields, the delete and add would cancel each other
+      // out in the store, so leave the stored row alone. Like with
+      // UpdateCookieAccessTime() the stored access time may lag behind.
+      bool sync_to_store = true;
+      if (!already_expired && !creation_date_to_inherit->is_null() &&
+          deletion_candidate->ExpiryDate() == cookie_being_set.ExpiryDate() &&
+          deletion_candidate->IsSecure() == cookie_being_set.IsSecure() &&
+          deletion_candidate->IsHttpOnly() == cookie_being_set.IsHttpOnly() &&
+          deletion_candidate->SameSite() == cookie_being_set.SameSite() &&
+          deletion_candidate->Priority() == cookie_being_set.Priority() &&
+          deletion_candidate->IsSameParty() == cookie_being_set.IsSameParty() &&
+          deletion_candidate->SourceScheme() ==
+              cookie_being_set.SourceScheme() &&
+          deletion_candidate->SourcePort() == cookie_being_set.SourcePort() &&
+          ShouldUpdatePersistentStore(deletion_candidate)) {
+        sync_to_store = false;
+        *skip_store_write = true;
+        num_store_writes_saved_ += 2;
+      }
       if (cookie_being_set.IsPartitioned()) {
         InternalDeletePartitionedCookie(
-            cookie_partition_it.value(), deletion_candidate_it,
-            true /* sync_to_store */,
+            cookie_partition_it.value(), deletion_candidate_it, sync_to_store,
             already_expired ? DELETE_COOKIE_EXPIRED_OVERWRITE
                             : DELETE_COOKIE_OVERWRITE);
       } else {
-        InternalDeleteCookie(deletion_candidate_it, true /* sync_to_store */,
+        InternalDeleteCookie(deletion_candidate_it, sync_to_store,
                              already_expired ? DELETE_COOKIE_EXPIRED_OVERWRITE
                                              : DELETE_COOKIE_OVERWRITE);
       }
@@ -1513,6 +1533,7 @@ void CookieMonster::SetCanonicalCookie(
   bool already_expired = cc->IsExpired(creation_date);
 
   base::Time creation_date_to_inherit;
+  bool skip_store_write = false;
 
   absl::optional<PartitionedCookieMap::iterator> cookie_partition_it;
   bool should_try_to_delete_duplicates = true;
@@ -1535,7 +1556,7 @@ void CookieMonster::SetCanonicalCookie(
     MaybeDeleteEquivalentCookieAndUpdateStatus(
         key, *cc, access_result.is_allowed_to_access_secure_cookies,
         options.exclude_httponly(), already_expired, &creation_date_to_inherit,
-        &access_result.status, cookie_partition_it);
+        &skip_store_write, &access_result.status, cookie_partition_it);
   }
 
   if (access_result.status.HasExclusionReason(
@@ -1599,10 +1620,11 @@ void CookieMonster::SetCanonicalCookie(
       }
 
       if (is_partitioned_cookie) {
-        InternalInsertPartitionedCookie(key, std::move(cc), true,
+        InternalInsertPartitionedCookie(key, std::move(cc), !skip_store_write,
                                         access_result);
       } else {
-        InternalInsertCookie(key, std::move(cc), true, access_result);
+        InternalInsertCookie(key, std::move(cc), !skip_store_write,
+                             access_result);
       }
     } else {
       DVLOG(net::cookie_util::kVlogSetCookies)
@@ -2171,7 +2193,7 @@ size_t CookieMonster::GarbageCollectLeastRecentlyAccessed(
 
 // A wrapper around registry_controlled_domains::GetDomainAndRegistry
 // to make clear we're creating a key for our local map or for the persistent
-// store's use. Here and in FindCookiesForRegistryControlledHost() are the only
+// store's use. Here and in FindCookiesForKey() are the only
 // two places where we need to conditionalize based on key type.
 //
 // Note that this key algorithm explicitly ignores the scheme.  This is
@@ -2286,6 +2308,11 @@ bool CookieMonster::DoRecordPeriodicStats() {
   // Can be up to kMaxCookies.
   UMA_HISTOGRAM_COUNTS_10000("Cookie.NumKeys", num_keys_);
 
+  // Vivaldi: Store operations saved since the last periodic stats.
+  base::UmaHistogramCounts100000("Cookie.Vivaldi.StoreWritesSaved",
+                                 num_store_writes_saved_);
+  num_store_writes_saved_ = 0;
+
   std::map<std::string, size_t> n_same_site_none_cookies;
   for (const auto& [host_key, host_cookie] : cookies_) {
     if (!host_cookie || !host_cookie->IsEffectivelySameSiteNone())
@@ -2444,11 +2471,11 @@ void CookieMonster::OnConvertPartitionedCookiesToUnpartitioned(
     const GURL& url) {
   DCHECK(thread_checker_.CalledOnValidThread());
 
-  std::vector<CanonicalCookie*> cookie_ptrs_for_site =
-      FindCookiesForRegistryControlledHost(url);
+  const std::string key(GetKey(url.host_piece()));
+  std::vector<CanonicalCookie*> cookie_ptrs_for_site = FindCookiesForKey(key);
   for (const auto& it : partitioned_cookies_) {
     std::vector<CanonicalCookie*> partitioned_cookie_ptrs =
-        FindPartitionedCookiesForRegistryControlledHost(it.first, url);
+        FindPartitionedCookiesForKey(it.first, key);
     cookie_ptrs_for_site.insert(cookie_ptrs_for_site.end(),
                                 partitioned_cookie_ptrs.begin(),
                                 partitioned_cookie_ptrs.end());
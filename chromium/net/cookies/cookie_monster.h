@@ -481,14 +481,16 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   void SetDefaultCookieableSchemes();
 
-  std::vector<CanonicalCookie*> FindCookiesForRegistryControlledHost(
-      const GURL& url,
+  // Vivaldi: These take the key of the url's host from GetKey() rather
+  // than the url, so a lookup over many partitions only computes it once.
+  std::vector<CanonicalCookie*> FindCookiesForKey(
+      const std::string& key,
       CookieMap* cookie_map = nullptr,
       PartitionedCookieMap::iterator* partition_it = nullptr);
 
-  std::vector<CanonicalCookie*> FindPartitionedCookiesForRegistryControlledHost(
+  std::vector<CanonicalCookie*> FindPartitionedCookiesForKey(
       const CookiePartitionKey& cookie_partition_key,
-      const GURL& url);
+      const std::string& key);
 
   void FilterCookiesWithOptions(const GURL url,
                                 const CookieOptions options,
@@ -524,6 +526,11 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // is the iterator of the CookieMap in |partitioned_cookies_| we should search
   // for duplicates.
   //
+  // Vivaldi: If the deleted cookie would be stored exactly like
+  // |cookie_being_set| apart from its access and update times, it is not
+  // deleted from the persistent store and |*skip_store_write| is set to true,
+  // so the caller inserts the new cookie without writing it either.
+  //
   // NOTE: There should never be more than a single matching equivalent cookie.
   void MaybeDeleteEquivalentCookieAndUpdateStatus(
       const std::string& key,
@@ -532,6 +539,7 @@ class NET_EXPORT CookieMonster : public CookieStore {
       bool skip_httponly,
       bool already_expired,
       base::Time* creation_date_to_inherit,
+      bool* skip_store_write,
       CookieInclusionStatus* status,
       absl::optional<PartitionedCookieMap::iterator> cookie_partition_it);
 
@@ -739,6 +747,11 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // global maximum on the number of partitioned cookies.
   size_t num_partitioned_cookies_ = 0u;
 
+  // Vivaldi: Number of persistent store delete and add operations saved
+  // by overwrites that did not change the stored cookie, since the last
+  // periodic stats.
+  size_t num_store_writes_saved_ = 0u;
+
   CookieMonsterChangeDispatcher change_dispatcher_;
 
   // Indicates whether the cookie store has been initialized.
@@ -41,6 +41,7 @@ static constexpr char kMetricQueryDomainTimeMs[] = "query_domain_time";
 static constexpr char kMetricImportTimeMs[] = "import_time";
 static constexpr char kMetricGetKeyTimeMs[] = "get_key_time";
 static constexpr char kMetricGCTimeMs[] = "gc_time";
+static constexpr char kMetricFrameQueryRate[] = "frame_query_rate";
 
 perf_test::PerfResultReporter SetUpParseReporter(const std::string& story) {
   perf_test::PerfResultReporter reporter(kMetricPrefixParsedCookie, story);
@@ -58,6 +59,7 @@ perf_test::PerfResultReporter SetUpCookieMonsterReporter(
   reporter.RegisterImportantMetric(kMetricImportTimeMs, "ms");
   reporter.RegisterImportantMetric(kMetricGetKeyTimeMs, "ms");
   reporter.RegisterImportantMetric(kMetricGCTimeMs, "ms");
+  reporter.RegisterImportantMetric(kMetricFrameQueryRate, "runs/s");
   return reporter;
 }
 
@@ -251,6 +253,53 @@ TEST_F(CookieMonsterTest, TestAddCookieOnManyHosts) {
                      delete_all_timer.Elapsed().InMillisecondsF());
 }
 
+// Simulates pages embedding many frames from different sites, each frame
+// asking for its cookies, with the store filled with cookies of many other
+// sites as well. The store keeps at most CookieMonster::kMaxCookies, so the
+// queries and not the cookies go to 10k and 100k.
+TEST_F(CookieMonsterTest, TestManyFramesManyDomains) {
+  constexpr int kNumDomains = 300;
+  constexpr int kCookiesPerDomain = 10;
+  constexpr int kFramesPerPage = 50;
+  // The store must keep all cookies.
+  ASSERT_LE(static_cast<size_t>(kNumDomains * kCookiesPerDomain),
+            CookieMonster::kMaxCookies);
+
+  auto cm =
+      std::make_unique<CookieMonster>(nullptr, nullptr, kFirstPartySetsEnabled);
+  std::vector<GURL> gurls;
+  for (int i = 0; i < kNumDomains; ++i) {
+    gurls.emplace_back(base::StringPrintf("https://frame.a%04d.izzle", i));
+  }
+
+  SetCookieCallback setCookieCallback;
+  for (const GURL& gurl : gurls) {
+    for (int i = 0; i < kCookiesPerDomain; ++i) {
+      setCookieCallback.SetCookie(
+          cm.get(), gurl,
+          base::StringPrintf("a%02d=b; SameSite=None; Secure", i));
+    }
+  }
+
+  GetCookieListCallback getCookieListCallback;
+  for (int num_queries : {10000, 100000}) {
+    auto reporter = SetUpCookieMonsterReporter(
+        base::StringPrintf("many_frames_%d_queries", num_queries));
+    base::ElapsedTimer query_timer;
+    for (int i = 0; i < num_queries; ++i) {
+      // Each page has its own set of frame sites.
+      int page = i / kFramesPerPage;
+      int frame = i % kFramesPerPage;
+      const GURL& gurl =
+          gurls[(page * kFramesPerPage + frame * 7) % kNumDomains];
+      EXPECT_EQ(static_cast<size_t>(kCookiesPerDomain),
+                getCookieListCallback.GetCookieList(cm.get(), gurl).size());
+    }
+    reporter.AddResult(kMetricFrameQueryRate,
+                       num_queries / query_timer.Elapsed().InSecondsF());
+  }
+}
+
 TEST_F(CookieMonsterTest, TestDomainTree) {
   auto cm =
       std::make_unique<CookieMonster>(nullptr, nullptr, kFirstPartySetsEnabled);
@@ -3269,6 +3269,30 @@ TEST_F(CookieMonsterTest, PersisentCookieStorageTest) {
   EXPECT_EQ(5u, store->commands().size());
 }
 
+// Vivaldi: Setting a cookie again without changing anything that is
+// stored must not write to the persistent cookie store.
+TEST_F(CookieMonsterTest, UnchangedOverwriteSkipsPersistentStore) {
+  auto store = base::MakeRefCounted<MockPersistentCookieStore>();
+  auto cm = std::make_unique<CookieMonster>(store.get(), net::NetLog::Get(),
+                                            kFirstPartySetsDefault);
+
+  const std::string cookie_line = "A=B" + FutureCookieExpirationString();
+  EXPECT_TRUE(SetCookie(cm.get(), http_www_foo_.url(), cookie_line));
+  ASSERT_EQ(1u, store->commands().size());
+  EXPECT_EQ(CookieStoreCommand::ADD, store->commands()[0].type);
+
+  EXPECT_TRUE(SetCookie(cm.get(), http_www_foo_.url(), cookie_line));
+  this->MatchCookieLines("A=B", GetCookies(cm.get(), http_www_foo_.url()));
+  EXPECT_EQ(1u, store->commands().size());
+
+  // A changed attribute is still written.
+  EXPECT_TRUE(SetCookie(cm.get(), http_www_foo_.url(),
+                        cookie_line + "; priority=high"));
+  ASSERT_EQ(3u, store->commands().size());
+  EXPECT_EQ(CookieStoreCommand::REMOVE, store->commands()[1].type);
+  EXPECT_EQ(CookieStoreCommand::ADD, store->commands()[2].type);
+}
+
 // Test to assure that cookies with control characters are purged appropriately.
 // See http://crbug.com/238041 for background.
 TEST_F(CookieMonsterTest, ControlCharacterPurge) {
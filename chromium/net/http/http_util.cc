@@ -7,6 +7,8 @@
 
 #include "net/http/http_util.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "base/check_op.h"
@@ -536,25 +538,26 @@ static size_t LocateEndOfHeadersHelper(const char* buf,
                                        size_t buf_len,
                                        size_t i,
                                        bool accept_empty_header_list) {
-  char last_c = '\0';
-  bool was_lf = false;
-  if (accept_empty_header_list) {
-    // Normally two line breaks signal the end of a header list. An empty header
-    // list ends with a single line break at the start of the buffer.
-    last_c = '\n';
-    was_lf = true;
-  }
-
-  for (; i < buf_len; ++i) {
-    char c = buf[i];
-    if (c == '\n') {
-      if (was_lf)
+  // Normally two line breaks signal the end of a header list. An empty header
+  // list ends with a single line break at the start of the buffer.
+  bool was_lf = accept_empty_header_list;
+
+  // Vivaldi: Only the bytes right after a LF can end the headers, so
+  // jump from one LF to the next with memchr() instead of looking at every
+  // byte. A line break is LF or a single CR followed by LF, the same as the
+  // byte by byte scan accepted.
+  while (i < buf_len) {
+    if (was_lf) {
+      if (buf[i] == '\n')
         return i + 1;
-      was_lf = true;
-    } else if (c != '\r' || last_c != '\n') {
-      was_lf = false;
+      if (buf[i] == '\r' && i + 1 < buf_len && buf[i + 1] == '\n')
+        return i + 2;
     }
-    last_c = c;
+    const void* lf = memchr(buf + i, '\n', buf_len - i);
+    if (!lf)
+      break;
+    i = static_cast<size_t>(static_cast<const char*>(lf) - buf) + 1;
+    was_lf = true;
   }
   return std::string::npos;
 }
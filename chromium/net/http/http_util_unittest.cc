@@ -338,6 +338,8 @@ TEST(HttpUtilTest, LocateEndOfHeaders) {
       {"foo\nbar\n\njunk", 9},
       {"foo\nbar\n\r\njunk", 10},
       {"foo\nbar\r\n\njunk", 10},
+      {"foo\n\r\r\n\n", 8},
+      {"foo\n\r\rbar\n\r", std::string::npos},
   };
   for (const auto& test : tests) {
     size_t input_len = strlen(test.input);
@@ -362,6 +364,8 @@ TEST(HttpUtilTest, LocateEndOfAdditionalHeaders) {
       {"foo\nbar\n\njunk", 9},
       {"foo\nbar\n\r\njunk", 10},
       {"foo\nbar\r\n\njunk", 10},
+      {"\r\r\n\n", 4},
+      {"foo\n\r\r\n\n", 8},
   };
   for (const auto& test : tests) {
     size_t input_len = strlen(test.input);
@@ -1465,6 +1465,11 @@ scoped_refptr<Database::StatementRef> Database::GetCachedStatement(
     StatementID id,
     const char* sql) {
   auto it = statement_cache_.find(id);
+  // Vivaldi: Count the lookups for the memory dumps.
+  if (memory_dump_provider_) {
+    memory_dump_provider_->RecordStatementCacheLookup(it !=
+                                                      statement_cache_.end());
+  }
   if (it != statement_cache_.end()) {
     // Statement is in the cache. It should still be valid. We're the only
     // entity invalidating cached statements, and we remove them from the cache
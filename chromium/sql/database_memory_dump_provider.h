@@ -5,6 +5,8 @@
 #ifndef SQL_DATABASE_MEMORY_DUMP_PROVIDER_H_
 #define SQL_DATABASE_MEMORY_DUMP_PROVIDER_H_
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 #include "base/memory/raw_ptr.h"
@@ -34,6 +36,11 @@ class DatabaseMemoryDumpProvider
 
   void ResetDatabase();
 
+  // Vivaldi: Counts lookups in the cached statement cache of the
+  // database so memory dumps show how well the cache works. Called on the
+  // database sequence.
+  void RecordStatementCacheLookup(bool hit);
+
   // base::trace_event::MemoryDumpProvider implementation.
   bool OnMemoryDump(
       const base::trace_event::MemoryDumpArgs& args,
@@ -58,6 +65,10 @@ class DatabaseMemoryDumpProvider
   base::Lock lock_;
   raw_ptr<sqlite3> db_ GUARDED_BY_CONTEXT(lock_);  // not owned.
   const std::string connection_name_;
+
+  // Read by OnMemoryDump() on the dump thread.
+  std::atomic<uint64_t> statement_cache_hits_{0};
+  std::atomic<uint64_t> statement_cache_misses_{0};
 };
 
 }  // namespace sql
@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <cstdint>
+#include <utility>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
@@ -1589,6 +1590,36 @@ TEST_P(SQLDatabaseTest, OnMemoryDump) {
   EXPECT_GE(pmd.allocator_dumps().size(), 1u);
 }
 
+// Vivaldi: The dumps report the cached statement lookups.
+TEST_P(SQLDatabaseTest, OnMemoryDumpStatementCacheLookups) {
+  // Returns the hits and misses reported so far.
+  auto get_lookups = [this]() -> std::pair<uint64_t, uint64_t> {
+    base::trace_event::MemoryDumpArgs args = {
+        base::trace_event::MemoryDumpLevelOfDetail::DETAILED};
+    base::trace_event::ProcessMemoryDump pmd(args);
+    EXPECT_TRUE(db_->memory_dump_provider_->OnMemoryDump(args, &pmd));
+    std::pair<uint64_t, uint64_t> lookups;
+    for (const auto& dump : pmd.allocator_dumps()) {
+      for (const auto& entry : dump.second->entries()) {
+        if (entry.name == "statement_cache_hits")
+          lookups.first = entry.value_uint64;
+        if (entry.name == "statement_cache_misses")
+          lookups.second = entry.value_uint64;
+      }
+    }
+    return lookups;
+  };
+
+  std::pair<uint64_t, uint64_t> before = get_lookups();
+  for (int i = 0; i < 3; ++i) {
+    Statement s(db_->GetCachedStatement(SQL_FROM_HERE, "SELECT 1"));
+    ASSERT_TRUE(s.Step());
+  }
+  std::pair<uint64_t, uint64_t> after = get_lookups();
+  EXPECT_EQ(after.first - before.first, 2u);
+  EXPECT_EQ(after.second - before.second, 1u);
+}
+
 // Test that the functions to collect diagnostic data run to completion, without
 // worrying too much about what they generate (since that will change).
 TEST_P(SQLDatabaseTest, CollectDiagnosticInfo) {
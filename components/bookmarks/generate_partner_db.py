@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+"""Compile partners.json and partners-locale-map.json into a C++ include.
+
+The output defines static tables used by vivaldi_partners.cc:
+
+  kPartnerDetails - all partner folders and bookmarks sorted by name.
+  kGuidIndex - guid and guid2 of each entry, sorted, with the entry index.
+  kLocaleIdMap - old locale-based partner ids, sorted, with the new GUID.
+
+All validation that the browser used to perform when parsing the JSON at
+startup is done here, so a malformed database fails the build.
+"""
+
+import argparse
+import json
+import re
+import sys
+import uuid
+
+RESOURCE_URL_PREFIX = "/resources/"
+
+FOLDER_NAME_RE = re.compile(r"^[A-Z][A-Za-z0-9]*$")
+BOOKMARK_NAME_RE = re.compile(r"^[a-z0-9][A-Za-z0-9.\-]*$")
+
+FOLDER_ONLY_KEYS = {"speeddial"}
+BOOKMARK_ONLY_KEYS = {"guid2", "thumbnail"}
+STRING_KEYS = {
+    "name", "title", "guid", "guid2", "thumbnail", "favicon", "favicon_url"
+}
+
+
+class DatabaseError(Exception):
+  pass
+
+
+def ParseGuid(value, where):
+  if not isinstance(value, str):
+    raise DatabaseError("%s is not a string" % where)
+  try:
+    return str(uuid.UUID(value))
+  except ValueError:
+    raise DatabaseError("%s is not a valid GUID - %s" % (where, value))
+
+
+def ParseDetailsList(is_folder, entries, list_key):
+  if not isinstance(entries, list):
+    raise DatabaseError("%s is not a list" % list_key)
+  result = []
+  for i, entry in enumerate(entries):
+    where = "%s[%d]" % (list_key, i)
+    if not isinstance(entry, dict):
+      raise DatabaseError("%s: entry is not an object" % where)
+    details = {
+        "name": "",
+        "title": "",
+        "guid": "",
+        "guid2": "",
+        "thumbnail": "",
+        "favicon": "",
+        "favicon_url": "",
+        "folder": is_folder,
+        "speeddial": False,
+    }
+    for key, value in entry.items():
+      if key in STRING_KEYS:
+        if not isinstance(value, str):
+          raise DatabaseError("%s: %s is not a string" % (where, key))
+      elif key == "speeddial":
+        if not isinstance(value, bool):
+          raise DatabaseError("%s: %s is not a boolean" % (where, key))
+      else:
+        raise DatabaseError("%s: unsupported or unknown property '%s'" %
+                            (where, key))
+      if is_folder and key in BOOKMARK_ONLY_KEYS:
+        raise DatabaseError("%s: property '%s' cannot present in a folder" %
+                            (where, key))
+      if not is_folder and key in FOLDER_ONLY_KEYS:
+        raise DatabaseError("%s: property '%s' cannot present in a bookmark" %
+                            (where, key))
+      if key in ("guid", "guid2"):
+        value = ParseGuid(value, "%s.%s" % (where, key))
+      elif key == "thumbnail" and value:
+        if not value.startswith(RESOURCE_URL_PREFIX):
+          raise DatabaseError("%s: %s value is not a browser resource URL" %
+                              (where, key))
+      details[key] = value
+
+    name_re = FOLDER_NAME_RE if is_folder else BOOKMARK_NAME_RE
+    if not details["name"]:
+      raise DatabaseError("%s: missing name property" % where)
+    if not name_re.match(details["name"]):
+      raise DatabaseError("%s: name is not a valid bookmark name - %s" %
+                          (where, details["name"]))
+    if not details["guid"]:
+      raise DatabaseError("%s: missing guid property" % where)
+    if is_folder:
+      if not details["title"]:
+        details["title"] = details["name"]
+    elif not details["guid2"]:
+      raise DatabaseError("%s: missing guid2 property" % where)
+    result.append(details)
+  return result
+
+
+def ParseLocaleMap(locale_map, details_by_name):
+  if not isinstance(locale_map, dict):
+    raise DatabaseError("partner locale map json is not an object")
+  result = {}
+  for name, guid_lists in locale_map.items():
+    details = details_by_name.get(name)
+    if not details:
+      raise DatabaseError("'%s' from partners-locale-map.json is not defined" %
+                          name)
+    if not isinstance(guid_lists, dict):
+      raise DatabaseError("%s is not a dictionary" % name)
+    for guid_key, ids in guid_lists.items():
+      if guid_key not in ("guid", "guid2"):
+        raise DatabaseError("unknown key %s in %s" % (guid_key, name))
+      if not isinstance(ids, list):
+        raise DatabaseError("%s.%s is not a list" % (name, guid_key))
+      if not details[guid_key]:
+        raise DatabaseError("%s has no %s" % (name, guid_key))
+      for locale_id in ids:
+        locale_id = ParseGuid(locale_id,
+                              "partner id in %s.%s" % (name, guid_key))
+        result[locale_id] = details[guid_key]
+  return result
+
+
+def CString(value):
+  """Returns |value| as a C++ string literal using only ASCII."""
+  out = ['"']
+  for byte in value.encode("utf-8"):
+    c = chr(byte)
+    if c in ('"', "\\") or byte < 0x20 or byte >= 0x7f:
+      # Octal escapes have at most 3 digits so they cannot swallow the
+      # following characters.
+      out.append("\\%03o" % byte)
+    else:
+      out.append(c)
+  out.append('"')
+  return "".join(out)
+
+
+def CBool(value):
+  return "true" if value else "false"
+
+
+def Generate(partners, locale_map):
+  if not isinstance(partners, dict):
+    raise DatabaseError("partner db json is not an object")
+  for key in ("folders", "bookmarks"):
+    if key not in partners:
+      raise DatabaseError("missing %s key" % key)
+  details_list = ParseDetailsList(True, partners["folders"], "folders")
+  details_list += ParseDetailsList(False, partners["bookmarks"], "bookmarks")
+
+  details_list.sort(key=lambda d: d["name"].encode("utf-8"))
+  details_by_name = {}
+  guid_index = {}
+  for index, details in enumerate(details_list):
+    if details["name"] in details_by_name:
+      raise DatabaseError("duplicated name %s" % details["name"])
+    details_by_name[details["name"]] = details
+    for key in ("guid", "guid2"):
+      guid = details[key]
+      if not guid:
+        continue
+      if guid in guid_index:
+        raise DatabaseError("duplicated GUID %s" % guid)
+      guid_index[guid] = index
+
+  locale_id_map = ParseLocaleMap(locale_map, details_by_name)
+
+  lines = [
+      "// Generated by components/bookmarks/generate_partner_db.py from",
+      "// partners.json and partners-locale-map.json. Do not edit.",
+      "",
+      "constexpr PartnerDetails kPartnerDetails[] = {",
+  ]
+  for details in details_list:
+    lines.append("    {%s," % CString(details["name"]))
+    lines.append("     %s," % CString(details["title"]))
+    lines.append("     %s," % CString(details["guid"]))
+    lines.append("     %s," % CString(details["guid2"]))
+    lines.append("     %s," % CString(details["thumbnail"]))
+    lines.append("     %s," % CString(details["favicon"]))
+    lines.append("     %s," % CString(details["favicon_url"]))
+    lines.append("     %s," % CBool(details["folder"]))
+    lines.append("     %s}," % CBool(details["speeddial"]))
+  lines.append("};")
+  lines.append("")
+  lines.append("constexpr GuidIndexEntry kGuidIndex[] = {")
+  for guid in sorted(guid_index):
+    lines.append("    {%s, %d}," % (CString(guid), guid_index[guid]))
+  lines.append("};")
+  lines.append("")
+  lines.append("constexpr LocaleIdEntry kLocaleIdMap[] = {")
+  for locale_id in sorted(locale_id_map):
+    lines.append("    {%s, %s}," %
+                 (CString(locale_id), CString(locale_id_map[locale_id])))
+  lines.append("};")
+  lines.append("")
+  return "\n".join(lines)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument("--partners", required=True,
+                      help="path to partners.json")
+  parser.add_argument("--locale-map", required=True,
+                      help="path to partners-locale-map.json")
+  parser.add_argument("--output", required=True,
+                      help="path to the generated include file")
+  args = parser.parse_args()
+
+  with open(args.partners, encoding="utf-8") as f:
+    partners = json.load(f)
+  with open(args.locale_map, encoding="utf-8") as f:
+    locale_map = json.load(f)
+
+  try:
+    output = Generate(partners, locale_map)
+  except DatabaseError as e:
+    sys.stderr.write("Partner database error: %s\n" % e)
+    return 1
+
+  with open(args.output, "w", encoding="utf-8", newline="\n") as f:
+    f.write(output)
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -13,7 +13,8 @@
 #include "components/bookmarks/browser/bookmark_storage.h"
 #include "components/bookmarks/browser/bookmark_utils.h"
 #include "components/bookmarks/browser/titled_url_index.h"
-#include "ui/base/models/tree_node_iterator.h"
+#include "components/bookmarks/vivaldi_nickname_index.h"
+#include "components/bookmarks/vivaldi_node_id_index.h"
 
 namespace bookmarks {
 
@@ -29,6 +30,16 @@ BookmarkNode* AsMutableNode(const BookmarkNode* node) {
 // Helper to access BookmarkModel private members
 class VivaldiBookmarkModelFriend {
  public:
+  static const vivaldi_bookmark_kit::NicknameIndex* GetNicknameIndex(
+      const BookmarkModel* model) {
+    return model->vivaldi_nickname_index_.get();
+  }
+
+  static const vivaldi_bookmark_kit::NodeIdIndex* GetNodeIdIndex(
+      const BookmarkModel* model) {
+    return model->vivaldi_node_id_index_.get();
+  }
+
   // Android-specific method to change meta that also affect url index
   static void SetNodeMetaInfoWithIndexChange(BookmarkModel* model,
                                              const BookmarkNode* node,
@@ -139,17 +150,17 @@ const std::string& GetMetaString(const BookmarkNode::MetaInfoMap& meta_info_map,
   return i->second;
 }
 
-const std::string& GetMetaString(const BookmarkNode* node,
-                                 const std::string& key) {
-  if (const BookmarkNode::MetaInfoMap* meta_info_map = node->GetMetaInfoMap()) {
-    return GetMetaString(*meta_info_map, key);
-  }
-  return base::EmptyString();
+const std::string* FindMetaString(
+    const BookmarkNode::MetaInfoMap& meta_info_map,
+    const std::string& key) {
+  auto i = meta_info_map.find(key);
+  if (i == meta_info_map.end())
+    return nullptr;
+  return &i->second;
 }
 
-bool GetMetaBool(const BookmarkNode* node, const std::string& key) {
-  const std::string& value = GetMetaString(node, key);
-  return value == GetMetaNames().true_value;
+const std::string& MetaStringOrEmpty(const std::string* value) {
+  return value ? *value : base::EmptyString();
 }
 
 void SetMetaBool(BookmarkNode::MetaInfoMap* map,
@@ -226,20 +237,43 @@ void CustomMetaInfo::SetThumbnail(const std::string& thumbnail) {
   SetMetaString(&map_, GetMetaNames().thumbnail, thumbnail);
 }
 
+void DecodeVivaldiMeta(const BookmarkNode::MetaInfoMap* meta_info_map,
+                       BookmarkNode::VivaldiMeta& meta) {
+  meta.flags = 0;
+  meta.nickname = nullptr;
+  meta.description = nullptr;
+  meta.thumbnail = nullptr;
+  meta.partner = base::GUID();
+  if (!meta_info_map)
+    return;
+
+  const VivaldiMetaNames& names = GetMetaNames();
+  if (GetMetaString(*meta_info_map, names.speeddial) == names.true_value) {
+    meta.flags |= BookmarkNode::VivaldiMeta::kSpeeddial;
+  }
+  if (GetMetaString(*meta_info_map, names.bookmarkbar) == names.true_value) {
+    meta.flags |= BookmarkNode::VivaldiMeta::kBookmarkbar;
+  }
+  meta.nickname = FindMetaString(*meta_info_map, names.nickname);
+  meta.description = FindMetaString(*meta_info_map, names.description);
+  meta.thumbnail = FindMetaString(*meta_info_map, names.thumbnail);
+  meta.partner = GetPartner(*meta_info_map);
+}
+
 bool GetSpeeddial(const BookmarkNode* node) {
-  return GetMetaBool(node, GetMetaNames().speeddial);
+  return node->vivaldi_meta().flags & BookmarkNode::VivaldiMeta::kSpeeddial;
 }
 
 bool GetBookmarkbar(const BookmarkNode* node) {
-  return GetMetaBool(node, GetMetaNames().bookmarkbar);
+  return node->vivaldi_meta().flags & BookmarkNode::VivaldiMeta::kBookmarkbar;
 }
 
 const std::string& GetNickname(const BookmarkNode* node) {
-  return GetMetaString(node, GetMetaNames().nickname);
+  return MetaStringOrEmpty(node->vivaldi_meta().nickname);
 }
 
 const std::string& GetDescription(const BookmarkNode* node) {
-  return GetMetaString(node, GetMetaNames().description);
+  return MetaStringOrEmpty(node->vivaldi_meta().description);
 }
 
 const base::GUID GetPartner(const BookmarkNode::MetaInfoMap& meta_info_map) {
@@ -255,21 +289,12 @@ const base::GUID GetPartner(const BookmarkNode::MetaInfoMap& meta_info_map) {
   return partner_id;
 }
 
-const base::GUID GetPartner(const BookmarkNode* node) {
-  base::GUID partner_id;
-  const std::string& partner_string =
-      GetMetaString(node, GetMetaNames().partner);
-  if (!partner_string.empty()) {
-    partner_id = base::GUID::ParseCaseInsensitive(partner_string);
-    if (!partner_id.is_valid()) {
-      LOG(ERROR) << "Invalid GUID as a partner id - " << partner_string;
-    }
-  }
-  return partner_id;
+const base::GUID& GetPartner(const BookmarkNode* node) {
+  return node->vivaldi_meta().partner;
 }
 
 const std::string& GetThumbnail(const BookmarkNode* node) {
-  return GetMetaString(node, GetMetaNames().thumbnail);
+  return MetaStringOrEmpty(node->vivaldi_meta().thumbnail);
 }
 
 bool IsSeparator(const BookmarkNode* node) {
@@ -288,13 +313,14 @@ void InitModelNonClonedKeys(BookmarkModel* model) {
 bool DoesNickExists(const BookmarkModel* model,
                     const std::string& nickname,
                     const BookmarkNode* updated_node) {
-  ui::TreeNodeIterator<const BookmarkNode> iterator(model->root_node());
-  while (iterator.has_next()) {
-    const BookmarkNode* node = iterator.Next();
-    if (GetNickname(node) == nickname && node != updated_node)
-      return true;
-  }
-  return false;
+  if (nickname.empty())
+    return false;
+  return VivaldiBookmarkModelFriend::GetNicknameIndex(model)->FindNode(
+             nickname, updated_node) != nullptr;
+}
+
+const BookmarkNode* FindNodeByID(const BookmarkModel* model, int64_t id) {
+  return VivaldiBookmarkModelFriend::GetNodeIdIndex(model)->FindNode(id);
 }
 
 bool SetBookmarkThumbnail(BookmarkModel* model,
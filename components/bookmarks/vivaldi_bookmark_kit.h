@@ -55,12 +55,18 @@ class CustomMetaInfo {
   BookmarkNode::MetaInfoMap map_;
 };
 
+// Fills |meta| from the Vivaldi keys of |meta_info_map|, which may be null.
+// The string pointers in |meta| refer into |meta_info_map|.
+void DecodeVivaldiMeta(const BookmarkNode::MetaInfoMap* meta_info_map,
+                       BookmarkNode::VivaldiMeta& meta);
+
+// The getters below read the typed meta of the node and are cheap.
 bool GetSpeeddial(const BookmarkNode* node);
 bool GetBookmarkbar(const BookmarkNode* node);
 const std::string& GetNickname(const BookmarkNode* node);
 const std::string& GetDescription(const BookmarkNode* node);
 const base::GUID GetPartner(const BookmarkNode::MetaInfoMap& meta_info_map);
-const base::GUID GetPartner(const BookmarkNode* node);
+const base::GUID& GetPartner(const BookmarkNode* node);
 const std::string& GetThumbnail(const BookmarkNode* node);
 
 bool IsSeparator(const BookmarkNode* node);
@@ -74,6 +80,10 @@ bool DoesNickExists(const BookmarkModel* model,
                     const std::string& nickname,
                     const BookmarkNode* updated_node);
 
+// Returns the node with the given id in the model or null if there is none.
+// This is a hash lookup once the model is loaded, see NodeIdIndex.
+const BookmarkNode* FindNodeByID(const BookmarkModel* model, int64_t id);
+
 bool SetBookmarkThumbnail(BookmarkModel* model,
                           int64_t bookmark_id,
                           const std::string& url);
@@ -32,6 +32,13 @@ const std::u16string TitledUrlNode::GetTitledUrlNodeDescription() const {
 const char BookmarkNode::kVivaldiTrashNodeGuid[] =
     "9f32a0fb-bfd9-5032-be46-07afe4a25400";
 
+BookmarkNode::VivaldiMeta::VivaldiMeta() = default;
+BookmarkNode::VivaldiMeta::~VivaldiMeta() = default;
+
+void BookmarkNode::UpdateVivaldiMeta() {
+  vivaldi_bookmark_kit::DecodeVivaldiMeta(meta_info_map_.get(), vivaldi_meta_);
+}
+
 const std::u16string BookmarkNode::GetTitledUrlNodeNickName() const {
   return base::UTF8ToUTF16(vivaldi_bookmark_kit::GetNickname(this));
 }
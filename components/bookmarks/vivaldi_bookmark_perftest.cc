@@ -0,0 +1,133 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/timer/elapsed_timer.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "components/bookmarks/test/test_bookmark_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+#include "components/bookmarks/vivaldi_bookmark_kit.h"
+
+namespace vivaldi_bookmark_kit {
+
+namespace {
+
+using bookmarks::BookmarkModel;
+using bookmarks::BookmarkNode;
+
+constexpr char kMetricPrefix[] = "VivaldiBookmarks.";
+constexpr char kMetricAddMs[] = "add";
+constexpr char kMetricFindByIdMs[] = "find_by_id";
+constexpr char kMetricFindByNicknameMs[] = "find_by_nickname";
+constexpr char kMetricFindByUrlMs[] = "find_by_url";
+
+// A synthetic profile the size of the largest ones seen in bug reports.
+constexpr int kFolderCount = 500;
+constexpr int kBookmarksPerFolder = 100;
+constexpr int kSpeedDialCount = 50;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story) {
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricAddMs, "ms");
+  reporter.RegisterImportantMetric(kMetricFindByIdMs, "ms");
+  reporter.RegisterImportantMetric(kMetricFindByNicknameMs, "ms");
+  reporter.RegisterImportantMetric(kMetricFindByUrlMs, "ms");
+  return reporter;
+}
+
+std::string GetNickname(size_t index) {
+  return "nick" + base::NumberToString(index);
+}
+
+GURL GetUrl(size_t index) {
+  return GURL("https://site" + base::NumberToString(index % 1000) +
+              ".example.com/page/" + base::NumberToString(index));
+}
+
+class VivaldiBookmarkPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = bookmarks::TestBookmarkClient::CreateModel();
+  }
+
+  // Fill the model with Speed Dial entries and with folders of bookmarks that
+  // all have a nickname.
+  void Populate() {
+    CustomMetaInfo speeddial_meta;
+    speeddial_meta.SetSpeeddial(true);
+    const BookmarkNode* speeddial = model_->AddFolder(
+        model_->bookmark_bar_node(), 0, u"Speed Dial", speeddial_meta.map());
+    for (int i = 0; i < kSpeedDialCount; ++i) {
+      CustomMetaInfo meta;
+      meta.SetThumbnail("chrome://vivaldi-data/thumbnail/" +
+                        base::NumberToString(i) + ".png");
+      model_->AddURL(speeddial, i, u"Speed Dial", GetUrl(i), meta.map());
+    }
+
+    size_t index = 0;
+    for (int folder_index = 0; folder_index < kFolderCount; ++folder_index) {
+      const BookmarkNode* folder =
+          model_->AddFolder(model_->other_node(), folder_index,
+                            u"Folder " + base::NumberToString16(folder_index));
+      for (int i = 0; i < kBookmarksPerFolder; ++i, ++index) {
+        CustomMetaInfo meta;
+        meta.SetNickname(GetNickname(index));
+        model_->AddURL(folder, i,
+                       u"Bookmark " + base::NumberToString16(index),
+                       GetUrl(index), meta.map());
+        ids_.push_back(folder->children().back()->id());
+      }
+    }
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<BookmarkModel> model_;
+  std::vector<int64_t> ids_;
+};
+
+}  // namespace
+
+// Too slow for every unit_tests run, run it with
+// --gtest_also_run_disabled_tests --gtest_filter=VivaldiBookmarkPerfTest.*
+TEST_F(VivaldiBookmarkPerfTest, DISABLED_LargeProfile) {
+  perf_test::PerfResultReporter reporter = SetUpReporter("large_profile");
+
+  base::ElapsedTimer add_timer;
+  Populate();
+  reporter.AddResult(kMetricAddMs, add_timer.Elapsed().InMillisecondsF());
+  ASSERT_EQ(ids_.size(),
+            static_cast<size_t>(kFolderCount * kBookmarksPerFolder));
+
+  base::ElapsedTimer id_timer;
+  for (int64_t id : ids_) {
+    ASSERT_TRUE(FindNodeByID(model_.get(), id));
+  }
+  reporter.AddResult(kMetricFindByIdMs, id_timer.Elapsed().InMillisecondsF());
+
+  base::ElapsedTimer nickname_timer;
+  for (size_t i = 0; i < ids_.size(); ++i) {
+    ASSERT_TRUE(DoesNickExists(model_.get(), GetNickname(i), nullptr));
+  }
+  reporter.AddResult(kMetricFindByNicknameMs,
+                     nickname_timer.Elapsed().InMillisecondsF());
+
+  base::ElapsedTimer url_timer;
+  std::vector<const BookmarkNode*> nodes;
+  for (size_t i = 0; i < ids_.size(); ++i) {
+    nodes.clear();
+    model_->GetNodesByURL(GetUrl(i), &nodes);
+    ASSERT_FALSE(nodes.empty());
+  }
+  reporter.AddResult(kMetricFindByUrlMs, url_timer.Elapsed().InMillisecondsF());
+}
+
+}  // namespace vivaldi_bookmark_kit
@@ -0,0 +1,351 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "components/bookmarks/vivaldi_bookmark_snapshot.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/hash/hash.h"
+#include "base/logging.h"
+#include "base/strings/string_piece.h"
+
+namespace vivaldi_bookmark_snapshot {
+
+namespace {
+
+const base::FilePath::CharType kSnapshotExtension[] =
+    FILE_PATH_LITERAL("snapshot");
+
+constexpr uint32_t kMagic = 0x4e534256;  // "VBSN" in little endian.
+
+// Increase when the layout changes, older snapshots are then ignored.
+constexpr uint32_t kVersion = 1;
+
+// Deeper values are rejected when reading to keep the recursion bounded.
+constexpr int kMaxDepth = 200;
+
+enum Tag : uint8_t {
+  kNone = 0,
+  kFalse = 1,
+  kTrue = 2,
+  kInt = 3,
+  kDouble = 4,
+  kString = 5,
+  kList = 6,
+  kDict = 7,
+};
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  // Size and modification time of the JSON file the snapshot was written
+  // for.
+  int64_t json_size;
+  int64_t json_modified;
+  // Size and hash of everything after the header.
+  uint64_t payload_size;
+  uint32_t payload_hash;
+  uint32_t padding;
+};
+
+struct JsonFileStamp {
+  int64_t size = 0;
+  int64_t modified = 0;
+};
+
+bool GetJsonFileStamp(const base::FilePath& json_path, JsonFileStamp* stamp) {
+  base::File::Info info;
+  if (!base::GetFileInfo(json_path, &info))
+    return false;
+  stamp->size = info.size;
+  stamp->modified =
+      info.last_modified.ToDeltaSinceWindowsEpoch().InMicroseconds();
+  return true;
+}
+
+template <typename T>
+void Append(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+class Encoder {
+ public:
+  bool EncodeValue(const base::Value& value) {
+    switch (value.type()) {
+      case base::Value::Type::NONE:
+        Append<uint8_t>(tree_, kNone);
+        return true;
+      case base::Value::Type::BOOLEAN:
+        Append<uint8_t>(tree_, value.GetBool() ? kTrue : kFalse);
+        return true;
+      case base::Value::Type::INTEGER:
+        Append<uint8_t>(tree_, kInt);
+        Append<int32_t>(tree_, value.GetInt());
+        return true;
+      case base::Value::Type::DOUBLE:
+        Append<uint8_t>(tree_, kDouble);
+        Append<double>(tree_, value.GetDouble());
+        return true;
+      case base::Value::Type::STRING:
+        Append<uint8_t>(tree_, kString);
+        Append<uint32_t>(tree_, Intern(value.GetString()));
+        return true;
+      case base::Value::Type::LIST: {
+        const base::Value::List& list = value.GetList();
+        Append<uint8_t>(tree_, kList);
+        Append<uint32_t>(tree_, static_cast<uint32_t>(list.size()));
+        for (const base::Value& item : list) {
+          if (!EncodeValue(item))
+            return false;
+        }
+        return true;
+      }
+      case base::Value::Type::DICTIONARY: {
+        const base::Value::Dict& dict = value.GetDict();
+        Append<uint8_t>(tree_, kDict);
+        Append<uint32_t>(tree_, static_cast<uint32_t>(dict.size()));
+        for (const auto item : dict) {
+          Append<uint32_t>(tree_, Intern(item.first));
+          if (!EncodeValue(item.second))
+            return false;
+        }
+        return true;
+      }
+      case base::Value::Type::BINARY:
+        // The bookmark codec never produces binary values.
+        return false;
+    }
+    return false;
+  }
+
+  std::string Finish() {
+    std::string payload;
+    Append<uint32_t>(payload, static_cast<uint32_t>(strings_.size()));
+    for (base::StringPiece s : strings_) {
+      Append<uint32_t>(payload, static_cast<uint32_t>(s.size()));
+      payload.append(s.data(), s.size());
+    }
+    payload.append(tree_);
+    return payload;
+  }
+
+ private:
+  uint32_t Intern(const std::string& s) {
+    auto result = string_index_.emplace(s, strings_.size());
+    if (result.second) {
+      strings_.push_back(result.first->first);
+    }
+    return result.first->second;
+  }
+
+  // The pieces in |strings_| point to the keys of |string_index_|, which do
+  // not move on rehashing.
+  std::unordered_map<std::string, uint32_t> string_index_;
+  std::vector<base::StringPiece> strings_;
+  std::string tree_;
+};
+
+class Decoder {
+ public:
+  explicit Decoder(base::StringPiece payload) : data_(payload) {}
+
+  absl::optional<base::Value> Decode() {
+    uint32_t string_count;
+    if (!Read(&string_count) || string_count > data_.size())
+      return absl::nullopt;
+    strings_.reserve(string_count);
+    for (uint32_t i = 0; i < string_count; ++i) {
+      uint32_t length;
+      if (!Read(&length) || length > data_.size())
+        return absl::nullopt;
+      strings_.push_back(data_.substr(0, length));
+      data_.remove_prefix(length);
+    }
+    absl::optional<base::Value> value = DecodeValue(0);
+    if (!data_.empty())
+      return absl::nullopt;
+    return value;
+  }
+
+ private:
+  template <typename T>
+  bool Read(T* value) {
+    if (data_.size() < sizeof(T))
+      return false;
+    memcpy(value, data_.data(), sizeof(T));
+    data_.remove_prefix(sizeof(T));
+    return true;
+  }
+
+  bool ReadString(base::StringPiece* s) {
+    uint32_t index;
+    if (!Read(&index) || index >= strings_.size())
+      return false;
+    *s = strings_[index];
+    return true;
+  }
+
+  absl::optional<base::Value> DecodeValue(int depth) {
+    if (depth > kMaxDepth)
+      return absl::nullopt;
+    uint8_t tag;
+    if (!Read(&tag))
+      return absl::nullopt;
+    switch (tag) {
+      case kNone:
+        return base::Value();
+      case kFalse:
+        return base::Value(false);
+      case kTrue:
+        return base::Value(true);
+      case kInt: {
+        int32_t i;
+        if (!Read(&i))
+          return absl::nullopt;
+        return base::Value(i);
+      }
+      case kDouble: {
+        double d;
+        if (!Read(&d))
+          return absl::nullopt;
+        return base::Value(d);
+      }
+      case kString: {
+        base::StringPiece s;
+        if (!ReadString(&s))
+          return absl::nullopt;
+        return base::Value(s);
+      }
+      case kList: {
+        uint32_t count;
+        if (!Read(&count) || count > data_.size())
+          return absl::nullopt;
+        base::Value::List list;
+        list.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+          absl::optional<base::Value> item = DecodeValue(depth + 1);
+          if (!item)
+            return absl::nullopt;
+          list.Append(std::move(*item));
+        }
+        return base::Value(std::move(list));
+      }
+      case kDict: {
+        uint32_t count;
+        if (!Read(&count) || count > data_.size())
+          return absl::nullopt;
+        base::Value::Dict dict;
+        for (uint32_t i = 0; i < count; ++i) {
+          base::StringPiece key;
+          if (!ReadString(&key))
+            return absl::nullopt;
+          absl::optional<base::Value> item = DecodeValue(depth + 1);
+          if (!item)
+            return absl::nullopt;
+          dict.Set(key, std::move(*item));
+        }
+        return base::Value(std::move(dict));
+      }
+    }
+    return absl::nullopt;
+  }
+
+  base::StringPiece data_;
+  std::vector<base::StringPiece> strings_;
+};
+
+}  // namespace
+
+base::FilePath GetSnapshotPath(const base::FilePath& json_path) {
+  return json_path.AddExtension(kSnapshotExtension);
+}
+
+std::string EncodePayload(const base::Value& value) {
+  Encoder encoder;
+  if (!encoder.EncodeValue(value))
+    return std::string();
+  return encoder.Finish();
+}
+
+void WriteSnapshot(const base::FilePath& json_path,
+                   const std::string& payload) {
+  JsonFileStamp stamp;
+  if (payload.empty() || !GetJsonFileStamp(json_path, &stamp)) {
+    DeleteSnapshot(json_path);
+    return;
+  }
+
+  Header header = {};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.json_size = stamp.size;
+  header.json_modified = stamp.modified;
+  header.payload_size = payload.size();
+  header.payload_hash = base::PersistentHash(payload);
+
+  std::string data;
+  data.reserve(sizeof(header) + payload.size());
+  data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  data.append(payload);
+  if (!base::ImportantFileWriter::WriteFileAtomically(
+          GetSnapshotPath(json_path), data, "BookmarkSnapshot")) {
+    LOG(WARNING) << "Failed to write the bookmark snapshot";
+    DeleteSnapshot(json_path);
+  }
+}
+
+void DeleteSnapshot(const base::FilePath& json_path) {
+  base::DeleteFile(GetSnapshotPath(json_path));
+}
+
+absl::optional<base::Value> LoadSnapshot(const base::FilePath& json_path) {
+  base::FilePath snapshot_path = GetSnapshotPath(json_path);
+  if (!base::PathExists(snapshot_path))
+    return absl::nullopt;
+
+  JsonFileStamp stamp;
+  if (!GetJsonFileStamp(json_path, &stamp))
+    return absl::nullopt;
+
+  base::MemoryMappedFile mapped_file;
+  if (!mapped_file.Initialize(snapshot_path) ||
+      mapped_file.length() < sizeof(Header)) {
+    return absl::nullopt;
+  }
+
+  Header header;
+  memcpy(&header, mapped_file.data(), sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion) {
+    return absl::nullopt;
+  }
+  if (header.json_size != stamp.size ||
+      header.json_modified != stamp.modified) {
+    // The JSON file was written without the snapshot or changed outside the
+    // browser.
+    return absl::nullopt;
+  }
+  base::StringPiece payload(
+      reinterpret_cast<const char*>(mapped_file.data()) + sizeof(header),
+      mapped_file.length() - sizeof(header));
+  if (header.payload_size != payload.size() ||
+      header.payload_hash !=
+          base::PersistentHash(payload.data(), payload.size())) {
+    LOG(WARNING) << "Ignoring corrupted bookmark snapshot";
+    return absl::nullopt;
+  }
+
+  absl::optional<base::Value> value = Decoder(payload).Decode();
+  if (!value) {
+    LOG(WARNING) << "Ignoring malformed bookmark snapshot";
+  }
+  return value;
+}
+
+}  // namespace vivaldi_bookmark_snapshot
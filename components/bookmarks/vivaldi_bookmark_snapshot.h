@@ -0,0 +1,46 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#ifndef COMPONENTS_BOOKMARKS_VIVALDI_BOOKMARK_SNAPSHOT_H_
+#define COMPONENTS_BOOKMARKS_VIVALDI_BOOKMARK_SNAPSHOT_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/values.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+// A binary copy of the encoded bookmarks next to the Bookmarks JSON file.
+// Loading it avoids parsing the JSON text on startup while BookmarkCodec still
+// decodes the same value, so checksums, id and guid fixups and meta info work
+// the same. The JSON file remains the format of record: the snapshot is only
+// used when it was written for the current JSON file and is otherwise
+// ignored.
+//
+// The snapshot is a header followed by a table of the distinct strings of the
+// value and by the value tree, which refers to strings by index. Meta info
+// keys and values repeat a lot, so each is stored once.
+namespace vivaldi_bookmark_snapshot {
+
+// Returns the path of the snapshot belonging to |json_path|.
+base::FilePath GetSnapshotPath(const base::FilePath& json_path);
+
+// Serializes |value| into the snapshot payload. Returns an empty string if
+// the value contains types the snapshot does not support.
+std::string EncodePayload(const base::Value& value);
+
+// Writes the snapshot for |json_path| from |payload|, tying it to the current
+// size and modification time of the JSON file. Must be called after the
+// JSON file has been written, on a sequence that allows blocking.
+void WriteSnapshot(const base::FilePath& json_path, const std::string& payload);
+
+// Removes the snapshot of |json_path| so it cannot be used with a JSON file
+// it was not written for.
+void DeleteSnapshot(const base::FilePath& json_path);
+
+// Returns the value stored in the snapshot of |json_path| if the snapshot
+// matches the JSON file and passes the checksum, absl::nullopt otherwise.
+absl::optional<base::Value> LoadSnapshot(const base::FilePath& json_path);
+
+}  // namespace vivaldi_bookmark_snapshot
+
+#endif  // COMPONENTS_BOOKMARKS_VIVALDI_BOOKMARK_SNAPSHOT_H_
@@ -0,0 +1,133 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "components/bookmarks/vivaldi_nickname_index.h"
+
+#include <algorithm>
+
+#include "base/check.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "components/bookmarks/vivaldi_bookmark_kit.h"
+
+namespace vivaldi_bookmark_kit {
+
+NicknameIndex::NicknameIndex(bookmarks::BookmarkModel* model) : model_(model) {
+  model_->AddObserver(this);
+}
+
+NicknameIndex::~NicknameIndex() {
+  model_->RemoveObserver(this);
+}
+
+const bookmarks::BookmarkNode* NicknameIndex::FindNode(
+    const std::string& nickname,
+    const bookmarks::BookmarkNode* ignored_node) const {
+  auto i = nodes_by_nickname_.find(nickname);
+  if (i == nodes_by_nickname_.end())
+    return nullptr;
+  for (const bookmarks::BookmarkNode* node : i->second) {
+    if (node != ignored_node)
+      return node;
+  }
+  return nullptr;
+}
+
+void NicknameIndex::BookmarkModelLoaded(bookmarks::BookmarkModel* model,
+                                        bool ids_reassigned) {
+  AddSubtree(model->root_node());
+}
+
+void NicknameIndex::BookmarkNodeAdded(bookmarks::BookmarkModel* model,
+                                      const bookmarks::BookmarkNode* parent,
+                                      size_t index) {
+  // Undo and sync may add a folder together with its children.
+  AddSubtree(parent->children()[index].get());
+}
+
+void NicknameIndex::BookmarkNodeRemoved(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* parent,
+    size_t old_index,
+    const bookmarks::BookmarkNode* node,
+    const std::set<GURL>& no_longer_bookmarked) {
+  RemoveSubtree(node);
+}
+
+void NicknameIndex::OnWillChangeBookmarkNode(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  // SetNodeMetaInfoWithIndexChange() reports nickname changes as node
+  // changes.
+  RemoveNode(node);
+}
+
+void NicknameIndex::BookmarkNodeChanged(bookmarks::BookmarkModel* model,
+                                        const bookmarks::BookmarkNode* node) {
+  AddNode(node);
+}
+
+void NicknameIndex::OnWillChangeBookmarkMetaInfo(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  RemoveNode(node);
+}
+
+void NicknameIndex::BookmarkMetaInfoChanged(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  AddNode(node);
+}
+
+void NicknameIndex::BookmarkAllUserNodesRemoved(
+    bookmarks::BookmarkModel* model,
+    const std::set<GURL>& removed_urls) {
+  nodes_by_nickname_.clear();
+  nickname_by_node_.clear();
+  AddSubtree(model->root_node());
+}
+
+void NicknameIndex::AddNode(const bookmarks::BookmarkNode* node) {
+  const std::string& nickname = GetNickname(node);
+  if (nickname.empty())
+    return;
+  auto inserted = nickname_by_node_.emplace(node, nickname);
+  if (!inserted.second) {
+    // Already indexed as nothing was removed before the change.
+    if (inserted.first->second == nickname)
+      return;
+    RemoveNode(node);
+    nickname_by_node_.emplace(node, nickname);
+  }
+  nodes_by_nickname_[nickname].push_back(node);
+}
+
+void NicknameIndex::RemoveNode(const bookmarks::BookmarkNode* node) {
+  auto i = nickname_by_node_.find(node);
+  if (i == nickname_by_node_.end())
+    return;
+  auto nodes = nodes_by_nickname_.find(i->second);
+  DCHECK(nodes != nodes_by_nickname_.end());
+  if (nodes != nodes_by_nickname_.end()) {
+    auto& list = nodes->second;
+    list.erase(std::remove(list.begin(), list.end(), node), list.end());
+    if (list.empty())
+      nodes_by_nickname_.erase(nodes);
+  }
+  nickname_by_node_.erase(i);
+}
+
+void NicknameIndex::AddSubtree(const bookmarks::BookmarkNode* node) {
+  AddNode(node);
+  for (const auto& child : node->children()) {
+    AddSubtree(child.get());
+  }
+}
+
+void NicknameIndex::RemoveSubtree(const bookmarks::BookmarkNode* node) {
+  RemoveNode(node);
+  for (const auto& child : node->children()) {
+    RemoveSubtree(child.get());
+  }
+}
+
+}  // namespace vivaldi_bookmark_kit
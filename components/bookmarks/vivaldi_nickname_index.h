@@ -0,0 +1,92 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#ifndef COMPONENTS_BOOKMARKS_VIVALDI_NICKNAME_INDEX_H_
+#define COMPONENTS_BOOKMARKS_VIVALDI_NICKNAME_INDEX_H_
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/memory/raw_ptr.h"
+#include "components/bookmarks/browser/bookmark_model_observer.h"
+
+namespace bookmarks {
+class BookmarkModel;
+class BookmarkNode;
+}  // namespace bookmarks
+
+namespace vivaldi_bookmark_kit {
+
+// Maps bookmark nicknames to their nodes so a nickname can be checked or
+// resolved without walking the whole tree. The index is owned by the model
+// and kept up to date from the observer notifications.
+class NicknameIndex : public bookmarks::BookmarkModelObserver {
+ public:
+  explicit NicknameIndex(bookmarks::BookmarkModel* model);
+  ~NicknameIndex() override;
+  NicknameIndex(const NicknameIndex&) = delete;
+  NicknameIndex& operator=(const NicknameIndex&) = delete;
+
+  // Returns a node with the given non-empty |nickname| other than
+  // |ignored_node| or null if there is none.
+  const bookmarks::BookmarkNode* FindNode(
+      const std::string& nickname,
+      const bookmarks::BookmarkNode* ignored_node = nullptr) const;
+
+  // bookmarks::BookmarkModelObserver
+  void BookmarkModelLoaded(bookmarks::BookmarkModel* model,
+                           bool ids_reassigned) override;
+  void BookmarkNodeMoved(bookmarks::BookmarkModel* model,
+                         const bookmarks::BookmarkNode* old_parent,
+                         size_t old_index,
+                         const bookmarks::BookmarkNode* new_parent,
+                         size_t new_index) override {}
+  void BookmarkNodeAdded(bookmarks::BookmarkModel* model,
+                         const bookmarks::BookmarkNode* parent,
+                         size_t index) override;
+  void BookmarkNodeRemoved(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* parent,
+                           size_t old_index,
+                           const bookmarks::BookmarkNode* node,
+                           const std::set<GURL>& no_longer_bookmarked) override;
+  void OnWillChangeBookmarkNode(bookmarks::BookmarkModel* model,
+                                const bookmarks::BookmarkNode* node) override;
+  void BookmarkNodeChanged(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* node) override;
+  void OnWillChangeBookmarkMetaInfo(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override;
+  void BookmarkMetaInfoChanged(bookmarks::BookmarkModel* model,
+                               const bookmarks::BookmarkNode* node) override;
+  void BookmarkNodeFaviconChanged(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override {}
+  void BookmarkNodeChildrenReordered(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override {}
+  void BookmarkAllUserNodesRemoved(bookmarks::BookmarkModel* model,
+                                   const std::set<GURL>& removed_urls) override;
+
+ private:
+  void AddNode(const bookmarks::BookmarkNode* node);
+  void RemoveNode(const bookmarks::BookmarkNode* node);
+  void AddSubtree(const bookmarks::BookmarkNode* node);
+  void RemoveSubtree(const bookmarks::BookmarkNode* node);
+
+  const raw_ptr<bookmarks::BookmarkModel> model_;
+
+  // Nodes by nickname. Nicknames are meant to be unique, but the model does
+  // not enforce it, so one nickname can have several nodes.
+  std::unordered_map<std::string, std::vector<const bookmarks::BookmarkNode*>>
+      nodes_by_nickname_;
+
+  // The indexed nickname of each node so it can be removed after the meta
+  // info of the node has already changed.
+  std::unordered_map<const bookmarks::BookmarkNode*, std::string>
+      nickname_by_node_;
+};
+
+}  // namespace vivaldi_bookmark_kit
+
+#endif  // COMPONENTS_BOOKMARKS_VIVALDI_NICKNAME_INDEX_H_
@@ -0,0 +1,157 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "components/bookmarks/vivaldi_nickname_index.h"
+
+#include <memory>
+#include <string>
+
+#include "base/test/task_environment.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "components/bookmarks/test/test_bookmark_client.h"
+#include "components/undo/bookmark_undo_service.h"
+#include "components/undo/undo_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+#include "components/bookmarks/vivaldi_bookmark_kit.h"
+
+namespace vivaldi_bookmark_kit {
+
+namespace {
+
+using bookmarks::BookmarkModel;
+using bookmarks::BookmarkNode;
+
+class VivaldiNicknameIndexTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = bookmarks::TestBookmarkClient::CreateModel();
+  }
+
+  const BookmarkNode* AddURL(const BookmarkNode* parent,
+                             const std::string& nickname) {
+    CustomMetaInfo meta_info;
+    meta_info.SetNickname(nickname);
+    return model_->AddURL(parent, parent->children().size(), u"url",
+                          GURL("http://" + nickname + ".com/"),
+                          meta_info.map());
+  }
+
+  // Adds a folder with a bookmark and a subfolder with another bookmark to
+  // the bookmark bar, all with nicknames.
+  const BookmarkNode* AddFolderTree() {
+    CustomMetaInfo meta_info;
+    meta_info.SetNickname("folder");
+    const BookmarkNode* folder = model_->AddFolder(
+        model_->bookmark_bar_node(), 0, u"folder", meta_info.map());
+    AddURL(folder, "a");
+    meta_info.SetNickname("subfolder");
+    const BookmarkNode* subfolder =
+        model_->AddFolder(folder, 1, u"subfolder", meta_info.map());
+    AddURL(subfolder, "b");
+    return folder;
+  }
+
+  bool NickExists(const std::string& nickname) {
+    return DoesNickExists(model_.get(), nickname, nullptr);
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<BookmarkModel> model_;
+};
+
+}  // namespace
+
+TEST_F(VivaldiNicknameIndexTest, AddAndRemoveSubtree) {
+  EXPECT_FALSE(NickExists("folder"));
+  const BookmarkNode* folder = AddFolderTree();
+  EXPECT_TRUE(NickExists("folder"));
+  EXPECT_TRUE(NickExists("a"));
+  EXPECT_TRUE(NickExists("subfolder"));
+  EXPECT_TRUE(NickExists("b"));
+  EXPECT_FALSE(NickExists(""));
+
+  model_->Remove(folder);
+  EXPECT_FALSE(NickExists("folder"));
+  EXPECT_FALSE(NickExists("a"));
+  EXPECT_FALSE(NickExists("subfolder"));
+  EXPECT_FALSE(NickExists("b"));
+}
+
+TEST_F(VivaldiNicknameIndexTest, UndoRestoresSubtree) {
+  BookmarkUndoService undo_service;
+  undo_service.Start(model_.get());
+
+  model_->Remove(AddFolderTree());
+  ASSERT_FALSE(NickExists("b"));
+
+  // The undo adds the folder back with its children in one notification.
+  undo_service.undo_manager()->Undo();
+  EXPECT_TRUE(NickExists("folder"));
+  EXPECT_TRUE(NickExists("a"));
+  EXPECT_TRUE(NickExists("subfolder"));
+  EXPECT_TRUE(NickExists("b"));
+
+  undo_service.Shutdown();
+}
+
+TEST_F(VivaldiNicknameIndexTest, MetaInfoChange) {
+  const BookmarkNode* node = AddURL(model_->other_node(), "old");
+
+  CustomMetaInfo meta_info;
+  meta_info.SetNickname("new");
+  model_->SetNodeMetaInfoMap(node, *meta_info.map());
+  EXPECT_FALSE(NickExists("old"));
+  EXPECT_TRUE(NickExists("new"));
+
+  model_->SetNodeMetaInfoMap(node, BookmarkNode::MetaInfoMap());
+  EXPECT_FALSE(NickExists("new"));
+}
+
+TEST_F(VivaldiNicknameIndexTest, SetNodeNickname) {
+  // This reports the change as a node change rather than a meta info change.
+  const BookmarkNode* node = AddURL(model_->other_node(), "old");
+  SetNodeNickname(model_.get(), node, "new");
+  EXPECT_FALSE(NickExists("old"));
+  EXPECT_TRUE(NickExists("new"));
+
+  SetNodeNickname(model_.get(), node, "");
+  EXPECT_FALSE(NickExists("new"));
+
+  SetNodeNickname(model_.get(), node, "again");
+  EXPECT_TRUE(NickExists("again"));
+}
+
+TEST_F(VivaldiNicknameIndexTest, RemoveAllUserBookmarks) {
+  AddFolderTree();
+  AddURL(model_->other_node(), "c");
+
+  model_->RemoveAllUserBookmarks();
+  EXPECT_FALSE(NickExists("folder"));
+  EXPECT_FALSE(NickExists("b"));
+  EXPECT_FALSE(NickExists("c"));
+
+  AddURL(model_->other_node(), "c");
+  EXPECT_TRUE(NickExists("c"));
+}
+
+TEST_F(VivaldiNicknameIndexTest, IgnoresUpdatedNode) {
+  const BookmarkNode* first = AddURL(model_->other_node(), "a");
+
+  // A node keeping its own nickname does not conflict with itself.
+  EXPECT_FALSE(DoesNickExists(model_.get(), "a", first));
+  EXPECT_TRUE(DoesNickExists(model_.get(), "a", model_->other_node()));
+
+  // The model does not enforce unique nicknames, so another node may have
+  // the same one.
+  const BookmarkNode* second = AddURL(model_->other_node(), "a");
+  EXPECT_TRUE(DoesNickExists(model_.get(), "a", first));
+  EXPECT_TRUE(DoesNickExists(model_.get(), "a", second));
+
+  model_->Remove(second);
+  EXPECT_FALSE(DoesNickExists(model_.get(), "a", first));
+  EXPECT_TRUE(NickExists("a"));
+}
+
+}  // namespace vivaldi_bookmark_kit
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "components/bookmarks/vivaldi_node_id_index.h"
+
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "ui/base/models/tree_node_iterator.h"
+
+namespace vivaldi_bookmark_kit {
+
+NodeIdIndex::NodeIdIndex(bookmarks::BookmarkModel* model) : model_(model) {
+  model_->AddObserver(this);
+}
+
+NodeIdIndex::~NodeIdIndex() {
+  model_->RemoveObserver(this);
+}
+
+const bookmarks::BookmarkNode* NodeIdIndex::FindNode(int64_t id) const {
+  if (!loaded_) {
+    if (model_->root_node()->id() == id)
+      return model_->root_node();
+    ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(
+        model_->root_node());
+    while (iterator.has_next()) {
+      const bookmarks::BookmarkNode* node = iterator.Next();
+      if (node->id() == id)
+        return node;
+    }
+    return nullptr;
+  }
+  auto i = nodes_by_id_.find(id);
+  if (i == nodes_by_id_.end())
+    return nullptr;
+  return i->second;
+}
+
+void NodeIdIndex::BookmarkModelLoaded(bookmarks::BookmarkModel* model,
+                                      bool ids_reassigned) {
+  loaded_ = true;
+  AddSubtree(model->root_node());
+}
+
+void NodeIdIndex::BookmarkNodeAdded(bookmarks::BookmarkModel* model,
+                                    const bookmarks::BookmarkNode* parent,
+                                    size_t index) {
+  // Undo and sync may add a folder together with its children.
+  AddSubtree(parent->children()[index].get());
+}
+
+void NodeIdIndex::BookmarkNodeRemoved(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* parent,
+    size_t old_index,
+    const bookmarks::BookmarkNode* node,
+    const std::set<GURL>& no_longer_bookmarked) {
+  RemoveSubtree(node);
+}
+
+void NodeIdIndex::BookmarkAllUserNodesRemoved(
+    bookmarks::BookmarkModel* model,
+    const std::set<GURL>& removed_urls) {
+  nodes_by_id_.clear();
+  AddSubtree(model->root_node());
+}
+
+void NodeIdIndex::AddSubtree(const bookmarks::BookmarkNode* node) {
+  if (!loaded_)
+    return;
+  nodes_by_id_[node->id()] = node;
+  for (const auto& child : node->children()) {
+    AddSubtree(child.get());
+  }
+}
+
+void NodeIdIndex::RemoveSubtree(const bookmarks::BookmarkNode* node) {
+  auto i = nodes_by_id_.find(node->id());
+  if (i != nodes_by_id_.end() && i->second == node)
+    nodes_by_id_.erase(i);
+  for (const auto& child : node->children()) {
+    RemoveSubtree(child.get());
+  }
+}
+
+}  // namespace vivaldi_bookmark_kit
@@ -0,0 +1,78 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#ifndef COMPONENTS_BOOKMARKS_VIVALDI_NODE_ID_INDEX_H_
+#define COMPONENTS_BOOKMARKS_VIVALDI_NODE_ID_INDEX_H_
+
+#include <stdint.h>
+
+#include <set>
+#include <unordered_map>
+
+#include "base/memory/raw_ptr.h"
+#include "components/bookmarks/browser/bookmark_model_observer.h"
+
+namespace bookmarks {
+class BookmarkModel;
+class BookmarkNode;
+}  // namespace bookmarks
+
+namespace vivaldi_bookmark_kit {
+
+// Maps bookmark ids to the nodes in the tree so GetBookmarkNodeByID() does
+// not walk the whole tree. The index is owned by the model and created with
+// it, so it is the first observer and sees each change before any other
+// observer can look nodes up.
+class NodeIdIndex : public bookmarks::BookmarkModelObserver {
+ public:
+  explicit NodeIdIndex(bookmarks::BookmarkModel* model);
+  ~NodeIdIndex() override;
+  NodeIdIndex(const NodeIdIndex&) = delete;
+  NodeIdIndex& operator=(const NodeIdIndex&) = delete;
+
+  // Returns the node with the given |id| in the tree of the model or null if
+  // there is none.
+  const bookmarks::BookmarkNode* FindNode(int64_t id) const;
+
+  // bookmarks::BookmarkModelObserver
+  void BookmarkModelLoaded(bookmarks::BookmarkModel* model,
+                           bool ids_reassigned) override;
+  void BookmarkNodeMoved(bookmarks::BookmarkModel* model,
+                         const bookmarks::BookmarkNode* old_parent,
+                         size_t old_index,
+                         const bookmarks::BookmarkNode* new_parent,
+                         size_t new_index) override {}
+  void BookmarkNodeAdded(bookmarks::BookmarkModel* model,
+                         const bookmarks::BookmarkNode* parent,
+                         size_t index) override;
+  void BookmarkNodeRemoved(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* parent,
+                           size_t old_index,
+                           const bookmarks::BookmarkNode* node,
+                           const std::set<GURL>& no_longer_bookmarked) override;
+  void BookmarkNodeChanged(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* node) override {}
+  void BookmarkNodeFaviconChanged(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override {}
+  void BookmarkNodeChildrenReordered(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override {}
+  void BookmarkAllUserNodesRemoved(bookmarks::BookmarkModel* model,
+                                   const std::set<GURL>& removed_urls) override;
+
+ private:
+  void AddSubtree(const bookmarks::BookmarkNode* node);
+  void RemoveSubtree(const bookmarks::BookmarkNode* node);
+
+  const raw_ptr<bookmarks::BookmarkModel> model_;
+
+  // The index is only built when the model has loaded. Before that lookups
+  // walk the tree like they did before the index.
+  bool loaded_ = false;
+
+  std::unordered_map<int64_t, const bookmarks::BookmarkNode*> nodes_by_id_;
+};
+
+}  // namespace vivaldi_bookmark_kit
+
+#endif  // COMPONENTS_BOOKMARKS_VIVALDI_NODE_ID_INDEX_H_
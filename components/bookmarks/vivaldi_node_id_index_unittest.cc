@@ -0,0 +1,132 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "components/bookmarks/vivaldi_node_id_index.h"
+
+#include <memory>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "components/bookmarks/test/bookmark_test_helpers.h"
+#include "components/bookmarks/test/test_bookmark_client.h"
+#include "components/undo/bookmark_undo_service.h"
+#include "components/undo/undo_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+#include "components/bookmarks/vivaldi_bookmark_kit.h"
+
+namespace vivaldi_bookmark_kit {
+
+namespace {
+
+using bookmarks::BookmarkModel;
+using bookmarks::BookmarkNode;
+
+class VivaldiNodeIdIndexTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = bookmarks::TestBookmarkClient::CreateModel();
+  }
+
+  // Adds a folder with a bookmark and a subfolder with another bookmark to
+  // the bookmark bar.
+  const BookmarkNode* AddFolderTree() {
+    const BookmarkNode* folder =
+        model_->AddFolder(model_->bookmark_bar_node(), 0, u"folder");
+    model_->AddURL(folder, 0, u"a", GURL("http://a.com/"));
+    const BookmarkNode* subfolder = model_->AddFolder(folder, 1, u"subfolder");
+    model_->AddURL(subfolder, 0, u"b", GURL("http://b.com/"));
+    return folder;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<BookmarkModel> model_;
+};
+
+}  // namespace
+
+TEST_F(VivaldiNodeIdIndexTest, FindBeforeLoad) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  auto model = std::make_unique<BookmarkModel>(
+      std::make_unique<bookmarks::TestBookmarkClient>());
+  model->Load(nullptr, temp_dir.GetPath());
+  ASSERT_FALSE(model->loaded());
+
+  // Until the model is loaded lookups walk the tree, which only has the root.
+  EXPECT_EQ(FindNodeByID(model.get(), model->root_node()->id()),
+            model->root_node());
+  EXPECT_EQ(FindNodeByID(model.get(), 1), nullptr);
+
+  bookmarks::test::WaitForBookmarkModelToLoad(model.get());
+  EXPECT_EQ(FindNodeByID(model.get(), model->root_node()->id()),
+            model->root_node());
+  EXPECT_EQ(FindNodeByID(model.get(), model->bookmark_bar_node()->id()),
+            model->bookmark_bar_node());
+}
+
+TEST_F(VivaldiNodeIdIndexTest, RemoveFolderWithChildren) {
+  const BookmarkNode* folder = AddFolderTree();
+  int64_t folder_id = folder->id();
+  int64_t url_id = folder->children()[0]->id();
+  const BookmarkNode* subfolder = folder->children()[1].get();
+  int64_t subfolder_id = subfolder->id();
+  int64_t suburl_id = subfolder->children()[0]->id();
+  EXPECT_EQ(FindNodeByID(model_.get(), suburl_id),
+            subfolder->children()[0].get());
+
+  model_->Remove(folder);
+  EXPECT_EQ(FindNodeByID(model_.get(), folder_id), nullptr);
+  EXPECT_EQ(FindNodeByID(model_.get(), url_id), nullptr);
+  EXPECT_EQ(FindNodeByID(model_.get(), subfolder_id), nullptr);
+  EXPECT_EQ(FindNodeByID(model_.get(), suburl_id), nullptr);
+}
+
+TEST_F(VivaldiNodeIdIndexTest, UndoRestoresSubtree) {
+  BookmarkUndoService undo_service;
+  undo_service.Start(model_.get());
+
+  const BookmarkNode* folder = AddFolderTree();
+  int64_t folder_id = folder->id();
+  int64_t subfolder_id = folder->children()[1]->id();
+  int64_t suburl_id = folder->children()[1]->children()[0]->id();
+  model_->Remove(folder);
+  ASSERT_EQ(FindNodeByID(model_.get(), suburl_id), nullptr);
+
+  // The undo adds the folder back with its children in one notification.
+  undo_service.undo_manager()->Undo();
+  const BookmarkNode* restored =
+      model_->bookmark_bar_node()->children()[0].get();
+  ASSERT_EQ(restored->id(), folder_id);
+  EXPECT_EQ(FindNodeByID(model_.get(), folder_id), restored);
+  EXPECT_EQ(FindNodeByID(model_.get(), subfolder_id),
+            restored->children()[1].get());
+  EXPECT_EQ(FindNodeByID(model_.get(), suburl_id),
+            restored->children()[1]->children()[0].get());
+
+  undo_service.Shutdown();
+}
+
+TEST_F(VivaldiNodeIdIndexTest, RemoveAllUserBookmarks) {
+  const BookmarkNode* folder = AddFolderTree();
+  int64_t folder_id = folder->id();
+  int64_t suburl_id = folder->children()[1]->children()[0]->id();
+
+  model_->RemoveAllUserBookmarks();
+  EXPECT_EQ(FindNodeByID(model_.get(), folder_id), nullptr);
+  EXPECT_EQ(FindNodeByID(model_.get(), suburl_id), nullptr);
+
+  // The permanent nodes stay in the index.
+  EXPECT_EQ(FindNodeByID(model_.get(), model_->root_node()->id()),
+            model_->root_node());
+  EXPECT_EQ(FindNodeByID(model_.get(), model_->other_node()->id()),
+            model_->other_node());
+
+  const BookmarkNode* added =
+      model_->AddURL(model_->other_node(), 0, u"c", GURL("http://c.com/"));
+  EXPECT_EQ(FindNodeByID(model_.get(), added->id()), added);
+}
+
+}  // namespace vivaldi_bookmark_kit
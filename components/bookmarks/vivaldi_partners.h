@@ -3,40 +3,29 @@
 #ifndef COMPONENTS_BOOKMARKS_VIVALDI_PARTNERS_H_
 #define COMPONENTS_BOOKMARKS_VIVALDI_PARTNERS_H_
 
-#include "base/containers/flat_map.h"
-#include "base/files/file_path.h"
 #include "base/guid.h"
-#include "base/memory/scoped_refptr.h"
-#include "base/values.h"
-
-namespace base {
-class SequencedTaskRunner;
-}  // namespace base
+#include "base/strings/string_piece.h"
 
 namespace vivaldi_partners {
 
 extern const char kBookmarkResourceDir[];
 
+// The partner database is compiled from partners.json and
+// partners-locale-map.json at build time by generate_partner_db.py, so the
+// details below refer to static data and need no loading.
 struct PartnerDetails {
-  PartnerDetails();
-  ~PartnerDetails();
-  PartnerDetails(PartnerDetails&&);
-  PartnerDetails& operator=(PartnerDetails&&);
-
-  PartnerDetails(const PartnerDetails&) = delete;
-  PartnerDetails& operator=(const PartnerDetails&) = delete;
-
   // guid2 is a GUID for a bookmark defined in the Bookmark folder as opposite
   // to SpeedDial. For some partners we define them twice both in SpeedDial and
   // Bookmarks so if the user deletes the speeddial the version in Bookmarks
-  // will be used instead.
-  std::string name;
-  std::string title;
-  base::GUID guid;
-  base::GUID guid2;
-  std::string thumbnail;
-  std::string favicon;
-  std::string favicon_url;
+  // will be used instead. Both GUIDs are stored in the lowercase form, guid2 is
+  // empty for folders.
+  base::StringPiece name;
+  base::StringPiece title;
+  base::StringPiece guid;
+  base::StringPiece guid2;
+  base::StringPiece thumbnail;
+  base::StringPiece favicon;
+  base::StringPiece favicon_url;
   bool folder = false;
   bool speeddial = false;
 };
@@ -50,12 +39,7 @@ bool MapLocaleIdToGUID(base::GUID& id);
 
 // Return an empty string if partner_id is not known or does not have a
 // thumbnail.
-const std::string& GetThumbnailUrl(const base::GUID& partner_id);
-
-// Load the partner database from a worker thread and store the result on the
-// main thread using passed reference.
-void LoadOnWorkerThread(
-    const scoped_refptr<base::SequencedTaskRunner>& main_thread_task_runner);
+base::StringPiece GetThumbnailUrl(const base::GUID& partner_id);
 
 }  // namespace vivaldi_partners
 
@@ -2,6 +2,9 @@
 
 #include "components/datasource/css_mods_data_source.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/path_service.h"
@@ -14,6 +14,9 @@
 #include "content/public/browser/browser_thread.h"
 #include "skia/ext/skia_utils_win.h"
 
+#include "components/datasource/vivaldi_data_url_utils.h"
+#include "components/datasource/vivaldi_image_store.h"
+
 namespace {
 // 1 pixel transparent PNG
 const char kDefaultFallbackImageBase64[] =
@@ -35,64 +38,151 @@ void DesktopWallpaperDataClassHandlerWin::GetData(
     content::URLDataSource::GotDataCallback callback) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
-  do {
-    Microsoft::WRL::ComPtr<IDesktopWallpaper> desktop_w;
-    HRESULT hr = CoCreateInstance(__uuidof(DesktopWallpaper), nullptr,
-                                  CLSCTX_ALL, IID_PPV_ARGS(&desktop_w));
-    if (FAILED(hr)) {
-      break;
-    }
-    UINT count;
-    hr = desktop_w->GetMonitorDevicePathCount(&count);
-    if (FAILED(hr)) {
-      break;
-    }
-    base::win::ScopedCoMem<wchar_t> file_path;
-    base::win::ScopedCoMem<wchar_t> monitor_id;
-
-    for (UINT n = 0; n < count; n++) {
-      hr = desktop_w->GetMonitorDevicePathAt(
-          n, reinterpret_cast<LPWSTR*>(&monitor_id));
-      if (SUCCEEDED(hr)) {
-        // Try first without monitor id, this will work if the user
-        // has the same image on all monitors.
-        hr = desktop_w->GetWallpaper(nullptr,
+  std::wstring file_path = GetWallpaperPath();
+  if (file_path.empty()) {
+    std::move(callback).Run(nullptr);
+    return;
+  }
+  if (file_path == previous_path_) {
+    // Path has not changed, serve cached data
+    std::move(callback).Run(cached_image_data_);
+    return;
+  }
+  // Unretained is used because Chromium's URLDataSource and so this
+  // class is destroyed on UI thread strictly after all outstanding
+  // GotDataCallback callbacks runs on UI thread.
+  base::ThreadPool::PostTask(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN,
+       base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&DesktopWallpaperDataClassHandlerWin::GetDataOnFileThread,
+                     base::Unretained(this), std::move(file_path),
+                     std::move(callback)));
+}
+
+void DesktopWallpaperDataClassHandlerWin::GetDataWithQuery(
+    Profile* profile,
+    const std::string& data_id,
+    base::StringPiece query,
+    content::URLDataSource::GotDataCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  // Wallpapers are often much bigger than the window showing them, so decode
+  // and downscale them once per wallpaper instead of on each window open.
+  int width = VivaldiImageStore::GetDisplaySizedWidth(
+      vivaldi_data_url_utils::ParseImageWidthQuery(query));
+  if (!width) {
+    GetData(profile, data_id, std::move(callback));
+    return;
+  }
+  std::wstring file_path = GetWallpaperPath();
+  if (!file_path.empty() && file_path == previous_path_ &&
+      width == cached_scaled_width_ && cached_scaled_data_) {
+    std::move(callback).Run(cached_scaled_data_);
+    return;
+  }
+  // Unretained is used because Chromium's URLDataSource and so this
+  // class is destroyed on UI thread strictly after all outstanding
+  // GotDataCallback callbacks runs on UI thread.
+  GetData(
+      profile, data_id,
+      base::BindOnce(
+          [](int width, content::URLDataSource::GotDataCallback callback,
+             scoped_refptr<base::RefCountedMemory> image_data) {
+            VivaldiImageStore::ScaleImageToWidth(std::move(image_data), width,
+                                                 std::move(callback));
+          },
+          width,
+          base::BindOnce(
+              &DesktopWallpaperDataClassHandlerWin::SendScaledDataOnUiThread,
+              base::Unretained(this), std::move(file_path), width,
+              std::move(callback))));
+}
+
+void DesktopWallpaperDataClassHandlerWin::SendScaledDataOnUiThread(
+    std::wstring path,
+    int width,
+    content::URLDataSource::GotDataCallback callback,
+    scoped_refptr<base::RefCountedMemory> image_data) {
+  // Keep the variant only if the wallpaper did not change while scaling.
+  if (image_data && path == previous_path_) {
+    cached_scaled_data_ = image_data;
+    cached_scaled_width_ = width;
+  }
+  std::move(callback).Run(std::move(image_data));
+}
+
+void DesktopWallpaperDataClassHandlerWin::GetFilePath(
+    Profile* profile,
+    const std::string& data_id,
+    content::URLDataSource::GotFilePathCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  std::wstring file_path = GetWallpaperPath();
+  if (file_path.empty()) {
+    std::move(callback).Run(base::FilePath());
+    return;
+  }
+  // Wallpapers can be multi-monitor images of hundreds of megabytes, so stream
+  // them. Unreadable or empty files go through GetData() to get the fallback
+  // image.
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN,
+       base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(
+          [](base::FilePath path) {
+            int64_t size = 0;
+            if (!base::GetFileSize(path, &size) || size <= 0)
+              return base::FilePath();
+            return path;
+          },
+          base::FilePath(file_path)),
+      std::move(callback));
+}
+
+// static
+std::wstring DesktopWallpaperDataClassHandlerWin::GetWallpaperPath() {
+  Microsoft::WRL::ComPtr<IDesktopWallpaper> desktop_w;
+  HRESULT hr = CoCreateInstance(__uuidof(DesktopWallpaper), nullptr,
+                                CLSCTX_ALL, IID_PPV_ARGS(&desktop_w));
+  if (FAILED(hr))
+    return std::wstring();
+  UINT count;
+  hr = desktop_w->GetMonitorDevicePathCount(&count);
+  if (FAILED(hr))
+    return std::wstring();
+  base::win::ScopedCoMem<wchar_t> file_path;
+  base::win::ScopedCoMem<wchar_t> monitor_id;
+
+  for (UINT n = 0; n < count; n++) {
+    hr = desktop_w->GetMonitorDevicePathAt(
+        n, reinterpret_cast<LPWSTR*>(&monitor_id));
+    if (SUCCEEDED(hr)) {
+      // Try first without monitor id, this will work if the user
+      // has the same image on all monitors.
+      hr = desktop_w->GetWallpaper(nullptr,
+                                   reinterpret_cast<LPWSTR*>(&file_path));
+      if (hr == S_FALSE) {
+        file_path.Reset(nullptr);
+        hr = desktop_w->GetWallpaper(monitor_id,
                                      reinterpret_cast<LPWSTR*>(&file_path));
-        if (hr == S_FALSE) {
-          file_path.Reset(nullptr);
-          hr = desktop_w->GetWallpaper(monitor_id,
-                                       reinterpret_cast<LPWSTR*>(&file_path));
-        }
-        if (SUCCEEDED(hr)) {
-          if (file_path.get() == previous_path_) {
-            // Path has not changed, serve cached data
-            std::move(callback).Run(cached_image_data_);
-            return;
-          }
-          // Unretained is used because Chromium's URLDataSource and so this
-          // class is destroyed on UI thread strictly after all outstanding
-          // GotDataCallback callbacks runs on UI thread.
-          base::ThreadPool::PostTask(
-              FROM_HERE,
-              {base::MayBlock(), base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN,
-               base::TaskPriority::USER_VISIBLE},
-              base::BindOnce(
-                  &DesktopWallpaperDataClassHandlerWin::GetDataOnFileThread,
-                  base::Unretained(this), std::move(file_path.get()),
-                  std::move(callback)));
-          return;
-        }
       }
+      if (SUCCEEDED(hr) && file_path.get())
+        return std::wstring(file_path.get());
     }
-  } while (false);
-
-  std::move(callback).Run(nullptr);
+  }
+  return std::wstring();
 }
 
 void DesktopWallpaperDataClassHandlerWin::SendDataResultsOnUiThread(
     scoped_refptr<base::RefCountedMemory> image_data,
     std::wstring path,
     content::URLDataSource::GotDataCallback callback) {
+  if (path != previous_path_) {
+    cached_scaled_data_.reset();
+    cached_scaled_width_ = 0;
+  }
   cached_image_data_ = image_data;
   previous_path_ = path;
 
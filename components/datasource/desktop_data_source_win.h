@@ -15,11 +15,29 @@ class DesktopWallpaperDataClassHandlerWin : public VivaldiDataClassHandler {
   void GetData(Profile* profile,
                const std::string& data_id,
                content::URLDataSource::GotDataCallback callback) override;
+  void GetDataWithQuery(
+      Profile* profile,
+      const std::string& data_id,
+      base::StringPiece query,
+      content::URLDataSource::GotDataCallback callback) override;
+  void GetFilePath(
+      Profile* profile,
+      const std::string& data_id,
+      content::URLDataSource::GotFilePathCallback callback) override;
 
  private:
+  // Returns the path of the current wallpaper or an empty string on errors.
+  static std::wstring GetWallpaperPath();
+
   void GetDataOnFileThread(std::wstring file_path,
                            content::URLDataSource::GotDataCallback callback);
 
+  void SendScaledDataOnUiThread(
+      std::wstring path,
+      int width,
+      content::URLDataSource::GotDataCallback callback,
+      scoped_refptr<base::RefCountedMemory> image_data);
+
   void SendDataResultsOnUiThread(
       scoped_refptr<base::RefCountedMemory> image_data,
       std::wstring path,
@@ -30,6 +48,10 @@ class DesktopWallpaperDataClassHandlerWin : public VivaldiDataClassHandler {
 
   // Cache image data
   scoped_refptr<base::RefCountedMemory> cached_image_data_;
+
+  // Display-sized variant of the previously served wallpaper and its width.
+  scoped_refptr<base::RefCountedMemory> cached_scaled_data_;
+  int cached_scaled_width_ = 0;
 };
 
 #endif  // COMPONENTS_DATASOURCE_DESKTOP_DATA_SOURCE_WIN_H_
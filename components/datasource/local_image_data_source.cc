@@ -24,3 +24,30 @@ void LocalImageDataClassHandler::GetData(
   VivaldiImageStore::GetDataForId(profile, url_kind_, data_id,
                                   std::move(callback));
 }
+
+void LocalImageDataClassHandler::GetDataWithQuery(
+    Profile* profile,
+    const std::string& data_id,
+    base::StringPiece query,
+    content::URLDataSource::GotDataCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  VivaldiImageStore::GetDataForId(
+      profile, url_kind_, data_id, std::move(callback),
+      vivaldi_data_url_utils::ParseImageWidthQuery(query));
+}
+
+void LocalImageDataClassHandler::GetFilePath(
+    Profile* profile,
+    const std::string& data_id,
+    content::URLDataSource::GotFilePathCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Path mappings point to user-selected files like big background images, so
+  // stream those. Stored images are small and are served from the memory
+  // cache.
+  if (url_kind_ != VivaldiImageStore::kPathMappingUrl) {
+    std::move(callback).Run(base::FilePath());
+    return;
+  }
+  VivaldiImageStore::GetFilePathForMapping(profile, data_id,
+                                           std::move(callback));
+}
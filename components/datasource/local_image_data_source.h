@@ -16,6 +16,15 @@ class LocalImageDataClassHandler : public VivaldiDataClassHandler {
   void GetData(Profile* profile,
                const std::string& data_id,
                content::URLDataSource::GotDataCallback callback) override;
+  void GetDataWithQuery(
+      Profile* profile,
+      const std::string& data_id,
+      base::StringPiece query,
+      content::URLDataSource::GotDataCallback callback) override;
+  void GetFilePath(
+      Profile* profile,
+      const std::string& data_id,
+      content::URLDataSource::GotFilePathCallback callback) override;
 
  private:
   const VivaldiImageStore::UrlKind url_kind_;
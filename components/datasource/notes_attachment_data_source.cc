@@ -3,13 +3,62 @@
 #include "components/datasource/notes_attachment_data_source.h"
 
 #include "base/base64.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
 #include "chrome/browser/profiles/profile.h"
 #include "content/public/browser/browser_thread.h"
 #include "notes/note_attachment.h"
 #include "notes/note_node.h"
 #include "notes/notes_factory.h"
 #include "notes/notes_model.h"
-#include "third_party/re2/src/re2/re2.h"
+
+namespace {
+
+// Parse data_id in the form noteId/attachmentChecksum%7Cattachmentsize. This
+// is called for every attachment shown, so it avoids regular expressions.
+bool ParseAttachmentDataId(base::StringPiece data_id,
+                           int64_t* note_id,
+                           base::StringPiece* checksum,
+                           base::StringPiece* size) {
+  constexpr base::StringPiece kSeparator = "%7C";
+  size_t slash = data_id.find('/');
+  size_t separator = data_id.rfind(kSeparator);
+  if (slash == base::StringPiece::npos ||
+      separator == base::StringPiece::npos || separator < slash)
+    return false;
+  base::StringPiece id_part = data_id.substr(0, slash);
+  base::StringPiece size_part =
+      data_id.substr(separator + kSeparator.length());
+  auto is_number = [](base::StringPiece s) {
+    return !s.empty() && base::ranges::all_of(s, base::IsAsciiDigit<char>);
+  };
+  if (!is_number(id_part) || !is_number(size_part))
+    return false;
+  if (!base::StringToInt64(id_part, note_id))
+    return false;
+  *checksum = data_id.substr(slash + 1, separator - slash - 1);
+  *size = size_part;
+  return true;
+}
+
+// Decode the base64 payload of the data url of an attachment.
+scoped_refptr<base::RefCountedMemory> DecodeAttachmentContent(
+    std::string content,
+    std::string data_id) {
+  size_t comma = content.find(',');
+  if (comma == std::string::npos) {
+    LOG(ERROR) << "Invalid note content format, dataid=" << data_id;
+    return nullptr;
+  }
+  std::string img_src;
+  base::Base64Decode(base::StringPiece(content).substr(comma + 1), &img_src);
+  return base::RefCountedString::TakeString(&img_src);
+}
+
+}  // namespace
 
 void NotesAttachmentDataClassHandler::GetData(
     Profile* profile,
@@ -18,40 +67,36 @@ void NotesAttachmentDataClassHandler::GetData(
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
   // data_id should be noteId/attachmentChecksum|attachmentsize
-  const char pattern[] = R"(^(\d+)\/(.*?)%7C(\d+)$)";
-  std::string note_id, checksum, size;
+  int64_t note_id;
+  base::StringPiece checksum;
+  base::StringPiece size;
   const vivaldi::NoteNode* note = nullptr;
-  if (RE2::FullMatch(data_id, pattern, &note_id, &checksum, &size)) {
-    int64_t int_id;
-    if (base::StringToInt64(note_id, &int_id)) {
-      const vivaldi::NotesModel* notes_model =
-          vivaldi::NotesModelFactory::GetForBrowserContext(profile);
-      note = vivaldi::GetNotesNodeByID(notes_model, int_id);
-    }
+  if (ParseAttachmentDataId(data_id, &note_id, &checksum, &size)) {
+    const vivaldi::NotesModel* notes_model =
+        vivaldi::NotesModelFactory::GetForBrowserContext(profile);
+    note = vivaldi::GetNotesNodeByID(notes_model, note_id);
   }
 
-  scoped_refptr<base::RefCountedMemory> data;
   if (!note) {
     LOG(ERROR) << "Unknown note, dataid=" << data_id;
-  } else {
-    std::string attachment_id = std::move(checksum);
-    attachment_id += '|';
-    attachment_id += size;
-    const vivaldi::NoteAttachments& att = note->GetAttachments();
-    auto it = att.find(attachment_id);
-    if (it == att.end()) {
-      LOG(ERROR) << "Unknown note attachment, dataid=" << data_id;
-    } else {
-      base::StringPiece content(it->second.content());
-      size_t comma = content.find(',');
-      if (comma == base::StringPiece::npos) {
-        LOG(ERROR) << "Invalid note content format, dataid=" << data_id;
-      } else {
-        std::string img_src;
-        base::Base64Decode(content.substr(comma + 1), &img_src);
-        data = base::RefCountedString::TakeString(&img_src);
-      }
-    }
+    std::move(callback).Run(nullptr);
+    return;
   }
-  std::move(callback).Run(std::move(data));
+  std::string attachment_id(checksum);
+  attachment_id += '|';
+  attachment_id.append(size.data(), size.size());
+  const vivaldi::NoteAttachments& att = note->GetAttachments();
+  auto it = att.find(attachment_id);
+  if (it == att.end()) {
+    LOG(ERROR) << "Unknown note attachment, dataid=" << data_id;
+    std::move(callback).Run(nullptr);
+    return;
+  }
+
+  // Copying the content is much cheaper than decoding it, so only the copy
+  // happens on UI thread.
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&DecodeAttachmentContent, it->second.content(), data_id),
+      std::move(callback));
 }
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+"""Pack the files of a resource directory into a single resource pack.
+
+See components/datasource/resource_pack.h for the format. ResourceReader
+serves resources from the pack when it is present in the resource directory,
+so the loose files are only read when the pack is missing or in development
+builds that load the UI from the source directory.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b"VIVPACK1"
+HEADER_FORMAT = "<8sII"
+ENTRY_FORMAT = "<QIIII"
+
+# Align the data of each entry so the browser can use it in place.
+DATA_ALIGNMENT = 8
+
+
+def HashPath(path):
+  """64-bit FNV-1a, must match ResourcePack::HashPath()."""
+  value = 0xcbf29ce484222325
+  for byte in path:
+    value ^= byte
+    value = (value * 0x100000001b3) & 0xffffffffffffffff
+  return value
+
+
+def CollectFiles(input_dir, excludes):
+  files = []
+  for root, dirs, names in os.walk(input_dir):
+    dirs.sort()
+    for name in sorted(names):
+      full_path = os.path.join(root, name)
+      path = os.path.relpath(full_path, input_dir).replace(os.sep, "/")
+      if any(path == e or path.startswith(e + "/") for e in excludes):
+        continue
+      files.append((path.encode("utf-8"), full_path))
+  return files
+
+
+def Pack(files):
+  entries = []
+  for path, full_path in files:
+    with open(full_path, "rb") as f:
+      entries.append((HashPath(path), path, f.read()))
+  entries.sort(key=lambda e: (e[0], e[1]))
+
+  offset = (struct.calcsize(HEADER_FORMAT) +
+            len(entries) * struct.calcsize(ENTRY_FORMAT))
+  path_offsets = []
+  for _, path, _ in entries:
+    path_offsets.append(offset)
+    offset += len(path)
+  data_offsets = []
+  for _, _, data in entries:
+    offset += -offset % DATA_ALIGNMENT
+    data_offsets.append(offset)
+    offset += len(data)
+  if offset > 0xffffffff:
+    raise ValueError("resource pack exceeds 4GB")
+
+  out = [struct.pack(HEADER_FORMAT, MAGIC, len(entries), 0)]
+  for i, (path_hash, path, data) in enumerate(entries):
+    out.append(
+        struct.pack(ENTRY_FORMAT, path_hash, path_offsets[i], len(path),
+                    data_offsets[i], len(data)))
+  for _, path, _ in entries:
+    out.append(path)
+  size = sum(len(chunk) for chunk in out)
+  for i, (_, _, data) in enumerate(entries):
+    out.append(b"\0" * (data_offsets[i] - size))
+    out.append(data)
+    size = data_offsets[i] + len(data)
+  return b"".join(out)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument("--input-dir", required=True,
+                      help="the resource directory to pack")
+  parser.add_argument("--output", required=True,
+                      help="path to the resource pack to write")
+  parser.add_argument("--exclude", action="append", default=[],
+                      help="relative path of a file or directory to skip")
+  args = parser.parse_args()
+
+  files = CollectFiles(args.input_dir, args.exclude)
+  try:
+    output = Pack(files)
+  except ValueError as e:
+    sys.stderr.write("Resource pack error: %s\n" % e)
+    return 1
+  with open(args.output, "wb") as f:
+    f.write(output)
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,139 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "components/datasource/resource_pack.h"
+
+#include <string.h>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "build/build_config.h"
+
+#if !defined(ARCH_CPU_LITTLE_ENDIAN)
+#error "The resource pack is read assuming a little-endian CPU"
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'V', 'I', 'V', 'P', 'A', 'C', 'K', '1'};
+constexpr size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint32_t);
+constexpr size_t kEntrySize = sizeof(uint64_t) + 4 * sizeof(uint32_t);
+
+// Offsets of entry fields.
+constexpr size_t kPathHashOffset = 0;
+constexpr size_t kPathOffsetOffset = 8;
+constexpr size_t kPathLengthOffset = 12;
+constexpr size_t kDataOffsetOffset = 16;
+constexpr size_t kDataSizeOffset = 20;
+
+// The data may not be aligned, so read integers with memcpy().
+template <typename T>
+T ReadAt(const uint8_t* p) {
+  T value;
+  memcpy(&value, p, sizeof(T));
+  return value;
+}
+
+}  // namespace
+
+ResourcePack::ResourcePack() = default;
+
+ResourcePack::ResourcePack(base::span<const uint8_t> data) {
+  Init(data);
+}
+
+ResourcePack::~ResourcePack() = default;
+
+/* static */
+std::unique_ptr<ResourcePack> ResourcePack::Open(const base::FilePath& path) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid()) {
+    if (file.error_details() != base::File::FILE_ERROR_NOT_FOUND) {
+      LOG(ERROR) << path << ": failed to open the resource pack, error_code="
+                 << file.error_details();
+    }
+    return nullptr;
+  }
+  std::unique_ptr<ResourcePack> pack = base::WrapUnique(new ResourcePack());
+  if (!pack->mapped_file_.Initialize(std::move(file))) {
+    LOG(ERROR) << path << ": failed to map the resource pack";
+    return nullptr;
+  }
+  pack->Init(base::make_span(pack->mapped_file_.data(),
+                             pack->mapped_file_.length()));
+  if (!pack->IsValid()) {
+    LOG(ERROR) << path << ": invalid resource pack";
+    return nullptr;
+  }
+  return pack;
+}
+
+/* static */
+uint64_t ResourcePack::HashPath(base::StringPiece resource_path) {
+  // 64-bit FNV-1a, pack_resources.py must use the same hash.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : resource_path) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+void ResourcePack::Init(base::span<const uint8_t> data) {
+  if (data.size() < kHeaderSize ||
+      memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return;
+  }
+  size_t entry_count = ReadAt<uint32_t>(data.data() + sizeof(kMagic));
+  if (ReadAt<uint32_t>(data.data() + sizeof(kMagic) + sizeof(uint32_t)) != 0)
+    return;
+  if ((data.size() - kHeaderSize) / kEntrySize < entry_count)
+    return;
+  data_ = data;
+  entry_count_ = entry_count;
+}
+
+absl::optional<base::span<const uint8_t>> ResourcePack::Find(
+    base::StringPiece resource_path) const {
+  if (!IsValid())
+    return absl::nullopt;
+  const uint8_t* entries = data_.data() + kHeaderSize;
+  uint64_t hash = HashPath(resource_path);
+
+  // Binary search for the first entry with the hash.
+  size_t begin = 0;
+  size_t end = entry_count_;
+  while (begin < end) {
+    size_t middle = begin + (end - begin) / 2;
+    if (ReadAt<uint64_t>(entries + middle * kEntrySize + kPathHashOffset) <
+        hash) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+
+  // Check the paths of all entries with the hash.
+  for (size_t i = begin; i < entry_count_; ++i) {
+    const uint8_t* entry = entries + i * kEntrySize;
+    if (ReadAt<uint64_t>(entry + kPathHashOffset) != hash)
+      break;
+    size_t path_offset = ReadAt<uint32_t>(entry + kPathOffsetOffset);
+    size_t path_length = ReadAt<uint32_t>(entry + kPathLengthOffset);
+    size_t data_offset = ReadAt<uint32_t>(entry + kDataOffsetOffset);
+    size_t data_size = ReadAt<uint32_t>(entry + kDataSizeOffset);
+    if (path_offset > data_.size() ||
+        path_length > data_.size() - path_offset ||
+        data_offset > data_.size() || data_size > data_.size() - data_offset) {
+      LOG(ERROR) << "Resource pack entry " << i << " is out of bounds";
+      return absl::nullopt;
+    }
+    base::StringPiece path(
+        reinterpret_cast<const char*>(data_.data() + path_offset),
+        path_length);
+    if (path == resource_path)
+      return data_.subspan(data_offset, data_size);
+  }
+  return absl::nullopt;
+}
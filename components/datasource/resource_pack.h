@@ -0,0 +1,73 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#ifndef COMPONENTS_DATASOURCE_RESOURCE_PACK_H_
+#define COMPONENTS_DATASOURCE_RESOURCE_PACK_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "base/containers/span.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/strings/string_piece.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace base {
+class FilePath;
+}
+
+// Read-only archive of Vivaldi resources produced at build time by
+// pack_resources.py. Reading resources from a single memory-mapped file avoids
+// opening and mapping hundreds of small files on a cold start.
+//
+// The format, with all integers little-endian, is:
+//
+//   char     magic[8]      "VIVPACK1"
+//   uint32   entry_count
+//   uint32   reserved      0
+//   Entry    entries[entry_count]
+//   ...      paths and data referenced by entries
+//
+// where each 24-byte Entry is
+//
+//   uint64   path_hash     FNV-1a hash of the resource path
+//   uint32   path_offset
+//   uint32   path_length
+//   uint32   data_offset
+//   uint32   data_size
+//
+// and the entries are sorted by path_hash.
+class ResourcePack {
+ public:
+  // Parse the pack from |data|, which must outlive this instance. IsValid()
+  // returns false if the data is not a pack.
+  explicit ResourcePack(base::span<const uint8_t> data);
+  ResourcePack(const ResourcePack&) = delete;
+  ResourcePack& operator=(const ResourcePack&) = delete;
+  ~ResourcePack();
+
+  // Map the pack at |path|. Return null if the file does not exist or is not a
+  // valid pack.
+  static std::unique_ptr<ResourcePack> Open(const base::FilePath& path);
+
+  // The hash of the resource path used in the index.
+  static uint64_t HashPath(base::StringPiece resource_path);
+
+  bool IsValid() const { return !data_.empty(); }
+
+  // Return the data of the resource with the given path relative to the
+  // resource directory, or nullopt if the pack has no such resource.
+  absl::optional<base::span<const uint8_t>> Find(
+      base::StringPiece resource_path) const;
+
+ private:
+  ResourcePack();
+
+  // Set data_ and entry_count_ if |data| is a valid pack.
+  void Init(base::span<const uint8_t> data);
+
+  base::MemoryMappedFile mapped_file_;
+  base::span<const uint8_t> data_;
+  size_t entry_count_ = 0;
+};
+
+#endif  // COMPONENTS_DATASOURCE_RESOURCE_PACK_H_
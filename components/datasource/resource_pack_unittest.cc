@@ -0,0 +1,111 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "components/datasource/resource_pack.h"
+
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+template <typename T>
+void Append(std::vector<uint8_t>& out, T value) {
+  size_t size = out.size();
+  out.resize(size + sizeof(T));
+  memcpy(out.data() + size, &value, sizeof(T));
+}
+
+// Build a pack the same way as pack_resources.py does, without aligning data.
+std::vector<uint8_t> BuildPack(
+    const std::map<std::string, std::string>& resources) {
+  std::multimap<uint64_t, std::pair<std::string, std::string>> entries;
+  for (const auto& resource : resources) {
+    entries.emplace(ResourcePack::HashPath(resource.first), resource);
+  }
+
+  std::vector<uint8_t> out = {'V', 'I', 'V', 'P', 'A', 'C', 'K', '1'};
+  Append(out, static_cast<uint32_t>(entries.size()));
+  Append(out, static_cast<uint32_t>(0));
+  size_t offset = out.size() + entries.size() * 24;
+  std::string tail;
+  for (const auto& entry : entries) {
+    Append(out, entry.first);
+    Append(out, static_cast<uint32_t>(offset + tail.size()));
+    Append(out, static_cast<uint32_t>(entry.second.first.size()));
+    tail += entry.second.first;
+    Append(out, static_cast<uint32_t>(offset + tail.size()));
+    Append(out, static_cast<uint32_t>(entry.second.second.size()));
+    tail += entry.second.second;
+  }
+  out.insert(out.end(), tail.begin(), tail.end());
+  return out;
+}
+
+std::string AsString(base::span<const uint8_t> data) {
+  return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+}  // namespace
+
+TEST(ResourcePackTest, Find) {
+  std::vector<uint8_t> data = BuildPack({
+      {"features.json", "{}"},
+      {"default-bookmarks/en-US.json", "[1, 2]"},
+      {"empty.txt", ""},
+  });
+  ResourcePack pack(data);
+  ASSERT_TRUE(pack.IsValid());
+
+  absl::optional<base::span<const uint8_t>> entry = pack.Find("features.json");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(AsString(*entry), "{}");
+
+  entry = pack.Find("default-bookmarks/en-US.json");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(AsString(*entry), "[1, 2]");
+
+  entry = pack.Find("empty.txt");
+  ASSERT_TRUE(entry);
+  EXPECT_TRUE(entry->empty());
+
+  EXPECT_FALSE(pack.Find("missing.json"));
+  EXPECT_FALSE(pack.Find("default-bookmarks"));
+  EXPECT_FALSE(pack.Find(""));
+}
+
+TEST(ResourcePackTest, EmptyPack) {
+  std::vector<uint8_t> data = BuildPack({});
+  ResourcePack pack(data);
+  EXPECT_TRUE(pack.IsValid());
+  EXPECT_FALSE(pack.Find("features.json"));
+}
+
+TEST(ResourcePackTest, Invalid) {
+  std::vector<uint8_t> data = BuildPack({{"a.json", "{}"}});
+
+  std::vector<uint8_t> bad_magic = data;
+  bad_magic[0] = 'X';
+  EXPECT_FALSE(ResourcePack(bad_magic).IsValid());
+
+  // The entry table does not fit.
+  std::vector<uint8_t> truncated(data.begin(), data.begin() + 20);
+  EXPECT_FALSE(ResourcePack(truncated).IsValid());
+
+  // Entries pointing past the end are not returned.
+  std::vector<uint8_t> bad_offset = data;
+  uint32_t data_offset = 0xffffff00;
+  memcpy(bad_offset.data() + 16 + 16, &data_offset, sizeof(data_offset));
+  ResourcePack pack(bad_offset);
+  ASSERT_TRUE(pack.IsValid());
+  EXPECT_FALSE(pack.Find("a.json"));
+}
+
+TEST(ResourcePackTest, HashMatchesPackScript) {
+  // Values computed with HashPath() in pack_resources.py.
+  EXPECT_EQ(ResourcePack::HashPath(""), 0xcbf29ce484222325ULL);
+  EXPECT_EQ(ResourcePack::HashPath("a"), 0xaf63dc4c8601ec8cULL);
+}
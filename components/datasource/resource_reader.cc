@@ -4,6 +4,7 @@
 
 #include "apps/switches.h"
 #include "base/command_line.h"
+#include "base/containers/lru_cache.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
@@ -14,9 +15,15 @@
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/png_codec.h"
 
 #include "app/vivaldi_apptools.h"
+#include "components/datasource/resource_pack.h"
 
 #if BUILDFLAG(IS_ANDROID)
 #include "base/android/apk_assets.h"
@@ -34,6 +41,69 @@ namespace {
 
 constexpr char kResourceUrlPrefix[] = "/resources/";
 
+// Bounds for the resource cache. Resources read through ReadJSON() and
+// ReadPngImage() are few and small, the bounds only protect against callers
+// that read arbitrary resources.
+constexpr size_t kMaxCachedJSON = 32;
+constexpr size_t kMaxCachedImages = 256;
+
+// True when resources are loaded from the vivapp source directory and can be
+// edited while the browser runs.
+bool g_resources_from_source_dir = false;
+
+// Process-wide cache of parsed JSON and decoded images keyed by the resource
+// path.
+class ResourceCache {
+ public:
+  ResourceCache() : json_(kMaxCachedJSON), images_(kMaxCachedImages) {}
+
+  static ResourceCache& Get() {
+    static base::NoDestructor<ResourceCache> instance;
+    return *instance;
+  }
+
+  static bool IsEnabled() {
+#if !BUILDFLAG(IS_ANDROID)
+    // Make sure g_resources_from_source_dir is initialized.
+    ResourceReader::GetResourceDirectory();
+#endif
+    return !g_resources_from_source_dir;
+  }
+
+  absl::optional<base::Value> FindJSON(const std::string& resource_path) {
+    base::AutoLock lock(lock_);
+    auto i = json_.Get(resource_path);
+    if (i == json_.end())
+      return absl::nullopt;
+    return i->second.Clone();
+  }
+
+  void AddJSON(const std::string& resource_path, const base::Value& value) {
+    base::AutoLock lock(lock_);
+    json_.Put(resource_path, value.Clone());
+  }
+
+  // SkBitmap shares the pixels between copies in a thread-safe way unlike
+  // gfx::Image, so the cache stores bitmaps.
+  absl::optional<SkBitmap> FindImage(base::StringPiece resource_url) {
+    base::AutoLock lock(lock_);
+    auto i = images_.Get(std::string(resource_url));
+    if (i == images_.end())
+      return absl::nullopt;
+    return i->second;
+  }
+
+  void AddImage(base::StringPiece resource_url, const SkBitmap& bitmap) {
+    base::AutoLock lock(lock_);
+    images_.Put(std::string(resource_url), bitmap);
+  }
+
+ private:
+  base::Lock lock_;
+  base::HashingLRUCache<std::string, base::Value> json_ GUARDED_BY(lock_);
+  base::HashingLRUCache<std::string, SkBitmap> images_ GUARDED_BY(lock_);
+};
+
 }  // namespace
 
 /* static */
@@ -68,6 +138,7 @@ base::FilePath GetResourceDirectoryImpl() {
       if (app_path.BaseName().value() == FILE_PATH_LITERAL("src") &&
           app_path.DirName().BaseName().value() ==
               FILE_PATH_LITERAL("vivapp")) {
+        g_resources_from_source_dir = true;
         return app_path;
       }
     }
@@ -83,6 +154,18 @@ base::FilePath GetResourceDirectoryImpl() {
 #endif
 }
 
+// Return the resource pack from the resource directory or null when there is
+// none or the resources come from the source directory for development.
+const ResourcePack* GetResourcePack() {
+  static base::NoDestructor<std::unique_ptr<ResourcePack>> pack([] {
+    const base::FilePath& dir = ResourceReader::GetResourceDirectory();
+    if (g_resources_from_source_dir)
+      return std::unique_ptr<ResourcePack>();
+    return ResourcePack::Open(dir.Append(FILE_PATH_LITERAL("resources.pack")));
+  }());
+  return pack->get();
+}
+
 }  // namespace
 
 /* static */
@@ -107,17 +190,39 @@ absl::optional<base::Value> ResourceReader::ReadJSON(
     resource_path += '/';
   }
   resource_path.append(resource_name.data(), resource_name.size());
+  TRACE_EVENT1("startup", "ResourceReader::ReadJSON", "resource",
+               resource_path);
 
-  ResourceReader reader(std::move(resource_path));
+  bool use_cache = ResourceCache::IsEnabled();
+  if (use_cache) {
+    absl::optional<base::Value> json =
+        ResourceCache::Get().FindJSON(resource_path);
+    if (json)
+      return json;
+  }
+
+  ResourceReader reader(resource_path);
   absl::optional<base::Value> json = reader.ParseJSON();
   if (!json) {
     LOG(ERROR) << reader.GetError();
+  } else if (use_cache) {
+    ResourceCache::Get().AddJSON(resource_path, *json);
   }
   return json;
 }
 
 /* static */
 gfx::Image ResourceReader::ReadPngImage(base::StringPiece resource_url) {
+  TRACE_EVENT1("startup", "ResourceReader::ReadPngImage", "resource",
+               std::string(resource_url));
+  bool use_cache = ResourceCache::IsEnabled();
+  if (use_cache) {
+    absl::optional<SkBitmap> bitmap =
+        ResourceCache::Get().FindImage(resource_url);
+    if (bitmap)
+      return gfx::Image::CreateFrom1xBitmap(*bitmap);
+  }
+
   std::string resource_path;
   if (!ResourceReader::IsResourceURL(resource_url, &resource_path)) {
     LOG(ERROR) << "resource_url does not start with " << kResourceUrlPrefix
@@ -135,13 +240,16 @@ gfx::Image ResourceReader::ReadPngImage(base::StringPiece resource_url) {
     LOG(ERROR) << reader.GetError();
     return gfx::Image();
   }
-  gfx::Image image =
-      gfx::Image::CreateFrom1xPNGBytes(reader.data(), reader.size());
-  if (image.IsEmpty()) {
+  SkBitmap bitmap;
+  if (!gfx::PNGCodec::Decode(reader.data(), reader.size(), &bitmap)) {
     LOG(ERROR) << "Failed to read " << resource_url << " as PNG image";
     return gfx::Image();
   }
-  return image;
+  bitmap.setImmutable();
+  if (use_cache) {
+    ResourceCache::Get().AddImage(resource_url, bitmap);
+  }
+  return gfx::Image::CreateFrom1xBitmap(bitmap);
 }
 
 ResourceReader::ResourceReader(std::string resource_path)
@@ -161,6 +269,14 @@ ResourceReader::ResourceReader(std::string resource_path)
     return;
   }
 #else
+  if (const ResourcePack* pack = GetResourcePack()) {
+    if (absl::optional<base::span<const uint8_t>> packed_data =
+            pack->Find(resource_path_)) {
+      packed_data_ = *packed_data;
+      from_pack_ = true;
+      return;
+    }
+  }
   base::FilePath path = GetResourceDirectory().Append(
       base::FilePath::FromUTF8Unsafe(resource_path_));
   base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
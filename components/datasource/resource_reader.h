@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/span.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/strings/string_piece.h"
 #include "base/values.h"
@@ -33,23 +34,34 @@ class ResourceReader {
   // Get directory holding Vivaldi resource files. To simplify development in
   // non-official builds this may return source directory of vivapp/src, not the
   // directory from the build or installation. This way the changes to it can be
-  // reflected without a rebuild.
+  // reflected without a rebuild. When the directory contains the resource pack
+  // built by pack_resources.py, resources are read from the pack and the loose
+  // files are not used.
   static const base::FilePath& GetResourceDirectory();
 #endif
 
   // Convenience method to read a resource as JSON from the given resource
   // directory and resource. `resource_directory`, when not empty, should not
-  // start or end with a slash. All errors are logged.
+  // start or end with a slash. All errors are logged. Successfully parsed
+  // values are kept in a process-wide cache, so repeated reads return a copy
+  // without touching the file system.
   static absl::optional<base::Value> ReadJSON(
       base::StringPiece resource_directory,
       base::StringPiece resource_name);
 
+  // Read and decode a PNG resource. As with ReadJSON() decoded images are
+  // cached per process. The decoding happens on the calling thread, so call
+  // this from a worker when the image is not cached yet.
   static gfx::Image ReadPngImage(base::StringPiece resource_url);
 
-  bool IsValid() const { return mapped_file_.IsValid(); }
+  bool IsValid() const { return from_pack_ || mapped_file_.IsValid(); }
 
-  const uint8_t* data() const { return mapped_file_.data(); }
-  size_t size() const { return mapped_file_.length(); }
+  const uint8_t* data() const {
+    return from_pack_ ? packed_data_.data() : mapped_file_.data();
+  }
+  size_t size() const {
+    return from_pack_ ? packed_data_.size() : mapped_file_.length();
+  }
 
   base::StringPiece as_string_view() const {
     return base::StringPiece(reinterpret_cast<const char*>(data()), size());
@@ -68,6 +80,11 @@ class ResourceReader {
 
  private:
   base::MemoryMappedFile mapped_file_;
+
+  // The resource data when it comes from the resource pack which is mapped for
+  // the lifetime of the process.
+  base::span<const uint8_t> packed_data_;
+  bool from_pack_ = false;
   std::string resource_path_;
   std::string error_;
   bool not_found_error_ = false;
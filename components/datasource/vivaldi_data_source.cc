@@ -10,6 +10,8 @@
 #include "base/callback.h"
 #include "base/memory/ptr_util.h"
 #include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
 #include "build/build_config.h"
 #include "chrome/browser/profiles/profile.h"
 #include "content/public/browser/browser_task_traits.h"
@@ -22,11 +24,26 @@
 #include "components/datasource/css_mods_data_source.h"
 #include "components/datasource/local_image_data_source.h"
 #include "components/datasource/notes_attachment_data_source.h"
+#include "components/datasource/vivaldi_data_url_utils.h"
+#include "components/datasource/vivaldi_image_store.h"
 
 #if BUILDFLAG(IS_WIN)
 #include "components/datasource/desktop_data_source_win.h"
 #endif  // BUILDFLAG(IS_WIN)
 
+namespace {
+
+// Old bookmark thumbnail urls, /local-image/<number> and
+// /http://bookmark_thumbnail/<id>, are parsed as PathType::kImage but their
+// ids are not hashes of the content.
+bool IsContentAddressedImagePath(base::StringPiece path) {
+  const char* image_dir =
+      vivaldi_data_url_utils::top_dir(vivaldi_data_url_utils::PathType::kImage);
+  return base::StartsWith(path, std::string("/") + image_dir + "/");
+}
+
+}  // namespace
+
 VivaldiDataSource::VivaldiDataSource(Profile* profile)
     : profile_(profile->GetOriginalProfile()) {
   std::vector<std::pair<PathType, std::unique_ptr<VivaldiDataClassHandler>>>
@@ -70,13 +87,37 @@ void VivaldiDataSource::StartDataRequest(
   if (type) {
     auto it = data_class_handlers_.find(*type);
     if (it != data_class_handlers_.end()) {
-      it->second->GetData(profile_, data, std::move(callback));
+      it->second->GetDataWithQuery(profile_, data, url.query_piece(),
+                                   std::move(callback));
       return;
     }
   }
   std::move(callback).Run(nullptr);
 }
 
+bool VivaldiDataSource::ShouldStreamFiles() {
+  return true;
+}
+
+void VivaldiDataSource::StartFilePathRequest(
+    const GURL& url,
+    const content::WebContents::Getter& wc_getter,
+    content::URLDataSource::GotFilePathCallback callback) {
+  std::string data;
+  absl::optional<PathType> type =
+      vivaldi_data_url_utils::ParsePath(url.path_piece(), &data);
+  // Requests with a size are served scaled from memory.
+  if (type &&
+      !vivaldi_data_url_utils::ParseImageWidthQuery(url.query_piece())) {
+    auto it = data_class_handlers_.find(*type);
+    if (it != data_class_handlers_.end()) {
+      it->second->GetFilePath(profile_, data, std::move(callback));
+      return;
+    }
+  }
+  std::move(callback).Run(base::FilePath());
+}
+
 std::string VivaldiDataSource::GetMimeType(const GURL& url) {
   // We need to explicitly return a mime type, otherwise if the user tries to
   // drag the image they get no extension.
@@ -88,6 +129,50 @@ bool VivaldiDataSource::AllowCaching(const GURL& url) {
   return type == PathType::kLocalPath || type == PathType::kImage;
 }
 
+std::string VivaldiDataSource::GetCacheControl(const GURL& url) {
+  absl::optional<PathType> type = vivaldi_data_url_utils::ParsePath(url.path());
+  if (!type)
+    return "no-cache";
+  switch (*type) {
+    case PathType::kImage:
+      // The image id is the hash of the content, so the data for a particular
+      // url never changes. This does not hold for old thumbnail urls.
+      if (IsContentAddressedImagePath(url.path_piece()))
+        return "public, max-age=31536000, immutable";
+      return "no-cache";
+    case PathType::kLocalPath:
+    case PathType::kCSSMod:
+      // The same url can map to a different file or css over time, so always
+      // revalidate.
+      return "no-cache";
+    default:
+      return URLDataSource::GetCacheControl(url);
+  }
+}
+
+std::string VivaldiDataSource::GetETag(const GURL& url) {
+  std::string data;
+  absl::optional<PathType> type =
+      vivaldi_data_url_utils::ParsePath(url.path_piece(), &data);
+  if (type != PathType::kImage || data.empty() ||
+      !IsContentAddressedImagePath(url.path_piece())) {
+    return std::string();
+  }
+
+  // Requests with a size get a scaled variant, so its width is a part of the
+  // tag.
+  std::string etag = "\"" + data;
+  int requested_width =
+      vivaldi_data_url_utils::ParseImageWidthQuery(url.query_piece());
+  if (int width = VivaldiImageStore::GetDisplaySizedWidth(requested_width)) {
+    etag += "-d" + base::NumberToString(width);
+  } else if (int width =
+                 VivaldiImageStore::FindImageTierWidth(requested_width)) {
+    etag += "-" + base::NumberToString(width);
+  }
+  return etag + "\"";
+}
+
 /*
  * Code to handle the chrome://thumb/ protocol.
  */
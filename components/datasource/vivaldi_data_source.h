@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include "base/containers/flat_map.h"
+#include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "content/public/browser/url_data_source.h"
@@ -27,6 +28,27 @@ class VivaldiDataClassHandler {
   virtual void GetData(Profile* profile,
                        const std::string& data_id,
                        content::URLDataSource::GotDataCallback callback) = 0;
+
+  // Variant of GetData() for handlers that use the query part of the url. The
+  // default implementation ignores the query.
+  virtual void GetDataWithQuery(
+      Profile* profile,
+      const std::string& data_id,
+      base::StringPiece query,
+      content::URLDataSource::GotDataCallback callback) {
+    GetData(profile, data_id, std::move(callback));
+  }
+
+  // Handlers that serve big files can run the callback with the path of the
+  // file so it is streamed rather than read into memory. Running it with an
+  // empty path makes the data source use GetDataWithQuery(). The default does
+  // that.
+  virtual void GetFilePath(
+      Profile* profile,
+      const std::string& data_id,
+      content::URLDataSource::GotFilePathCallback callback) {
+    std::move(callback).Run(base::FilePath());
+  }
 };
 
 class VivaldiDataSource : public content::URLDataSource {
@@ -42,8 +64,15 @@ class VivaldiDataSource : public content::URLDataSource {
       const GURL& path,
       const content::WebContents::Getter& wc_getter,
       content::URLDataSource::GotDataCallback callback) override;
+  bool ShouldStreamFiles() override;
+  void StartFilePathRequest(
+      const GURL& url,
+      const content::WebContents::Getter& wc_getter,
+      content::URLDataSource::GotFilePathCallback callback) override;
   std::string GetMimeType(const GURL& url) override;
   bool AllowCaching(const GURL& url) override;
+  std::string GetCacheControl(const GURL& url) override;
+  std::string GetETag(const GURL& url) override;
 
  private:
   using PathType = vivaldi_data_url_utils::PathType;
@@ -9,6 +9,7 @@
 #include "base/logging.h"
 #include "base/strings/escape.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "net/base/mime_util.h"
@@ -40,6 +41,11 @@ const char kCSSModsExtension[] = ".css";
 
 const char kOldThumbnailFormatPrefix[] = "/http://bookmark_thumbnail/";
 
+const char kImageSizeParameter[] = "size";
+
+// Do not accept sizes beyond the reasonable screen size.
+constexpr int kMaxImageWidthQuery = 16384;
+
 }  // namespace
 
 absl::optional<PathType> ParsePath(base::StringPiece path, std::string* data) {
@@ -155,6 +161,22 @@ std::string GetPathMimeType(base::StringPiece path) {
   return kMimeTypePNG;
 }
 
+int ParseImageWidthQuery(base::StringPiece query) {
+  for (base::StringPiece param : base::SplitStringPiece(
+           query, "&", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    size_t pos = param.find('=');
+    if (pos == base::StringPiece::npos ||
+        param.substr(0, pos) != kImageSizeParameter)
+      continue;
+    int width;
+    if (!base::StringToInt(param.substr(pos + 1), &width) || width <= 0 ||
+        width > kMaxImageWidthQuery)
+      return 0;
+    return width;
+  }
+  return 0;
+}
+
 bool isOldFormatThumbnailId(base::StringPiece id) {
   int64_t bookmark_id;
   return id.length() <= 20 && base::StringToInt64(id, &bookmark_id) &&
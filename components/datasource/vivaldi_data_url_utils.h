@@ -42,6 +42,10 @@ absl::optional<PathType> ParseUrl(base::StringPiece url,
 
 std::string GetPathMimeType(base::StringPiece path);
 
+// Get the width in pixels from the size=N parameter in the url query. Return 0
+// if the parameter is absent or invalid.
+int ParseImageWidthQuery(base::StringPiece query);
+
 // Check if path mapping id is really old-format thumbanil, not a path
 // mapping.
 bool isOldFormatThumbnailId(base::StringPiece id);
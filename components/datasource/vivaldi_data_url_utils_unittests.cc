@@ -217,4 +217,18 @@ TEST_F(VivaldiDataUrlUtilsTest, MakeUrl) {
   }
 }
 
+TEST_F(VivaldiDataUrlUtilsTest, ParseImageWidthQuery) {
+  EXPECT_EQ(ParseImageWidthQuery("size=220"), 220);
+  EXPECT_EQ(ParseImageWidthQuery("a=1&size=110&b=2"), 110);
+
+  // Missing or invalid values means the original size.
+  EXPECT_EQ(ParseImageWidthQuery(""), 0);
+  EXPECT_EQ(ParseImageWidthQuery("size"), 0);
+  EXPECT_EQ(ParseImageWidthQuery("size="), 0);
+  EXPECT_EQ(ParseImageWidthQuery("size=-5"), 0);
+  EXPECT_EQ(ParseImageWidthQuery("size=abc"), 0);
+  EXPECT_EQ(ParseImageWidthQuery("size=100000"), 0);
+  EXPECT_EQ(ParseImageWidthQuery("width=220"), 0);
+}
+
 }  // namespace vivaldi_data_url_utils
\ No newline at end of file
@@ -2,27 +2,40 @@
 
 #include "components/datasource/vivaldi_image_store.h"
 
+#include "base/callback_helpers.h"
+#include "base/containers/adapters.h"
 #include "base/containers/contains.h"
 #include "base/containers/flat_set.h"
 #include "base/containers/span.h"
+#include "base/files/file.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/lazy_instance.h"
+#include "base/memory/memory_pressure_monitor.h"
 #include "base/memory/singleton.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/path_service.h"
+#include "base/scoped_observation.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/thread_pool.h"
 #include "base/task/thread_pool/thread_pool_instance.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/trace_event/trace_event.h"
+#include "base/vivaldi_batching_task_runner.h"
 #include "build/build_config.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/profiles/incognito_helpers.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/chrome_paths.h"
 #include "components/base32/base32.h"
+#include "components/bookmarks/browser/base_bookmark_model_observer.h"
 #include "components/bookmarks/browser/bookmark_model.h"
 #include "components/keyed_service/content/browser_context_dependency_manager.h"
 #include "components/keyed_service/content/browser_context_keyed_service_factory.h"
@@ -33,7 +46,15 @@
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "crypto/sha2.h"
+#include "services/data_decoder/public/cpp/decode_image.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/base/models/tree_node_iterator.h"
+#include "ui/display/display.h"
+#include "ui/display/screen.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/codec/webp_codec.h"
 
 #include "app/vivaldi_constants.h"
 #include "components/bookmarks/vivaldi_bookmark_kit.h"
@@ -42,6 +63,12 @@
 #include "components/datasource/vivaldi_theme_io.h"
 #include "prefs/vivaldi_gen_prefs.h"
 
+#if BUILDFLAG(IS_POSIX)
+#include <unistd.h>
+#elif BUILDFLAG(IS_WIN)
+#include <windows.h>
+#endif
+
 namespace {
 
 constexpr const char* const kCanonicalExtensions[] = {
@@ -80,6 +107,26 @@ static_assert(std::size(kAllowedMimeTypes) ==
 const char kDatasourceFilemappingFilename[] = "file_mapping.json";
 const char kDatasourceFilemappingTmpFilename[] = "file_mapping.tmp";
 
+// Journal of changes to the mapping file since it was written. Each line is a
+// JSON dictionary with an id and, when the mapping is added, a local path. A
+// line without the path records a removed mapping. Builds without journal
+// support read only the mapping file and miss the changes in the journal.
+const char kDatasourceFilemappingJournalFilename[] = "file_mapping.journal";
+
+// Present when the last check for unused url data found nothing left to
+// remove and no url data has been stored or may have lost its last reference
+// since. Then the check is skipped on startup.
+const char kUnusedUrlDataCheckedFilename[] = "file_mapping.checked";
+
+// Rewrite the mapping file and clear the journal when the journal has more
+// entries than this or than the number of mappings.
+constexpr size_t kMappingJournalCompactThreshold = 64;
+
+// Bookkeeping tasks are cheap, so runs of them, like after capturing
+// thumbnails for a folder of bookmarks, are batched.
+constexpr base::TimeDelta kBookkeepingBatchDelay = base::Milliseconds(100);
+constexpr size_t kBookkeepingBatchSize = 64;
+
 // The name is thumbnails as originally the directory stored only bookmark
 // thumbnails.
 const base::FilePath::StringPieceType kImageDirectory =
@@ -97,28 +144,131 @@ constexpr int kOffscreenWindowHeight = 838;
 // browser is likely idle.
 constexpr base::TimeDelta kDataUrlGCStartupDelay = base::Seconds(60);
 
+// Widths of the downscaled thumbnail tiers in increasing order. Tiers are
+// only generated for images wider than the tier.
+constexpr int kImageTierWidths[] = {
+    kBookmarkThumbnailWidth / 4,
+    kBookmarkThumbnailWidth / 2,
+};
+
+// Display-sized variants of big images are produced for widths that are a
+// multiple of this so windows of slightly different sizes share them.
+constexpr int kDisplaySizedWidthStep = 256;
+
+// Quality of the lossy WebP encoding of thumbnails.
+constexpr int kThumbnailWebPQuality = 80;
+
+// Budget for the in-memory image data cache. With the bookmark thumbnail size
+// above a typical PNG thumbnail takes 100-200KB so this covers a big Speed Dial.
+constexpr size_t kDataCacheMaxBytes = 64 * 1024 * 1024;
+
+// Images bigger than this are not cached to prevent a few big background
+// images from evicting all thumbnails.
+constexpr size_t kDataCacheMaxEntryBytes = 8 * 1024 * 1024;
+
 }  // namespace
 
-// Helper to store ref-counted VivaldiImageStore in BrowserContext.
-class VivaldiImageStoreHolder : public KeyedService {
+// Helper to store ref-counted VivaldiImageStore in BrowserContext. It also
+// watches the places that reference url data so the store knows when some
+// data may have become unused.
+class VivaldiImageStoreHolder : public KeyedService,
+                                public bookmarks::BaseBookmarkModelObserver {
  public:
   explicit VivaldiImageStoreHolder(content::BrowserContext* context) {
     Profile* profile = Profile::FromBrowserContext(context);
     api_ = base::MakeRefCounted<VivaldiImageStore>(profile);
     api_->Start();
+    memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+        FROM_HERE, base::BindRepeating(&VivaldiImageStore::OnMemoryPressure,
+                                       base::Unretained(api_.get())));
+
+    if (bookmarks::BookmarkModel* bookmark_model = api_->GetBookmarkModel()) {
+      bookmark_observation_.Observe(bookmark_model);
+    }
+    prefs_registrar_.Init(profile->GetPrefs());
+    for (const char* path :
+         {vivaldiprefs::kThemeBackgroundUserImage, vivaldiprefs::kThemesUser,
+          vivaldiprefs::kThemesPreview}) {
+      // base::Unretained() is OK as the registrar is owned by this.
+      prefs_registrar_.Add(
+          path, base::BindRepeating(&VivaldiImageStoreHolder::OnPrefChanged,
+                                    base::Unretained(this)));
+    }
   }
 
   ~VivaldiImageStoreHolder() override = default;
 
  private:
+  void OnPrefChanged(const std::string& path) {
+    api_->MarkUrlDataMayBeUnused();
+  }
+
+  // bookmarks::BaseBookmarkModelObserver
+  void BookmarkModelChanged() override {}
+
+  void BookmarkModelBeingDeleted(bookmarks::BookmarkModel* model) override {
+    bookmark_observation_.Reset();
+  }
+
+  void BookmarkNodeRemoved(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* parent,
+                           size_t old_index,
+                           const bookmarks::BookmarkNode* node,
+                           const std::set<GURL>& removed_urls) override {
+    api_->MarkUrlDataMayBeUnused();
+  }
+
+  void BookmarkAllUserNodesRemoved(
+      bookmarks::BookmarkModel* model,
+      const std::set<GURL>& removed_urls) override {
+    api_->MarkUrlDataMayBeUnused();
+  }
+
+  void OnWillChangeBookmarkMetaInfo(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override {
+    thumbnail_before_change_ = vivaldi_bookmark_kit::GetThumbnail(node);
+  }
+
+  void BookmarkMetaInfoChanged(bookmarks::BookmarkModel* model,
+                               const bookmarks::BookmarkNode* node) override {
+    if (vivaldi_bookmark_kit::GetThumbnail(node) != thumbnail_before_change_) {
+      api_->MarkUrlDataMayBeUnused();
+    }
+    thumbnail_before_change_.clear();
+  }
+
+  // SetNodeMetaInfoWithIndexChange(), which SetNodeThumbnail() uses, reports
+  // the meta info change as a node change.
+  void OnWillChangeBookmarkNode(bookmarks::BookmarkModel* model,
+                                const bookmarks::BookmarkNode* node) override {
+    OnWillChangeBookmarkMetaInfo(model, node);
+  }
+
+  void BookmarkNodeChanged(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* node) override {
+    BookmarkMetaInfoChanged(model, node);
+  }
+
   // KeyedService
   void Shutdown() override {
+    bookmark_observation_.Reset();
+    prefs_registrar_.RemoveAll();
+    memory_pressure_listener_.reset();
+
     // Prevent further access to api_ from UI thread. Note that it can still
     // be used on worker threads.
     api_->profile_ = nullptr;
     api_.reset();
   }
 
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  base::ScopedObservation<bookmarks::BookmarkModel,
+                          bookmarks::BookmarkModelObserver>
+      bookmark_observation_{this};
+  PrefChangeRegistrar prefs_registrar_;
+  std::string thumbnail_before_change_;
+
  public:
   scoped_refptr<VivaldiImageStore> api_;
 };
@@ -143,7 +293,9 @@ class VivaldiImageStoreFactory : public BrowserContextKeyedServiceFactory {
   VivaldiImageStoreFactory()
       : BrowserContextKeyedServiceFactory(
             "VivaldiImageStore",
-            BrowserContextDependencyManager::GetInstance()) {}
+            BrowserContextDependencyManager::GetInstance()) {
+    DependsOn(BookmarkModelFactory::GetInstance());
+  }
   ~VivaldiImageStoreFactory() override = default;
 
   // BrowserContextKeyedServiceFactory:
@@ -157,6 +309,11 @@ class VivaldiImageStoreFactory : public BrowserContextKeyedServiceFactory {
       content::BrowserContext* browser_context) const override {
     return new VivaldiImageStoreHolder(browser_context);
   }
+
+  // The holder must see all changes to bookmarks and preferences to know
+  // when the check for unused url data can be skipped, so create it before
+  // anything can change them.
+  bool ServiceIsCreatedWithBrowserContext() const override { return true; }
 };
 
 }  // namespace
@@ -234,6 +391,133 @@ bool VivaldiImageStore::ParseDataUrl(base::StringPiece url,
 }
 
 namespace {
+
+// Hardlink the file with the same image id stored by another profile to
+// dest_path so identical images are kept on disk once. The id is the hash of
+// the data, so a file with the same name and size has the same content.
+// Deleting the file in one profile does not affect the others. Return false
+// when no profile has the image or linking is not supported.
+bool LinkImageFromOtherProfile(const base::FilePath& profile_dir,
+                               const base::FilePath& dest_path,
+                               size_t size) {
+  base::FilePath file_name = dest_path.BaseName();
+  base::FileEnumerator profiles(profile_dir.DirName(), false,
+                                base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath dir = profiles.Next(); !dir.empty();
+       dir = profiles.Next()) {
+    if (dir == profile_dir)
+      continue;
+    base::FilePath source_path = dir.Append(kImageDirectory).Append(file_name);
+    int64_t source_size = 0;
+    if (!base::GetFileSize(source_path, &source_size) ||
+        static_cast<uint64_t>(source_size) != size)
+      continue;
+#if BUILDFLAG(IS_POSIX)
+    if (link(source_path.value().c_str(), dest_path.value().c_str()) == 0)
+      return true;
+#elif BUILDFLAG(IS_WIN)
+    if (::CreateHardLinkW(dest_path.value().c_str(),
+                          source_path.value().c_str(), nullptr))
+      return true;
+#endif
+    // Profiles share the volume, so if linking fails for one profile it fails
+    // for all of them.
+    return false;
+  }
+  return false;
+}
+
+base::FilePath MappingPathFromString(const std::string& path_string) {
+#if BUILDFLAG(IS_POSIX)
+  return base::FilePath(path_string);
+#elif BUILDFLAG(IS_WIN)
+  return base::FilePath(base::UTF8ToWide(path_string));
+#endif
+}
+
+// Decode the thumbnail data that we re-encode. We only support formats that we
+// produce ourselves via captures or get from the old Chromium thumbnail
+// database.
+bool DecodeThumbnail(VivaldiImageStore::ImageFormat format,
+                     const base::RefCountedMemory& data,
+                     SkBitmap* bitmap) {
+  switch (format) {
+    case VivaldiImageStore::ImageFormat::kPNG:
+      return gfx::PNGCodec::Decode(data.front(), data.size(), bitmap);
+    case VivaldiImageStore::ImageFormat::kJPEG: {
+      std::unique_ptr<SkBitmap> decoded =
+          gfx::JPEGCodec::Decode(data.front(), data.size());
+      if (!decoded)
+        return false;
+      *bitmap = std::move(*decoded);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+scoped_refptr<base::RefCountedMemory> EncodeThumbnailAsWebP(
+    const SkBitmap& bitmap) {
+  std::vector<unsigned char> encoded;
+  if (!gfx::WebpCodec::Encode(bitmap, kThumbnailWebPQuality, &encoded))
+    return nullptr;
+  return base::RefCountedBytes::TakeVector(&encoded);
+}
+
+std::string GetTierCacheId(base::StringPiece id, int tier_width) {
+  std::string cache_id = "w" + base::NumberToString(tier_width) + "/";
+  cache_id.append(id.data(), id.size());
+  return cache_id;
+}
+
+std::string GetDisplaySizedCacheId(base::StringPiece id, int width) {
+  std::string cache_id = "d" + base::NumberToString(width) + "/";
+  cache_id.append(id.data(), id.size());
+  return cache_id;
+}
+
+// Return the id of the stored image or mapping for a cache id of a tier or a
+// display-sized variant. Stored ids never contain a slash.
+base::StringPiece GetBaseCacheId(base::StringPiece cache_id) {
+  size_t slash = cache_id.find('/');
+  if (slash == base::StringPiece::npos)
+    return cache_id;
+  return cache_id.substr(slash + 1);
+}
+
+scoped_refptr<base::RefCountedMemory> DownscaleAndEncode(SkBitmap bitmap,
+                                                         int width) {
+  int height = std::max(
+      1, static_cast<int>(static_cast<int64_t>(bitmap.height()) * width /
+                          bitmap.width()));
+  SkBitmap scaled = skia::ImageOperations::Resize(
+      bitmap, skia::ImageOperations::RESIZE_GOOD, width, height);
+  return EncodeThumbnailAsWebP(scaled);
+}
+
+void OnImageDecodedForScaling(scoped_refptr<base::RefCountedMemory> data,
+                              int width,
+                              content::URLDataSource::GotDataCallback callback,
+                              const SkBitmap& bitmap) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (bitmap.drawsNothing() || bitmap.width() <= width) {
+    std::move(callback).Run(std::move(data));
+    return;
+  }
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&DownscaleAndEncode, bitmap, width),
+      base::BindOnce(
+          [](scoped_refptr<base::RefCountedMemory> data,
+             content::URLDataSource::GotDataCallback callback,
+             scoped_refptr<base::RefCountedMemory> scaled) {
+            std::move(callback).Run(scaled ? std::move(scaled)
+                                           : std::move(data));
+          },
+          std::move(data), std::move(callback)));
+}
+
 // Hash the image data and produce a string that can be used as a file name. The
 // strings should contain all uppercase letters.
 std::string HashDataToFileName(const uint8_t* data, size_t size) {
@@ -261,15 +545,178 @@ VivaldiImageStore::VivaldiImageStore(Profile* profile)
       ui_thread_runner_(content::GetUIThreadTaskRunner(
           {base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
       sequence_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
-          {base::TaskPriority::USER_VISIBLE, base::MayBlock()})) {}
+          {base::TaskPriority::USER_VISIBLE, base::MayBlock()})),
+      bookkeeping_runner_(base::MakeRefCounted<vivaldi::BatchingTaskRunner>(
+          sequence_task_runner_,
+          kBookkeepingBatchDelay,
+          kBookkeepingBatchSize)) {}
 
 VivaldiImageStore::~VivaldiImageStore() {}
 
+// static
+VivaldiImageStore::FileVersion VivaldiImageStore::GetFileVersion(
+    const base::FilePath& file_path) {
+  FileVersion version;
+  base::File::Info info;
+  if (base::GetFileInfo(file_path, &info)) {
+    version.last_modified = info.last_modified;
+    version.size = info.size;
+  }
+  return version;
+}
+
+VivaldiImageStore::DataCache::DataCache()
+    : cache_(Cache::NO_AUTO_EVICT) {}
+
+VivaldiImageStore::DataCache::~DataCache() = default;
+
+scoped_refptr<base::RefCountedMemory> VivaldiImageStore::DataCache::Get(
+    UrlKind url_kind,
+    const std::string& id,
+    const FileVersion& version) {
+  base::AutoLock lock(lock_);
+  auto i = cache_.Get(Key(url_kind, id));
+  if (i == cache_.end())
+    return nullptr;
+  if (i->second.version != version) {
+    EraseLocked(i);
+    return nullptr;
+  }
+  return i->second.data;
+}
+
+void VivaldiImageStore::DataCache::Put(
+    UrlKind url_kind,
+    const std::string& id,
+    scoped_refptr<base::RefCountedMemory> data,
+    uint64_t removal_count,
+    const FileVersion& version) {
+  if (!data || data->size() > kDataCacheMaxEntryBytes)
+    return;
+  base::AutoLock lock(lock_);
+  if (removal_count != removal_count_)
+    return;
+  Key key(url_kind, id);
+  auto i = cache_.Peek(key);
+  if (i != cache_.end()) {
+    EraseLocked(i);
+  }
+  total_bytes_ += data->size();
+  variants_[Key(url_kind, std::string(GetBaseCacheId(id)))].insert(id);
+  cache_.Put(std::move(key), Entry{std::move(data), version});
+  EvictToSizeLocked(kDataCacheMaxBytes);
+}
+
+bool VivaldiImageStore::DataCache::Contains(UrlKind url_kind,
+                                            const std::string& id) {
+  base::AutoLock lock(lock_);
+  return cache_.Peek(Key(url_kind, id)) != cache_.end();
+}
+
+uint64_t VivaldiImageStore::DataCache::GetRemovalCount() {
+  base::AutoLock lock(lock_);
+  return removal_count_;
+}
+
+void VivaldiImageStore::DataCache::Remove(UrlKind url_kind,
+                                          const std::string& id) {
+  base::AutoLock lock(lock_);
+  removal_count_++;
+  auto variants = variants_.find(Key(url_kind, id));
+  if (variants == variants_.end())
+    return;
+  // EraseLocked() updates variants_, so iterate over a copy.
+  base::flat_set<std::string> cache_ids = variants->second;
+  for (const std::string& cache_id : cache_ids) {
+    auto i = cache_.Peek(Key(url_kind, cache_id));
+    if (i != cache_.end()) {
+      EraseLocked(i);
+    }
+  }
+}
+
+void VivaldiImageStore::DataCache::RemoveUnused(
+    UrlKind url_kind,
+    const base::flat_set<std::string>& used) {
+  base::AutoLock lock(lock_);
+  removal_count_++;
+  for (auto i = cache_.begin(); i != cache_.end();) {
+    auto current = i++;
+    if (current->first.first == url_kind &&
+        !used.contains(GetBaseCacheId(current->first.second))) {
+      EraseLocked(current);
+    }
+  }
+}
+
+void VivaldiImageStore::DataCache::ShrinkToBytes(size_t max_bytes) {
+  base::AutoLock lock(lock_);
+  EvictToSizeLocked(max_bytes);
+}
+
+void VivaldiImageStore::DataCache::Clear() {
+  base::AutoLock lock(lock_);
+  cache_.Clear();
+  variants_.clear();
+  total_bytes_ = 0;
+}
+
+void VivaldiImageStore::DataCache::EraseLocked(Cache::iterator i) {
+  const Key& key = i->first;
+  auto variants =
+      variants_.find(Key(key.first, std::string(GetBaseCacheId(key.second))));
+  if (variants != variants_.end()) {
+    variants->second.erase(key.second);
+    if (variants->second.empty()) {
+      variants_.erase(variants);
+    }
+  }
+  total_bytes_ -= i->second.data->size();
+  cache_.Erase(i);
+}
+
+void VivaldiImageStore::DataCache::EvictToSizeLocked(size_t max_bytes) {
+  while (total_bytes_ > max_bytes && !cache_.empty()) {
+    EraseLocked(std::prev(cache_.end()));
+  }
+}
+
+void VivaldiImageStore::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  using Level = base::MemoryPressureListener::MemoryPressureLevel;
+  switch (memory_pressure_level) {
+    case Level::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case Level::MEMORY_PRESSURE_LEVEL_MODERATE:
+      // Keep the recently used part in the hope that it is for the visible
+      // Speed Dial.
+      data_cache_.ShrinkToBytes(kDataCacheMaxBytes / 4);
+      break;
+    case Level::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      data_cache_.Clear();
+      break;
+  }
+}
+
 void VivaldiImageStore::Start() {
   sequence_task_runner_->PostTask(
       FROM_HERE,
       base::BindOnce(&VivaldiImageStore::LoadMappingsOnFileThread, this));
 
+  sequence_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          &VivaldiImageStore::ScheduleStartupRemovalOfUnusedUrlDataOnFileThread,
+          this));
+}
+
+void VivaldiImageStore::ScheduleStartupRemovalOfUnusedUrlDataOnFileThread() {
+  DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+  unused_url_data_checked_ =
+      base::PathExists(GetUnusedUrlDataCheckedFilePath());
+  if (unused_url_data_checked_)
+    return;
+
   // Inline ScheduleRemovalOfUnusedUrlData here as it uses FromBrowserContext()
   // but that can not be used when the factory initializes the instance.
   ui_thread_runner_->PostDelayedTask(
@@ -278,10 +725,49 @@ void VivaldiImageStore::Start() {
       kDataUrlGCStartupDelay);
 }
 
+void VivaldiImageStore::MarkUrlDataMayBeUnused() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Only the first change since the last check needs to reach the file
+  // thread.
+  if (url_data_may_be_unused_)
+    return;
+  url_data_may_be_unused_ = true;
+  sequence_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&VivaldiImageStore::MarkUrlDataMayBeUnusedOnFileThread,
+                     this));
+}
+
+void VivaldiImageStore::MarkUrlDataMayBeUnusedOnFileThread() {
+  DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+  if (!unused_url_data_checked_)
+    return;
+  unused_url_data_checked_ = false;
+  if (!base::DeleteFile(GetUnusedUrlDataCheckedFilePath())) {
+    LOG(WARNING) << "Failed to remove " << GetUnusedUrlDataCheckedFilePath();
+  }
+}
+
 void VivaldiImageStore::LoadMappingsOnFileThread() {
+  TRACE_EVENT0("startup", "VivaldiImageStore::LoadMappingsOnFileThread");
   DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
   DCHECK(path_id_map_.empty());
 
+  // Allow path mapping reads to bypass the sequence however this function
+  // returns.
+  base::ScopedClosureRunner set_loaded(base::BindOnce(
+      [](std::atomic<bool>* loaded) { loaded->store(true); },
+      base::Unretained(&mappings_loaded_)));
+
+  LoadMappingSnapshotOnFileThread();
+  ReplayMappingJournalOnFileThread();
+}
+
+void VivaldiImageStore::LoadMappingSnapshotOnFileThread() {
+  TRACE_EVENT0("vivaldi",
+               "VivaldiImageStore::LoadMappingSnapshotOnFileThread");
+  DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+
   base::FilePath file_path = GetFileMappingFilePath();
   scoped_refptr<base::RefCountedMemory> data =
       vivaldi_data_url_utils::ReadFileOnBlockingThread(file_path,
@@ -309,6 +795,7 @@ void VivaldiImageStore::InitMappingsOnFileThread(base::Value::Dict& mappings) {
   DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
   DCHECK(path_id_map_.empty());
 
+  base::AutoLock lock(path_id_map_lock_);
   for (auto i : mappings) {
     const std::string& id = i.first;
     if (vivaldi_data_url_utils::isOldFormatThumbnailId(id)) {
@@ -322,12 +809,7 @@ void VivaldiImageStore::InitMappingsOnFileThread(base::Value::Dict& mappings) {
         path_string = dict->FindString("relative_path");
       }
       if (path_string) {
-#if BUILDFLAG(IS_POSIX)
-        base::FilePath path(*path_string);
-#elif BUILDFLAG(IS_WIN)
-        base::FilePath path(base::UTF8ToWide(*path_string));
-#endif
-        path_id_map_.emplace(id, std::move(path));
+        path_id_map_.emplace(id, MappingPathFromString(*path_string));
         continue;
       }
     }
@@ -336,6 +818,77 @@ void VivaldiImageStore::InitMappingsOnFileThread(base::Value::Dict& mappings) {
   }
 }
 
+void VivaldiImageStore::ReplayMappingJournalOnFileThread() {
+  TRACE_EVENT0("vivaldi",
+               "VivaldiImageStore::ReplayMappingJournalOnFileThread");
+  DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+
+  base::FilePath journal_path = GetMappingJournalFilePath();
+  scoped_refptr<base::RefCountedMemory> data =
+      vivaldi_data_url_utils::ReadFileOnBlockingThread(journal_path,
+                                                       /*log_not_found=*/false);
+  if (!data)
+    return;
+
+  base::AutoLock lock(path_id_map_lock_);
+  for (base::StringPiece line : base::SplitStringPiece(
+           base::StringPiece(data->front_as<char>(), data->size()), "\n",
+           base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    journal_entries_++;
+    absl::optional<base::Value> record = base::JSONReader::Read(line);
+    const std::string* id = nullptr;
+    if (record && record->is_dict()) {
+      id = record->GetDict().FindString("id");
+    }
+    if (!id) {
+      // A crash while appending can leave the last line truncated.
+      LOG(WARNING) << "Invalid entry in \""
+                   << kDatasourceFilemappingJournalFilename << "\" file.";
+      continue;
+    }
+    if (const std::string* path_string =
+            record->GetDict().FindString("local_path")) {
+      path_id_map_.insert_or_assign(*id, MappingPathFromString(*path_string));
+    } else {
+      path_id_map_.erase(*id);
+    }
+  }
+}
+
+void VivaldiImageStore::AppendMappingsToJournalOnFileThread(
+    const MappingChanges& changes) {
+  DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+
+  journal_entries_ += changes.size();
+  if (journal_entries_ >
+      std::max(kMappingJournalCompactThreshold, path_id_map_.size())) {
+    SaveMappingsOnFileThread();
+    return;
+  }
+
+  std::string lines;
+  for (const auto& change : changes) {
+    base::Value::Dict record;
+    record.Set("id", change.first);
+    if (!change.second.empty()) {
+      record.Set("local_path", change.second.AsUTF16Unsafe());
+    }
+    std::string line;
+    base::JSONWriter::Write(record, &line);
+    lines += line;
+    lines += '\n';
+  }
+
+  base::FilePath journal_path = GetMappingJournalFilePath();
+  bool ok = base::PathExists(journal_path)
+                ? base::AppendToFile(journal_path, lines)
+                : base::WriteFile(journal_path, lines);
+  if (!ok) {
+    LOG(ERROR) << "Failed to append to " << journal_path.value();
+    SaveMappingsOnFileThread();
+  }
+}
+
 std::string VivaldiImageStore::GetMappingJSONOnFileThread() {
   DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
 
@@ -356,12 +909,12 @@ std::string VivaldiImageStore::GetMappingJSONOnFileThread() {
   root.Set("mappings", std::move(items));
 
   std::string json;
-  base::JSONWriter::WriteWithOptions(
-      root, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+  base::JSONWriter::Write(root, &json);
   return json;
 }
 
 void VivaldiImageStore::SaveMappingsOnFileThread() {
+  TRACE_EVENT0("vivaldi", "VivaldiImageStore::SaveMappingsOnFileThread");
   DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
 
   std::string json = GetMappingJSONOnFileThread();
@@ -370,6 +923,7 @@ void VivaldiImageStore::SaveMappingsOnFileThread() {
     if (!base::DeleteFile(path)) {
       LOG(ERROR) << "failed to delete " << path.value();
     }
+    DeleteMappingJournalOnFileThread();
     return;
   }
 
@@ -395,6 +949,21 @@ void VivaldiImageStore::SaveMappingsOnFileThread() {
   if (!base::ReplaceFile(tmp_path, path, nullptr)) {
     LOG(ERROR) << "Failed to rename " << tmp_path.value() << " to "
                << path.value();
+    return;
+  }
+
+  // The mapping file now contains all changes from the journal. If we crash
+  // before the journal is deleted, replaying it on the next start just repeats
+  // the changes that are already in the file.
+  DeleteMappingJournalOnFileThread();
+}
+
+void VivaldiImageStore::DeleteMappingJournalOnFileThread() {
+  DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+  journal_entries_ = 0;
+  base::FilePath journal_path = GetMappingJournalFilePath();
+  if (!base::DeleteFile(journal_path)) {
+    LOG(ERROR) << "failed to delete " << journal_path.value();
   }
 }
 
@@ -402,6 +971,19 @@ base::FilePath VivaldiImageStore::GetFileMappingFilePath() {
   return user_data_dir_.AppendASCII(kDatasourceFilemappingFilename);
 }
 
+base::FilePath VivaldiImageStore::GetMappingJournalFilePath() {
+  return user_data_dir_.AppendASCII(kDatasourceFilemappingJournalFilename);
+}
+
+base::FilePath VivaldiImageStore::GetUnusedUrlDataCheckedFilePath() {
+  return user_data_dir_.AppendASCII(kUnusedUrlDataCheckedFilename);
+}
+
+base::FilePath VivaldiImageStore::GetImageTierDirectory(int tier_width) {
+  return user_data_dir_.Append(kImageDirectory)
+      .AppendASCII("w" + base::NumberToString(tier_width));
+}
+
 base::FilePath VivaldiImageStore::GetImagePath(base::StringPiece image_id) {
   base::FilePath path = user_data_dir_.Append(kImageDirectory);
 #if BUILDFLAG(IS_POSIX)
@@ -437,10 +1019,14 @@ void VivaldiImageStore::FindUsedUrlsOnUIThread() {
 
 void VivaldiImageStore::FindUsedUrlsOnUIThreadWithLoadedBookmaks(
     bookmarks::BookmarkModel* bookmark_model) {
+  TRACE_EVENT0("vivaldi", "VivaldiImageStore::FindUsedUrlsOnUIThread");
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   if (!profile_ || !bookmark_model)
     return;
 
+  // Changes from now on are not seen by this check.
+  url_data_may_be_unused_ = false;
+
   UrlKind url_kind;
   std::string id;
   UsedIds used_ids;
@@ -480,9 +1066,16 @@ void VivaldiImageStore::FindUsedUrlsOnUIThreadWithLoadedBookmaks(
 }
 
 void VivaldiImageStore::RemoveUnusedUrlDataOnFileThread(UsedIds used_ids) {
+  TRACE_EVENT0("vivaldi",
+               "VivaldiImageStore::RemoveUnusedUrlDataOnFileThread");
   static_assert(kUrlKindCount == 2, "The code supports 2 url kinds");
   DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
 
+  // Data for newborn urls is not referenced yet. It becomes unused if the
+  // browser exits before it is, so a later check is still needed. The same
+  // applies when some unused file could not be removed.
+  bool checked = file_thread_newborn_urls_.empty();
+
   // Add newly allocated ids that have not been stored in bookmarks or
   // preferences yet.
   UrlKind url_kind;
@@ -496,20 +1089,24 @@ void VivaldiImageStore::RemoveUnusedUrlDataOnFileThread(UsedIds used_ids) {
   base::flat_set<std::string> used_path_mapping_set(
       std::move(used_ids[kPathMappingUrl]));
 
-  size_t removed_path_mappings = 0;
-  for (auto i = path_id_map_.begin(); i != path_id_map_.end();) {
-    // Update the iterator before the following erase call.
-    auto current = i;
-    i++;
-    if (!used_path_mapping_set.contains(current->first)) {
-      path_id_map_.erase(current);
-      removed_path_mappings++;
+  MappingChanges removed_path_mappings;
+  {
+    base::AutoLock lock(path_id_map_lock_);
+    for (auto i = path_id_map_.begin(); i != path_id_map_.end();) {
+      // Update the iterator before the following erase call.
+      auto current = i;
+      i++;
+      if (!used_path_mapping_set.contains(current->first)) {
+        removed_path_mappings.emplace_back(current->first, base::FilePath());
+        path_id_map_.erase(current);
+      }
     }
   }
-  if (removed_path_mappings) {
-    LOG(INFO) << removed_path_mappings
+  data_cache_.RemoveUnused(kPathMappingUrl, used_path_mapping_set);
+  if (!removed_path_mappings.empty()) {
+    LOG(INFO) << removed_path_mappings.size()
               << " unused local path mappings were removed";
-    SaveMappingsOnFileThread();
+    AppendMappingsToJournalOnFileThread(removed_path_mappings);
   }
 
   base::flat_set<std::string> used_image_set(std::move(used_ids[kImageUrl]));
@@ -522,17 +1119,40 @@ void VivaldiImageStore::RemoveUnusedUrlDataOnFileThread(UsedIds used_ids) {
     if (!used_image_set.contains(id)) {
       if (!base::DeleteFile(path)) {
         LOG(WARNING) << "Failed to remove the image file " << path;
+        checked = false;
       }
       removed_images++;
     }
   }
+  for (int tier_width : kImageTierWidths) {
+    base::FileEnumerator tier_files(GetImageTierDirectory(tier_width), false,
+                                    base::FileEnumerator::FILES);
+    for (base::FilePath path = tier_files.Next(); !path.empty();
+         path = tier_files.Next()) {
+      if (!used_image_set.contains(path.BaseName().AsUTF8Unsafe())) {
+        if (!base::DeleteFile(path)) {
+          LOG(WARNING) << "Failed to remove the image tier file " << path;
+          checked = false;
+        }
+      }
+    }
+  }
+  // Drop the cached data only after the files are gone so a read that is
+  // still in flight cannot add it back.
+  data_cache_.RemoveUnused(kImageUrl, used_image_set);
   if (removed_images) {
     LOG(INFO) << removed_images << " unreferenced image files were removed";
   }
+
+  if (checked && !unused_url_data_checked_) {
+    unused_url_data_checked_ =
+        base::WriteFile(GetUnusedUrlDataCheckedFilePath(), base::StringPiece());
+  }
 }
 
 void VivaldiImageStore::AddNewbornUrlOnFileThread(base::StringPiece data_url) {
   DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+  MarkUrlDataMayBeUnusedOnFileThread();
   file_thread_newborn_urls_.push_back(
       std::string(data_url.data(), data_url.size()));
 }
@@ -540,7 +1160,8 @@ void VivaldiImageStore::AddNewbornUrlOnFileThread(base::StringPiece data_url) {
 void VivaldiImageStore::ForgetNewbornUrl(std::string data_url) {
   if (data_url.empty())
     return;
-  sequence_task_runner_->PostTask(
+  // A delayed forget only keeps the url data from removal a bit longer.
+  bookkeeping_runner_->PostTask(
       FROM_HERE,
       base::BindOnce(&VivaldiImageStore::ForgetNewbornUrlOnFileThread, this,
                      std::move(data_url)));
@@ -583,6 +1204,7 @@ void VivaldiImageStore::UpdateMappingOnFileThread(ImagePlace place,
                                                   ImageFormat format,
                                                   base::FilePath file_path,
                                                   StoreImageCallback callback) {
+  TRACE_EVENT0("vivaldi", "VivaldiImageStore::UpdateMappingOnFileThread");
   DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
   DCHECK(format == FindFormatForPath(file_path));
 
@@ -599,16 +1221,23 @@ void VivaldiImageStore::UpdateMappingOnFileThread(ImagePlace place,
       vivaldi_data_url_utils::PathType::kLocalPath, path_id);
   AddNewbornUrlOnFileThread(data_url);
 
+  // The user may have changed the file since we cached it, so re-read it on
+  // the next request.
+  data_cache_.Remove(kPathMappingUrl, path_id);
+
   // inserted is false when file_path points to an already existing mapping.
-  bool inserted =
-      path_id_map_.emplace(std::move(path_id), std::move(file_path)).second;
+  bool inserted;
+  {
+    base::AutoLock lock(path_id_map_lock_);
+    inserted = path_id_map_.emplace(path_id, file_path).second;
+  }
 
   ui_thread_runner_->PostTask(
       FROM_HERE, base::BindOnce(&VivaldiImageStore::FinishStoreImageOnUIThread,
                                 this, std::move(callback), std::move(place),
                                 std::move(data_url)));
   if (inserted) {
-    SaveMappingsOnFileThread();
+    AppendMappingsToJournalOnFileThread({{path_id, file_path}});
   }
 }
 
@@ -645,7 +1274,8 @@ void VivaldiImageStore::GetDataForId(
     content::BrowserContext* browser_context,
     UrlKind url_kind,
     std::string id,
-    content::URLDataSource::GotDataCallback callback) {
+    content::URLDataSource::GotDataCallback callback,
+    int requested_width) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
   VivaldiImageStore* api = FromBrowserContext(browser_context);
@@ -654,44 +1284,262 @@ void VivaldiImageStore::GetDataForId(
     std::move(callback).Run(nullptr);
     return;
   }
-  api->GetDataForId(url_kind, std::move(id), std::move(callback));
+  if (int width = GetDisplaySizedWidth(requested_width)) {
+    api->GetDisplaySizedDataForId(url_kind, std::move(id), width,
+                                  std::move(callback));
+    return;
+  }
+  api->GetDataForId(url_kind, std::move(id), std::move(callback),
+                    requested_width);
 }
 
-void VivaldiImageStore::GetDataForId(
+// static
+int VivaldiImageStore::GetDisplaySizedWidth(int requested_width) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Smaller requests are for thumbnails that use the stored tiers.
+  if (requested_width <= kBookmarkThumbnailWidth)
+    return 0;
+  int width = (requested_width + kDisplaySizedWidthStep - 1) /
+              kDisplaySizedWidthStep * kDisplaySizedWidthStep;
+  int max_display_width = 0;
+  if (display::Screen* screen = display::Screen::GetScreen()) {
+    for (const display::Display& display : screen->GetAllDisplays()) {
+      max_display_width =
+          std::max(max_display_width, display.GetSizeInPixel().width());
+    }
+  }
+  if (max_display_width > 0) {
+    width = std::min(width, max_display_width);
+  }
+  return width;
+}
+
+// static
+void VivaldiImageStore::ScaleImageToWidth(
+    scoped_refptr<base::RefCountedMemory> data,
+    int width,
+    content::URLDataSource::GotDataCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!data || width <= 0) {
+    std::move(callback).Run(std::move(data));
+    return;
+  }
+  // Backgrounds come from user files and imported themes, so decode them in
+  // the sandboxed data decoder.
+  base::span<const uint8_t> bytes(data->front(), data->size());
+  data_decoder::DecodeImageIsolated(
+      bytes, data_decoder::mojom::ImageCodec::kDefault,
+      /*shrink_to_fit=*/false, data_decoder::kDefaultMaxSizeInBytes,
+      gfx::Size(),
+      base::BindOnce(&OnImageDecodedForScaling, data, width,
+                     std::move(callback)));
+}
+
+void VivaldiImageStore::GetDisplaySizedDataForId(
     UrlKind url_kind,
     std::string id,
+    int width,
     content::URLDataSource::GotDataCallback callback) {
-  sequence_task_runner_->PostTaskAndReplyWithResult(
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (url_kind == kPathMappingUrl) {
+    // The mapped file can be changed outside the browser, so check the
+    // cached variant against the current version of the file.
+    base::OnceCallback<FileVersion()> task = base::BindOnce(
+        [](scoped_refptr<VivaldiImageStore> api, std::string id) {
+          return GetFileVersion(api->GetFilePathForMappingId(id));
+        },
+        base::WrapRefCounted(this), id);
+    base::OnceCallback<void(FileVersion)> reply = base::BindOnce(
+        &VivaldiImageStore::GetDisplaySizedDataForVersion, this, url_kind,
+        std::move(id), width, std::move(callback));
+    if (mappings_loaded_.load()) {
+      base::ThreadPool::PostTaskAndReplyWithResult(
+          FROM_HERE, {base::TaskPriority::USER_VISIBLE, base::MayBlock()},
+          std::move(task), std::move(reply));
+    } else {
+      sequence_task_runner_->PostTaskAndReplyWithResult(
+          FROM_HERE, std::move(task), std::move(reply));
+    }
+    return;
+  }
+  GetDisplaySizedDataForVersion(url_kind, std::move(id), width,
+                                std::move(callback), FileVersion());
+}
+
+void VivaldiImageStore::GetDisplaySizedDataForVersion(
+    UrlKind url_kind,
+    std::string id,
+    int width,
+    content::URLDataSource::GotDataCallback callback,
+    FileVersion version) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  std::string cache_id = GetDisplaySizedCacheId(id, width);
+  if (scoped_refptr<base::RefCountedMemory> data =
+          data_cache_.Get(url_kind, cache_id, version)) {
+    std::move(callback).Run(std::move(data));
+    return;
+  }
+  content::URLDataSource::GotDataCallback cache_callback = base::BindOnce(
+      [](scoped_refptr<VivaldiImageStore> api, UrlKind url_kind,
+         std::string cache_id, uint64_t removal_count, FileVersion version,
+         content::URLDataSource::GotDataCallback callback,
+         scoped_refptr<base::RefCountedMemory> data) {
+        api->data_cache_.Put(url_kind, cache_id, data, removal_count,
+                             version);
+        std::move(callback).Run(std::move(data));
+      },
+      base::WrapRefCounted(this), url_kind, std::move(cache_id),
+      data_cache_.GetRemovalCount(), version, std::move(callback));
+  GetDataForId(url_kind, std::move(id),
+               base::BindOnce(
+                   [](int width,
+                      content::URLDataSource::GotDataCallback callback,
+                      scoped_refptr<base::RefCountedMemory> data) {
+                     ScaleImageToWidth(std::move(data), width,
+                                       std::move(callback));
+                   },
+                   width, std::move(cache_callback)));
+}
+
+// static
+void VivaldiImageStore::GetFilePathForMapping(
+    content::BrowserContext* browser_context,
+    std::string id,
+    content::URLDataSource::GotFilePathCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  VivaldiImageStore* api = FromBrowserContext(browser_context);
+  DCHECK(api);
+  if (!api || api->data_cache_.Contains(kPathMappingUrl, id)) {
+    std::move(callback).Run(base::FilePath());
+    return;
+  }
+  if (api->mappings_loaded_.load()) {
+    std::move(callback).Run(api->GetFilePathForMappingId(id));
+    return;
+  }
+  api->sequence_task_runner_->PostTaskAndReplyWithResult(
       FROM_HERE,
-      base::BindOnce(&VivaldiImageStore::GetDataForIdOnFileThread, this,
-                     url_kind, std::move(id)),
+      base::BindOnce(&VivaldiImageStore::GetFilePathForMappingId, api,
+                     std::move(id)),
       std::move(callback));
 }
 
-scoped_refptr<base::RefCountedMemory>
-VivaldiImageStore::GetDataForIdOnFileThread(UrlKind url_kind, std::string id) {
-  DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+base::FilePath VivaldiImageStore::GetFilePathForId(UrlKind url_kind,
+                                                   const std::string& id) {
+  if (url_kind == kImageUrl)
+    return GetImagePath(id);
+  DCHECK(url_kind == kPathMappingUrl);
+  if (!mappings_loaded_.load())
+    return base::FilePath();
+  return GetFilePathForMappingId(id);
+}
 
+base::FilePath VivaldiImageStore::GetFilePathForMappingId(
+    const std::string& id) {
+  base::AutoLock lock(path_id_map_lock_);
+  auto it = path_id_map_.find(id);
+  if (it == path_id_map_.end())
+    return base::FilePath();
+  base::FilePath file_path = it->second;
+  if (!file_path.IsAbsolute()) {
+    file_path = user_data_dir_.Append(file_path);
+  }
+  return file_path;
+}
+
+// static
+int VivaldiImageStore::FindImageTierWidth(int requested_width) {
+  if (requested_width <= 0)
+    return 0;
+  for (int tier_width : kImageTierWidths) {
+    if (tier_width >= requested_width)
+      return tier_width;
+  }
+  return 0;
+}
+
+void VivaldiImageStore::GetDataForId(
+    UrlKind url_kind,
+    std::string id,
+    content::URLDataSource::GotDataCallback callback,
+    int requested_width) {
+  int tier_width = 0;
+  if (url_kind == kImageUrl) {
+    // Stored images never change, so the cache can be checked without
+    // touching the disk. Path mappings are checked on the file thread against
+    // the current version of the file.
+    tier_width = FindImageTierWidth(requested_width);
+    scoped_refptr<base::RefCountedMemory> cached_data = data_cache_.Get(
+        url_kind, tier_width ? GetTierCacheId(id, tier_width) : id);
+    base::UmaHistogramBoolean("Vivaldi.ImageStore.CacheHit", !!cached_data);
+    if (cached_data) {
+      std::move(callback).Run(std::move(cached_data));
+      return;
+    }
+  }
+  base::OnceCallback<scoped_refptr<base::RefCountedMemory>()> task =
+      base::BindOnce(&VivaldiImageStore::GetDataForIdOnFileThread, this,
+                     url_kind, std::move(id), tier_width);
+
+  // Files for kImageUrl are named after the hash of their content and never
+  // change so they can be read in parallel with anything else. Path mappings
+  // must wait until the mapping file is loaded.
+  if (url_kind == kImageUrl || mappings_loaded_.load()) {
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE, base::MayBlock()},
+        std::move(task), std::move(callback));
+  } else {
+    sequence_task_runner_->PostTaskAndReplyWithResult(
+        FROM_HERE, std::move(task), std::move(callback));
+  }
+}
+
+scoped_refptr<base::RefCountedMemory>
+VivaldiImageStore::GetDataForIdOnFileThread(UrlKind url_kind,
+                                            std::string id,
+                                            int tier_width) {
+  TRACE_EVENT0("vivaldi", "VivaldiImageStore::GetDataForIdOnFileThread");
+  base::ElapsedTimer timer;
+  uint64_t removal_count = data_cache_.GetRemovalCount();
   base::FilePath file_path;
   if (url_kind == kImageUrl) {
+    if (tier_width) {
+      // Tiers exist only for thumbnails stored with StoreMode::kThumbnail.
+      std::string cache_id = GetTierCacheId(id, tier_width);
+      scoped_refptr<base::RefCountedMemory> data =
+          vivaldi_data_url_utils::ReadFileOnBlockingThread(
+              GetImageTierDirectory(tier_width).AppendASCII(id),
+              /*log_not_found=*/false);
+      if (data) {
+        data_cache_.Put(url_kind, cache_id, data, removal_count);
+        base::UmaHistogramTimes("Vivaldi.ImageStore.ReadTime",
+                                timer.Elapsed());
+        return data;
+      }
+    }
     file_path = GetImagePath(id);
   } else {
     DCHECK(url_kind == kPathMappingUrl);
 
     // It is not an error if id is not in the map. The IO thread may not
     // be aware yet that the id was removed when it called this.
-    auto it = path_id_map_.find(id);
-    if (it != path_id_map_.end()) {
-      file_path = it->second;
-      if (!file_path.IsAbsolute()) {
-        file_path = user_data_dir_.Append(file_path);
-      }
-    }
+    file_path = GetFilePathForMappingId(id);
   }
 
   scoped_refptr<base::RefCountedMemory> data;
   if (!file_path.empty()) {
+    FileVersion version;
+    if (url_kind == kPathMappingUrl) {
+      version = GetFileVersion(file_path);
+      data = data_cache_.Get(url_kind, id, version);
+      base::UmaHistogramBoolean("Vivaldi.ImageStore.CacheHit", !!data);
+      if (data)
+        return data;
+    }
     data = vivaldi_data_url_utils::ReadFileOnBlockingThread(file_path);
+    data_cache_.Put(url_kind, id, data, removal_count, version);
+    base::UmaHistogramTimes("Vivaldi.ImageStore.ReadTime", timer.Elapsed());
   }
 
   return data;
@@ -709,15 +1557,162 @@ void VivaldiImageStore::CaptureBookmarkThumbnail(
     std::move(ui_thread_callback).Run(false);
     return;
   }
+  api->StartBookmarkCapture(bookmark_id, url, std::move(ui_thread_callback));
+}
+
+void VivaldiImageStore::StartBookmarkCapture(
+    int64_t bookmark_id,
+    const GURL& url,
+    StoreImageCallback ui_thread_callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  DCHECK(profile_);
   ImagePlace place;
   place.SetBookmarkId(bookmark_id);
   ::vivaldi::ThumbnailCaptureContents::Capture(
-      browser_context, url,
-      gfx::Size(kOffscreenWindowWidth, kOffscreenWindowHeight),
+      profile_, url, gfx::Size(kOffscreenWindowWidth, kOffscreenWindowHeight),
       gfx::Size(kBookmarkThumbnailWidth, kBookmarkThumbnailHeight),
-      base::BindOnce(&VivaldiImageStore::StoreImageUIThread, api,
+      base::BindOnce(&VivaldiImageStore::StoreImageUIThread, this,
                      std::move(place), std::move(ui_thread_callback),
-                     ImageFormat::kPNG));
+                     ImageFormat::kPNG, StoreMode::kThumbnail));
+}
+
+// Helper to run a batch of bookmark captures with bounded concurrency. It
+// lives on UI thread and deletes itself when all captures are done.
+class VivaldiImageStore::CaptureBatch {
+ public:
+  CaptureBatch(scoped_refptr<VivaldiImageStore> api,
+               std::vector<BookmarkCaptureItem> items,
+               size_t max_concurrency,
+               StartCaptureCallback start_capture,
+               CaptureProgressCallback progress_callback,
+               base::OnceClosure done_callback)
+      : api_(std::move(api)),
+        items_(std::move(items)),
+        max_concurrency_(std::max<size_t>(max_concurrency, 1)),
+        start_capture_(std::move(start_capture)),
+        progress_callback_(std::move(progress_callback)),
+        done_callback_(std::move(done_callback)) {}
+  CaptureBatch(const CaptureBatch&) = delete;
+  CaptureBatch& operator=(const CaptureBatch&) = delete;
+
+  void Pump() {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    pump_scheduled_ = false;
+    // A capture can report back before start_capture_ returns. OnItemDone()
+    // then leaves starting the next one to this loop rather than nesting
+    // another Pump() that could delete this under the loop.
+    in_pump_ = true;
+    while (active_ < max_concurrency_ && next_ < items_.size()) {
+      if (!api_->profile_) {
+        // Shutdown started, report the rest as failed.
+        const BookmarkCaptureItem& item = items_[next_++];
+        progress_callback_.Run(item.bookmark_id, false);
+        continue;
+      }
+      if (IsUnderMemoryPressure()) {
+        // Let the running captures finish first. If nothing runs, retry
+        // later.
+        if (active_ == 0) {
+          SchedulePump(kMemoryPressureBackoff);
+        }
+        break;
+      }
+      const BookmarkCaptureItem& item = items_[next_++];
+      active_++;
+      // base::Unretained() is safe as we delete this only after all started
+      // captures report back.
+      start_capture_.Run(
+          item.bookmark_id, item.url,
+          base::BindOnce(&CaptureBatch::OnItemDone, base::Unretained(this),
+                         item.bookmark_id));
+    }
+    in_pump_ = false;
+    if (active_ == 0 && next_ == items_.size() && !pump_scheduled_) {
+      std::move(done_callback_).Run();
+      delete this;
+    }
+  }
+
+ private:
+  static constexpr base::TimeDelta kMemoryPressureBackoff = base::Seconds(5);
+
+  static bool IsUnderMemoryPressure() {
+    base::MemoryPressureMonitor* monitor = base::MemoryPressureMonitor::Get();
+    if (!monitor)
+      return false;
+    return monitor->GetCurrentPressureLevel() !=
+           base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE;
+  }
+
+  void SchedulePump(base::TimeDelta delay) {
+    pump_scheduled_ = true;
+    api_->ui_thread_runner_->PostDelayedTask(
+        FROM_HERE,
+        base::BindOnce(&CaptureBatch::Pump, base::Unretained(this)), delay);
+  }
+
+  void OnItemDone(int64_t bookmark_id, bool success) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    DCHECK_GT(active_, 0u);
+    active_--;
+    progress_callback_.Run(bookmark_id, success);
+    if (!pump_scheduled_ && !in_pump_) {
+      Pump();
+    }
+  }
+
+  const scoped_refptr<VivaldiImageStore> api_;
+  const std::vector<BookmarkCaptureItem> items_;
+  const size_t max_concurrency_;
+  const StartCaptureCallback start_capture_;
+  CaptureProgressCallback progress_callback_;
+  base::OnceClosure done_callback_;
+
+  // Index of the next item to start.
+  size_t next_ = 0;
+
+  // Number of started but not yet finished captures.
+  size_t active_ = 0;
+
+  bool pump_scheduled_ = false;
+  bool in_pump_ = false;
+};
+
+// static
+void VivaldiImageStore::CaptureBookmarkThumbnails(
+    content::BrowserContext* browser_context,
+    std::vector<BookmarkCaptureItem> items,
+    size_t max_concurrency,
+    CaptureProgressCallback progress_callback,
+    base::OnceClosure done_callback) {
+  VivaldiImageStore* api = FromBrowserContext(browser_context);
+  DCHECK(api);
+  if (!api) {
+    for (const BookmarkCaptureItem& item : items) {
+      progress_callback.Run(item.bookmark_id, false);
+    }
+    std::move(done_callback).Run();
+    return;
+  }
+  // base::Unretained() is safe as the batch keeps a reference to api.
+  api->RunCaptureBatch(
+      std::move(items), max_concurrency,
+      base::BindRepeating(&VivaldiImageStore::StartBookmarkCapture,
+                          base::Unretained(api)),
+      std::move(progress_callback), std::move(done_callback));
+}
+
+void VivaldiImageStore::RunCaptureBatch(
+    std::vector<BookmarkCaptureItem> items,
+    size_t max_concurrency,
+    StartCaptureCallback start_capture,
+    CaptureProgressCallback progress_callback,
+    base::OnceClosure done_callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  CaptureBatch* batch = new CaptureBatch(
+      this, std::move(items), max_concurrency, std::move(start_capture),
+      std::move(progress_callback), std::move(done_callback));
+  batch->Pump();
 }
 
 // static
@@ -726,7 +1721,8 @@ void VivaldiImageStore::StoreImage(
     ImagePlace place,
     ImageFormat format,
     scoped_refptr<base::RefCountedMemory> image_data,
-    StoreImageCallback callback) {
+    StoreImageCallback callback,
+    StoreMode store_mode) {
   VivaldiImageStore* api = FromBrowserContext(browser_context);
   DCHECK(api);
   if (!api) {
@@ -735,39 +1731,59 @@ void VivaldiImageStore::StoreImage(
   }
 
   api->StoreImageUIThread(std::move(place), std::move(callback), format,
-                          std::move(image_data));
+                          store_mode, std::move(image_data));
 }
 
 void VivaldiImageStore::StoreImageUIThread(
     ImagePlace place,
     StoreImageCallback ui_thread_callback,
     ImageFormat format,
+    StoreMode store_mode,
     scoped_refptr<base::RefCountedMemory> image_data) {
   StoreImageData(
       format, std::move(image_data),
       base::BindOnce(&VivaldiImageStore::FinishStoreImageOnUIThread, this,
-                     std::move(ui_thread_callback), std::move(place)));
+                     std::move(ui_thread_callback), std::move(place)),
+      store_mode);
 }
 
 void VivaldiImageStore::StoreImageData(
     ImageFormat format,
     scoped_refptr<base::RefCountedMemory> image_data,
-    StoreImageDataResult callback) {
+    StoreImageDataResult callback,
+    StoreMode store_mode) {
   sequence_task_runner_->PostTaskAndReplyWithResult(
       FROM_HERE,
       base::BindOnce(&VivaldiImageStore::StoreImageDataOnFileThread, this,
-                     format, std::move(image_data)),
+                     format, store_mode, std::move(image_data)),
       std::move(callback));
 }
 
 std::string VivaldiImageStore::StoreImageDataOnFileThread(
     ImageFormat format,
+    StoreMode store_mode,
     scoped_refptr<base::RefCountedMemory> image_data) {
+  TRACE_EVENT1("vivaldi", "VivaldiImageStore::StoreImageDataOnFileThread",
+               "size", image_data ? image_data->size() : 0);
   DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
 
   if (!image_data || !image_data->size())
     return std::string();
 
+  SkBitmap bitmap;
+  if (store_mode == StoreMode::kThumbnail) {
+    if (DecodeThumbnail(format, *image_data, &bitmap)) {
+      if (scoped_refptr<base::RefCountedMemory> webp =
+              EncodeThumbnailAsWebP(bitmap)) {
+        image_data = std::move(webp);
+        format = ImageFormat::kWEBP;
+      }
+    } else {
+      LOG(WARNING) << "Failed to decode thumbnail, storing it as is";
+      bitmap.reset();
+    }
+  }
+
   std::string image_id =
       HashDataToFileName(image_data->data(), image_data->size());
   image_id += '.';
@@ -787,16 +1803,66 @@ std::string VivaldiImageStore::StoreImageDataOnFileThread(
     return data_url;
   }
 
-  // The caller must ensure that data fit 2G.
-  int bytes = base::WriteFile(path, image_data->front_as<char>(),
-                              static_cast<int>(image_data->size()));
-  if (bytes < 0 || static_cast<size_t>(bytes) != image_data->size()) {
+  // The file may have been removed from the disk outside the browser and the
+  // cache may still hold the old data. This also drops the cached tiers of the
+  // image.
+  data_cache_.Remove(kImageUrl, image_id);
+
+  if (LinkImageFromOtherProfile(user_data_dir_, path, image_data->size())) {
+    if (!bitmap.drawsNothing()) {
+      StoreImageTiersOnFileThread(image_id, bitmap);
+    }
+    return data_url;
+  }
+
+  // Reads run in parallel with this, so write via a temporary file to never
+  // expose a partially written image.
+  if (!base::ImportantFileWriter::WriteFileAtomically(
+          path, base::StringPiece(image_data->front_as<char>(),
+                                  image_data->size()))) {
     LOG(ERROR) << "Error writing to file: " << path.value();
     return std::string();
   }
+  if (!bitmap.drawsNothing()) {
+    StoreImageTiersOnFileThread(image_id, bitmap);
+  }
   return data_url;
 }
 
+void VivaldiImageStore::StoreImageTiersOnFileThread(const std::string& image_id,
+                                                    const SkBitmap& bitmap) {
+  DCHECK(sequence_task_runner_->RunsTasksInCurrentSequence());
+
+  // Go from the widest tier down and scale each tier from the previous one.
+  // The filter cost grows with the source size, so this avoids resampling the
+  // full capture for every tier.
+  SkBitmap source = bitmap;
+  for (int tier_width : base::Reversed(kImageTierWidths)) {
+    if (bitmap.width() <= tier_width)
+      continue;
+    int tier_height = std::max(
+        1, static_cast<int>(static_cast<int64_t>(bitmap.height()) * tier_width /
+                            bitmap.width()));
+    SkBitmap scaled = skia::ImageOperations::Resize(
+        source, skia::ImageOperations::RESIZE_GOOD, tier_width, tier_height);
+    source = scaled;
+    scoped_refptr<base::RefCountedMemory> data = EncodeThumbnailAsWebP(scaled);
+    if (!data)
+      continue;
+
+    base::FilePath dir = GetImageTierDirectory(tier_width);
+    if (!base::DirectoryExists(dir)) {
+      base::CreateDirectory(dir);
+    }
+    base::FilePath path = dir.AppendASCII(image_id);
+    if (!base::ImportantFileWriter::WriteFileAtomically(
+            path,
+            base::StringPiece(data->front_as<char>(), data->size()))) {
+      LOG(ERROR) << "Error writing to file: " << path.value();
+    }
+  }
+}
+
 bookmarks::BookmarkModel* VivaldiImageStore::GetBookmarkModel() {
   if (!profile_)
     return nullptr;
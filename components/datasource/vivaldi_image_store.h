@@ -3,16 +3,25 @@
 #ifndef COMPONENTS_DATASOURCE_VIVALDI_IMAGE_STORE_H_
 #define COMPONENTS_DATASOURCE_VIVALDI_IMAGE_STORE_H_
 
+#include <atomic>
 #include <map>
 #include <string>
 
+#include "base/containers/flat_set.h"
+#include "base/containers/lru_cache.h"
 #include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
 #include "content/public/browser/url_data_source.h"
+#include "url/gurl.h"
 
 class Profile;
+class SkBitmap;
 
 namespace bookmarks {
 class BookmarkModel;
@@ -22,6 +31,10 @@ namespace content {
 class BrowserContext;
 }
 
+namespace vivaldi {
+class BatchingTaskRunner;
+}
+
 class VivaldiImageStoreHolder;
 
 // This is used to setup and control the mapping between local images and the
@@ -51,6 +64,16 @@ class VivaldiImageStore : public base::RefCountedThreadSafe<VivaldiImageStore> {
   static constexpr int kImageFormatCount =
       static_cast<int>(ImageFormat::kWEBP) + 1;
 
+  // How to process the image data before storing it.
+  enum class StoreMode {
+    // Store the data as is.
+    kOriginal,
+
+    // Re-encode PNG or JPEG data as lossy WebP and store downscaled tiers
+    // that can be requested with the size parameter of the data url.
+    kThumbnail,
+  };
+
   // Location where to store or update the image.
   class ImagePlace {
    public:
@@ -154,7 +177,8 @@ class VivaldiImageStore : public base::RefCountedThreadSafe<VivaldiImageStore> {
                          ImagePlace place,
                          ImageFormat format,
                          scoped_refptr<base::RefCountedMemory> image_data,
-                         StoreImageCallback callback);
+                         StoreImageCallback callback,
+                         StoreMode store_mode = StoreMode::kOriginal);
 
   // Capture the url and store the resulting image as a thumbnail for the given
   // bookmark.
@@ -163,15 +187,76 @@ class VivaldiImageStore : public base::RefCountedThreadSafe<VivaldiImageStore> {
                                        const GURL& url,
                                        StoreImageCallback ui_thread_callback);
 
+  struct BookmarkCaptureItem {
+    int64_t bookmark_id = 0;
+    GURL url;
+  };
+
+  // Callback to report the result for each item of the batch capture.
+  using CaptureProgressCallback =
+      base::RepeatingCallback<void(int64_t bookmark_id, bool success)>;
+
+  // Capture thumbnails for many bookmarks running at most max_concurrency
+  // captures at the same time. New captures are not started while the system
+  // is under memory pressure. All callbacks are called on UI thread.
+  static void CaptureBookmarkThumbnails(
+      content::BrowserContext* browser_context,
+      std::vector<BookmarkCaptureItem> items,
+      size_t max_concurrency,
+      CaptureProgressCallback progress_callback,
+      base::OnceClosure done_callback);
+
+  // Find the width of the stored downscaled tier that is suitable for showing
+  // the image with the given width in pixels. Return 0 when the original
+  // image should be used.
+  static int FindImageTierWidth(int requested_width);
+
+  // Read data for the given UrlKind on UI thread. Requests wider than a
+  // thumbnail get the display-sized variant, see GetDisplaySizedWidth().
   static void GetDataForId(content::BrowserContext* browser_context,
                            UrlKind url_kind,
                            std::string id,
-                           content::URLDataSource::GotDataCallback callback);
-
-  // Read data for the given UrlKind. This can be called from any thread.
+                           content::URLDataSource::GotDataCallback callback,
+                           int requested_width = 0);
+
+  // Return the width of the display-sized variant to serve for a request of
+  // an image with the given width or 0 when the request is for a thumbnail.
+  // The width is rounded up to limit the number of variants and does not
+  // exceed the widest display. This must be called on UI thread.
+  static int GetDisplaySizedWidth(int requested_width);
+
+  // Decode the image data in the sandboxed decoder and, when it is wider than
+  // width, downscale and re-encode it as WebP. The callback gets the original
+  // data when no downscaling is needed or on errors. This must be called on
+  // UI thread and the callback is called on UI thread.
+  static void ScaleImageToWidth(
+      scoped_refptr<base::RefCountedMemory> data,
+      int width,
+      content::URLDataSource::GotDataCallback callback);
+
+  // Read data for the given UrlKind. For kImageUrl when requested_width is
+  // positive this returns the smallest stored tier that is at least that
+  // wide falling back to the original image. This can be called from any
+  // thread.
   void GetDataForId(UrlKind url_kind,
                     std::string id,
-                    content::URLDataSource::GotDataCallback callback);
+                    content::URLDataSource::GotDataCallback callback,
+                    int requested_width = 0);
+
+  // Find the file for the given path mapping id so its data can be streamed.
+  // The callback gets an empty path when the id is unknown or when the data
+  // is already in the memory cache and should be read with GetDataForId().
+  // This must be called on UI thread and the callback is called on UI
+  // thread.
+  static void GetFilePathForMapping(
+      content::BrowserContext* browser_context,
+      std::string id,
+      content::URLDataSource::GotFilePathCallback callback);
+
+  // Return the file holding the original data for the given id or an empty
+  // path if it is not known. Path mappings are known only after they are
+  // loaded. This can be called from any thread.
+  base::FilePath GetFilePathForId(UrlKind url_kind, const std::string& id);
 
   void Start();
 
@@ -181,7 +266,8 @@ class VivaldiImageStore : public base::RefCountedThreadSafe<VivaldiImageStore> {
   using StoreImageDataResult = base::OnceCallback<void(std::string image_url)>;
   void StoreImageData(ImageFormat format,
                       scoped_refptr<base::RefCountedMemory> image_data,
-                      StoreImageDataResult callback);
+                      StoreImageDataResult callback,
+                      StoreMode store_mode = StoreMode::kOriginal);
 
   // Call this after storing the newborn data_url for stored image data into a
   // persistent storage like bookmark or preferences or on errors. This can be
@@ -191,9 +277,127 @@ class VivaldiImageStore : public base::RefCountedThreadSafe<VivaldiImageStore> {
  private:
   friend class base::RefCountedThreadSafe<VivaldiImageStore>;
   friend class VivaldiImageStoreHolder;
+  friend class VivaldiImageStoreTest;
+
+  class CaptureBatch;
 
   ~VivaldiImageStore();
 
+  // Start offscreen capture of the url for the given bookmark. This must be
+  // called on UI thread with non-null profile_.
+  void StartBookmarkCapture(int64_t bookmark_id,
+                            const GURL& url,
+                            StoreImageCallback ui_thread_callback);
+
+  // Starts the capture of one item of a batch. The callback may be called
+  // before this returns.
+  using StartCaptureCallback =
+      base::RepeatingCallback<void(int64_t bookmark_id,
+                                   const GURL& url,
+                                   StoreImageCallback ui_thread_callback)>;
+
+  // Run the batch of CaptureBookmarkThumbnails() with the given function to
+  // start each capture.
+  void RunCaptureBatch(std::vector<BookmarkCaptureItem> items,
+                       size_t max_concurrency,
+                       StartCaptureCallback start_capture,
+                       CaptureProgressCallback progress_callback,
+                       base::OnceClosure done_callback);
+
+  // Modification time and size of the file that cached data was read from.
+  // Files of path mappings can be changed outside the browser, so their cached
+  // data is only used while the file stays the same.
+  struct FileVersion {
+    base::Time last_modified;
+    int64_t size = 0;
+
+    bool operator==(const FileVersion& other) const {
+      return last_modified == other.last_modified && size == other.size;
+    }
+    bool operator!=(const FileVersion& other) const {
+      return !(*this == other);
+    }
+  };
+
+  // Return the version of the file or an empty version when the file does not
+  // exist. This must be called on a thread that allows blocking.
+  static FileVersion GetFileVersion(const base::FilePath& file_path);
+
+  // Byte-bounded LRU cache of the recently read image data so repeated
+  // requests for the same image, like Speed Dial thumbnails shown on each new
+  // tab, do not touch the disk. This is thread-safe.
+  class DataCache {
+   public:
+    DataCache();
+    ~DataCache();
+    DataCache(const DataCache&) = delete;
+    DataCache& operator=(const DataCache&) = delete;
+
+    // Return the cached data if it was read from the given version of the
+    // file. A stale entry is removed.
+    scoped_refptr<base::RefCountedMemory> Get(
+        UrlKind url_kind,
+        const std::string& id,
+        const FileVersion& version = FileVersion());
+    // Return true if there is data for the id. Unlike Get() this does not
+    // mark the entry as recently used.
+    bool Contains(UrlKind url_kind, const std::string& id);
+
+    // Add the data unless some data was removed since removal_count was
+    // obtained with GetRemovalCount() before reading the data. This prevents
+    // a read that races with the removal from adding the removed data back.
+    void Put(UrlKind url_kind,
+             const std::string& id,
+             scoped_refptr<base::RefCountedMemory> data,
+             uint64_t removal_count,
+             const FileVersion& version = FileVersion());
+
+    uint64_t GetRemovalCount();
+
+    // Remove the data for the id and all its downscaled variants.
+    void Remove(UrlKind url_kind, const std::string& id);
+
+    // Remove all entries of the given kind that are not in the used set.
+    void RemoveUnused(UrlKind url_kind,
+                      const base::flat_set<std::string>& used);
+
+    void ShrinkToBytes(size_t max_bytes);
+    void Clear();
+
+   private:
+    using Key = std::pair<UrlKind, std::string>;
+
+    struct Entry {
+      scoped_refptr<base::RefCountedMemory> data;
+      FileVersion version;
+    };
+
+    using Cache = base::LRUCache<Key, Entry>;
+
+    void EraseLocked(Cache::iterator i) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+    // Evict the least recently used entries until the total size fits
+    // max_bytes.
+    void EvictToSizeLocked(size_t max_bytes) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+    base::Lock lock_;
+    Cache cache_ GUARDED_BY(lock_);
+
+    // Cache ids of the cached data, including downscaled variants, for each
+    // stored image or path mapping id. This keeps Remove() independent of the
+    // number of cached entries.
+    std::map<Key, base::flat_set<std::string>> variants_ GUARDED_BY(lock_);
+
+    size_t total_bytes_ GUARDED_BY(lock_) = 0;
+
+    // Number of calls to Remove() and RemoveUnused().
+    uint64_t removal_count_ GUARDED_BY(lock_) = 0;
+  };
+
+  // Called by VivaldiImageStoreHolder on UI thread.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   scoped_refptr<base::RefCountedMemory> GetDataForNoteAttachment(
       const std::string& path);
 
@@ -213,31 +417,75 @@ class VivaldiImageStore : public base::RefCountedThreadSafe<VivaldiImageStore> {
   using UsedIds = std::array<std::vector<std::string>, kUrlKindCount>;
   void RemoveUnusedUrlDataOnFileThread(UsedIds used_ids);
 
+  base::FilePath GetFilePathForMappingId(const std::string& id);
+
+  // Serve the display-sized variant of the image decoding and scaling it on
+  // the first request. This must be called on UI thread.
+  void GetDisplaySizedDataForId(
+      UrlKind url_kind,
+      std::string id,
+      int width,
+      content::URLDataSource::GotDataCallback callback);
+  void GetDisplaySizedDataForVersion(
+      UrlKind url_kind,
+      std::string id,
+      int width,
+      content::URLDataSource::GotDataCallback callback,
+      FileVersion version);
+
   scoped_refptr<base::RefCountedMemory> GetDataForIdOnFileThread(
       UrlKind url_kind,
-      std::string id);
+      std::string id,
+      int tier_width);
 
   void StoreImageUIThread(ImagePlace place,
                           StoreImageCallback ui_thread_callback,
                           ImageFormat format,
+                          StoreMode store_mode,
                           scoped_refptr<base::RefCountedMemory> image_data);
 
   std::string StoreImageDataOnFileThread(
       ImageFormat format,
+      StoreMode store_mode,
       scoped_refptr<base::RefCountedMemory> image_data);
 
+  // Write the downscaled tiers for the stored thumbnail image.
+  void StoreImageTiersOnFileThread(const std::string& image_id,
+                                   const SkBitmap& bitmap);
+
   void FinishStoreImageOnUIThread(StoreImageCallback callback,
                                   ImagePlace place,
                                   std::string image_url);
 
   void LoadMappingsOnFileThread();
+  void LoadMappingSnapshotOnFileThread();
   void InitMappingsOnFileThread(base::Value::Dict& mappings);
+  void ReplayMappingJournalOnFileThread();
+
+  // Record changed mappings in the journal as pairs of the id and the local
+  // path. An empty path records the removal of the mapping. This rewrites the
+  // whole mapping file instead when the journal becomes too long.
+  using MappingChanges = std::vector<std::pair<std::string, base::FilePath>>;
+  void AppendMappingsToJournalOnFileThread(const MappingChanges& changes);
+  void DeleteMappingJournalOnFileThread();
 
   std::string GetMappingJSONOnFileThread();
   void SaveMappingsOnFileThread();
 
   base::FilePath GetFileMappingFilePath();
+  base::FilePath GetMappingJournalFilePath();
+  base::FilePath GetUnusedUrlDataCheckedFilePath();
   base::FilePath GetImagePath(base::StringPiece thumbnail_id);
+  base::FilePath GetImageTierDirectory(int tier_width);
+
+  // Check for unused url data after startup unless the last check left
+  // nothing to remove.
+  void ScheduleStartupRemovalOfUnusedUrlDataOnFileThread();
+
+  // Record that some url data may have lost its last reference so the next
+  // startup checks for unused data. This must be called on UI thread.
+  void MarkUrlDataMayBeUnused();
+  void MarkUrlDataMayBeUnusedOnFileThread();
 
   void AddNewbornUrlOnFileThread(base::StringPiece data_url);
   void ForgetNewbornUrlOnFileThread(std::string data_url);
@@ -254,17 +502,44 @@ class VivaldiImageStore : public base::RefCountedThreadSafe<VivaldiImageStore> {
   const scoped_refptr<base::SingleThreadTaskRunner> ui_thread_runner_;
 
   // Runner to ensure that tasks to manipulate the data mapping runs in sequence
-  // with the proper order.
+  // with the proper order. Reads of the image data do not use it and run in
+  // parallel on the thread pool.
   const scoped_refptr<base::SequencedTaskRunner> sequence_task_runner_;
 
+  // Batches the small bookkeeping tasks posted per stored image, like
+  // ForgetNewbornUrl() after each bookmark thumbnail capture, into single
+  // tasks on sequence_task_runner_.
+  const scoped_refptr<vivaldi::BatchingTaskRunner> bookkeeping_runner_;
+
   // Map path ids into their paths. Outside constructor or destructor this must
-  // be accessed only from the sequence_task_runner_.
+  // be modified only from the sequence_task_runner_ while holding
+  // path_id_map_lock_. The sequence can read it without the lock, other
+  // threads must hold the lock.
   std::map<std::string, base::FilePath> path_id_map_;
+  base::Lock path_id_map_lock_;
+
+  // True after LoadMappingsOnFileThread() is done so path mapping reads no
+  // longer need to run in sequence after it.
+  std::atomic<bool> mappings_loaded_{false};
+
+  // Number of entries in the mapping journal. This must be accessed only from
+  // sequence_task_runner_.
+  size_t journal_entries_ = 0;
 
   // urls that have data stored but that are not stored themselves. This
   // prevents their removal in RemoveUnusedUrlData. This must be accessed only
   // from sequence_task_runner_.
   std::vector<std::string> file_thread_newborn_urls_;
+
+  // True when the file kUnusedUrlDataCheckedFilename exists. This must be
+  // accessed only from sequence_task_runner_.
+  bool unused_url_data_checked_ = false;
+
+  // True when MarkUrlDataMayBeUnused() was called since the last check
+  // collected the used urls. This must be accessed only on UI thread.
+  bool url_data_may_be_unused_ = false;
+
+  DataCache data_cache_;
 };
 
 #endif  // COMPONENTS_DATASOURCE_VIVALDI_IMAGE_STORE_H_
@@ -0,0 +1,247 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "components/datasource/vivaldi_image_store.h"
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "build/build_config.h"
+#include "chrome/test/base/testing_profile.h"
+#include "components/memory_pressure/fake_memory_pressure_monitor.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+class VivaldiImageStoreTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    store_ = base::MakeRefCounted<VivaldiImageStore>(&profile_);
+    marker_path_ = store_->GetUnusedUrlDataCheckedFilePath();
+    image_dir_ = store_->GetImagePath("X").DirName();
+    ASSERT_TRUE(base::CreateDirectory(image_dir_));
+  }
+
+  void TearDown() override {
+    store_->profile_ = nullptr;
+    store_.reset();
+  }
+
+  // Run the task on the sequence of the store and wait for it.
+  void RunOnFileThread(base::OnceClosure task) {
+    base::RunLoop run_loop;
+    store_->sequence_task_runner_->PostTaskAndReply(FROM_HERE, std::move(task),
+                                                    run_loop.QuitClosure());
+    run_loop.Run();
+  }
+
+  // Remove the data that is not in the used ids like the check for unused
+  // url data does after it collected the urls on UI thread.
+  void RemoveUnusedUrlData(const std::string& used_image_id = std::string()) {
+    VivaldiImageStore::UsedIds used_ids;
+    if (!used_image_id.empty()) {
+      used_ids[VivaldiImageStore::kImageUrl].push_back(used_image_id);
+    }
+    RunOnFileThread(
+        base::BindOnce(&VivaldiImageStore::RemoveUnusedUrlDataOnFileThread,
+                       store_, std::move(used_ids)));
+  }
+
+  void WriteImage(const std::string& image_id) {
+    ASSERT_TRUE(base::WriteFile(store_->GetImagePath(image_id), "data"));
+  }
+
+  // Run a capture batch for bookmarks with ids from 1 to item_count. The
+  // captures finish when the test calls CompleteCapture() unless
+  // complete_synchronously_ is set.
+  void RunCaptureBatch(size_t item_count, size_t max_concurrency) {
+    std::vector<VivaldiImageStore::BookmarkCaptureItem> items(item_count);
+    for (size_t i = 0; i < item_count; ++i) {
+      items[i].bookmark_id = i + 1;
+      items[i].url = GURL("http://example.com/" + base::NumberToString(i + 1));
+    }
+    store_->RunCaptureBatch(
+        std::move(items), max_concurrency,
+        base::BindRepeating(&VivaldiImageStoreTest::StartCapture,
+                            base::Unretained(this)),
+        base::BindRepeating(&VivaldiImageStoreTest::OnCaptureProgress,
+                            base::Unretained(this)),
+        base::BindOnce(&VivaldiImageStoreTest::OnCaptureDone,
+                       base::Unretained(this)));
+  }
+
+  void StartCapture(int64_t bookmark_id,
+                    const GURL& url,
+                    VivaldiImageStore::StoreImageCallback callback) {
+    started_ids_.push_back(bookmark_id);
+    if (complete_synchronously_) {
+      std::move(callback).Run(true);
+      return;
+    }
+    pending_captures_.push_back(std::move(callback));
+  }
+
+  // Finish the oldest running capture.
+  void CompleteCapture(bool success = true) {
+    ASSERT_FALSE(pending_captures_.empty());
+    VivaldiImageStore::StoreImageCallback callback =
+        std::move(pending_captures_.front());
+    pending_captures_.pop_front();
+    std::move(callback).Run(success);
+  }
+
+  void OnCaptureProgress(int64_t bookmark_id, bool success) {
+    finished_.emplace_back(bookmark_id, success);
+  }
+
+  void OnCaptureDone() { done_count_++; }
+
+  content::BrowserTaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  TestingProfile profile_;
+  scoped_refptr<VivaldiImageStore> store_;
+  base::FilePath marker_path_;
+  base::FilePath image_dir_;
+
+  bool complete_synchronously_ = false;
+  std::vector<int64_t> started_ids_;
+  std::deque<VivaldiImageStore::StoreImageCallback> pending_captures_;
+  std::vector<std::pair<int64_t, bool>> finished_;
+  int done_count_ = 0;
+};
+
+TEST_F(VivaldiImageStoreTest, CheckWritesMarker) {
+  WriteImage("USED.png");
+  WriteImage("UNUSED.png");
+  EXPECT_FALSE(base::PathExists(marker_path_));
+
+  RemoveUnusedUrlData("USED.png");
+  EXPECT_TRUE(base::PathExists(store_->GetImagePath("USED.png")));
+  EXPECT_FALSE(base::PathExists(store_->GetImagePath("UNUSED.png")));
+  EXPECT_TRUE(base::PathExists(marker_path_));
+}
+
+TEST_F(VivaldiImageStoreTest, ChangeDeletesMarker) {
+  RemoveUnusedUrlData();
+  ASSERT_TRUE(base::PathExists(marker_path_));
+
+  store_->MarkUrlDataMayBeUnused();
+  RunOnFileThread(base::DoNothing());
+  EXPECT_FALSE(base::PathExists(marker_path_));
+
+  // The next check writes it again.
+  RemoveUnusedUrlData();
+  EXPECT_TRUE(base::PathExists(marker_path_));
+}
+
+TEST_F(VivaldiImageStoreTest, NewbornUrlKeepsMarkerAway) {
+  RunOnFileThread(base::BindOnce(
+      &VivaldiImageStore::AddNewbornUrlOnFileThread, store_,
+      "chrome://vivaldi-data/thumbnail/NEWBORN.png"));
+  RemoveUnusedUrlData();
+  EXPECT_FALSE(base::PathExists(marker_path_));
+
+  RunOnFileThread(base::BindOnce(
+      &VivaldiImageStore::ForgetNewbornUrlOnFileThread, store_,
+      "chrome://vivaldi-data/thumbnail/NEWBORN.png"));
+  RemoveUnusedUrlData();
+  EXPECT_TRUE(base::PathExists(marker_path_));
+}
+
+#if BUILDFLAG(IS_POSIX)
+TEST_F(VivaldiImageStoreTest, FailedRemovalKeepsMarkerAway) {
+  WriteImage("UNUSED.png");
+
+  // Files in a read-only directory cannot be deleted.
+  int mode = 0;
+  ASSERT_TRUE(base::GetPosixFilePermissions(image_dir_, &mode));
+  ASSERT_TRUE(base::SetPosixFilePermissions(
+      image_dir_, base::FILE_PERMISSION_READ_BY_USER |
+                      base::FILE_PERMISSION_EXECUTE_BY_USER));
+  RemoveUnusedUrlData();
+  ASSERT_TRUE(base::SetPosixFilePermissions(image_dir_, mode));
+  if (!base::PathExists(store_->GetImagePath("UNUSED.png"))) {
+    // Running with privileges that ignore the permissions.
+    return;
+  }
+  EXPECT_FALSE(base::PathExists(marker_path_));
+
+  RemoveUnusedUrlData();
+  EXPECT_FALSE(base::PathExists(store_->GetImagePath("UNUSED.png")));
+  EXPECT_TRUE(base::PathExists(marker_path_));
+}
+#endif  // BUILDFLAG(IS_POSIX)
+
+TEST_F(VivaldiImageStoreTest, CaptureBatchBoundsConcurrency) {
+  RunCaptureBatch(5, 2);
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1, 2}));
+
+  CompleteCapture();
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1, 2, 3}));
+  while (!pending_captures_.empty()) {
+    EXPECT_LE(pending_captures_.size(), 2u);
+    EXPECT_EQ(done_count_, 0);
+    CompleteCapture(pending_captures_.size() != 1);
+  }
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1, 2, 3, 4, 5}));
+  EXPECT_EQ(finished_, (std::vector<std::pair<int64_t, bool>>{
+                           {1, true}, {2, true}, {3, true}, {4, true},
+                           {5, false}}));
+  EXPECT_EQ(done_count_, 1);
+}
+
+TEST_F(VivaldiImageStoreTest, CaptureBatchSynchronousCompletion) {
+  // Each capture reports back while the batch is still starting it.
+  complete_synchronously_ = true;
+  RunCaptureBatch(5, 2);
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1, 2, 3, 4, 5}));
+  EXPECT_EQ(finished_.size(), 5u);
+  EXPECT_EQ(done_count_, 1);
+}
+
+TEST_F(VivaldiImageStoreTest, CaptureBatchWaitsOutMemoryPressure) {
+  memory_pressure::test::FakeMemoryPressureMonitor monitor;
+  RunCaptureBatch(3, 1);
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1}));
+
+  // The running capture finishes, but no new one starts under pressure.
+  monitor.SetAndNotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  CompleteCapture();
+  task_environment_.FastForwardBy(base::Minutes(1));
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1}));
+  EXPECT_EQ(done_count_, 0);
+
+  monitor.SetAndNotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE);
+  task_environment_.FastForwardBy(base::Minutes(1));
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1, 2}));
+  CompleteCapture();
+  CompleteCapture();
+  EXPECT_EQ(done_count_, 1);
+}
+
+TEST_F(VivaldiImageStoreTest, CaptureBatchStopsOnShutdown) {
+  RunCaptureBatch(3, 1);
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1}));
+
+  // The running capture still reports, the rest fail without starting.
+  store_->profile_ = nullptr;
+  CompleteCapture();
+  EXPECT_EQ(started_ids_, (std::vector<int64_t>{1}));
+  EXPECT_EQ(finished_, (std::vector<std::pair<int64_t, bool>>{
+                           {1, true}, {2, false}, {3, false}}));
+  EXPECT_EQ(done_count_, 1);
+}
+
+TEST_F(VivaldiImageStoreTest, CaptureBatchEmpty) {
+  RunCaptureBatch(0, 2);
+  EXPECT_TRUE(started_ids_.empty());
+  EXPECT_EQ(done_count_, 1);
+}
@@ -2,7 +2,9 @@
 
 #include "components/datasource/vivaldi_theme_io.h"
 
+#include <map>
 #include <type_traits>
+#include <vector>
 
 #include "base/containers/flat_set.h"
 #include "base/files/file_util.h"
@@ -19,6 +21,7 @@
 #include "base/task/thread_pool.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "chrome/browser/profiles/profile.h"
@@ -111,6 +114,51 @@ const base::Value* FindThemeValue(const PrefService* prefs,
   return &themes->GetList()[index];
 }
 
+// Give Zip() the archive entries from their own locations so files that
+// already exist on disk, like stored background images, are not copied.
+class ArchiveFileAccessor : public zip::FileAccessor {
+ public:
+  explicit ArchiveFileAccessor(
+      const std::map<base::FilePath, base::FilePath>& entry_paths)
+      : entry_paths_(entry_paths) {}
+  ~ArchiveFileAccessor() override = default;
+
+  bool Open(zip::Paths paths, std::vector<base::File>* files) override {
+    for (const base::FilePath& path : paths) {
+      auto i = entry_paths_.find(path);
+      if (i == entry_paths_.end()) {
+        files->emplace_back();
+        continue;
+      }
+      files->emplace_back(i->second,
+                          base::File::FLAG_OPEN | base::File::FLAG_READ);
+    }
+    return true;
+  }
+
+  bool List(const base::FilePath& path,
+            std::vector<base::FilePath>* files,
+            std::vector<base::FilePath>* subdirs) override {
+    // The archive has no directories.
+    return false;
+  }
+
+  bool GetInfo(const base::FilePath& path, Info* info) override {
+    auto i = entry_paths_.find(path);
+    if (i == entry_paths_.end())
+      return false;
+    base::File::Info file_info;
+    if (!base::GetFileInfo(i->second, &file_info))
+      return false;
+    info->is_directory = file_info.is_directory;
+    info->last_modified = file_info.last_modified;
+    return true;
+  }
+
+ private:
+  const std::map<base::FilePath, base::FilePath>& entry_paths_;
+};
+
 class Exporter : public base::RefCountedThreadSafe<Exporter> {
  public:
   Exporter() = default;
@@ -150,9 +198,10 @@ class Exporter : public base::RefCountedThreadSafe<Exporter> {
 
   void StartOnWorkSequence() {
     DCHECK(work_sequence_->RunsTasksInCurrentSequence());
+    TRACE_EVENT0("vivaldi", "vivaldi_theme_io::Exporter::StartOnWorkSequence");
 
-    // Zip API in Chromium do not work with memory, so copy all to a temporary
-    // directory.
+    // Zip API in Chromium do not work with memory, so data that is not already
+    // in a file goes to a temporary directory.
     if (!temp_dir_.CreateUniqueTempDir()) {
       error_ = "Failed to create a temporary directory";
       return;
@@ -165,6 +214,14 @@ class Exporter : public base::RefCountedThreadSafe<Exporter> {
       std::string url_id;
       if (VivaldiImageStore::ParseDataUrl(*background_image, url_kind,
                                           url_id)) {
+        // Zip the stored file directly when possible.
+        base::FilePath image_path =
+            data_source_api_->GetFilePathForId(url_kind, url_id);
+        if (!image_path.empty() && base::PathExists(image_path)) {
+          AddArchiveEntry(GetBackgroundFileName(url_id), image_path);
+          SaveJSON();
+          return;
+        }
         data_source_api_->GetDataForId(
             url_kind, url_id,
             base::BindOnce(&Exporter::SaveBackgroundImage, this, url_id));
@@ -194,25 +251,37 @@ class Exporter : public base::RefCountedThreadSafe<Exporter> {
     SaveJSON();
   }
 
-  void WriteBackgroundImage(base::StringPiece name,
-                            const uint8_t* data,
-                            size_t size) {
-    if (size == 0)
-      return;
+  static std::string GetBackgroundFileName(base::StringPiece name) {
     std::string file_name = "background";
     size_t last_dot = name.rfind('.');
     if (last_dot != std::string::npos) {
       file_name.append(name.data() + last_dot, name.size() - last_dot);
     }
+    return file_name;
+  }
+
+  void WriteBackgroundImage(base::StringPiece name,
+                            const uint8_t* data,
+                            size_t size) {
+    if (size == 0)
+      return;
+    std::string file_name = GetBackgroundFileName(name);
     base::FilePath path =
         temp_dir_.GetPath().Append(base::FilePath::FromUTF8Unsafe(file_name));
     if (!base::WriteFile(path, reinterpret_cast<const char*>(data), size)) {
       error_ = std::string("Failed to write ") + file_name;
       return;
     }
-    archive_files_.push_back(path.BaseName());
+    AddArchiveEntry(file_name, path);
+  }
 
-    theme_object_.SetStringKey(kBackgroundImageKey, std::move(file_name));
+  void AddArchiveEntry(const std::string& file_name, base::FilePath path) {
+    base::FilePath entry = base::FilePath::FromUTF8Unsafe(file_name);
+    archive_files_.push_back(entry);
+    archive_paths_[entry] = std::move(path);
+    if (file_name != kSettingsFileName) {
+      theme_object_.SetStringKey(kBackgroundImageKey, file_name);
+    }
   }
 
   void SaveJSON() {
@@ -235,15 +304,16 @@ class Exporter : public base::RefCountedThreadSafe<Exporter> {
       error_ = std::string("Failed to write ") + kSettingsFileName;
       return;
     }
-    archive_files_.push_back(settings_path.BaseName());
+    AddArchiveEntry(kSettingsFileName, settings_path);
 
     bool zip_to_blob = theme_archive_.empty();
     if (zip_to_blob) {
       theme_archive_ = temp_dir_.GetPath().AppendASCII(kTempBlobFileName);
     }
 
+    ArchiveFileAccessor file_accessor(archive_paths_);
     zip::ZipParams zip_params;
-    zip_params.src_dir = temp_dir_.GetPath();
+    zip_params.file_accessor = &file_accessor;
     zip_params.src_files = archive_files_;
     zip_params.dest_file = theme_archive_;
     if (!zip::Zip(zip_params)) {
@@ -287,6 +357,9 @@ class Exporter : public base::RefCountedThreadSafe<Exporter> {
   base::ScopedTempDir temp_dir_;
   std::string error_;
   std::vector<base::FilePath> archive_files_;
+
+  // Maps archive entries to the files with their data.
+  std::map<base::FilePath, base::FilePath> archive_paths_;
   std::vector<uint8_t> data_blob_;
 };
 
@@ -343,6 +416,7 @@ class Importer : public base::RefCountedThreadSafe<Importer> {
 
   void StartOnWorkSequence() {
     DCHECK(work_sequence_->RunsTasksInCurrentSequence());
+    TRACE_EVENT0("vivaldi", "vivaldi_theme_io::Importer::StartOnWorkSequence");
     if (!temp_dir_.CreateUniqueTempDir()) {
       AddError(ImportError::kIO, "Failed to create a temporary directory");
       return;
@@ -529,6 +603,7 @@ class Importer : public base::RefCountedThreadSafe<Importer> {
 void VerifyAndNormalizeJson(VerifyAndNormalizeFlags flags,
                             base::Value& object,
                             std::string& error) {
+  TRACE_EVENT0("vivaldi", "vivaldi_theme_io::VerifyAndNormalizeJson");
   // Manually check that object contains only known keys of the proper type and
   // values. The FooInfo structures below hold restructions on the type. They
   // are put into a lazily-built name->info map. Then the Checker class below
@@ -5,10 +5,13 @@
 #include <string>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/lazy_instance.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "browser/vivaldi_internal_handlers.h"
 #include "calendar/calendar_model_observer.h"
@@ -261,67 +264,106 @@ CalendarEventRouter::CalendarEventRouter(Profile* profile,
 CalendarEventRouter::~CalendarEventRouter() {}
 
 void CalendarEventRouter::ExtensiveCalendarChangesBeginning(
-    CalendarService* model) {}
+    CalendarService* model) {
+  extensive_changes_depth_++;
+}
 
 void CalendarEventRouter::ExtensiveCalendarChangesEnded(
-    CalendarService* model) {}
-std::unique_ptr<CalendarEvent> CreateVivaldiEvent(
-    const calendar::EventResult& event) {
-  std::unique_ptr<CalendarEvent> cal_event(new CalendarEvent());
-
-  cal_event->id = base::NumberToString(event.id);
-  cal_event->calendar_id = base::NumberToString(event.calendar_id);
-  cal_event->alarm_id.reset(
+    CalendarService* model) {
+  DCHECK_GT(extensive_changes_depth_, 0);
+  if (--extensive_changes_depth_ == 0 && calendar_modified_)
+    ScheduleCalendarDataChanged();
+}
+
+void CalendarEventRouter::ScheduleCalendarDataChanged() {
+  calendar_modified_ = true;
+  if (extensive_changes_depth_ > 0 || calendar_data_changed_posted_)
+    return;
+  calendar_data_changed_posted_ = true;
+  base::SequencedTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&CalendarEventRouter::DispatchCalendarDataChanged,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+void CalendarEventRouter::DispatchCalendarDataChanged() {
+  TRACE_EVENT0("vivaldi", "CalendarEventRouter::DispatchCalendarDataChanged");
+  calendar_data_changed_posted_ = false;
+  // Changes may have started again after the task was posted.
+  if (extensive_changes_depth_ > 0 || !calendar_modified_)
+    return;
+  calendar_modified_ = false;
+  DispatchEvent(profile_, OnCalendarDataChanged::kEventName,
+                base::Value::List());
+}
+CalendarEvent CreateVivaldiEvent(const calendar::EventResult& event) {
+  CalendarEvent cal_event;
+
+  cal_event.id = base::NumberToString(event.id);
+  cal_event.calendar_id = base::NumberToString(event.calendar_id);
+  cal_event.alarm_id.reset(
       new std::string(base::NumberToString(event.alarm_id)));
 
-  cal_event->title = base::UTF16ToUTF8(event.title);
-  cal_event->description.reset(
+  cal_event.title = base::UTF16ToUTF8(event.title);
+  cal_event.description.reset(
       new std::string(base::UTF16ToUTF8(event.description)));
-  cal_event->start.reset(new double(MilliSecondsFromTime(event.start)));
-  cal_event->end.reset(new double(MilliSecondsFromTime(event.end)));
-  cal_event->all_day.reset(new bool(event.all_day));
-  cal_event->is_recurring.reset(new bool(event.is_recurring));
-  cal_event->location.reset(new std::string(base::UTF16ToUTF8(event.location)));
-  cal_event->url.reset(new std::string(base::UTF16ToUTF8(event.url)));
-  cal_event->etag.reset(new std::string(event.etag));
-  cal_event->href.reset(new std::string(event.href));
-  cal_event->uid.reset(new std::string(event.uid));
-  cal_event->event_type_id.reset(
+  cal_event.start.reset(new double(MilliSecondsFromTime(event.start)));
+  cal_event.end.reset(new double(MilliSecondsFromTime(event.end)));
+  cal_event.all_day.reset(new bool(event.all_day));
+  cal_event.is_recurring.reset(new bool(event.is_recurring));
+  cal_event.location.reset(new std::string(base::UTF16ToUTF8(event.location)));
+  cal_event.url.reset(new std::string(base::UTF16ToUTF8(event.url)));
+  cal_event.etag.reset(new std::string(event.etag));
+  cal_event.href.reset(new std::string(event.href));
+  cal_event.uid.reset(new std::string(event.uid));
+  cal_event.event_type_id.reset(
       new std::string(base::NumberToString(event.event_type_id)));
-  cal_event->task.reset(new bool(event.task));
-  cal_event->complete.reset(new bool(event.complete));
-  cal_event->trash.reset(new bool(event.trash));
-  cal_event->trash_time.reset(
+  cal_event.task.reset(new bool(event.task));
+  cal_event.complete.reset(new bool(event.complete));
+  cal_event.trash.reset(new bool(event.trash));
+  cal_event.trash_time.reset(
       new double(MilliSecondsFromTime(event.trash_time)));
-  cal_event->sequence.reset(new int(event.sequence));
-  cal_event->ical.reset(new std::string(base::UTF16ToUTF8(event.ical)));
-  cal_event->rrule.reset(new std::string(event.rrule));
-  cal_event->recurrence_exceptions =
+  cal_event.sequence.reset(new int(event.sequence));
+  cal_event.ical.reset(new std::string(base::UTF16ToUTF8(event.ical)));
+  cal_event.rrule.reset(new std::string(event.rrule));
+  cal_event.recurrence_exceptions =
       CreateRecurrenceException(event.recurrence_exceptions);
 
-  cal_event->notifications = CreateNotifications(event.notifications);
-  cal_event->invites = CreateInvites(event.invites);
-  cal_event->organizer.reset(new std::string(event.organizer));
-  cal_event->timezone.reset(new std::string(event.timezone));
-  cal_event->priority.reset(new int(event.priority));
-  cal_event->status.reset(new std::string(event.status));
-  cal_event->percentage_complete.reset(new int(event.percentage_complete));
-  cal_event->categories.reset(
+  cal_event.notifications = CreateNotifications(event.notifications);
+  cal_event.invites = CreateInvites(event.invites);
+  cal_event.organizer.reset(new std::string(event.organizer));
+  cal_event.timezone.reset(new std::string(event.timezone));
+  cal_event.priority.reset(new int(event.priority));
+  cal_event.status.reset(new std::string(event.status));
+  cal_event.percentage_complete.reset(new int(event.percentage_complete));
+  cal_event.categories.reset(
       new std::string(base::UTF16ToUTF8(event.categories)));
-  cal_event->component_class.reset(
+  cal_event.component_class.reset(
       new std::string(base::UTF16ToUTF8(event.component_class)));
-  cal_event->attachment.reset(
+  cal_event.attachment.reset(
       new std::string(base::UTF16ToUTF8(event.attachment)));
-  cal_event->completed.reset(new double(MilliSecondsFromTime(event.completed)));
-  cal_event->sync_pending.reset(new bool(event.sync_pending));
-  cal_event->delete_pending.reset(new bool(event.delete_pending));
+  cal_event.completed.reset(new double(MilliSecondsFromTime(event.completed)));
+  cal_event.sync_pending.reset(new bool(event.sync_pending));
+  cal_event.delete_pending.reset(new bool(event.delete_pending));
   return cal_event;
 }
+
+EventList CreateEventList(calendar::EventQueryResults* results) {
+  EventList event_list;
+  if (!results)
+    return event_list;
+  for (const auto& event : *results) {
+    event_list.push_back(CreateVivaldiEvent(*event));
+  }
+  return event_list;
+}
+
 void CalendarEventRouter::OnEventCreated(CalendarService* service,
                                          const calendar::EventResult& event) {
-  std::unique_ptr<CalendarEvent> createdEvent = CreateVivaldiEvent(event);
+  TRACE_EVENT0("vivaldi", "CalendarEventRouter::OnEventCreated");
+  CalendarEvent createdEvent = CreateVivaldiEvent(event);
 
-  base::Value::List args = OnEventCreated::Create(*createdEvent);
+  base::Value::List args = OnEventCreated::Create(createdEvent);
   DispatchEvent(profile_, OnEventCreated::kEventName, std::move(args));
 }
 
@@ -343,6 +385,7 @@ void CalendarEventRouter::OnMailtoOpened(GURL mailto) {
 void CalendarEventRouter::OnNotificationChanged(
     CalendarService* service,
     const calendar::NotificationRow& row) {
+  TRACE_EVENT0("vivaldi", "CalendarEventRouter::OnNotificationChanged");
   Notification changedNotification = CreateNotification(row);
   base::Value::List args =
       OnNotificationChanged::Create(changedNotification);
@@ -350,14 +393,15 @@ void CalendarEventRouter::OnNotificationChanged(
 }
 
 void CalendarEventRouter::OnCalendarModified(CalendarService* service) {
-  base::Value::List args;
-  DispatchEvent(profile_, OnCalendarDataChanged::kEventName, std::move(args));
+  ScheduleCalendarDataChanged();
 }
 
 // Helper to actually dispatch an event to extension listeners.
 void CalendarEventRouter::DispatchEvent(Profile* profile,
                                         const std::string& event_name,
                                         base::Value::List event_args) {
+  TRACE_EVENT1("vivaldi", "CalendarEventRouter::DispatchEvent", "event",
+               event_name);
   if (profile && EventRouter::Get(profile)) {
     EventRouter* event_router = EventRouter::Get(profile);
     if (event_router) {
@@ -456,6 +500,7 @@ void CalendarAPI::RegisterInternalHandlers() {
 }
 
 void CalendarAPI::OnListenerAdded(const EventListenerInfo& details) {
+  TRACE_EVENT0("vivaldi", "CalendarAPI::OnListenerAdded");
   Profile* profile = Profile::FromBrowserContext(browser_context_);
 
   calendar_event_router_ = std::make_unique<CalendarEventRouter>(
@@ -481,16 +526,8 @@ ExtensionFunction::ResponseAction CalendarGetAllEventsFunction::Run() {
 
 void CalendarGetAllEventsFunction::GetAllEventsComplete(
     std::shared_ptr<calendar::EventQueryResults> results) {
-  EventList eventList;
-
-  if (results && !results->empty()) {
-    for (calendar::EventQueryResults::EventResultVector::const_iterator
-             iterator = results->begin();
-         iterator != results->end(); ++iterator) {
-      eventList.push_back(std::move(
-          *base::WrapUnique((CreateVivaldiEvent(**iterator).release()))));
-    }
-  }
+  TRACE_EVENT0("vivaldi", "CalendarGetAllEventsFunction::GetAllEventsComplete");
+  EventList eventList = CreateEventList(results.get());
 
   Respond(ArgumentList(
       vivaldi::calendar::GetAllEvents::Results::Create(eventList)));
@@ -520,9 +557,9 @@ void CalendarEventCreateFunction::CreateEventComplete(
   if (!results->success) {
     Respond(Error("Error creating event. " + results->message));
   } else {
-    std::unique_ptr<CalendarEvent> event = CreateVivaldiEvent(results->event);
+    CalendarEvent event = CreateVivaldiEvent(results->event);
     Respond(ArgumentList(
-        extensions::vivaldi::calendar::EventCreate::Results::Create(*event)));
+        extensions::vivaldi::calendar::EventCreate::Results::Create(event)));
   }
 }
 
@@ -770,9 +807,9 @@ void CalendarUpdateEventFunction::UpdateEventComplete(
   if (!results->success) {
     Respond(Error("Error updating event"));
   } else {
-    std::unique_ptr<CalendarEvent> event = CreateVivaldiEvent(results->event);
+    CalendarEvent event = CreateVivaldiEvent(results->event);
     Respond(ArgumentList(
-        extensions::vivaldi::calendar::UpdateEvent::Results::Create(*event)));
+        extensions::vivaldi::calendar::UpdateEvent::Results::Create(event)));
   }
 }
 
@@ -840,10 +877,10 @@ void CalendarDeleteEventExceptionFunction::DeleteEventExceptionComplete(
   if (!results->success) {
     Respond(Error("Error deleting event exception"));
   } else {
-    std::unique_ptr<CalendarEvent> event = CreateVivaldiEvent(results->event);
+    CalendarEvent event = CreateVivaldiEvent(results->event);
     Respond(ArgumentList(
         extensions::vivaldi::calendar::DeleteEventException::Results::Create(
-            *event)));
+            event)));
   }
 }
 
@@ -1329,10 +1366,10 @@ void CalendarCreateEventExceptionFunction::CreateEventExceptionComplete(
   if (!results->success) {
     Respond(Error("Error creating event exception"));
   } else {
-    std::unique_ptr<CalendarEvent> event = CreateVivaldiEvent(results->event);
+    CalendarEvent event = CreateVivaldiEvent(results->event);
     Respond(ArgumentList(
         extensions::vivaldi::calendar::CreateEventException::Results::Create(
-            *event)));
+            event)));
   }
 }
 
@@ -1842,16 +1879,7 @@ ExtensionFunction::ResponseAction CalendarGetAllEventTemplatesFunction::Run() {
 
 void CalendarGetAllEventTemplatesFunction::GetAllEventTemplatesComplete(
     std::shared_ptr<calendar::EventQueryResults> results) {
-  EventList eventList;
-
-  if (results && !results->empty()) {
-    for (calendar::EventQueryResults::EventResultVector::const_iterator
-             iterator = results->begin();
-         iterator != results->end(); ++iterator) {
-      eventList.push_back(std::move(
-          *base::WrapUnique((CreateVivaldiEvent(**iterator).release()))));
-    }
-  }
+  EventList eventList = CreateEventList(results.get());
 
   Respond(ArgumentList(
       vivaldi::calendar::GetAllEventTemplates::Results::Create(eventList)));
@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 
+#include "base/memory/weak_ptr.h"
 #include "base/scoped_observation.h"
 #include "calendar/calendar_model_observer.h"
 #include "calendar/calendar_service.h"
@@ -62,9 +63,18 @@ class CalendarEventRouter : public CalendarModelObserver {
   void ExtensiveCalendarChangesBeginning(CalendarService* model) override;
   void ExtensiveCalendarChangesEnded(CalendarService* model) override;
 
+  // OnCalendarDataChanged carries no data, so any number of modifications
+  // within a task or an extensive change are reported with one event.
+  void ScheduleCalendarDataChanged();
+  void DispatchCalendarDataChanged();
+
   Profile* profile_;
+  int extensive_changes_depth_ = 0;
+  bool calendar_modified_ = false;
+  bool calendar_data_changed_posted_ = false;
   base::ScopedObservation<calendar::CalendarService, CalendarModelObserver>
       calendar_service_observation_{this};
+  base::WeakPtrFactory<CalendarEventRouter> weak_ptr_factory_{this};
 };
 
 class CalendarAPI : public BrowserContextKeyedAPI,
@@ -7,6 +7,8 @@
 #include <utility>
 #include <vector>
 
+#include "base/containers/lru_cache.h"
+#include "base/hash/hash.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/json/json_writer.h"
@@ -14,6 +16,8 @@
 #include "base/numerics/clamped_math.h"
 #include "base/scoped_observation.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/lazy_thread_pool_task_runner.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "browser/translate/vivaldi_translate_client.h"
 #include "build/build_config.h"
 #include "chrome/browser/browser_process.h"
@@ -21,8 +25,10 @@
 #include "chrome/browser/content_settings/host_content_settings_map_factory.h"
 #include "chrome/browser/extensions/extension_tab_util.h"
 #include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/browser/renderer_preferences_util.h"
 #include "chrome/browser/resource_coordinator/tab_manager.h"
+#include "chrome/browser/sessions/tab_loader.h"
 #include "chrome/browser/ui/browser_finder.h"
 #include "chrome/browser/ui/browser_list.h"
 #include "chrome/browser/ui/recently_audible_helper.h"
@@ -61,6 +67,7 @@
 #include "extensions/browser/extensions_browser_client.h"
 #include "mojo/public/cpp/bindings/callback_helpers.h"
 #include "third_party/cld_3/src/src/nnet_language_identifier.h"
+#include "third_party/skia/include/core/SkSwizzle.h"
 #include "ui/base/dragdrop/mojom/drag_drop_types.mojom-shared.h"
 #include "ui/base/dragdrop/os_exchange_data.h"
 #include "ui/base/l10n/l10n_util.h"
@@ -105,7 +112,15 @@ const int& VivaldiPrivateTabObserver::kUserDataKey =
 namespace tabs_private = vivaldi::tabs_private;
 
 bool IsTabMuted(const WebContents* web_contents) {
-  std::string viv_extdata = web_contents->GetVivExtData();
+  // Reuse the ext data the tab observer keeps parsed rather than building a
+  // new value tree on each call.
+  if (VivaldiPrivateTabObserver* tab_observer =
+          VivaldiPrivateTabObserver::FromWebContents(
+              const_cast<WebContents*>(web_contents))) {
+    const base::Value* json = tab_observer->GetExtData();
+    return json && json->FindBoolKey(kVivaldiTabMuted).value_or(false);
+  }
+  const std::string& viv_extdata = web_contents->GetVivExtData();
   base::JSONParserOptions options = base::JSON_PARSE_RFC;
   absl::optional<base::Value> json =
       base::JSONReader::Read(viv_extdata, options);
@@ -118,6 +133,31 @@ bool IsTabMuted(const WebContents* web_contents) {
 
 namespace {
 
+// Number of recently identified texts whose language is remembered. The UI
+// tends to ask again for the same selection.
+constexpr size_t kTextLanguageCacheSize = 32;
+
+// Language identification runs on one sequence so the model is set up once
+// and never used from two threads at the same time.
+base::LazyThreadPoolSequencedTaskRunner g_text_language_task_runner =
+    LAZY_THREAD_POOL_SEQUENCED_TASK_RUNNER_INITIALIZER(
+        base::TaskTraits(base::TaskPriority::USER_VISIBLE,
+                         base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN));
+
+std::string IdentifyTextLanguage(const std::string& text) {
+  static base::NoDestructor<chrome_lang_id::NNetLanguageIdentifier> lang_id;
+  return lang_id->FindLanguage(text).language;
+}
+
+// Keyed by the hash of the text to avoid keeping large selections alive.
+using TextLanguageCache = base::HashingLRUCache<size_t, std::string>;
+
+TextLanguageCache& GetTextLanguageCache() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  static base::NoDestructor<TextLanguageCache> cache(kTextLanguageCacheSize);
+  return *cache;
+}
+
 class JSDialogObserver : public javascript_dialogs::AppModalDialogObserver {
  public:
   JSDialogObserver() = default;
@@ -209,7 +249,13 @@ class TabMutingHandler : public content_settings::Observer {
   HostContentSettingsMap* host_content_settings_map_;
   PrefChangeRegistrar prefs_registrar_;
   Profile* profile_;
+  // Cached value of vivaldiprefs::kTabsAutoMuting.
   TabsAutoMutingValues muteRule_ = TabsAutoMutingValues::kOff;
+  // The active tab and its audible state as of the last update. Background
+  // tabs all share one muting state that only depends on these and on
+  // |muteRule_|, so most notifications only need to update a single tab.
+  base::WeakPtr<WebContents> active_contents_;
+  bool active_is_audible_ = false;
   // NOTE(andre@vivaldi.com) : This is per profile so make sure the handler
   // takes this into account.
   base::ScopedObservation<HostContentSettingsMap, content_settings::Observer>
@@ -218,10 +264,11 @@ class TabMutingHandler : public content_settings::Observer {
   void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
                                const ContentSettingsPattern& secondary_pattern,
                                ContentSettingsType content_type) override {
-    if (content_type != ContentSettingsType::SOUND)
+    if (content_type != ContentSettingsType::SOUND ||
+        muteRule_ == TabsAutoMutingValues::kOff)
       return;
 
-    UpdateMuting();
+    UpdateAllTabs();
   }
 
   bool ContentSettingIsMuted(WebContents* web_contents) {
@@ -252,12 +299,97 @@ class TabMutingHandler : public content_settings::Observer {
     return nullptr;
   }
 
+  static bool IsAudible(WebContents* web_contents) {
+    RecentlyAudibleHelper* audible_helper =
+        RecentlyAudibleHelper::FromWebContents(web_contents);
+    return audible_helper ? audible_helper->WasRecentlyAudible() : false;
+  }
+
+  bool ShouldMute(WebContents* tab) const {
+    bool is_active = (tab == active_contents_.get());
+    bool mute = (muteRule_ != TabsAutoMutingValues::kOff);
+    if (muteRule_ == TabsAutoMutingValues::kOnlyactive) {
+      mute = !is_active;
+    } else if (muteRule_ == TabsAutoMutingValues::kPrioritizeactive) {
+      // Only unmute background tabs if the active is not audible.
+      mute = (active_is_audible_ && !is_active);
+    }
+    return mute;
+  }
+
+  // Returns true when the muting state of background tabs may have changed
+  // since the last update, that is when there was no known active tab or when
+  // the audible state of the active tab matters and changed.
+  bool UpdateActiveContents(WebContents* active_contents) {
+    bool had_active = !!active_contents_;
+    bool was_audible = active_is_audible_;
+    active_contents_ = active_contents->GetWeakPtr();
+    active_is_audible_ = IsAudible(active_contents);
+    return !had_active ||
+           (muteRule_ == TabsAutoMutingValues::kPrioritizeactive &&
+            was_audible != active_is_audible_);
+  }
+
+  void UpdateTab(WebContents* tab) {
+    bool mute = ShouldMute(tab);
+    // Check the cheap condition first, most tabs are already in the right
+    // state.
+    if (tab->IsAudioMuted() == mute)
+      return;
+    if (ContentSettingIsMuted(tab) || IsTabMuted(tab))
+      return;
+    tab->SetAudioMuted(mute);
+  }
+
+  // Updates the active tab, the previously active tab and |changed_tab|. All
+  // tabs are only visited when the muting state of background tabs changed.
+  void UpdateForActiveContents(WebContents* active_contents,
+                               WebContents* changed_tab) {
+    WebContents* old_active = active_contents_.get();
+    if (UpdateActiveContents(active_contents)) {
+      UpdateAllTabs();
+      return;
+    }
+    if (old_active && old_active != active_contents)
+      UpdateTab(old_active);
+    UpdateTab(active_contents);
+    if (changed_tab && changed_tab != active_contents)
+      UpdateTab(changed_tab);
+  }
+
+  void UpdateAllTabs() {
+    WebContents* active_contents = FindActiveTabContentsInThisProfile();
+    if (!active_contents)
+      return;
+    UpdateActiveContents(active_contents);
+
+    for (auto* browser : *BrowserList::GetInstance()) {
+      if (browser->profile()->GetOriginalProfile() == profile_) {
+        for (int i = 0, tab_count = browser->tab_strip_model()->count();
+             i < tab_count; ++i) {
+          UpdateTab(browser->tab_strip_model()->GetWebContentsAt(i));
+        }
+      }
+    }
+  }
+
   void OnPrefsChanged(const std::string& path) {
     if (path == vivaldiprefs::kTabsAutoMuting) {
-      UpdateMuting();
+      TabsAutoMutingValues old_rule = muteRule_;
+      ReadMuteRule();
+      // Nothing was automatically muted while off, so there is nothing to
+      // undo.
+      if (old_rule == TabsAutoMutingValues::kOff && muteRule_ == old_rule)
+        return;
+      UpdateAllTabs();
     }
   }
 
+  void ReadMuteRule() {
+    muteRule_ = static_cast<TabsAutoMutingValues>(
+        profile_->GetPrefs()->GetInteger(vivaldiprefs::kTabsAutoMuting));
+  }
+
  public:
   TabMutingHandler(Profile* profile) : profile_(profile) {
     host_content_settings_map_ =
@@ -270,55 +402,25 @@ class TabMutingHandler : public content_settings::Observer {
     prefs_registrar_.Add(vivaldiprefs::kTabsAutoMuting,
                          base::BindRepeating(&TabMutingHandler::OnPrefsChanged,
                                              base::Unretained(this)));
+    ReadMuteRule();
   }
   ~TabMutingHandler() override {}
 
   void NotifyTabSelectionChange(WebContents* active_contents) {
-    UpdateMuting(active_contents);
+    if (muteRule_ == TabsAutoMutingValues::kOff)
+      return;
+    UpdateForActiveContents(active_contents, nullptr);
   }
 
-  // Called when a tabs audio-state might have changed, or when the active tab
-  // is changed.
-  void UpdateMuting(WebContents* active_contents = nullptr) {
-    if (!active_contents) {
-      active_contents = FindActiveTabContentsInThisProfile();
-    }
-
-    const TabsAutoMutingValues muteRule = static_cast<TabsAutoMutingValues>(
-        profile_->GetPrefs()->GetInteger(vivaldiprefs::kTabsAutoMuting));
-    // active muteRule
-    if ((muteRule_ == TabsAutoMutingValues::kOff && (muteRule_ == muteRule)) ||
-        !active_contents) {
+  // Called when the audio-state, the URL or capturing of |web_contents|
+  // might have changed.
+  void NotifyTabChange(WebContents* web_contents) {
+    if (muteRule_ == TabsAutoMutingValues::kOff)
       return;
-    }
-    muteRule_ = muteRule;
-    RecentlyAudibleHelper* audible_helper =
-        active_contents
-            ? RecentlyAudibleHelper::FromWebContents(active_contents)
-            : nullptr;
-
-    bool active_is_audible =
-        audible_helper ? audible_helper->WasRecentlyAudible() : false;
-
-    for (auto* browser : *BrowserList::GetInstance()) {
-      if (browser->profile()->GetOriginalProfile() == profile_) {
-        for (int i = 0, tab_count = browser->tab_strip_model()->count();
-             i < tab_count; ++i) {
-          WebContents* tab = browser->tab_strip_model()->GetWebContentsAt(i);
-          if (!ContentSettingIsMuted(tab) && !IsTabMuted(tab)) {
-            bool is_active = (tab == active_contents);
-            bool mute = (muteRule_ != TabsAutoMutingValues::kOff);
-            if (muteRule_ == TabsAutoMutingValues::kOnlyactive) {
-              mute = !is_active;
-            } else if (muteRule_ == TabsAutoMutingValues::kPrioritizeactive) {
-              // Only unmute background tabs if the active is not audible.
-              mute = (active_is_audible && !is_active);
-            }
-            tab->SetAudioMuted(mute);
-          }
-        }
-      }
-    }
+    WebContents* active_contents = FindActiveTabContentsInThisProfile();
+    if (!active_contents)
+      return;
+    UpdateForActiveContents(active_contents, web_contents);
   }
 };
 
@@ -345,9 +447,44 @@ TabsPrivateAPI::TabsPrivateAPI(content::BrowserContext* context)
 
 TabsPrivateAPI::~TabsPrivateAPI() {}
 
-void TabsPrivateAPI::UpdateMuting(
-    content::WebContents* active_contents = nullptr) {
-  tabmuting_handler_->UpdateMuting(active_contents);
+void TabsPrivateAPI::Shutdown() {
+  flush_tab_events_timer_.Stop();
+  pending_tab_events_.clear();
+}
+
+// Roughly one frame, so the UI can apply everything in one render pass.
+constexpr base::TimeDelta kCoalescedTabEventsDelay = base::Milliseconds(16);
+
+void TabsPrivateAPI::BroadcastCoalescedTabEvent(
+    const std::string& event_name,
+    int tab_id,
+    base::Value::List args,
+    content::BrowserContext* browser_context) {
+  pending_tab_events_[std::make_pair(event_name, tab_id)] =
+      PendingTabEvent{browser_context, std::move(args)};
+  if (!flush_tab_events_timer_.IsRunning()) {
+    flush_tab_events_timer_.Start(FROM_HERE, kCoalescedTabEventsDelay, this,
+                                  &TabsPrivateAPI::FlushCoalescedTabEvents);
+  }
+}
+
+void TabsPrivateAPI::FlushCoalescedTabEvents() {
+  std::map<std::pair<std::string, int>, PendingTabEvent> events;
+  events.swap(pending_tab_events_);
+  ProfileManager* profile_manager = g_browser_process->profile_manager();
+  for (auto& [key, event] : events) {
+    // An incognito profile may have gone away since the event was queued.
+    if (profile_manager &&
+        !profile_manager->IsValidProfile(event.browser_context)) {
+      continue;
+    }
+    ::vivaldi::BroadcastEvent(key.first, std::move(event.args),
+                              event.browser_context);
+  }
+}
+
+void TabsPrivateAPI::UpdateMuting(content::WebContents* web_contents) {
+  tabmuting_handler_->NotifyTabChange(web_contents);
 }
 
 void TabsPrivateAPI::NotifyTabSelectionChange(
@@ -365,7 +502,7 @@ void TabsPrivateAPI::NotifyTabChange(content::WebContents* web_contents) {
     return;
   }
   // Sound state might have changed, check if any tabs should play or be muted.
-  UpdateMuting();
+  UpdateMuting(web_contents);
 
   std::vector<tabs_private::TabAlertState> states =
       ConvertTabAlertState(chrome::GetTabAlertStatesForContents(web_contents));
@@ -377,8 +514,8 @@ void TabsPrivateAPI::NotifyTabChange(content::WebContents* web_contents) {
   int tabId = extensions::ExtensionTabUtil::GetTabId(web_contents);
   int windowId = extensions::ExtensionTabUtil::GetWindowIdOfTab(web_contents);
 
-  ::vivaldi::BroadcastEvent(
-      tabs_private::OnMediaStateChanged::kEventName,
+  BroadcastCoalescedTabEvent(
+      tabs_private::OnMediaStateChanged::kEventName, tabId,
       tabs_private::OnMediaStateChanged::Create(tabId, windowId, states),
       web_contents->GetBrowserContext());
 }
@@ -447,6 +584,24 @@ void VivaldiPrivateTabObserver::BroadcastTabInfo(
 const int kThemeColorBufferSize = 8;
 
 void VivaldiPrivateTabObserver::DidChangeThemeColor() {
+  // Pages that animate their theme color would make the UI restyle for tabs
+  // nobody sees. Send only the latest color once the tab is shown.
+  if (web_contents()->GetVisibility() == content::Visibility::HIDDEN) {
+    theme_color_pending_ = true;
+    return;
+  }
+  BroadcastThemeColor();
+}
+
+void VivaldiPrivateTabObserver::OnVisibilityChanged(
+    content::Visibility visibility) {
+  if (visibility == content::Visibility::HIDDEN || !theme_color_pending_)
+    return;
+  BroadcastThemeColor();
+}
+
+void VivaldiPrivateTabObserver::BroadcastThemeColor() {
+  theme_color_pending_ = false;
   absl::optional<SkColor> theme_color = web_contents()->GetThemeColor();
   if (!theme_color)
     return;
@@ -456,10 +611,11 @@ void VivaldiPrivateTabObserver::DidChangeThemeColor() {
                  SkColorGetR(*theme_color), SkColorGetG(*theme_color),
                  SkColorGetB(*theme_color));
   int tab_id = extensions::ExtensionTabUtil::GetTabId(web_contents());
-  ::vivaldi::BroadcastEvent(
-      tabs_private::OnThemeColorChanged::kEventName,
-      tabs_private::OnThemeColorChanged::Create(tab_id, rgb_buffer),
-      web_contents()->GetBrowserContext());
+  TabsPrivateAPI::FromBrowserContext(web_contents()->GetBrowserContext())
+      ->BroadcastCoalescedTabEvent(
+          tabs_private::OnThemeColorChanged::kEventName, tab_id,
+          tabs_private::OnThemeColorChanged::Create(tab_id, rgb_buffer),
+          web_contents()->GetBrowserContext());
 }
 
 bool ValueToJSONString(const base::Value& value, std::string& json_string) {
@@ -478,10 +634,56 @@ absl::optional<base::Value> GetDictValueFromVivExtData(
   return absl::nullopt;
 }
 
+const base::Value* VivaldiPrivateTabObserver::GetExtData() {
+  const std::string& viv_ext_data = web_contents()->GetVivExtData();
+  if (!ext_data_parsed_ || viv_ext_data != ext_data_json_) {
+    ext_data_json_ = viv_ext_data;
+    absl::optional<base::Value> json =
+        GetDictValueFromVivExtData(ext_data_json_);
+    ext_data_ = json ? std::move(*json) : base::Value();
+    ext_data_parsed_ = true;
+  }
+  return ext_data_.is_dict() ? &ext_data_ : nullptr;
+}
+
+void VivaldiPrivateTabObserver::SetExtDataKey(base::StringPiece key,
+                                              base::Value value) {
+  if (!GetExtData())
+    return;
+  const base::Value* existing = ext_data_.FindKey(key);
+  if (existing && *existing == value)
+    return;
+  ext_data_.SetKey(key, std::move(value));
+  std::string json_string;
+  if (ValueToJSONString(ext_data_, json_string)) {
+    ext_data_json_ = json_string;
+    web_contents()->SetVivExtData(json_string);
+  } else {
+    // Keep the cache in sync with the unchanged ext data.
+    ext_data_parsed_ = false;
+  }
+}
+
 void VivaldiPrivateTabObserver::RenderFrameCreated(
     content::RenderFrameHost* render_frame_host) {
-  std::string viv_ext_data = web_contents()->GetVivExtData();
-  absl::optional<base::Value> json = GetDictValueFromVivExtData(viv_ext_data);
+  // The tab settings below are per WebContents and a new subframe, also one in
+  // a new process, picks them up from there. So only refresh them for main
+  // frames instead of once per iframe of the page.
+  if (!render_frame_host->GetParent()) {
+    UpdateTabSettingsForMainFrame();
+  }
+
+  const GURL& site = render_frame_host->GetSiteInstance()->GetSiteURL();
+  if (::vivaldi::IsVivaldiApp(site.host())) {
+    auto* security_policy = content::ChildProcessSecurityPolicy::GetInstance();
+    int process_id = render_frame_host->GetProcess()->GetID();
+    security_policy->GrantRequestScheme(process_id, url::kFileScheme);
+    security_policy->GrantRequestScheme(process_id, content::kViewSourceScheme);
+  }
+}
+
+void VivaldiPrivateTabObserver::UpdateTabSettingsForMainFrame() {
+  const base::Value* json = GetExtData();
   if (::vivaldi::IsTabZoomEnabled(web_contents())) {
     absl::optional<double> zoom =
         json ? json->FindDoubleKey(kVivaldiTabZoom) : absl::nullopt;
@@ -497,33 +699,17 @@ void VivaldiPrivateTabObserver::RenderFrameCreated(
 
   // This is not necessary for each RVH-change. And only set when the tab is
   // marked as muted to avoid interfering with site-settings.
-  if (IsTabMuted(web_contents())) {
+  if (json && json->FindBoolKey(kVivaldiTabMuted).value_or(false)) {
     SetMuted(true);
   }
 
   SetLoadFromCacheOnly(load_from_cache_only_);
   UpdateAllowTabCycleIntoUI();
   CommitSettings();
-
-  const GURL& site = render_frame_host->GetSiteInstance()->GetSiteURL();
-  if (::vivaldi::IsVivaldiApp(site.host())) {
-    auto* security_policy = content::ChildProcessSecurityPolicy::GetInstance();
-    int process_id = render_frame_host->GetProcess()->GetID();
-    security_policy->GrantRequestScheme(process_id, url::kFileScheme);
-    security_policy->GrantRequestScheme(process_id, content::kViewSourceScheme);
-  }
 }
 
 void VivaldiPrivateTabObserver::SaveZoomLevelToExtData(double zoom_level) {
-  std::string viv_ext_data = web_contents()->GetVivExtData();
-  absl::optional<base::Value> json = GetDictValueFromVivExtData(viv_ext_data);
-  if (json) {
-    json->SetDoubleKey(kVivaldiTabZoom, zoom_level);
-    std::string json_string;
-    if (ValueToJSONString(*json, json_string)) {
-      web_contents()->SetVivExtData(json_string);
-    }
-  }
+  SetExtDataKey(kVivaldiTabZoom, base::Value(zoom_level));
 }
 
 void VivaldiPrivateTabObserver::RenderViewHostChanged(
@@ -583,16 +769,11 @@ void VivaldiPrivateTabObserver::SetLoadFromCacheOnly(
 
 void VivaldiPrivateTabObserver::SetMuted(bool mute) {
   mute_ = mute;
-  std::string viv_ext_data = web_contents()->GetVivExtData();
-  absl::optional<base::Value> json = GetDictValueFromVivExtData(viv_ext_data);
-  if (json) {
+  if (const base::Value* json = GetExtData()) {
     absl::optional<bool> existing = json->FindBoolKey(kVivaldiTabMuted);
-    if ((existing && *existing != mute) || (!existing && mute)) {
-      json->SetBoolKey(kVivaldiTabMuted, mute);
-      std::string json_string;
-      if (ValueToJSONString(*json, json_string)) {
-        web_contents()->SetVivExtData(json_string);
-      }
+    // Do not add the key just to store the default.
+    if (existing || mute) {
+      SetExtDataKey(kVivaldiTabMuted, base::Value(mute));
     }
   }
   if (mute_ == web_contents()->IsAudioMuted()) {
@@ -732,20 +913,29 @@ void VivaldiPrivateTabObserver::DetermineTextLanguage(
     const std::string& text,
     JSDetermineTextLanguageCallback callback) {
   DCHECK(callback);
-  auto* rfhi = static_cast<content::RenderFrameHostImpl*>(
-      web_contents()->GetPrimaryMainFrame());
-  rfhi->GetVivaldiFrameService()->DetermineTextLanguage(
-      text,
-      mojo::WrapCallbackWithDefaultInvokeIfNotRun(
-          base::BindOnce(&VivaldiPrivateTabObserver::DetermineTextLanguageDone,
-                         weak_ptr_factory_.GetWeakPtr(), std::move(callback)),
-          chrome_lang_id::NNetLanguageIdentifier::kUnknown));
+  // The text comes from the UI, so identify it in the browser rather than
+  // waiting for the page renderer, which may be busy or hung.
+  size_t text_hash = base::FastHash(text);
+  TextLanguageCache& cache = GetTextLanguageCache();
+  auto it = cache.Get(text_hash);
+  if (it != cache.end()) {
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(std::move(callback), it->second));
+    return;
+  }
+  g_text_language_task_runner.Get()->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&IdentifyTextLanguage, text),
+      base::BindOnce(&VivaldiPrivateTabObserver::DetermineTextLanguageDone,
+                     std::move(callback), text_hash));
 }
 
+// static
 void VivaldiPrivateTabObserver::DetermineTextLanguageDone(
     JSDetermineTextLanguageCallback callback,
-    const std::string& langCode) {
-  std::move(callback).Run(std::move(langCode));
+    size_t text_hash,
+    std::string langCode) {
+  GetTextLanguageCache().Put(text_hash, langCode);
+  std::move(callback).Run(langCode);
 }
 
 void VivaldiPrivateTabObserver::OnPermissionAccessed(
@@ -790,6 +980,9 @@ void VivaldiPrivateTabObserver::WebContentsDidDetach() {
 }
 
 void VivaldiPrivateTabObserver::WebContentsDidAttach() {
+  // Restored tabs are loaded only once they are inside their webview.
+  TabLoader::OnVivaldiTabAttached(web_contents());
+
   int tab_id = extensions::ExtensionTabUtil::GetTabId(web_contents());
   ::vivaldi::BroadcastEvent(
       tabs_private::OnTabIsAttached::kEventName,
@@ -836,7 +1029,7 @@ VivaldiPrivateTabObserver* VivaldiPrivateTabObserver::FromTabId(
 void VivaldiPrivateTabObserver::NavigationEntryCommitted(
     const content::LoadCommittedDetails& load_details) {
   TabsPrivateAPI::FromBrowserContext(web_contents()->GetBrowserContext())
-      ->UpdateMuting();
+      ->UpdateMuting(web_contents());
 }
 
 // translate::ContentTranslateDriver::Observer implementation
@@ -1069,14 +1262,12 @@ ExtensionFunction::ResponseAction TabsPrivateStartDragFunction::Run() {
                         kN32_SkColorType == kRGBA_8888_SkColorType,
                     "only two native orders exists");
       // The native order is BGRA and we must use that to construct SkBitmap
-      // that is passed to gfx::ImageSkia(). Swap red and blue.
-      // TODO(igor@vivaldi.com): Find out if there is a utility in Chromium for
-      // doing this conversion in place. SkOpts::RGBA_to_BGRA() is not suitable
-      // as it does the conversion when copying the bytes.
-      uint8_t* p = params->drag_data.image_data->data();
-      for (uint8_t* end = p + size; p < end; p += 4) {
-        std::swap(p[0], p[2]);
-      }
+      // that is passed to gfx::ImageSkia(). Swap red and blue. SkSwapRB() uses
+      // the SIMD kernels of SkOpts::RGBA_to_BGRA(). Those load each block of
+      // pixels before storing it, so the conversion can be done in place.
+      uint32_t* pixels =
+          reinterpret_cast<uint32_t*>(params->drag_data.image_data->data());
+      SkSwapRB(pixels, pixels, w * h);
     }
     SkBitmap bitmap;
     SkImageInfo image_info = SkImageInfo::MakeN32Premul(w, h);
@@ -6,9 +6,12 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/memory/unsafe_shared_memory_region.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
 #include "chrome/browser/extensions/api/tabs/tabs_api.h"
 #include "chrome/browser/ui/tabs/tab_change_type.h"
 #include "components/content_settings/core/common/content_settings.h"
@@ -56,11 +59,26 @@ class TabsPrivateAPI : public BrowserContextKeyedAPI {
   std::unique_ptr<TabMutingHandler> tabmuting_handler_;
   Profile* profile_;
 
+  // Tab events waiting for FlushCoalescedTabEvents keyed by the event name
+  // and the tab id. The browser context is stored as incognito tabs share
+  // this API instance with the original profile.
+  struct PendingTabEvent {
+    content::BrowserContext* browser_context;
+    base::Value::List args;
+  };
+  std::map<std::pair<std::string, int>, PendingTabEvent> pending_tab_events_;
+  base::OneShotTimer flush_tab_events_timer_;
+
+  void FlushCoalescedTabEvents();
+
   // BrowserContextKeyedAPI implementation.
   static const char* service_name() { return "TabsPrivateAPI"; }
   static const bool kServiceIsNULLWhileTesting = true;
   static const bool kServiceRedirectedInIncognito = true;
 
+  // KeyedService implementation.
+  void Shutdown() override;
+
  public:
   explicit TabsPrivateAPI(content::BrowserContext* context);
   ~TabsPrivateAPI() override;
@@ -72,7 +90,9 @@ class TabsPrivateAPI : public BrowserContextKeyedAPI {
   static TabsPrivateAPI* FromBrowserContext(
       content::BrowserContext* browser_context);
 
-  void UpdateMuting(content::WebContents* active_contents);
+  // Update the auto-muting after the audio-state or the URL of |web_contents|
+  // might have changed.
+  void UpdateMuting(content::WebContents* web_contents);
 
   void NotifyTabSelectionChange(content::WebContents* active_contents);
 
@@ -80,6 +100,15 @@ class TabsPrivateAPI : public BrowserContextKeyedAPI {
   static BrowserContextKeyedAPIFactory<TabsPrivateAPI>* GetFactoryInstance();
 
   void NotifyTabChange(content::WebContents* web_contents);
+
+  // Broadcast |event_name| with |args| for |tab_id| after a short delay. The
+  // args of a still pending event with the same name for the same tab are
+  // replaced, so a tab changing state repeatedly within a frame only sends
+  // the latest state to the UI.
+  void BroadcastCoalescedTabEvent(const std::string& event_name,
+                                  int tab_id,
+                                  base::Value::List args,
+                                  content::BrowserContext* browser_context);
 };
 
 // Tab contents observer that forward private settings to any new renderer.
@@ -106,6 +135,11 @@ class VivaldiPrivateTabObserver
 
   void BroadcastTabInfo(vivaldi::tabs_private::UpdateTabInfo& info);
 
+  // Return the ext data of the tab as a dictionary or null if it is not a
+  // JSON object. The parsed value is kept and the ext data is only parsed
+  // again when it changed outside this observer.
+  const base::Value* GetExtData();
+
   // content::WebContentsObserver implementation.
   void DidChangeThemeColor() override;
   void RenderFrameCreated(content::RenderFrameHost* render_frame_host) override;
@@ -123,6 +157,7 @@ class VivaldiPrivateTabObserver
   void CaptureStarted() override;
   void CaptureFinished() override;
   void MediaPictureInPictureChanged(bool is_picture_in_picture) override;
+  void OnVisibilityChanged(content::Visibility visibility) override;
 
   // translate::ContentTranslateDriver::Observer implementation
   void OnPageTranslated(const std::string& original_lang,
@@ -182,8 +217,10 @@ class VivaldiPrivateTabObserver
 
   void DetermineTextLanguage(const std::string& text,
                              JSDetermineTextLanguageCallback callback);
-  void DetermineTextLanguageDone(JSDetermineTextLanguageCallback callback,
-                                 const std::string& langCode);
+  static void DetermineTextLanguageDone(
+      JSDetermineTextLanguageCallback callback,
+      size_t text_hash,
+      std::string langCode);
 
   // If a page is accessing a resource controlled by a permission this will
   // fire.
@@ -194,10 +231,20 @@ class VivaldiPrivateTabObserver
  private:
   friend class content::WebContentsUserData<VivaldiPrivateTabObserver>;
 
+  // Load the tab zoom and mute state from the ext data and push the renderer
+  // settings for a new main frame.
+  void UpdateTabSettingsForMainFrame();
+
   void SaveZoomLevelToExtData(double zoom_level);
 
+  // Set |key| in the ext data. The ext data is serialized and stored only if
+  // the value changes.
+  void SetExtDataKey(base::StringPiece key, base::Value value);
+
   void OnPrefsChanged(const std::string& path);
 
+  void BroadcastThemeColor();
+
   // Show images for all pages loaded in this tab. Default is true.
   bool show_images_ = true;
 
@@ -213,6 +260,15 @@ class VivaldiPrivateTabObserver
   // The tab is muted.
   bool mute_ = false;
 
+  // The theme color changed while the tab was hidden and the UI has not been
+  // told yet.
+  bool theme_color_pending_ = false;
+
+  // Parsed copy of the tab ext data and the string it was parsed from.
+  base::Value ext_data_;
+  std::string ext_data_json_;
+  bool ext_data_parsed_ = false;
+
   // We want to communicate changes in some prefs to the renderer right away.
   PrefChangeRegistrar prefs_registrar_;
 
@@ -13,6 +13,7 @@
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "chrome/browser/importer/importer_list.h"
 #include "chrome/browser/shell_integration.h"
@@ -179,21 +180,21 @@ void ChromeBookmarkReader::DecodeNode(const base::Value::Dict& dict) {
 
 }  // namespace
 
-void ChromiumImporter::ImportBookMarks() {
-  if (bookmarkfilename_.empty()) {
-    bridge_->NotifyEnded();
-    return;
-  }
-
-  base::FilePath file(bookmarkfilename_);
+// static
+std::vector<ImportedBookmarkEntry> ChromiumImporter::ReadBookmarks(
+    const base::FilePath& file) {
   ChromeBookmarkReader reader;
-
   reader.LoadFile(file);
+  return reader.Bookmarks();
+}
 
-  if (!reader.Bookmarks().empty() && !cancelled()) {
+void ChromiumImporter::ImportBookMarks(
+    const std::vector<ImportedBookmarkEntry>& bookmarks) {
+  TRACE_EVENT0("vivaldi", "ChromiumImporter::ImportBookMarks");
+  if (!bookmarks.empty() && !cancelled()) {
     const std::u16string& first_folder_name =
         bridge_->GetLocalizedString(IDS_IMPORTED_BOOKMARKS);
 
-    bridge_->AddBookmarks(reader.Bookmarks(), first_folder_name);
+    bridge_->AddBookmarks(bookmarks, first_folder_name);
   }
 }
@@ -11,12 +11,17 @@
 #include "base/command_line.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
+#include "base/memory/ref_counted.h"
 #include "base/path_service.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_tokenizer.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task/thread_pool.h"
 #include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "chrome/browser/importer/importer_list.h"
@@ -35,6 +40,51 @@
 #include "sql/statement.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "ui/base/l10n/l10n_util.h"
+#include "ui/base/page_transition_types.h"
+
+namespace {
+
+// Number of history rows to read before sending them to the bridge. Each
+// chunk is written to the history database in one go.
+constexpr size_t kHistoryChunkSize = 5000;
+
+// Result of a reader running on the thread pool. The import thread only
+// blocks in Take() when it is ready to write that data type to the bridge, so
+// reading overlaps with the writes of the data types imported before it.
+template <typename T>
+class PendingRead : public base::RefCountedThreadSafe<PendingRead<T>> {
+ public:
+  PendingRead() = default;
+  PendingRead(const PendingRead&) = delete;
+  PendingRead& operator=(const PendingRead&) = delete;
+
+  static scoped_refptr<PendingRead> Start(base::OnceCallback<T()> reader) {
+    auto pending = base::MakeRefCounted<PendingRead>();
+    base::ThreadPool::PostTask(
+        FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&PendingRead::Run, pending, std::move(reader)));
+    return pending;
+  }
+
+  T Take() {
+    done_.Wait();
+    return std::move(value_);
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<PendingRead>;
+  ~PendingRead() = default;
+
+  void Run(base::OnceCallback<T()> reader) {
+    value_ = std::move(reader).Run();
+    done_.Signal();
+  }
+
+  T value_;
+  base::WaitableEvent done_;
+};
+
+}  // namespace
 
 ChromiumImporter::ChromiumImporter() {}
 
@@ -48,6 +98,25 @@ void ChromiumImporter::StartImport(
   std::string name = source_profile.selected_profile_name;
   profile_dir_ = source_profile.source_path.AppendASCII(name);
 
+  // Start the readers for bookmarks and passwords right away. If the import
+  // is cancelled the readers finish on their own, they do not use |this|.
+  scoped_refptr<PendingRead<std::vector<ImportedBookmarkEntry>>> bookmarks;
+  if (items & importer::FAVORITES) {
+    base::FilePath bookmark_file = profile_dir_.AppendASCII("Bookmarks");
+    if (base::PathExists(bookmark_file)) {
+      bookmarks = PendingRead<std::vector<ImportedBookmarkEntry>>::Start(
+          base::BindOnce(&ChromiumImporter::ReadBookmarks, bookmark_file));
+    }
+  }
+  scoped_refptr<PendingRead<std::vector<importer::ImportedPasswordForm>>>
+      passwords;
+  if (items & importer::PASSWORDS) {
+    passwords =
+        PendingRead<std::vector<importer::ImportedPasswordForm>>::Start(
+            base::BindOnce(&ChromiumImporter::ReadPasswords, profile_dir_,
+                           source_profile.importer_type));
+  }
+
   bridge_->NotifyStarted();
 
   if ((items & importer::HISTORY) && !cancelled()) {
@@ -57,24 +126,18 @@ void ChromiumImporter::StartImport(
   }
 
   if ((items & importer::FAVORITES) && !cancelled()) {
-    base::FilePath bookmarkFilePath = profile_dir_.AppendASCII("Bookmarks");
-
-    bookmarkfilename_ = bookmarkFilePath.value();
-    if (!base::PathExists(bookmarkFilePath)) {
-      // Just notify about start and end if the file doesn't exist, otherwise
-      // the end of import detection won't work.
-      bridge_->NotifyItemStarted(importer::FAVORITES);
-      bridge_->NotifyItemEnded(importer::FAVORITES);
-    } else {
-      bridge_->NotifyItemStarted(importer::FAVORITES);
-      ImportBookMarks();
-      bridge_->NotifyItemEnded(importer::FAVORITES);
+    // Always notify about start and end, even if the file doesn't exist,
+    // otherwise the end of import detection won't work.
+    bridge_->NotifyItemStarted(importer::FAVORITES);
+    if (bookmarks) {
+      ImportBookMarks(bookmarks->Take());
     }
+    bridge_->NotifyItemEnded(importer::FAVORITES);
   }
 
   if ((items & importer::PASSWORDS) && !cancelled()) {
     bridge_->NotifyItemStarted(importer::PASSWORDS);
-    ImportPasswords(source_profile.importer_type);
+    ImportPasswords(passwords->Take());
     bridge_->NotifyItemEnded(importer::PASSWORDS);
   }
 
@@ -84,46 +147,49 @@ void ChromiumImporter::StartImport(
 #if BUILDFLAG(IS_WIN)
 std::string import_encryption_key;
 #endif  // IS_WIN
-void ChromiumImporter::ImportPasswords(importer::ImporterType importer_type) {
+// static
+std::vector<importer::ImportedPasswordForm> ChromiumImporter::ReadPasswords(
+    const base::FilePath& profile_dir,
+    importer::ImporterType importer_type) {
   // Initializes Chrome decryptor
 
   std::vector<importer::ImportedPasswordForm> forms;
-  base::FilePath source_path = profile_dir_;
+  base::FilePath source_path = profile_dir;
 
 #if BUILDFLAG(IS_WIN)
   // Read encryption key from other browser local state
   base::FilePath local_state_file =
-      profile_dir_.DirName().AppendASCII("Local State");
+      profile_dir.DirName().AppendASCII("Local State");
   if (!base::PathExists(local_state_file)) {
     LOG(ERROR) << "Unable to find Local State for import browser.";
-    return;
+    return forms;
   }
 
   std::string local_state_string;
   if (!ReadFileToString(local_state_file, &local_state_string)) {
     LOG(ERROR) << "Unable to read Local State from disk.";
-    return;
+    return forms;
   }
 
   absl::optional<base::Value> local_state(
       base::JSONReader::Read(local_state_string));
   if (!local_state) {
     LOG(ERROR) << "Unable to parse JSON in Local State.";
-    return;
+    return forms;
   }
 
   if (local_state->is_dict()) {
     base::Value* os_crypt_dict = local_state->FindDictKey("os_crypt");
     if (!os_crypt_dict) {
       LOG(ERROR) << "Unable to find 'os_cypt' entry for import browser.";
-      return;
+      return forms;
     }
 
     const std::string* base64_encoded_key =
         os_crypt_dict->FindStringKey("encrypted_key");
     if (!base64_encoded_key) {
       LOG(ERROR) << "Unable to find 'encrypted_key' entry for import browser.";
-      return;
+      return forms;
     }
 
     std::string encrypted_key_with_header;
@@ -134,7 +200,7 @@ void ChromiumImporter::ImportPasswords(importer::ImporterType importer_type) {
     if (!base::StartsWith(encrypted_key_with_header, kDPAPIKeyPrefix,
                           base::CompareCase::SENSITIVE)) {
       LOG(ERROR) << "Key is not DPAPI key, unable to decrypt.";
-      return;
+      return forms;
     }
 
     std::string dpapi_encrypted_key =
@@ -144,7 +210,7 @@ void ChromiumImporter::ImportPasswords(importer::ImporterType importer_type) {
     // by an Administrator.
     if (!OSCrypt::DecryptString(dpapi_encrypted_key, &import_encryption_key)) {
       LOG(ERROR) << "Decryption key invalid.";
-      return;
+      return forms;
     }
   }
 #endif  // IS_WIN
@@ -153,16 +219,21 @@ void ChromiumImporter::ImportPasswords(importer::ImporterType importer_type) {
   if (base::PathExists(file)) {
     ReadAndParseSignons(file, &forms, importer_type);
   }
-  if (!cancelled()) {
-    for (size_t i = 0; i < forms.size(); ++i) {
-      if (!forms[i].username_value.empty() ||
-          !forms[i].password_value.empty()) {
-        bridge_->SetPasswordForm(forms[i]);
-      }
+  return forms;
+}
+
+void ChromiumImporter::ImportPasswords(
+    const std::vector<importer::ImportedPasswordForm>& forms) {
+  if (cancelled())
+    return;
+  for (const importer::ImportedPasswordForm& form : forms) {
+    if (!form.username_value.empty() || !form.password_value.empty()) {
+      bridge_->SetPasswordForm(form);
     }
   }
 }
 
+// static
 bool ChromiumImporter::ReadAndParseSignons(
     const base::FilePath& sqlite_file,
     std::vector<importer::ImportedPasswordForm>* forms,
@@ -252,35 +323,67 @@ bool ChromiumImporter::ReadAndParseSignons(
 }
 
 void ChromiumImporter::ImportHistory() {
-  std::vector<ImporterURLRow> historyRows;
+  TRACE_EVENT0("vivaldi", "ChromiumImporter::ImportHistory");
   base::FilePath source_path = profile_dir_;
 
   base::FilePath file = source_path.AppendASCII("History");
   if (base::PathExists(file)) {
-    ReadAndParseHistory(file, &historyRows);
+    size_t count = ReadAndImportHistory(file);
+    VLOG(1) << "Imported " << count << " history rows";
   }
-
-  if (!historyRows.empty() && !cancelled())
-    bridge_->SetHistoryItems(historyRows,
-                             importer::VISIT_SOURCE_CHROMIUM_IMPORTED);
 }
 
-bool ChromiumImporter::ReadAndParseHistory(const base::FilePath& sqlite_file,
-                                           std::vector<ImporterURLRow>* forms) {
+size_t ChromiumImporter::ReadAndImportHistory(
+    const base::FilePath& sqlite_file) {
   sql::Database db;
   if (!db.Open(sqlite_file))
-    return false;
-
-  const char query2[] =
+    return 0;
+
+  // Import every visit rather than only the last one per url. The history
+  // backend adds one visit per imported row and only adds the url itself
+  // for the first row, so the visits are sorted newest first to give the url
+  // its most recent visit time. Urls without visits keep their last visit.
+  // Each imported visit shows up as a page the user opened, so subframe
+  // visits and all but the last hop of a redirect chain are skipped, as are
+  // the urls that only have such visits.
+  const std::string visits_query = base::StringPrintf(
+      "SELECT u.url, u.title, u.visit_count, u.hidden, u.typed_count, "
+      "COALESCE(v.visit_time, case when u.last_visit_time = 0 then 1 else "
+      "u.last_visit_time end) AS visit_time "
+      "FROM urls u LEFT JOIN visits v ON v.url = u.id "
+      "AND (v.transition & %u) NOT IN (%u, %u) AND (v.transition & %u) != 0 "
+      "WHERE v.id IS NOT NULL "
+      "OR NOT EXISTS (SELECT 1 FROM visits w WHERE w.url = u.id) "
+      "ORDER BY visit_time DESC",
+      static_cast<unsigned>(ui::PAGE_TRANSITION_CORE_MASK),
+      static_cast<unsigned>(ui::PAGE_TRANSITION_AUTO_SUBFRAME),
+      static_cast<unsigned>(ui::PAGE_TRANSITION_MANUAL_SUBFRAME),
+      static_cast<unsigned>(ui::PAGE_TRANSITION_CHAIN_END));
+  // Fallback for profiles without a visits table.
+  const char urls_query[] =
       "SELECT url, title, visit_count, hidden, typed_count, case when "
       "last_visit_time = 0 then 1 else last_visit_time end as last_visit_time "
       "FROM urls";
 
-  sql::Statement s2(db.GetUniqueStatement(query2));
+  const char* query =
+      db.DoesTableExist("visits") ? visits_query.c_str() : urls_query;
+  sql::Statement s2(db.GetUniqueStatement(query));
   if (!s2.is_valid())
-    return false;
+    return 0;
 
-  while (s2.Step()) {
+  size_t imported = 0;
+  std::vector<ImporterURLRow> rows;
+  rows.reserve(kHistoryChunkSize);
+  auto flush = [&]() {
+    if (rows.empty())
+      return;
+    bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_CHROMIUM_IMPORTED);
+    imported += rows.size();
+    VLOG(1) << "Imported " << imported << " history rows so far";
+    rows.clear();
+  };
+
+  while (!cancelled() && s2.Step()) {
     ImporterURLRow row(GURL(s2.ColumnString(0)));
     row.title = s2.ColumnString16(1);
     row.visit_count = s2.ColumnInt(2);
@@ -289,7 +392,13 @@ bool ChromiumImporter::ReadAndParseHistory(const base::FilePath& sqlite_file,
 
     base::Time t = base::Time::FromInternalValue(s2.ColumnInt64(5));
     row.last_visit = t;
-    forms->push_back(row);
+    rows.push_back(std::move(row));
+    if (rows.size() >= kHistoryChunkSize) {
+      flush();
+    }
   }
-  return true;
+  if (!cancelled()) {
+    flush();
+  }
+  return imported;
 }
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "base/values.h"
+#include "chrome/common/importer/imported_bookmark_entry.h"
 #include "chrome/common/importer/importer_data_types.h"
 #include "chrome/common/importer/importer_type.h"
 #include "chrome/common/importer/importer_url_row.h"
@@ -17,7 +18,6 @@ class ImportedNoteEntry;
 class ChromiumImporter : public Importer {
  public:
   ChromiumImporter();
-  void ImportPasswords(importer::ImporterType importer_type);
 
   // Importer
   void StartImport(const importer::SourceProfile& source_profile,
@@ -31,15 +31,26 @@ class ChromiumImporter : public Importer {
 
  private:
   base::FilePath profile_dir_;
-  base::FilePath::StringType bookmarkfilename_;
-  void ImportBookMarks();
+  void ImportBookMarks(const std::vector<ImportedBookmarkEntry>& bookmarks);
   void ImportHistory();
-  bool ReadAndParseSignons(const base::FilePath& sqlite_file,
-                           std::vector<importer::ImportedPasswordForm>* forms,
-                           importer::ImporterType importer_type);
-
-  bool ReadAndParseHistory(const base::FilePath& sqlite_file,
-                           std::vector<ImporterURLRow>* forms);
+  void ImportPasswords(
+      const std::vector<importer::ImportedPasswordForm>& forms);
+
+  // The readers below only use their arguments, so StartImport runs them on
+  // the thread pool while the import thread writes other data to the bridge.
+  static std::vector<ImportedBookmarkEntry> ReadBookmarks(
+      const base::FilePath& file);
+  static std::vector<importer::ImportedPasswordForm> ReadPasswords(
+      const base::FilePath& profile_dir,
+      importer::ImporterType importer_type);
+  static bool ReadAndParseSignons(
+      const base::FilePath& sqlite_file,
+      std::vector<importer::ImportedPasswordForm>* forms,
+      importer::ImporterType importer_type);
+
+  // Read the history visits in chunks and pass each chunk to the bridge as
+  // soon as it is read. Returns the number of imported rows.
+  size_t ReadAndImportHistory(const base::FilePath& sqlite_file);
 };
 
 #endif  // IMPORTER_CHROMIUM_IMPORTER_H_
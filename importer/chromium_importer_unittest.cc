@@ -0,0 +1,146 @@
+// Copyright (c) 2022 Vivaldi Technologies AS. All rights reserved
+
+#include "importer/chromium_importer.h"
+
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "chrome/common/importer/importer_data_types.h"
+#include "chrome/common/importer/importer_url_row.h"
+#include "chrome/common/importer/mock_importer_bridge.h"
+#include "sql/database.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/base/page_transition_types.h"
+
+namespace {
+
+using ::testing::_;
+
+constexpr char kProfileName[] = "Default";
+
+// A link click that is the only visit of its redirect chain.
+constexpr uint32_t kLinkVisit = ui::PAGE_TRANSITION_LINK |
+                                ui::PAGE_TRANSITION_CHAIN_START |
+                                ui::PAGE_TRANSITION_CHAIN_END;
+
+class ChromiumImporterTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    base::FilePath profile_dir = temp_dir_.GetPath().AppendASCII(kProfileName);
+    ASSERT_TRUE(base::CreateDirectory(profile_dir));
+    ASSERT_TRUE(db_.Open(profile_dir.AppendASCII("History")));
+    // The columns of the History database that the importer reads.
+    ASSERT_TRUE(db_.Execute(
+        "CREATE TABLE urls(id INTEGER PRIMARY KEY, url LONGVARCHAR, "
+        "title LONGVARCHAR, visit_count INTEGER DEFAULT 0 NOT NULL, "
+        "typed_count INTEGER DEFAULT 0 NOT NULL, "
+        "last_visit_time INTEGER NOT NULL, "
+        "hidden INTEGER DEFAULT 0 NOT NULL)"));
+    ASSERT_TRUE(db_.Execute(
+        "CREATE TABLE visits(id INTEGER PRIMARY KEY, url INTEGER NOT NULL, "
+        "visit_time INTEGER NOT NULL, transition INTEGER DEFAULT 0 NOT NULL)"));
+  }
+
+  void AddURL(int id, const std::string& url, int64_t last_visit_time) {
+    ASSERT_TRUE(db_.Execute(
+        base::StringPrintf("INSERT INTO urls(id, url, title, visit_count, "
+                           "last_visit_time) VALUES(%d, '%s', 'title', 1, "
+                           "%" PRId64 ")",
+                           id, url.c_str(), last_visit_time)
+            .c_str()));
+  }
+
+  void AddVisit(int url_id, int64_t visit_time, uint32_t transition) {
+    ASSERT_TRUE(db_.Execute(
+        base::StringPrintf("INSERT INTO visits(url, visit_time, transition) "
+                           "VALUES(%d, %" PRId64 ", %u)",
+                           url_id, visit_time, transition)
+            .c_str()));
+  }
+
+  // Runs the history import and returns the urls of the imported rows.
+  std::vector<std::string> ImportHistory() {
+    db_.Close();
+    std::vector<ImporterURLRow> rows;
+    scoped_refptr<ChromiumImporter> importer = new ChromiumImporter;
+    importer::SourceProfile profile;
+    profile.source_path = temp_dir_.GetPath();
+    profile.selected_profile_name = kProfileName;
+    scoped_refptr<MockImporterBridge> bridge = new MockImporterBridge;
+    EXPECT_CALL(*bridge, NotifyStarted());
+    EXPECT_CALL(*bridge, NotifyItemStarted(importer::HISTORY));
+    EXPECT_CALL(*bridge, SetHistoryItems(_, _))
+        .WillOnce(::testing::SaveArg<0>(&rows));
+    EXPECT_CALL(*bridge, NotifyItemEnded(importer::HISTORY));
+    EXPECT_CALL(*bridge, NotifyEnded());
+    importer->StartImport(profile, importer::HISTORY, bridge.get());
+
+    std::vector<std::string> urls;
+    for (const ImporterURLRow& row : rows) {
+      urls.push_back(row.url.spec());
+    }
+    return urls;
+  }
+
+  base::ScopedTempDir temp_dir_;
+  sql::Database db_;
+};
+
+}  // namespace
+
+TEST_F(ChromiumImporterTest, ImportsEveryVisitNewestFirst) {
+  AddURL(1, "http://a.com/", 30);
+  AddURL(2, "http://b.com/", 20);
+  AddVisit(1, 10, kLinkVisit);
+  AddVisit(2, 20, ui::PAGE_TRANSITION_TYPED | ui::PAGE_TRANSITION_CHAIN_START |
+                      ui::PAGE_TRANSITION_CHAIN_END);
+  AddVisit(1, 30, kLinkVisit);
+
+  EXPECT_EQ(ImportHistory(),
+            (std::vector<std::string>{"http://a.com/", "http://b.com/",
+                                      "http://a.com/"}));
+}
+
+TEST_F(ChromiumImporterTest, SkipsRedirectHops) {
+  AddURL(1, "http://redirect.com/", 10);
+  AddURL(2, "http://target.com/", 11);
+  AddVisit(1, 10, ui::PAGE_TRANSITION_LINK | ui::PAGE_TRANSITION_CHAIN_START);
+  AddVisit(2, 11,
+           ui::PAGE_TRANSITION_LINK | ui::PAGE_TRANSITION_SERVER_REDIRECT |
+               ui::PAGE_TRANSITION_CHAIN_END);
+
+  EXPECT_EQ(ImportHistory(), (std::vector<std::string>{"http://target.com/"}));
+}
+
+TEST_F(ChromiumImporterTest, SkipsSubframes) {
+  AddURL(1, "http://page.com/", 30);
+  AddURL(2, "http://ad.com/", 20);
+  AddURL(3, "http://frame.com/", 10);
+  AddVisit(1, 30, kLinkVisit);
+  AddVisit(2, 20,
+           ui::PAGE_TRANSITION_AUTO_SUBFRAME |
+               ui::PAGE_TRANSITION_CHAIN_START |
+               ui::PAGE_TRANSITION_CHAIN_END);
+  AddVisit(3, 10,
+           ui::PAGE_TRANSITION_MANUAL_SUBFRAME |
+               ui::PAGE_TRANSITION_CHAIN_START |
+               ui::PAGE_TRANSITION_CHAIN_END);
+
+  EXPECT_EQ(ImportHistory(), (std::vector<std::string>{"http://page.com/"}));
+}
+
+TEST_F(ChromiumImporterTest, KeepsUrlsWithoutVisits) {
+  AddURL(1, "http://visited.com/", 10);
+  AddURL(2, "http://expired.com/", 20);
+  AddVisit(1, 10, kLinkVisit);
+
+  EXPECT_EQ(ImportHistory(),
+            (std::vector<std::string>{"http://expired.com/",
+                                      "http://visited.com/"}));
+}
@@ -5,6 +5,7 @@
 #include "base/files/file_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
 #include "chrome/common/importer/importer_bridge.h"
 #include "chrome/common/ini_parser.h"
@@ -136,6 +137,7 @@ void OperaImporter::StartImport(const importer::SourceProfile& source_profile,
 }
 
 bool OperaImporter::ImportSpeedDial(std::string* error) {
+  TRACE_EVENT0("vivaldi", "OperaImporter::ImportSpeedDial");
   std::vector<ImportedSpeedDialEntry> entries;
   DictionaryValueINIParser inifile_parser;
   base::FilePath ini_file(profile_dir_);
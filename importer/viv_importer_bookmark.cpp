@@ -8,10 +8,10 @@
 #include "base/files/file_util.h"
 #include "base/path_service.h"
 #include "base/strings/string_number_conversions.h"
-#include "base/strings/string_tokenizer.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "chrome/browser/importer/importer_list.h"
 #include "chrome/browser/shell_integration.h"
@@ -34,7 +34,7 @@ class OperaBookmarkReader : public OperaAdrFileReader {
   OperaBookmarkReader& operator=(const OperaBookmarkReader&) = delete;
 
   void AddBookmark(const std::vector<std::u16string>& current_folder,
-                   const base::Value::Dict& entries,
+                   const OperaAdrEntry& entry,
                    bool is_folder,
                    std::u16string* item_name = NULL);
 
@@ -43,22 +43,22 @@ class OperaBookmarkReader : public OperaAdrFileReader {
   }
 
  protected:
-  void HandleEntry(const std::string& category,
-                   const base::Value::Dict& entries) override;
+  void HandleEntry(base::StringPiece category,
+                   const OperaAdrEntry& entry) override;
 
  private:
   std::vector<std::u16string> current_folder_;
   std::vector<ImportedBookmarkEntry> bookmarks_;
 };
 
-void OperaBookmarkReader::HandleEntry(const std::string& category,
-                                      const base::Value::Dict& entries) {
+void OperaBookmarkReader::HandleEntry(base::StringPiece category,
+                                      const OperaAdrEntry& entry) {
   if (base::EqualsCaseInsensitiveASCII(category, "folder")) {
     std::u16string foldername;
-    AddBookmark(current_folder_, entries, true, &foldername);
+    AddBookmark(current_folder_, entry, true, &foldername);
     current_folder_.push_back(foldername);
   } else if (base::EqualsCaseInsensitiveASCII(category, "url")) {
-    AddBookmark(current_folder_, entries, false);
+    AddBookmark(current_folder_, entry, false);
   } else if (category == "-") {
     current_folder_.pop_back();
   }
@@ -66,47 +66,47 @@ void OperaBookmarkReader::HandleEntry(const std::string& category,
 
 void OperaBookmarkReader::AddBookmark(
     const std::vector<std::u16string>& current_folder,
-    const base::Value::Dict& entries,
+    const OperaAdrEntry& entry,
     bool is_folder,
     std::u16string* item_name) {
-  const std::string* url = nullptr;
+  absl::optional<base::StringPiece> url;
   if (!is_folder) {
-    url = entries.FindString("url");
+    url = entry.url;
   }
 
-  const std::string* name = entries.FindString("name");
+  absl::optional<base::StringPiece> name = entry.name;
   if (!name) {
     name = url;
   }
 
-  const std::string* nickname = entries.FindString("short name");
-  const std::string* description = entries.FindString("description");
-
   double created_time = 0;
-  if (const std::string* created = entries.FindString("created")) {
-    if (!base::StringToDouble(*created, &created_time)) {
+  if (entry.created) {
+    if (!base::StringToDouble(*entry.created, &created_time)) {
       created_time = 0;
     }
   }
 
-  ImportedBookmarkEntry entry;
-  entry.in_toolbar = false;  // on_personal_bar;
-  entry.is_folder = is_folder;
-  entry.title = name ? base::UTF8ToUTF16(*name) : std::u16string();
-  entry.nickname = nickname ? *nickname : std::string();
-  entry.description = description ? *description : std::string();
-  entry.path = current_folder;
-  entry.url = GURL(url ? *url : std::string());
-  entry.creation_time = base::Time::FromTimeT(created_time);
+  ImportedBookmarkEntry bookmark;
+  bookmark.in_toolbar = false;  // on_personal_bar;
+  bookmark.is_folder = is_folder;
+  bookmark.title = name ? base::UTF8ToUTF16(*name) : std::u16string();
+  bookmark.nickname =
+      entry.short_name ? std::string(*entry.short_name) : std::string();
+  bookmark.description =
+      entry.description ? std::string(*entry.description) : std::string();
+  bookmark.path = current_folder;
+  bookmark.url = url ? GURL(*url) : GURL();
+  bookmark.creation_time = base::Time::FromTimeT(created_time);
 
   if (item_name) {
-    *item_name = entry.title;
+    *item_name = bookmark.title;
   }
 
-  bookmarks_.push_back(std::move(entry));
+  bookmarks_.push_back(std::move(bookmark));
 }
 
 bool OperaImporter::ImportBookMarks(std::string* error) {
+  TRACE_EVENT0("vivaldi", "OperaImporter::ImportBookMarks");
   if (bookmarkfilename_.empty()) {
     *error = "No bookmark filename provided.";
     return false;
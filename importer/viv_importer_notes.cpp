@@ -12,6 +12,7 @@
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "chrome/browser/importer/importer_list.h"
 #include "chrome/browser/shell_integration.h"
@@ -30,29 +31,29 @@ class OperaNotesReader : public OperaAdrFileReader {
   OperaNotesReader& operator=(const OperaNotesReader&) = delete;
 
   void AddNote(const std::vector<std::u16string>& current_folder,
-               const base::Value::Dict& entries,
+               const OperaAdrEntry& entry,
                bool is_folder,
                std::u16string* item_name = NULL);
 
   const std::vector<ImportedNotesEntry>& Notes() const { return notes_; }
 
  protected:
-  void HandleEntry(const std::string& category,
-                   const base::Value::Dict& entries) override;
+  void HandleEntry(base::StringPiece category,
+                   const OperaAdrEntry& entry) override;
 
  private:
   std::vector<std::u16string> current_folder_;
   std::vector<ImportedNotesEntry> notes_;
 };
 
-void OperaNotesReader::HandleEntry(const std::string& category,
-                                   const base::Value::Dict& entries) {
+void OperaNotesReader::HandleEntry(base::StringPiece category,
+                                   const OperaAdrEntry& entry) {
   if (base::EqualsCaseInsensitiveASCII(category, "folder")) {
     std::u16string foldername;
-    AddNote(current_folder_, entries, true, &foldername);
+    AddNote(current_folder_, entry, true, &foldername);
     current_folder_.push_back(foldername);
   } else if (base::EqualsCaseInsensitiveASCII(category, "note")) {
-    AddNote(current_folder_, entries, false);
+    AddNote(current_folder_, entry, false);
   } else if (category == "-") {
     current_folder_.pop_back();
   }
@@ -60,16 +61,15 @@ void OperaNotesReader::HandleEntry(const std::string& category,
 
 void OperaNotesReader::AddNote(
     const std::vector<std::u16string>& current_folder,
-    const base::Value::Dict& entries,
+    const OperaAdrEntry& entry,
     bool is_folder,
     std::u16string* item_name) {
-
-  const std::string* url = nullptr;
+  absl::optional<base::StringPiece> url;
   if (!is_folder) {
-    url = entries.FindString("url");
+    url = entry.url;
   }
 
-  const std::string* name = entries.FindString("name");
+  absl::optional<base::StringPiece> name = entry.name;
   if (!name) {
     name = url;
   }
@@ -99,24 +99,25 @@ void OperaNotesReader::AddNote(
     *item_name = title;
 
   double created_time = 0;
-  if (const std::string* created = entries.FindString("created")) {
-    if (!base::StringToDouble(*created, &created_time)) {
+  if (entry.created) {
+    if (!base::StringToDouble(*entry.created, &created_time)) {
       created_time = 0;
     }
   }
 
-  ImportedNotesEntry entry;
-  entry.is_folder = is_folder;
-  entry.title = std::move(title);
-  entry.content = std::move(content);
-  entry.path = current_folder;
-  entry.url = GURL(url ? *url : std::string());
-  entry.creation_time = base::Time::FromTimeT(created_time);
+  ImportedNotesEntry note;
+  note.is_folder = is_folder;
+  note.title = std::move(title);
+  note.content = std::move(content);
+  note.path = current_folder;
+  note.url = url ? GURL(*url) : GURL();
+  note.creation_time = base::Time::FromTimeT(created_time);
 
-  notes_.push_back(std::move(entry));
+  notes_.push_back(std::move(note));
 }
 
 bool OperaImporter::ImportNotes(std::string* error) {
+  TRACE_EVENT0("vivaldi", "OperaImporter::ImportNotes");
   if (notesfilename_.empty()) {
     *error = "No notes filename provided.";
     return false;
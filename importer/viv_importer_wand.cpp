@@ -5,11 +5,13 @@
 #include <openssl/evp.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/files/file_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
 #include "chrome/browser/importer/importer_list.h"
 #include "chrome/common/importer/importer_bridge.h"
 #include "chrome/common/importer/importer_data_types.h"
@@ -338,6 +340,7 @@ bool WandReadEncryptedField(std::string::iterator* buffer,
     out_data.resize(total_len);
   }
   result->clear();
+  result->reserve(out_data.size() / 2);
   for (binary_string::iterator it = out_data.begin(); it < out_data.end();) {
     unsigned char c01 = *it;
     it++;
@@ -476,16 +479,16 @@ bool OperaImporter::ImportWand_ReadEntryHTML(
   password.blocked_by_user = (field_count == 0);
 
   if (first_field >= 0) {
-    password.username_element = fields[first_field].fieldname;
-    password.username_value = fields[first_field].fieldvalue;
+    password.username_element = std::move(fields[first_field].fieldname);
+    password.username_value = std::move(fields[first_field].fieldvalue);
   }
 
   if (first_pass >= 0) {
-    password.password_element = fields[first_pass].fieldname;
-    password.password_value = fields[first_pass].fieldvalue;
+    password.password_element = std::move(fields[first_pass].fieldname);
+    password.password_value = std::move(fields[first_pass].fieldvalue);
   }
 
-  passwords->push_back(password);
+  passwords->push_back(std::move(password));
 
   return true;
 }
@@ -561,13 +564,13 @@ bool OperaImporter::ImportWand_ReadEntryAuth(
   password.blocked_by_user = (field_count == 0);
 
   if (first_field >= 0) {
-    password.username_element = fields[first_field].fieldname;
-    password.username_value = fields[first_field].fieldvalue;
+    password.username_element = std::move(fields[first_field].fieldname);
+    password.username_value = std::move(fields[first_field].fieldvalue);
   }
 
   if (first_pass >= 0) {
-    password.password_element = fields[first_pass].fieldname;
-    password.password_value = fields[first_pass].fieldvalue;
+    password.password_element = std::move(fields[first_pass].fieldname);
+    password.password_value = std::move(fields[first_pass].fieldvalue);
   }
 
   /*
@@ -581,7 +584,7 @@ bool OperaImporter::ImportWand_ReadEntryAuth(
   }
   */
 
-  passwords->push_back(password);
+  passwords->push_back(std::move(password));
 
   return true;
 }
@@ -673,6 +676,7 @@ bool WandFormatError(std::string* error) {
 }  // namespace
 
 bool OperaImporter::ImportWand(std::string* error) {
+  TRACE_EVENT0("vivaldi", "OperaImporter::ImportWand");
   if (wandfilename_.empty()) {
     *error = "No notes filename provided.";
     return false;
@@ -771,11 +775,10 @@ bool OperaImporter::ImportWand(std::string* error) {
       return WandFormatError(error);
   }
 
-  if (!cancelled()) {
-    for (std::vector<importer::ImportedPasswordForm>::iterator it =
-             passwords.begin();
-         it < passwords.end(); it++)
-      bridge_->SetPasswordForm(*it);
+  for (const importer::ImportedPasswordForm& password : passwords) {
+    if (cancelled())
+      break;
+    bridge_->SetPasswordForm(password);
   }
   return true;
 }
@@ -1,25 +1,28 @@
 // Copyright (c) 2013-2016 Vivaldi Technologies AS. All rights reserved
 
-#include <stack>
-#include <string>
-
 #include "importer/viv_opera_reader.h"
 
-#include "base/bind.h"
 #include "base/files/file_util.h"
-#include "base/path_service.h"
-#include "base/strings/string_number_conversions.h"
-#include "base/strings/string_tokenizer.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
 #include "base/strings/string_util.h"
-#include "base/time/time.h"
-#include "base/values.h"
-#include "chrome/browser/importer/importer_list.h"
-#include "chrome/browser/shell_integration.h"
-#include "chrome/common/importer/imported_bookmark_entry.h"
-#include "chrome/common/importer/importer_bridge.h"
-#include "chrome/common/importer/importer_data_types.h"
-#include "chrome/common/ini_parser.h"
-#include "ui/base/l10n/l10n_util.h"
+
+OperaAdrEntry::OperaAdrEntry() = default;
+OperaAdrEntry::~OperaAdrEntry() = default;
+
+void OperaAdrEntry::SetField(base::StringPiece key, base::StringPiece value) {
+  if (base::EqualsCaseInsensitiveASCII(key, "name")) {
+    name = value;
+  } else if (base::EqualsCaseInsensitiveASCII(key, "url")) {
+    url = value;
+  } else if (base::EqualsCaseInsensitiveASCII(key, "short name")) {
+    short_name = value;
+  } else if (base::EqualsCaseInsensitiveASCII(key, "description")) {
+    description = value;
+  } else if (base::EqualsCaseInsensitiveASCII(key, "created")) {
+    created = value;
+  }
+}
 
 OperaAdrFileReader::OperaAdrFileReader() {}
 
@@ -29,43 +32,56 @@ bool OperaAdrFileReader::LoadFile(const base::FilePath& file) {
   if (!base::PathExists(file)) {
     return false;
   }
-  std::string bookmark_data;
-  base::ReadFileToString(file, &bookmark_data);
 
-  base::StringTokenizer tokenizer(bookmark_data, "\r\n");
+  // Map the file rather than reading it into memory, legacy exports can be
+  // tens of megabytes. All parsing below works on views into the mapping.
+  base::MemoryMappedFile mapped_file;
+  if (!mapped_file.Initialize(file)) {
+    int64_t size = 0;
+    if (base::GetFileSize(file, &size) && size == 0)
+      return true;
+    LOG(ERROR) << "Failed to map " << file;
+    return false;
+  }
+  base::StringPiece data(reinterpret_cast<const char*>(mapped_file.data()),
+                         mapped_file.length());
 
-  std::string category;
-  base::Value::Dict entries;
-  while (tokenizer.GetNext()) {
-    std::string line = tokenizer.token();
+  base::StringPiece category;
+  bool has_fields = false;
+  OperaAdrEntry entry;
+  while (!data.empty()) {
+    size_t line_end = data.find_first_of("\r\n");
+    base::StringPiece line = data.substr(0, line_end);
+    data.remove_prefix(line_end == base::StringPiece::npos ? data.size()
+                                                           : line_end + 1);
 
-    base::TrimWhitespaceASCII(line, base::TRIM_ALL, &line);
+    line = base::TrimWhitespaceASCII(line, base::TRIM_ALL);
     if (line.empty())
       continue;
 
     if (line[0] == '-' || line[0] == '#') {
       if (!category.empty())
-        HandleEntry(category, entries);
-      entries.clear();
+        HandleEntry(category, entry);
+      entry = OperaAdrEntry();
+      has_fields = false;
       if (line[0] == '-') {
-        HandleEntry("-", entries);
-        category = "";
+        HandleEntry("-", entry);
+        category = base::StringPiece();
         continue;
       }
 
       // #foo
-      category = base::ToLowerASCII(line.substr(1));  // Strip away leading'#'
+      category = line.substr(1);  // Strip away leading'#'
       continue;
     }
-    size_t equal = line.find_first_of('=');
-    if (equal != std::string::npos) {
-      std::string key = base::ToLowerASCII(line.substr(0, equal));
-      std::string val = line.substr(equal + 1);
-      entries.Set(std::move(key), std::move(val));
+    size_t equal = line.find('=');
+    if (equal != base::StringPiece::npos) {
+      entry.SetField(line.substr(0, equal), line.substr(equal + 1));
+      has_fields = true;
     }
   }
-  if (entries.size() > 0) {
-    HandleEntry(category, entries);
+  if (has_fields) {
+    HandleEntry(category, entry);
   }
   return true;
 }
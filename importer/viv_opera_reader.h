@@ -3,18 +3,35 @@
 #ifndef IMPORTER_VIV_OPERA_READER_H_
 #define IMPORTER_VIV_OPERA_READER_H_
 
-#include <string>
-
 #include "base/files/file_path.h"
-#include "base/values.h"
+#include "base/strings/string_piece.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+// The fields of one entry in an Opera .adr file that the importers use. The
+// pieces point into the mapped file and are only valid during HandleEntry.
+struct OperaAdrEntry {
+  OperaAdrEntry();
+  ~OperaAdrEntry();
+
+  // Store the value if the key, compared case-insensitively, is a known field.
+  void SetField(base::StringPiece key, base::StringPiece value);
+
+  absl::optional<base::StringPiece> name;
+  absl::optional<base::StringPiece> url;
+  absl::optional<base::StringPiece> short_name;
+  absl::optional<base::StringPiece> description;
+  absl::optional<base::StringPiece> created;
+};
 
 class OperaAdrFileReader {
  public:
   bool LoadFile(const base::FilePath& file);
 
  protected:
-  virtual void HandleEntry(const std::string& category,
-                           const base::Value::Dict& entries) = 0;
+  // Called for every entry with its category, like "folder" or "url", in the
+  // case used by the file. A folder end is reported with the category "-".
+  virtual void HandleEntry(base::StringPiece category,
+                           const OperaAdrEntry& entry) = 0;
 
   OperaAdrFileReader();
   virtual ~OperaAdrFileReader();
@@ -9,7 +9,7 @@ using chrome::mojom::ProfileImportObserver;
 
 namespace {
 
-const int kNumNotesToSend = 10;
+const int kNumNotesToSend = 100;
 const int kNumSpeedDialToSend = 100;
 
 }  // namespace
@@ -33,8 +33,12 @@ void ExternalProcessImporterClient::OnNotesImportGroup(
   // Collect sets of bookmarks from importer process until we have reached
   // total_bookmarks_count_:
   notes_.insert(notes_.end(), notes_group.begin(), notes_group.end());
-  if (notes_.size() == total_notes_count_)
+  if (notes_.size() == total_notes_count_) {
     bridge_->AddNotes(notes_, notes_first_folder_name_);
+    // The bridge does not keep a reference, so release the entries now
+    // rather than with the client once the whole import has finished.
+    std::vector<ImportedNotesEntry>().swap(notes_);
+  }
 }
 
 void ExternalProcessImporterClient::OnSpeedDialImportStart(
@@ -52,6 +56,8 @@ void ExternalProcessImporterClient::OnSpeedDialImportGroup(
     return;
 
   speeddial_.insert(speeddial_.end(), group.begin(), group.end());
-  if (speeddial_.size() == total_speeddial_count_)
+  if (speeddial_.size() == total_speeddial_count_) {
     bridge_->AddSpeedDial(speeddial_);
+    std::vector<ImportedSpeedDialEntry>().swap(speeddial_);
+  }
 }
@@ -30,6 +30,20 @@ const wchar_t kSystemMarkerFile[] = L"sys.viv";
 const wchar_t kVivaldiUpdateNotifierExe[] = L"update_notifier.exe";
 const wchar_t kVivaldiUpdateNotifierOldExe[] = L"update_notifier.old";
 
+// Browser instance detection.
+
+// Prefix of the name of the mutex that all processes running vivaldi.exe from
+// an installation keep open. The global namespace is used so the installer
+// sees the processes from all sessions.
+const wchar_t kBrowserInstanceMutexPrefix[] = L"Global\\VivaldiInstance-";
+
+// The first version that holds the browser instance mutex. Processes of older
+// versions must still be found by enumerating all processes. The mutex was
+// added while VIVALDI_NIGHTLY was 2805, so only the following nightly number
+// is certain to have it. Builds of 2805 that hold the mutex just take the
+// slower enumeration.
+const char kBrowserInstanceMutexMinVersion[] = "5.5.2806.0";
+
 // Vivaldi installer command line switches.
 
 // Use the given installation directory overriding the value from the registry.
@@ -27,6 +27,10 @@ extern const wchar_t kSystemMarkerFile[];
 extern const wchar_t kVivaldiUpdateNotifierExe[];
 extern const wchar_t kVivaldiUpdateNotifierOldExe[];
 
+// Browser instance detection.
+extern const wchar_t kBrowserInstanceMutexPrefix[];
+extern const char kBrowserInstanceMutexMinVersion[];
+
 // Vivaldi installer command line switches.
 extern const char kVivaldiInstallDir[];
 extern const char kVivaldiLanguage[];
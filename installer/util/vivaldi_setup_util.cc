@@ -4,6 +4,7 @@
 
 #include "base/command_line.h"
 #include "base/environment.h"
+#include "base/file_version_info_win.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/path_service.h"
@@ -11,6 +12,7 @@
 #include "base/strings/string_util_win.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "base/win/registry.h"
 #include "base/win/scoped_handle.h"
 #include "base/win/win_util.h"
@@ -31,6 +33,7 @@
 #include "installer/util/vivaldi_install_dialog.h"
 #include "installer/util/vivaldi_install_util.h"
 #include "installer/util/vivaldi_progress_dialog.h"
+#include "installer/util/vivaldi_static_install_helpers.h"
 #include "installer/win/vivaldi_install_l10n.h"
 #include "update_notifier/update_notifier_switches.h"
 
@@ -255,7 +258,9 @@ std::vector<base::win::ScopedHandle> GetRunningProcessesForPath(
   return processes;
 }
 
-void KillProcesses(std::vector<base::win::ScopedHandle> processes) {
+std::vector<base::win::ScopedHandle> KillProcesses(
+    std::vector<base::win::ScopedHandle> processes) {
+  std::vector<base::win::ScopedHandle> killed_processes;
   for (auto& process : processes) {
     DCHECK(process.IsValid());
 
@@ -267,11 +272,68 @@ void KillProcesses(std::vector<base::win::ScopedHandle> processes) {
     if (!process.IsValid())
       continue;
     ::TerminateProcess(process.Get(), 1);
+    killed_processes.push_back(std::move(process));
+  }
+  return killed_processes;
+}
+
+// Wait until all processes exit or the timeout expires.
+void WaitForProcessesToExit(
+    const std::vector<base::win::ScopedHandle>& processes,
+    base::TimeDelta timeout) {
+  base::TimeTicks deadline = base::TimeTicks::Now() + timeout;
+  for (size_t i = 0; i < processes.size(); i += MAXIMUM_WAIT_OBJECTS) {
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    DWORD count = 0;
+    for (; count < MAXIMUM_WAIT_OBJECTS && i + count < processes.size();
+         ++count) {
+      handles[count] = processes[i + count].Get();
+    }
+    base::TimeDelta remaining = deadline - base::TimeTicks::Now();
+    if (remaining <= base::TimeDelta())
+      return;
+    DWORD result = ::WaitForMultipleObjects(
+        count, handles, TRUE, static_cast<DWORD>(remaining.InMilliseconds()));
+    if (result == WAIT_TIMEOUT || result == WAIT_FAILED)
+      return;
+  }
+}
+
+// Return true if no process is running vivaldi_exe_path according to the
+// browser instance mutex. This avoids enumerating all processes in the common
+// case when nothing runs. Return false if some processes may run or when the
+// installed version is too old to hold the mutex.
+bool IsBrowserInstanceMutexAbsent(const base::FilePath& vivaldi_exe_path) {
+  std::unique_ptr<FileVersionInfoWin> file_version_info =
+      FileVersionInfoWin::CreateFileVersionInfoWin(vivaldi_exe_path);
+  if (!file_version_info)
+    return false;
+  base::Version version = file_version_info->GetFileVersion();
+  if (!version.IsValid() ||
+      version <
+          base::Version(vivaldi::constants::kBrowserInstanceMutexMinVersion)) {
+    return false;
+  }
+  std::wstring mutex_name =
+      GetBrowserInstanceMutexName(vivaldi_exe_path.value().c_str());
+  if (mutex_name.empty())
+    return false;
+  base::win::ScopedHandle mutex(
+      ::OpenMutex(SYNCHRONIZE, FALSE, mutex_name.c_str()));
+  if (mutex.IsValid())
+    return false;
 
-    // Close no longer necessary process handle now without wating for the loop
-    // to finish.
-    process.Close();
+  // Access errors mean that the mutex exists.
+  return ::GetLastError() == ERROR_FILE_NOT_FOUND;
+}
+
+std::vector<base::win::ScopedHandle> GetRunningBrowserProcesses(
+    const base::FilePath& vivaldi_exe_path) {
+  if (IsBrowserInstanceMutexAbsent(vivaldi_exe_path)) {
+    VLOG(1) << "GetRunningBrowserProcesses: no instance mutex";
+    return std::vector<base::win::ScopedHandle>();
   }
+  return GetRunningProcessesForPath(vivaldi_exe_path);
 }
 
 bool TryToCloseAllRunningBrowsers(
@@ -284,18 +346,12 @@ bool TryToCloseAllRunningBrowsers(
     PLOG(ERROR) << "Failed to normalize " << vivaldi_exe_path;
   }
   std::vector<base::win::ScopedHandle> vivaldi_processes(
-      GetRunningProcessesForPath(vivaldi_exe_path));
+      GetRunningBrowserProcesses(vivaldi_exe_path));
   if (vivaldi_processes.empty())
     return true;
-  KillProcesses(std::move(vivaldi_processes));
-
-  const int MAX_WAIT_SECS = 10;
-  for (int wait = MAX_WAIT_SECS * 10; wait > 0; --wait) {
-    Sleep(100);
-    vivaldi_processes = GetRunningProcessesForPath(vivaldi_exe_path);
-    if (vivaldi_processes.empty())
-      break;
-  }
+  WaitForProcessesToExit(KillProcesses(std::move(vivaldi_processes)),
+                         base::Seconds(10));
+  vivaldi_processes = GetRunningBrowserProcesses(vivaldi_exe_path);
 
   while (!vivaldi_processes.empty()) {
     int choice = MessageBox(
@@ -307,7 +363,7 @@ bool TryToCloseAllRunningBrowsers(
       VLOG(1) << "Vivaldi: install cancelled due to running instances.";
       return false;
     }
-    vivaldi_processes = vivaldi::GetRunningProcessesForPath(vivaldi_exe_path);
+    vivaldi_processes = GetRunningBrowserProcesses(vivaldi_exe_path);
   }
 
   return true;
@@ -610,6 +666,17 @@ void EndInstallOrUninstall(const installer::InstallerState& installer_state,
                            installer::InstallStatus install_status) {
   if (installer_state.operation() == installer::InstallerState::UNINSTALL)
     return;
+  switch (install_status) {
+    case installer::APPLY_DIFF_PATCH_FAILED:
+    case installer::DIFF_PATCH_SOURCE_MISSING:
+      // The Zucchini, Courgette or bsdiff patch from the delta installer
+      // could not be applied to the installed archive. Record this so the
+      // next update downloads the full installer instead of another delta.
+      UpdateDeltaPatchStatus(false);
+      break;
+    default:
+      break;
+  }
   if (!g_silent_install) {
     int return_code = InstallUtil::GetInstallReturnCode(install_status);
     if (return_code == 0) {
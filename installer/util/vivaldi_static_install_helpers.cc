@@ -71,4 +71,42 @@ bool IsSystemInstallExecutable(const std::wstring& exe_path) {
   return is_system;
 }
 
+std::wstring GetBrowserInstanceMutexName(const wchar_t* exe_path) {
+  HANDLE file =
+      ::CreateFile(exe_path, FILE_READ_ATTRIBUTES,
+                   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                   nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return std::wstring();
+  wchar_t final_path[MAX_PATH];
+  DWORD length = ::GetFinalPathNameByHandle(file, final_path, MAX_PATH,
+                                            FILE_NAME_NORMALIZED);
+  ::CloseHandle(file);
+  if (length == 0 || length >= MAX_PATH)
+    return std::wstring();
+
+  const wchar_t* last_backslash = ::wcsrchr(final_path, L'\\');
+  if (!last_backslash)
+    return std::wstring();
+
+  std::wstring name(vivaldi::constants::kBrowserInstanceMutexPrefix);
+  size_t prefix_length = name.length();
+  name.append(final_path, last_backslash - final_path);
+  if (name.length() >= MAX_PATH)
+    return std::wstring();
+
+  // Backslashes are not allowed in kernel object names past the namespace.
+  int path_length = static_cast<int>(name.length() - prefix_length);
+  wchar_t* path = &name[prefix_length];
+  for (int i = 0; i < path_length; ++i) {
+    if (path[i] == L'\\') {
+      path[i] = L'/';
+    }
+  }
+  // Do not use CharUpper() as only kernel.lib API is allowed here.
+  ::LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_UPPERCASE, path, path_length,
+                  path, path_length, nullptr, nullptr, 0);
+  return name;
+}
+
 }  // namespace vivaldi
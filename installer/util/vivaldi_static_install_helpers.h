@@ -19,6 +19,13 @@ bool GetStandaloneInstallDataDirectory(std::wstring& result);
 // be an absolute path that uses \ as a path separators.
 bool IsSystemInstallExecutable(const std::wstring& exe_path);
 
+// Return the name of the mutex that every process running the given vivaldi.exe
+// keeps open for its lifetime. The name is derived from the final path of the
+// executable directory so it does not depend on how the executable was
+// reached. Return an empty string if the executable cannot be opened or the
+// name would be too long for a kernel object.
+std::wstring GetBrowserInstanceMutexName(const wchar_t* exe_path);
+
 }  // namespace vivaldi
 
 #endif  // INSTALLER_UTIL_VIVALDI_STATIC_INSTALL_HELPERS_H_
@@ -4,6 +4,7 @@
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/strings/string_util.h"
 #include "base/strings/string_util_win.h"
 #include "base/test/test_file_util.h"
 #include "components/version_info/version_info_values.h"
@@ -64,4 +65,53 @@ TEST(VivaldiStaticInstallHelpers, IsSystemInstallExecutable) {
   EXPECT_FALSE(IsSystemInstallExecutable(L"" VIVALDI_VERSION "\\" + kVivaldi));
 }
 
+TEST(VivaldiStaticInstallHelpers, GetBrowserInstanceMutexName) {
+  const std::wstring kPrefix = vivaldi::constants::kBrowserInstanceMutexPrefix;
+  ASSERT_EQ(kPrefix, L"Global\\VivaldiInstance-");
+
+  base::FilePath dir =
+      base::CreateUniqueTempDirectoryScopedToTest().Append(L"Application");
+  ASSERT_TRUE(base::CreateDirectory(dir));
+  base::FilePath exe_path = dir.Append(L"vivaldi.exe");
+  ASSERT_TRUE(base::WriteFile(exe_path, ""));
+
+  std::wstring name = GetBrowserInstanceMutexName(exe_path.value().c_str());
+  ASSERT_TRUE(base::StartsWith(name, kPrefix));
+  std::wstring path = name.substr(kPrefix.length());
+
+  // The name holds the upper-cased directory with slashes as separators.
+  EXPECT_EQ(path.find(L'\\'), std::wstring::npos);
+  EXPECT_EQ(path, base::ToUpperASCII(path));
+  EXPECT_TRUE(base::EndsWith(path, L"/APPLICATION"));
+
+  // The name does not depend on the case of the path.
+  EXPECT_EQ(name, GetBrowserInstanceMutexName(
+                      base::ToLowerASCII(exe_path.value()).c_str()));
+  EXPECT_EQ(name, GetBrowserInstanceMutexName(
+                      base::ToUpperASCII(exe_path.value()).c_str()));
+
+  // Any file in the same directory gives the same name.
+  base::FilePath other_path = dir.Append(L"update_notifier.exe");
+  ASSERT_TRUE(base::WriteFile(other_path, ""));
+  EXPECT_EQ(name, GetBrowserInstanceMutexName(other_path.value().c_str()));
+
+  // Missing files give no name.
+  EXPECT_EQ(std::wstring(), GetBrowserInstanceMutexName(
+                                dir.Append(L"missing.exe").value().c_str()));
+  EXPECT_EQ(std::wstring(), GetBrowserInstanceMutexName(L""));
+
+  // A directory that still fits MAX_PATH gives no name when the prefix makes
+  // it too long for a kernel object.
+  base::FilePath long_dir = base::CreateUniqueTempDirectoryScopedToTest();
+  const size_t kLongDirLength = 240;
+  ASSERT_LT(long_dir.value().length() + 1, kLongDirLength);
+  long_dir = long_dir.Append(
+      std::wstring(kLongDirLength - long_dir.value().length() - 1, L'a'));
+  ASSERT_TRUE(base::CreateDirectory(long_dir));
+  base::FilePath long_exe_path = long_dir.Append(L"vivaldi.exe");
+  ASSERT_TRUE(base::WriteFile(long_exe_path, ""));
+  EXPECT_EQ(std::wstring(),
+            GetBrowserInstanceMutexName(long_exe_path.value().c_str()));
+}
+
 }  // namespace vivaldi
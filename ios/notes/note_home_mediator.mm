@@ -24,6 +24,7 @@
 #import "ios/notes/note_home_consumer.h"
 #import "ios/notes/note_home_shared_state.h"
 #import "ios/notes/note_model_bridge_observer.h"
+#import "ios/notes/note_utils_ios.h"
 #import "ios/notes/cells/note_home_node_item.h"
 #include "notes/notes_model.h"
 #include "ui/base/l10n/l10n_util.h"
@@ -58,6 +59,9 @@ class NoteModelBridge;
   std::unique_ptr<PrefObserverBridge> _prefObserverBridge;
   // Registrar for pref changes notifications.
   std::unique_ptr<PrefChangeRegistrar> _prefChangeRegistrar;
+
+  // YES while a refresh for note model changes is posted but has not run.
+  BOOL _refreshPending;
 }
 
 // Shared state between Note home classes.
@@ -110,6 +114,7 @@ class NoteModelBridge;
 
 - (void)disconnect {
   _modelBridge = nullptr;
+  _refreshPending = NO;
   //_syncedNotesObserver = nullptr;
   self.browserState = nullptr;
   self.consumer = nil;
@@ -198,17 +203,19 @@ class NoteModelBridge;
   [self deleteAllItemsOrAddSectionWithIdentifier:
             NoteHomeSectionIdentifierMessages];
 
-  std::vector<const NoteNode*> nodes;
   std::vector<std::pair<int, NoteNode::Type>> results;
   self.sharedState.notesModel->GetNotesMatching(
         base::SysNSStringToUTF16(searchText),
         kMaxNotesSearchResults,
         &results);
+  // Resolve all results with one walk of the tree rather than one per result.
+  std::vector<int64_t> ids;
+  ids.reserve(results.size());
   for (const std::pair<int, NoteNode::Type>& node : results) {
-      const NoteNode* noteNode = vivaldi::GetNotesNodeByID(
-            self.sharedState.notesModel, static_cast<int64_t>(node.first));
-      nodes.push_back(noteNode);
+    ids.push_back(static_cast<int64_t>(node.first));
   }
+  note_utils_ios::NodeVector nodes = note_utils_ios::FindNodesByIdsInOrder(
+      self.sharedState.notesModel, ids);
   int count = 0;
   for (const NoteNode* node : nodes) {
     NoteHomeNodeItem* nodeItem =
@@ -283,7 +290,7 @@ class NoteModelBridge;
 
   // A specific cell changed. Reload, if currently shown.
   if ([self itemForNode:noteNode] != nil) {
-    [self.consumer refreshContents];
+    [self setNeedsRefresh];
   }
 }
 
@@ -291,14 +298,14 @@ class NoteModelBridge;
 - (void)noteNodeChildrenChanged:(const NoteNode*)noteNode {
   // In search mode, we want to refresh any changes (like undo).
   if (self.sharedState.currentlyShowingSearchResults) {
-    [self.consumer refreshContents];
+    [self setNeedsRefresh];
   }
   // The current root folder's children changed. Reload everything.
   // (When adding new folder, table is already been updated. So no need to
   // reload here.)
   if (noteNode == self.sharedState.tableViewDisplayedRootNode &&
       !self.sharedState.addingNewFolder && !self.sharedState.addingNewNote) {
-    [self.consumer refreshContents];
+    [self setNeedsRefresh];
     return;
   }
 }
@@ -310,24 +317,57 @@ class NoteModelBridge;
   if (oldParent == self.sharedState.tableViewDisplayedRootNode ||
       newParent == self.sharedState.tableViewDisplayedRootNode) {
     // A folder was added or removed from the current root folder.
-    [self.consumer refreshContents];
+    [self setNeedsRefresh];
   }
 }
 
 // |node| was deleted from |folder|.
+// The table items and the selected edit nodes hold raw pointers to the shown
+// nodes, and |node| with its descendants is freed right after this returns.
+// So deletions refresh at once rather than after the run loop turn.
 - (void)noteNodeDeleted:(const NoteNode*)node
                  fromFolder:(const NoteNode*)folder {
   if (self.sharedState.currentlyShowingSearchResults) {
-    [self.consumer refreshContents];
+    [self refreshNow];
   } else if (self.sharedState.tableViewDisplayedRootNode == node) {
     self.sharedState.tableViewDisplayedRootNode = NULL;
-    [self.consumer refreshContents];
+    [self refreshNow];
+  } else if (self.sharedState.tableViewDisplayedRootNode == folder) {
+    [self refreshNow];
   }
 }
 
 // All non-permanent nodes have been removed.
 - (void)noteModelRemovedAllNodes {
   // TODO(crbug.com/695749) Check if this case is applicable in the new UI.
+  // The removed nodes are freed, so do not wait for a pending refresh.
+  [self refreshNow];
+}
+
+// Refreshes the consumer once the current run loop turn is done. Moving,
+// changing or undoing a selection of notes sends a notification per node, and
+// rebuilding the table for each of them made large edits slow. This must not
+// be used for deletions, see noteNodeDeleted:fromFolder:.
+- (void)setNeedsRefresh {
+  if (_refreshPending)
+    return;
+  _refreshPending = YES;
+  __weak NoteHomeMediator* weakSelf = self;
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [weakSelf refreshIfNeeded];
+  });
+}
+
+- (void)refreshIfNeeded {
+  if (!_refreshPending)
+    return;
+  [self refreshNow];
+}
+
+// Refreshes the consumer synchronously. This also serves a pending refresh.
+- (void)refreshNow {
+  _refreshPending = NO;
+  [self.consumer refreshContents];
 }
 
 - (NoteHomeNodeItem*)itemForNode:
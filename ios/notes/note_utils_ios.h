@@ -32,6 +32,11 @@ typedef std::set<const vivaldi::NoteNode*> NodeSet;
 absl::optional<NodeSet> FindNodesByIds(vivaldi::NotesModel* model,
                                        const std::set<int64_t>& ids);
 
+// Finds the note nodes for |ids| with a single walk of the tree. The result
+// has the order of |ids| and skips the ids that are not in the |model|.
+NodeVector FindNodesByIdsInOrder(vivaldi::NotesModel* model,
+                                 const std::vector<int64_t>& ids);
+
 // Finds note node passed in |id|, in the |model|.
 const vivaldi::NoteNode* FindNodeById(vivaldi::NotesModel* model,
                                             int64_t id);
@@ -5,6 +5,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #import <MaterialComponents/MaterialSnackbar.h>
@@ -64,6 +65,35 @@ absl::optional<NodeSet> FindNodesByIds(NotesModel* model,
   return nodes;
 }
 
+NodeVector FindNodesByIdsInOrder(NotesModel* model,
+                                 const std::vector<int64_t>& ids) {
+  DCHECK(model);
+  std::unordered_map<int64_t, size_t> positions;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    positions.emplace(ids[i], i);
+  }
+
+  NodeVector found(ids.size(), nullptr);
+  size_t found_count = 0;
+  ui::TreeNodeIterator<const NoteNode> iterator(model->root_node());
+  while (found_count < positions.size() && iterator.has_next()) {
+    const NoteNode* node = iterator.Next();
+    auto i = positions.find(node->id());
+    if (i == positions.end())
+      continue;
+    found[i->second] = node;
+    found_count++;
+  }
+
+  NodeVector nodes;
+  nodes.reserve(found_count);
+  for (const NoteNode* node : found) {
+    if (node)
+      nodes.push_back(node);
+  }
+  return nodes;
+}
+
 const NoteNode* FindNodeById(vivaldi::NotesModel* model, int64_t id) {
   DCHECK(model);
   ui::TreeNodeIterator<const NoteNode> iterator(model->root_node());
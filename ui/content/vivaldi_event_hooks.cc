@@ -3,6 +3,7 @@
 #include "ui/content/vivaldi_event_hooks.h"
 
 #include "app/vivaldi_apptools.h"
+#include "base/trace_event/trace_event.h"
 #include "content/browser/renderer_host/render_widget_host_view_base.h"
 #include "content/browser/web_contents/web_contents_impl.h"
 
@@ -25,6 +26,7 @@ bool VivaldiEventHooks::HandleMouseEvent(
     const blink::WebMouseEvent& event) {
   if (!instance_)
     return false;
+  TRACE_EVENT0("input,latency", "VivaldiEventHooks::HandleMouseEvent");
   return instance_->DoHandleMouseEvent(root_view, event);
 }
 
@@ -35,6 +37,7 @@ bool VivaldiEventHooks::HandleWheelEvent(
     const ui::LatencyInfo& latency) {
   if (!instance_)
     return false;
+  TRACE_EVENT0("input,latency", "VivaldiEventHooks::HandleWheelEvent");
   return instance_->DoHandleWheelEvent(root_view, event, latency);
 }
 
@@ -44,6 +47,8 @@ bool VivaldiEventHooks::HandleWheelEventAfterChild(
     const blink::WebMouseWheelEvent& event) {
   if (!instance_)
     return false;
+  TRACE_EVENT0("input,latency",
+               "VivaldiEventHooks::HandleWheelEventAfterChild");
   return instance_->DoHandleWheelEventAfterChild(root_view, event);
 }
 
@@ -53,6 +58,7 @@ bool VivaldiEventHooks::HandleKeyboardEvent(
     const content::NativeWebKeyboardEvent& event) {
   if (!instance_)
     return false;
+  TRACE_EVENT0("input,latency", "VivaldiEventHooks::HandleKeyboardEvent");
   return instance_->DoHandleKeyboardEvent(widget_host, event);
 }
 